@@ -29,6 +29,22 @@ bool IsValidOrder(const Order& order) {
           (order.oneof_amount_case() == Order::kQuoteAmount &&
            order.has_quote_amount() && order.quote_amount() > 0));
 }
+
+Account::FeeCoefficients ToFeeCoefficients(const FeeConfig& fee_config) {
+  Account::FeeCoefficients fee;
+  fee.relative_fee = fee_config.relative_fee();
+  fee.fixed_fee = fee_config.fixed_fee();
+  fee.minimum_fee = fee_config.minimum_fee();
+  return fee;
+}
+
+bool IsValidOrderSpec(const OrderSpec& order) {
+  return
+      // Positive price is required for non-market orders.
+      (order.type == Order::MARKET || order.price > 0) &&
+      // Every order must specify a positive amount.
+      order.amount > 0;
+}
 }  // namespace
 
 void Account::InitAccount(const AccountConfig& account_config) {
@@ -39,12 +55,21 @@ void Account::InitAccount(const AccountConfig& account_config) {
   quote_unit = account_config.quote_unit();
   market_liquidity = account_config.market_liquidity();
   max_volume_ratio = account_config.max_volume_ratio();
+  order_fees[Order::MARKET] =
+      ToFeeCoefficients(account_config.market_order_fee_config());
+  order_fees[Order::STOP] =
+      ToFeeCoefficients(account_config.stop_order_fee_config());
+  order_fees[Order::LIMIT] =
+      ToFeeCoefficients(account_config.limit_order_fee_config());
 }
 
 float Account::GetFee(const FeeConfig& fee_config, float quote_amount) const {
-  return Ceil(std::max(fee_config.minimum_fee(),
-                       fee_config.fixed_fee() +
-                           quote_amount * fee_config.relative_fee()),
+  return GetFee(ToFeeCoefficients(fee_config), quote_amount);
+}
+
+float Account::GetFee(const FeeCoefficients& fee, float quote_amount) const {
+  return Ceil(std::max(fee.minimum_fee,
+                       fee.fixed_fee + quote_amount * fee.relative_fee),
               quote_unit);
 }
 
@@ -76,6 +101,11 @@ float Account::GetMaxBaseAmount(const OhlcTick& ohlc_tick) const {
 
 bool Account::BuyBase(const FeeConfig& fee_config, float base_amount,
                       float price) {
+  return BuyBase(ToFeeCoefficients(fee_config), base_amount, price);
+}
+
+bool Account::BuyBase(const FeeCoefficients& fee, float base_amount,
+                      float price) {
   assert(price > 0);
   assert(base_amount >= 0);
   base_amount = Round(base_amount, base_unit);
@@ -83,7 +113,7 @@ bool Account::BuyBase(const FeeConfig& fee_config, float base_amount,
     return false;
   }
   const float quote_amount = Ceil(base_amount * price, quote_unit);
-  const float quote_fee = GetFee(fee_config, quote_amount);
+  const float quote_fee = GetFee(fee, quote_amount);
   const float total_quote_amount = quote_amount + quote_fee;
   if (total_quote_amount > quote_balance) {
     return false;
@@ -96,13 +126,19 @@ bool Account::BuyBase(const FeeConfig& fee_config, float base_amount,
 
 bool Account::BuyAtQuote(const FeeConfig& fee_config, float quote_amount,
                          float price, float max_base_amount) {
+  return BuyAtQuote(ToFeeCoefficients(fee_config), quote_amount, price,
+                    max_base_amount);
+}
+
+bool Account::BuyAtQuote(const FeeCoefficients& fee, float quote_amount,
+                         float price, float max_base_amount) {
   assert(price > 0);
   assert(quote_amount >= 0);
   quote_amount = Round(quote_amount, quote_unit);
   if (quote_amount < quote_unit || quote_amount > quote_balance) {
     return false;
   }
-  const float quote_fee = GetFee(fee_config, quote_amount);
+  const float quote_fee = GetFee(fee, quote_amount);
   if (quote_amount <= quote_fee) {
     return false;
   }
@@ -111,11 +147,16 @@ bool Account::BuyAtQuote(const FeeConfig& fee_config, float quote_amount,
   if (base_amount < base_unit) {
     return false;
   }
-  return BuyBase(fee_config, base_amount, price);
+  return BuyBase(fee, base_amount, price);
 }
 
 bool Account::SellBase(const FeeConfig& fee_config, float base_amount,
                        float price) {
+  return SellBase(ToFeeCoefficients(fee_config), base_amount, price);
+}
+
+bool Account::SellBase(const FeeCoefficients& fee, float base_amount,
+                       float price) {
   assert(price > 0);
   assert(base_amount >= 0);
   base_amount = Round(base_amount, base_unit);
@@ -123,7 +164,7 @@ bool Account::SellBase(const FeeConfig& fee_config, float base_amount,
     return false;
   }
   const float quote_amount = Floor(base_amount * price, quote_unit);
-  const float quote_fee = GetFee(fee_config, quote_amount);
+  const float quote_fee = GetFee(fee, quote_amount);
   const float total_quote_amount = quote_amount - quote_fee;
   if (total_quote_amount < quote_unit) {
     return false;
@@ -136,13 +177,19 @@ bool Account::SellBase(const FeeConfig& fee_config, float base_amount,
 
 bool Account::SellAtQuote(const FeeConfig& fee_config, float quote_amount,
                           float price, float max_base_amount) {
+  return SellAtQuote(ToFeeCoefficients(fee_config), quote_amount, price,
+                     max_base_amount);
+}
+
+bool Account::SellAtQuote(const FeeCoefficients& fee, float quote_amount,
+                          float price, float max_base_amount) {
   assert(price > 0);
   assert(quote_amount >= 0);
   quote_amount = Round(quote_amount, quote_unit);
   if (quote_amount < quote_unit) {
     return false;
   }
-  const float quote_fee = GetFee(fee_config, quote_amount);
+  const float quote_fee = GetFee(fee, quote_amount);
   const float base_amount = Floor(
       std::min((quote_amount + quote_fee) / price, max_base_amount), base_unit);
   if (base_amount < base_unit) {
@@ -152,7 +199,7 @@ bool Account::SellAtQuote(const FeeConfig& fee_config, float quote_amount,
   //   (quote_amount + quote_fee) - GetFee(quote_amount + quote_fee)
   // Since GetFee(quote_amount) <= GetFee(quote_amount + quote_fee),
   // We receive at most quote_amount of quote currency.
-  return SellBase(fee_config, base_amount, price);
+  return SellBase(fee, base_amount, price);
 }
 
 bool Account::MarketBuy(const FeeConfig& fee_config, const OhlcTick& ohlc_tick,
@@ -290,76 +337,114 @@ bool Account::LimitSellAtQuote(const FeeConfig& fee_config,
 bool Account::ExecuteOrder(const AccountConfig& account_config,
                            const Order& order, const OhlcTick& ohlc_tick) {
   assert(IsValidOrder(order));
-  switch (order.type()) {
+  return ExecuteOrder(account_config, ToOrderSpec(order), ohlc_tick);
+}
+
+namespace {
+// Execution kernel for orders of the given type, side, and amount kind.
+// Implements exactly the same semantics as the corresponding Account methods
+// (e.g. Account::StopBuyAtQuote), but all order parameters (except the amount
+// and the price) are resolved at compile time.
+template <Order::Type kType, Order::Side kSide, OrderSpec::AmountKind kAmount>
+bool ExecuteOrderKernel(Account& account, const Account::FeeCoefficients& fee,
+                        const OrderSpec& order, const OhlcTick& ohlc_tick) {
+  constexpr bool kBuy = kSide == Order::BUY;
+  constexpr bool kBaseAmount = kAmount == OrderSpec::AmountKind::kBase;
+  float price = 0;
+  float max_base_amount = std::numeric_limits<float>::max();
+  if constexpr (kType == Order::MARKET) {
+    price = kBuy ? account.GetMarketBuyPrice(ohlc_tick)
+                 : account.GetMarketSellPrice(ohlc_tick);
+  } else if constexpr (kType == Order::STOP) {
+    // Stop buy (sell) order can be executed only if the actual price jumps
+    // above (drops below) the stop order price.
+    if (kBuy ? ohlc_tick.high() < order.price
+             : ohlc_tick.low() > order.price) {
+      return false;
+    }
+    price = kBuy ? account.GetStopBuyPrice(ohlc_tick, order.price)
+                 : account.GetStopSellPrice(ohlc_tick, order.price);
+  } else {
+    static_assert(kType == Order::LIMIT, "Invalid order type");
+    // Limit buy (sell) order can be executed only if the actual price drops
+    // below (jumps above) the limit order price.
+    if (kBuy ? ohlc_tick.low() > order.price
+             : ohlc_tick.high() < order.price) {
+      return false;
+    }
+    price = order.price;
+    max_base_amount = account.GetMaxBaseAmount(ohlc_tick);
+  }
+  if constexpr (kBaseAmount) {
+    const float base_amount = kType == Order::LIMIT
+                                  ? std::min(order.amount, max_base_amount)
+                                  : order.amount;
+    return kBuy ? account.BuyBase(fee, base_amount, price)
+                : account.SellBase(fee, base_amount, price);
+  } else {
+    return kBuy
+               ? account.BuyAtQuote(fee, order.amount, price, max_base_amount)
+               : account.SellAtQuote(fee, order.amount, price,
+                                     max_base_amount);
+  }
+}
+
+using OrderKernel = bool (*)(Account&, const Account::FeeCoefficients&,
+                             const OrderSpec&, const OhlcTick&);
+
+// Returns the kernel for the given order type (indexed by the order side and
+// the amount kind).
+template <Order::Type kType>
+constexpr std::array<std::array<OrderKernel, 2>, 2> GetOrderKernels() {
+  return {{{ExecuteOrderKernel<kType, Order::BUY, OrderSpec::AmountKind::kBase>,
+            ExecuteOrderKernel<kType, Order::BUY,
+                               OrderSpec::AmountKind::kQuote>},
+           {ExecuteOrderKernel<kType, Order::SELL,
+                               OrderSpec::AmountKind::kBase>,
+            ExecuteOrderKernel<kType, Order::SELL,
+                               OrderSpec::AmountKind::kQuote>}}};
+}
+
+// Order execution kernels indexed by the order type, side, and amount kind.
+constexpr std::array<std::array<std::array<OrderKernel, 2>, 2>, 3>
+    kOrderKernels = {GetOrderKernels<Order::MARKET>(),
+                     GetOrderKernels<Order::STOP>(),
+                     GetOrderKernels<Order::LIMIT>()};
+
+// Returns the kernel for executing the given order.
+OrderKernel GetOrderKernel(const OrderSpec& order) {
+  assert(order.type >= 0 && order.type < Order::Type_ARRAYSIZE);
+  assert(order.side >= 0 && order.side < Order::Side_ARRAYSIZE);
+  return kOrderKernels[order.type][order.side]
+                      [static_cast<int>(order.amount_kind)];
+}
+}  // namespace
+
+bool Account::ExecuteOrder(const AccountConfig& account_config,
+                           const OrderSpec& order, const OhlcTick& ohlc_tick) {
+  assert(IsValidOrderSpec(order));
+  FeeCoefficients fee;
+  switch (order.type) {
     case Order::MARKET:
-      if (order.side() == Order::BUY) {
-        if (order.oneof_amount_case() == Order::kBaseAmount) {
-          return MarketBuy(account_config.market_order_fee_config(), ohlc_tick,
-                           order.base_amount());
-        } else {
-          assert(order.oneof_amount_case() == Order::kQuoteAmount);
-          return MarketBuyAtQuote(account_config.market_order_fee_config(),
-                                  ohlc_tick, order.quote_amount());
-        }
-      } else {
-        assert(order.side() == Order::SELL);
-        if (order.oneof_amount_case() == Order::kBaseAmount) {
-          return MarketSell(account_config.market_order_fee_config(), ohlc_tick,
-                            order.base_amount());
-        } else {
-          assert(order.oneof_amount_case() == Order::kQuoteAmount);
-          return MarketSellAtQuote(account_config.market_order_fee_config(),
-                                   ohlc_tick, order.quote_amount());
-        }
-      }
+      fee = ToFeeCoefficients(account_config.market_order_fee_config());
+      break;
     case Order::STOP:
-      if (order.side() == Order::BUY) {
-        if (order.oneof_amount_case() == Order::kBaseAmount) {
-          return StopBuy(account_config.stop_order_fee_config(), ohlc_tick,
-                         order.base_amount(), order.price());
-        } else {
-          assert(order.oneof_amount_case() == Order::kQuoteAmount);
-          return StopBuyAtQuote(account_config.stop_order_fee_config(),
-                                ohlc_tick, order.quote_amount(), order.price());
-        }
-      } else {
-        assert(order.side() == Order::SELL);
-        if (order.oneof_amount_case() == Order::kBaseAmount) {
-          return StopSell(account_config.stop_order_fee_config(), ohlc_tick,
-                          order.base_amount(), order.price());
-        } else {
-          assert(order.oneof_amount_case() == Order::kQuoteAmount);
-          return StopSellAtQuote(account_config.stop_order_fee_config(),
-                                 ohlc_tick, order.quote_amount(),
-                                 order.price());
-        }
-      }
+      fee = ToFeeCoefficients(account_config.stop_order_fee_config());
+      break;
     case Order::LIMIT:
-      if (order.side() == Order::BUY) {
-        if (order.oneof_amount_case() == Order::kBaseAmount) {
-          return LimitBuy(account_config.limit_order_fee_config(), ohlc_tick,
-                          order.base_amount(), order.price());
-        } else {
-          assert(order.oneof_amount_case() == Order::kQuoteAmount);
-          return LimitBuyAtQuote(account_config.limit_order_fee_config(),
-                                 ohlc_tick, order.quote_amount(),
-                                 order.price());
-        }
-      } else {
-        assert(order.side() == Order::SELL);
-        if (order.oneof_amount_case() == Order::kBaseAmount) {
-          return LimitSell(account_config.limit_order_fee_config(), ohlc_tick,
-                           order.base_amount(), order.price());
-        } else {
-          assert(order.oneof_amount_case() == Order::kQuoteAmount);
-          return LimitSellAtQuote(account_config.limit_order_fee_config(),
-                                  ohlc_tick, order.quote_amount(),
-                                  order.price());
-        }
-      }
+      fee = ToFeeCoefficients(account_config.limit_order_fee_config());
+      break;
     default:
       assert(false);  // Invalid order type.
+      return false;
   }
+  return GetOrderKernel(order)(*this, fee, order, ohlc_tick);
+}
+
+bool Account::ExecuteOrder(const OrderSpec& order, const OhlcTick& ohlc_tick) {
+  assert(IsValidOrderSpec(order));
+  return GetOrderKernel(order)(*this, order_fees[order.type], order,
+                               ohlc_tick);
 }
 
 }  // namespace trader
@@ -3,12 +3,22 @@
 #ifndef BASE_ACCOUNT_H
 #define BASE_ACCOUNT_H
 
+#include <array>
+
 #include "base/base.h"
+#include "base/order.h"
 
 namespace trader {
 
 // Keeps track of balances and implements methods for all exchange orders.
 struct Account {
+  // Flat representation of the FeeConfig (see GetFee below).
+  struct FeeCoefficients {
+    float relative_fee = 0;
+    float fixed_fee = 0;
+    float minimum_fee = 0;
+  };
+
   // Base (crypto) currency balance (e.g. BTC balance when trading BTC/YYY).
   float base_balance = 0;
   // Quote currency balance (e.g. USD balance when trading XXX/USD).
@@ -39,6 +49,10 @@ struct Account {
   // order amount, then the limit order will be filled only partially.
   // Not used if zero.
   float max_volume_ratio = 0.0f;
+  // Fee coefficients for every order type (indexed by Order::Type).
+  // Resolved from the AccountConfig once in InitAccount, so that the orders
+  // can be executed without reading the FeeConfig protos.
+  std::array<FeeCoefficients, Order::Type_ARRAYSIZE> order_fees;
 
   // Initializes the account based on the account_config.
   void InitAccount(const AccountConfig& account_config);
@@ -46,6 +60,8 @@ struct Account {
   // Returns the fee (in quote currency) based on the provided fee_config and
   // the given quote currency amount involved in the transaction.
   float GetFee(const FeeConfig& fee_config, float quote_amount) const;
+  // The same method as above, but for the resolved fee coefficients.
+  float GetFee(const FeeCoefficients& fee, float quote_amount) const;
 
   // Returns the price of the market buy order based on the market_liquidity
   // (defined above) when executed over the given OHLC tick.
@@ -68,22 +84,28 @@ struct Account {
   // Buys the specified amount of base (crypto) currency at the given price.
   // Returns true iff the order was executed successfully.
   bool BuyBase(const FeeConfig& fee_config, float base_amount, float price);
+  bool BuyBase(const FeeCoefficients& fee, float base_amount, float price);
   // Buys as much base (crypto) currency as possible at the given price,
   // spending at most quote_amount in quote currency.
   // It is possible to buy at most max_base_amount base (crypto) currency.
   // Returns true iff the order was executed successfully.
   bool BuyAtQuote(const FeeConfig& fee_config, float quote_amount, float price,
                   float max_base_amount = std::numeric_limits<float>::max());
+  bool BuyAtQuote(const FeeCoefficients& fee, float quote_amount, float price,
+                  float max_base_amount = std::numeric_limits<float>::max());
   // Sells the specified amount of base (crypto) currency at the given price.
   // Returns true iff the order was executed successfully.
   bool SellBase(const FeeConfig& fee_config, float security_amount,
                 float price);
+  bool SellBase(const FeeCoefficients& fee, float base_amount, float price);
   // Sells as much base (crypto) currency as possible at the given price,
   // receiving at most quote_amount in quote currency.
   // It is possible to sell at most max_base_amount base (crypto) currency.
   // Returns true iff the order was executed successfully.
   bool SellAtQuote(const FeeConfig& fee_config, float quote_amount, float price,
                    float max_base_amount = std::numeric_limits<float>::max());
+  bool SellAtQuote(const FeeCoefficients& fee, float quote_amount, float price,
+                   float max_base_amount = std::numeric_limits<float>::max());
 
   // MARKET ORDERS
 
@@ -180,6 +202,13 @@ struct Account {
   // Returns true iff the order was executed successfully.
   bool ExecuteOrder(const AccountConfig& account_config, const Order& order,
                     const OhlcTick& ohlc_tick);
+  // The same method as above, but for the compact order representation.
+  bool ExecuteOrder(const AccountConfig& account_config,
+                    const OrderSpec& order, const OhlcTick& ohlc_tick);
+  // The same method as above, but uses the fee coefficients resolved in
+  // InitAccount (instead of the account_config). Dispatches the order directly
+  // to the execution kernel specialized for its type, side, and amount kind.
+  bool ExecuteOrder(const OrderSpec& order, const OhlcTick& ohlc_tick);
 };
 
 }  // namespace trader
@@ -41,6 +41,19 @@ TEST(InitAccountTest, Basic) {
   EXPECT_FLOAT_EQ(account.quote_unit, 0.01f);
   EXPECT_FLOAT_EQ(account.market_liquidity, 0.5f);
   EXPECT_FLOAT_EQ(account.max_volume_ratio, 0.9f);
+  for (const Account::FeeCoefficients& fee : account.order_fees) {
+    EXPECT_FLOAT_EQ(fee.relative_fee, 0.0f);
+    EXPECT_FLOAT_EQ(fee.fixed_fee, 0.0f);
+    EXPECT_FLOAT_EQ(fee.minimum_fee, 0.0f);
+  }
+
+  account_config.mutable_market_order_fee_config()->set_relative_fee(0.1f);
+  account_config.mutable_stop_order_fee_config()->set_fixed_fee(2.0f);
+  account_config.mutable_limit_order_fee_config()->set_minimum_fee(3.0f);
+  account.InitAccount(account_config);
+  EXPECT_FLOAT_EQ(account.order_fees[Order::MARKET].relative_fee, 0.1f);
+  EXPECT_FLOAT_EQ(account.order_fees[Order::STOP].fixed_fee, 2.0f);
+  EXPECT_FLOAT_EQ(account.order_fees[Order::LIMIT].minimum_fee, 3.0f);
 }
 
 TEST(GetFeeTest, RelativeFee) {
@@ -2136,4 +2149,142 @@ TEST(ExecuteOrderTest, LimitSellAtQuoteWithFeeAndLimitedPrecision) {
   EXPECT_FLOAT_EQ(account.total_fee, 7.0f);
 }
 
+TEST(ExecuteOrderTest, OrderSpecMatchesOrder) {
+  AccountConfig account_config;
+  for (FeeConfig* fee_config :
+       {account_config.mutable_market_order_fee_config(),
+        account_config.mutable_stop_order_fee_config(),
+        account_config.mutable_limit_order_fee_config()}) {
+    fee_config->set_relative_fee(0.1f);
+    fee_config->set_fixed_fee(1.0f);
+    fee_config->set_minimum_fee(1.5f);
+  }
+
+  OhlcTick ohlc_tick;
+  SetupOhlcTick(ohlc_tick);  // O = 10, H = 20, L = 2, C = 15, V = 1234.56
+
+  for (const Order::Type type : {Order::MARKET, Order::STOP, Order::LIMIT}) {
+    for (const Order::Side side : {Order::BUY, Order::SELL}) {
+      for (const bool base_amount : {true, false}) {
+        Order order;
+        order.set_type(type);
+        order.set_side(side);
+        if (base_amount) {
+          order.set_base_amount(5.0f);
+        } else {
+          order.set_quote_amount(50.0f);
+        }
+        if (type != Order::MARKET) {
+          order.set_price(side == Order::BUY ? 12.0f : 8.0f);
+        }
+
+        Account account;
+        account.market_liquidity = 0.5f;
+        account.base_unit = 0.1f;
+        account.quote_unit = 1.0f;
+        account.base_balance = 10.0f;
+        account.quote_balance = 1000.0f;
+        Account account_spec = account;
+
+        const bool success =
+            account.ExecuteOrder(account_config, order, ohlc_tick);
+        const bool success_spec = account_spec.ExecuteOrder(
+            account_config, ToOrderSpec(order), ohlc_tick);
+        EXPECT_EQ(success_spec, success) << order.DebugString();
+        EXPECT_EQ(account_spec.base_balance, account.base_balance);
+        EXPECT_EQ(account_spec.quote_balance, account.quote_balance);
+        EXPECT_EQ(account_spec.total_fee, account.total_fee);
+      }
+    }
+  }
+}
+
+TEST(ExecuteOrderTest, KernelsMatchOrderMethods) {
+  AccountConfig account_config;
+  account_config.set_start_base_balance(10.0f);
+  account_config.set_start_quote_balance(1000.0f);
+  account_config.set_base_unit(0.1f);
+  account_config.set_quote_unit(1.0f);
+  account_config.set_market_liquidity(0.7f);
+  account_config.set_max_volume_ratio(0.01f);
+  account_config.mutable_market_order_fee_config()->set_relative_fee(0.1f);
+  account_config.mutable_market_order_fee_config()->set_minimum_fee(1.5f);
+  account_config.mutable_stop_order_fee_config()->set_relative_fee(0.05f);
+  account_config.mutable_stop_order_fee_config()->set_fixed_fee(1.0f);
+  account_config.mutable_limit_order_fee_config()->set_relative_fee(0.01f);
+  account_config.mutable_limit_order_fee_config()->set_minimum_fee(0.5f);
+
+  OhlcTick ohlc_tick;
+  SetupOhlcTick(ohlc_tick);  // O = 10, H = 20, L = 2, C = 15, V = 1234.56
+
+  // Executes the order via the corresponding (generic) Account method.
+  const auto execute_order_method = [&](Account& account,
+                                        const OrderSpec& order) {
+    const bool base = order.amount_kind == OrderSpec::AmountKind::kBase;
+    const bool buy = order.side == Order::BUY;
+    switch (order.type) {
+      case Order::MARKET: {
+        const FeeConfig& fee = account_config.market_order_fee_config();
+        return buy ? (base ? account.MarketBuy(fee, ohlc_tick, order.amount)
+                           : account.MarketBuyAtQuote(fee, ohlc_tick,
+                                                      order.amount))
+                   : (base ? account.MarketSell(fee, ohlc_tick, order.amount)
+                           : account.MarketSellAtQuote(fee, ohlc_tick,
+                                                       order.amount));
+      }
+      case Order::STOP: {
+        const FeeConfig& fee = account_config.stop_order_fee_config();
+        return buy ? (base ? account.StopBuy(fee, ohlc_tick, order.amount,
+                                             order.price)
+                           : account.StopBuyAtQuote(fee, ohlc_tick,
+                                                    order.amount, order.price))
+                   : (base ? account.StopSell(fee, ohlc_tick, order.amount,
+                                              order.price)
+                           : account.StopSellAtQuote(
+                                 fee, ohlc_tick, order.amount, order.price));
+      }
+      default: {
+        const FeeConfig& fee = account_config.limit_order_fee_config();
+        return buy ? (base ? account.LimitBuy(fee, ohlc_tick, order.amount,
+                                              order.price)
+                           : account.LimitBuyAtQuote(
+                                 fee, ohlc_tick, order.amount, order.price))
+                   : (base ? account.LimitSell(fee, ohlc_tick, order.amount,
+                                               order.price)
+                           : account.LimitSellAtQuote(
+                                 fee, ohlc_tick, order.amount, order.price));
+      }
+    }
+  };
+
+  int num_executed = 0;
+  for (const Order::Type type : {Order::MARKET, Order::STOP, Order::LIMIT}) {
+    for (const Order::Side side : {Order::BUY, Order::SELL}) {
+      for (const float amount : {0.05f, 0.37f, 3.0f, 11.0f, 123.4f, 5000.0f}) {
+        for (const float price : {1.0f, 2.0f, 7.5f, 10.0f, 19.9f, 25.0f}) {
+          for (const OrderSpec& order :
+               {OrderSpec::Base(type, side, amount, price),
+                OrderSpec::Quote(type, side, amount, price)}) {
+            Account account;
+            account.InitAccount(account_config);
+            Account account_kernel = account;
+            const bool success = execute_order_method(account, order);
+            const bool success_kernel =
+                account_kernel.ExecuteOrder(order, ohlc_tick);
+            ASSERT_EQ(success_kernel, success)
+                << ToOrder(order).DebugString();
+            EXPECT_EQ(account_kernel.base_balance, account.base_balance);
+            EXPECT_EQ(account_kernel.quote_balance, account.quote_balance);
+            EXPECT_EQ(account_kernel.total_fee, account.total_fee);
+            num_executed += success;
+          }
+        }
+      }
+    }
+  }
+  // Both executed and not executed orders are covered.
+  EXPECT_GT(num_executed, 50);
+  EXPECT_LT(num_executed, 400);
+}
+
 }  // namespace trader
@@ -0,0 +1,298 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/binary_history.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "absl/strings/str_format.h"
+
+namespace trader {
+namespace {
+constexpr char kMagic[8] = {'T', 'R', 'D', 'R', 'H', 'I', 'S', 'T'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+// Returns the number of bytes rounded up to the multiple of 8.
+uint64_t AlignedSize(uint64_t num_bytes) { return (num_bytes + 7) & ~7ULL; }
+
+// Returns the number of (float) columns (besides the timestamp_sec column).
+int GetNumFloatColumns(uint32_t record_type) {
+  switch (static_cast<BinaryHistoryRecordType>(record_type)) {
+    case BinaryHistoryRecordType::kPrice:
+      return 2;
+    case BinaryHistoryRecordType::kOhlc:
+      return 5;
+  }
+  return -1;
+}
+
+// Returns the size (in bytes) of the section data.
+uint64_t GetSectionDataSize(uint32_t record_type, uint64_t num_records) {
+  return AlignedSize(num_records * sizeof(int64_t)) +
+         GetNumFloatColumns(record_type) *
+             AlignedSize(num_records * sizeof(float));
+}
+
+// Appends the column (padded to the multiple of 8 bytes) to the data.
+template <typename T>
+void AppendColumn(const std::vector<T>& column, std::string& data) {
+  const size_t num_bytes = column.size() * sizeof(T);
+  data.append(reinterpret_cast<const char*>(column.data()), num_bytes);
+  data.append(AlignedSize(num_bytes) - num_bytes, '\0');
+}
+
+// Returns the pointer to the column_index-th float column of the section.
+const float* GetFloatColumn(const char* section_data, uint64_t num_records,
+                            int column_index) {
+  return reinterpret_cast<const float*>(
+      section_data + AlignedSize(num_records * sizeof(int64_t)) +
+      column_index * AlignedSize(num_records * sizeof(float)));
+}
+
+BinaryHistorySectionHeader NewSectionHeader(BinaryHistoryRecordType type,
+                                            int sampling_rate_sec,
+                                            uint64_t num_records,
+                                            int64_t start_timestamp_sec,
+                                            int64_t end_timestamp_sec) {
+  BinaryHistorySectionHeader header;
+  header.record_type = static_cast<uint32_t>(type);
+  header.sampling_rate_sec = sampling_rate_sec;
+  header.num_records = num_records;
+  header.start_timestamp_sec = start_timestamp_sec;
+  header.end_timestamp_sec = end_timestamp_sec;
+  header.data_offset = 0;
+  return header;
+}
+}  // namespace
+
+void BinaryHistoryWriter::AddPriceHistory(const PriceHistory& price_history) {
+  std::vector<int64_t> timestamp_sec;
+  std::vector<float> price;
+  std::vector<float> volume;
+  timestamp_sec.reserve(price_history.size());
+  price.reserve(price_history.size());
+  volume.reserve(price_history.size());
+  for (const PriceRecord& price_record : price_history) {
+    timestamp_sec.push_back(price_record.timestamp_sec());
+    price.push_back(price_record.price());
+    volume.push_back(price_record.volume());
+  }
+  sections_.emplace_back();
+  Section& section = sections_.back();
+  section.header = NewSectionHeader(
+      BinaryHistoryRecordType::kPrice, /*sampling_rate_sec=*/0,
+      price_history.size(),
+      price_history.empty() ? 0 : price_history.front().timestamp_sec(),
+      price_history.empty() ? 0 : price_history.back().timestamp_sec());
+  AppendColumn(timestamp_sec, section.data);
+  AppendColumn(price, section.data);
+  AppendColumn(volume, section.data);
+}
+
+void BinaryHistoryWriter::AddOhlcHistory(const OhlcHistory& ohlc_history,
+                                         int sampling_rate_sec) {
+  std::vector<int64_t> timestamp_sec;
+  std::vector<float> columns[5];
+  timestamp_sec.reserve(ohlc_history.size());
+  for (std::vector<float>& column : columns) {
+    column.reserve(ohlc_history.size());
+  }
+  for (const OhlcTick& ohlc_tick : ohlc_history) {
+    timestamp_sec.push_back(ohlc_tick.timestamp_sec());
+    columns[0].push_back(ohlc_tick.open());
+    columns[1].push_back(ohlc_tick.high());
+    columns[2].push_back(ohlc_tick.low());
+    columns[3].push_back(ohlc_tick.close());
+    columns[4].push_back(ohlc_tick.volume());
+  }
+  sections_.emplace_back();
+  Section& section = sections_.back();
+  section.header = NewSectionHeader(
+      BinaryHistoryRecordType::kOhlc, sampling_rate_sec, ohlc_history.size(),
+      ohlc_history.empty() ? 0 : ohlc_history.front().timestamp_sec(),
+      ohlc_history.empty() ? 0 : ohlc_history.back().timestamp_sec());
+  AppendColumn(timestamp_sec, section.data);
+  for (const std::vector<float>& column : columns) {
+    AppendColumn(column, section.data);
+  }
+}
+
+absl::Status BinaryHistoryWriter::WriteToFile(
+    const std::string& file_name) const {
+  std::ofstream outfile(file_name,
+                        std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!outfile.is_open()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot open the file: %s", file_name));
+  }
+  BinaryHistoryFileHeader file_header;
+  std::memcpy(file_header.magic, kMagic, sizeof(kMagic));
+  file_header.version = kVersion;
+  file_header.byte_order_mark = kByteOrderMark;
+  file_header.num_sections = sections_.size();
+  file_header.reserved = 0;
+  outfile.write(reinterpret_cast<const char*>(&file_header),
+                sizeof(file_header));
+  uint64_t data_offset = sizeof(BinaryHistoryFileHeader) +
+                         sections_.size() * sizeof(BinaryHistorySectionHeader);
+  for (const Section& section : sections_) {
+    BinaryHistorySectionHeader section_header = section.header;
+    section_header.data_offset = data_offset;
+    outfile.write(reinterpret_cast<const char*>(&section_header),
+                  sizeof(section_header));
+    data_offset += section.data.size();
+  }
+  for (const Section& section : sections_) {
+    outfile.write(section.data.data(), section.data.size());
+  }
+  outfile.close();
+  if (outfile.fail()) {
+    return absl::InternalError(
+        absl::StrFormat("Cannot write to the file: %s", file_name));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<BinaryHistoryFile> BinaryHistoryFile::Open(
+    const std::string& file_name) {
+  absl::StatusOr<std::unique_ptr<MappedFile>> mapped_file_status =
+      MappedFile::Open(file_name);
+  if (!mapped_file_status.ok()) {
+    return mapped_file_status.status();
+  }
+  BinaryHistoryFile history_file(std::move(mapped_file_status).value());
+  const char* data = history_file.mapped_file_->data();
+  const uint64_t size = history_file.mapped_file_->size();
+  if (size < sizeof(BinaryHistoryFileHeader)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Truncated binary history file: %s", file_name));
+  }
+  const BinaryHistoryFileHeader& file_header =
+      *reinterpret_cast<const BinaryHistoryFileHeader*>(data);
+  if (std::memcmp(file_header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Not a binary history file: %s", file_name));
+  }
+  if (file_header.version != kVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Unsupported binary history file version %d: %s",
+                        file_header.version, file_name));
+  }
+  if (file_header.byte_order_mark != kByteOrderMark) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Incompatible byte order of the file: %s", file_name));
+  }
+  if (file_header.num_sections >
+      (size - sizeof(BinaryHistoryFileHeader)) /
+          sizeof(BinaryHistorySectionHeader)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Truncated binary history file: %s", file_name));
+  }
+  for (uint32_t index = 0; index < file_header.num_sections; ++index) {
+    const BinaryHistorySectionHeader* section_header =
+        reinterpret_cast<const BinaryHistorySectionHeader*>(
+            data + sizeof(BinaryHistoryFileHeader) +
+            index * sizeof(BinaryHistorySectionHeader));
+    if (GetNumFloatColumns(section_header->record_type) < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid record type of the section %d: %s", index,
+                          file_name));
+    }
+    if (section_header->data_offset % 8 != 0 ||
+        section_header->data_offset > size ||
+        section_header->num_records > size ||
+        GetSectionDataSize(section_header->record_type,
+                           section_header->num_records) >
+            size - section_header->data_offset) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Invalid data of the section %d: %s", index, file_name));
+    }
+    history_file.sections_.push_back(section_header);
+  }
+  return history_file;
+}
+
+absl::StatusOr<ColumnarOhlcHistory> BinaryHistoryFile::GetOhlcHistory(
+    int sampling_rate_sec) const {
+  for (const BinaryHistorySectionHeader* section_header : sections_) {
+    if (section_header->record_type !=
+            static_cast<uint32_t>(BinaryHistoryRecordType::kOhlc) ||
+        (sampling_rate_sec > 0 &&
+         section_header->sampling_rate_sec !=
+             static_cast<uint32_t>(sampling_rate_sec))) {
+      continue;
+    }
+    const uint64_t num_records = section_header->num_records;
+    if (num_records == 0) {
+      return ColumnarOhlcHistory();
+    }
+    const char* section_data =
+        mapped_file_->data() + section_header->data_offset;
+    return ColumnarOhlcHistory(
+        mapped_file_, num_records,
+        reinterpret_cast<const int64_t*>(section_data),
+        GetFloatColumn(section_data, num_records, 0),
+        GetFloatColumn(section_data, num_records, 1),
+        GetFloatColumn(section_data, num_records, 2),
+        GetFloatColumn(section_data, num_records, 3),
+        GetFloatColumn(section_data, num_records, 4));
+  }
+  return absl::NotFoundError(absl::StrFormat(
+      "OHLC history with sampling rate %d not found", sampling_rate_sec));
+}
+
+absl::Status BinaryHistoryFile::ReadPriceRecords(
+    int64_t start_timestamp_sec, int64_t end_timestamp_sec,
+    const std::function<void(const PriceRecord&)>& consumer) const {
+  for (const BinaryHistorySectionHeader* section_header : sections_) {
+    if (section_header->record_type !=
+        static_cast<uint32_t>(BinaryHistoryRecordType::kPrice)) {
+      continue;
+    }
+    const uint64_t num_records = section_header->num_records;
+    const char* section_data =
+        mapped_file_->data() + section_header->data_offset;
+    const int64_t* timestamp_sec =
+        reinterpret_cast<const int64_t*>(section_data);
+    const float* price = GetFloatColumn(section_data, num_records, 0);
+    const float* volume = GetFloatColumn(section_data, num_records, 1);
+    const int64_t* begin =
+        start_timestamp_sec > 0
+            ? std::lower_bound(timestamp_sec, timestamp_sec + num_records,
+                               start_timestamp_sec)
+            : timestamp_sec;
+    const int64_t* end =
+        end_timestamp_sec > 0
+            ? std::lower_bound(timestamp_sec, timestamp_sec + num_records,
+                               end_timestamp_sec)
+            : timestamp_sec + num_records;
+    PriceRecord price_record;
+    for (const int64_t* it = begin; it < end; ++it) {
+      const size_t index = it - timestamp_sec;
+      price_record.set_timestamp_sec(timestamp_sec[index]);
+      price_record.set_price(price[index]);
+      price_record.set_volume(volume[index]);
+      consumer(price_record);
+    }
+    return absl::OkStatus();
+  }
+  return absl::NotFoundError("Price history not found");
+}
+
+absl::StatusOr<PriceHistory> BinaryHistoryFile::GetPriceHistory(
+    int64_t start_timestamp_sec, int64_t end_timestamp_sec) const {
+  PriceHistory price_history;
+  const absl::Status status = ReadPriceRecords(
+      start_timestamp_sec, end_timestamp_sec,
+      [&price_history](const PriceRecord& price_record) {
+        price_history.push_back(price_record);
+      });
+  if (!status.ok()) {
+    return status;
+  }
+  return price_history;
+}
+
+}  // namespace trader
@@ -0,0 +1,127 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef BASE_BINARY_HISTORY_H
+#define BASE_BINARY_HISTORY_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "base/base.h"
+#include "base/columnar_history.h"
+#include "util/mapped_file.h"
+
+namespace trader {
+
+// Binary (fixed-width, versioned) history file format.
+//
+// The file starts with BinaryHistoryFileHeader, followed by num_sections of
+// BinaryHistorySectionHeader, followed by the section data. Every section
+// stores num_records of a single record type as packed columns, in the order:
+//   kPrice: timestamp_sec (int64), price (float), volume (float)
+//   kOhlc:  timestamp_sec (int64), open, high, low, close, volume (float)
+// Every column starts at an 8-byte aligned offset (relative to the beginning
+// of the file). All values are stored in the native byte order, which is
+// verified by the byte_order_mark when reading the file.
+// The file is designed to be memory-mapped and used directly without parsing.
+
+// Type of the records stored in the section.
+enum class BinaryHistoryRecordType : uint32_t {
+  kPrice = 1,  // PriceRecord
+  kOhlc = 2,   // OhlcTick
+};
+
+struct BinaryHistoryFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order_mark;
+  uint32_t num_sections;
+  uint32_t reserved;
+};
+static_assert(sizeof(BinaryHistoryFileHeader) == 24,
+              "Unexpected BinaryHistoryFileHeader size");
+
+struct BinaryHistorySectionHeader {
+  // BinaryHistoryRecordType of the records stored in the section.
+  uint32_t record_type;
+  // Sampling rate (in seconds) of the OHLC ticks. Zero for the price records.
+  uint32_t sampling_rate_sec;
+  // Number of records stored in the section.
+  uint64_t num_records;
+  // UNIX timestamp (in seconds) of the first record (zero if empty).
+  int64_t start_timestamp_sec;
+  // UNIX timestamp (in seconds) of the last record (zero if empty).
+  int64_t end_timestamp_sec;
+  // Offset (in bytes) of the first column (relative to the file beginning).
+  uint64_t data_offset;
+};
+static_assert(sizeof(BinaryHistorySectionHeader) == 40,
+              "Unexpected BinaryHistorySectionHeader size");
+
+// Writes one or more history sections into a binary history file.
+class BinaryHistoryWriter {
+ public:
+  // Adds a section containing the price_history.
+  void AddPriceHistory(const PriceHistory& price_history);
+  // Adds a section containing the ohlc_history with the given sampling rate.
+  void AddOhlcHistory(const OhlcHistory& ohlc_history, int sampling_rate_sec);
+  // Writes all added sections into the (binary) output file.
+  absl::Status WriteToFile(const std::string& file_name) const;
+
+ private:
+  struct Section {
+    BinaryHistorySectionHeader header;
+    // Packed (8-byte aligned) columns.
+    std::string data;
+  };
+  std::vector<Section> sections_;
+};
+
+// Memory-mapped binary history file.
+class BinaryHistoryFile {
+ public:
+  // Maps the binary history file into memory and validates its structure.
+  // The records themselves are not parsed nor validated.
+  static absl::StatusOr<BinaryHistoryFile> Open(const std::string& file_name);
+
+  // Returns the number of sections.
+  size_t num_sections() const { return sections_.size(); }
+  // Returns the header of the given section.
+  const BinaryHistorySectionHeader& section(size_t index) const {
+    return *sections_.at(index);
+  }
+
+  // Returns the (zero-copy) columnar OHLC history stored in the OHLC section
+  // with the given sampling rate (or the first OHLC section if
+  // sampling_rate_sec is zero). The history keeps the mapped file alive.
+  absl::StatusOr<ColumnarOhlcHistory> GetOhlcHistory(
+      int sampling_rate_sec) const;
+
+  // Returns (a copy of) the price history stored in the first price section,
+  // restricted to the time interval [start_timestamp_sec, end_timestamp_sec).
+  // Zero timestamps mean no restriction (same semantics as HistorySubset).
+  absl::StatusOr<PriceHistory> GetPriceHistory(
+      int64_t start_timestamp_sec, int64_t end_timestamp_sec) const;
+
+  // Passes the price records stored in the first price section (restricted to
+  // the time interval as above) one by one to the consumer, without copying
+  // the whole price history.
+  absl::Status ReadPriceRecords(
+      int64_t start_timestamp_sec, int64_t end_timestamp_sec,
+      const std::function<void(const PriceRecord&)>& consumer) const;
+
+ private:
+  explicit BinaryHistoryFile(std::shared_ptr<const MappedFile> mapped_file)
+      : mapped_file_(std::move(mapped_file)) {}
+
+  std::shared_ptr<const MappedFile> mapped_file_;
+  std::vector<const BinaryHistorySectionHeader*> sections_;
+};
+
+}  // namespace trader
+
+#endif  // BASE_BINARY_HISTORY_H
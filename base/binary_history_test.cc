@@ -0,0 +1,192 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/binary_history.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+void AddPriceRecord(int64_t timestamp_sec, float price, float volume,
+                    PriceHistory& price_history) {
+  price_history.emplace_back();
+  price_history.back().set_timestamp_sec(timestamp_sec);
+  price_history.back().set_price(price);
+  price_history.back().set_volume(volume);
+}
+
+void AddOhlcTick(int64_t timestamp_sec, float open, float high, float low,
+                 float close, float volume, OhlcHistory& ohlc_history) {
+  ohlc_history.emplace_back();
+  ohlc_history.back().set_timestamp_sec(timestamp_sec);
+  ohlc_history.back().set_open(open);
+  ohlc_history.back().set_high(high);
+  ohlc_history.back().set_low(low);
+  ohlc_history.back().set_close(close);
+  ohlc_history.back().set_volume(volume);
+}
+
+void PreparePriceHistory(PriceHistory& price_history) {
+  AddPriceRecord(1483228800, 100, 1000, price_history);
+  AddPriceRecord(1483228860, 110, 500, price_history);
+  AddPriceRecord(1483228920, 105, 0, price_history);
+}
+
+void PrepareOhlcHistory(int sampling_rate_sec, OhlcHistory& ohlc_history) {
+  AddOhlcTick(1483228800, 100, 150, 80, 120, 1000, ohlc_history);
+  AddOhlcTick(1483228800 + sampling_rate_sec, 120, 180, 100, 150, 500,
+              ohlc_history);
+  AddOhlcTick(1483228800 + 2 * sampling_rate_sec, 150, 250, 100, 140, 2000,
+              ohlc_history);
+}
+
+void ExpectOhlcHistoryEq(const ColumnarOhlcHistory& actual,
+                         const OhlcHistory& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  const OhlcHistory actual_ohlc_history =
+      actual.ToOhlcHistory(0, actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual_ohlc_history[i].SerializeAsString(),
+              expected[i].SerializeAsString());
+  }
+}
+}  // namespace
+
+TEST(BinaryHistoryTest, WriteAndReadEmptyFile) {
+  const std::string file_name = ::testing::TempDir() + "binary_history_empty";
+  BinaryHistoryWriter writer;
+  ASSERT_TRUE(writer.WriteToFile(file_name).ok());
+  absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(file_name);
+  ASSERT_TRUE(history_file_status.ok()) << history_file_status.status();
+  EXPECT_EQ(history_file_status.value().num_sections(), 0);
+  EXPECT_FALSE(history_file_status.value().GetOhlcHistory(0).ok());
+  EXPECT_FALSE(history_file_status.value().GetPriceHistory(0, 0).ok());
+}
+
+TEST(BinaryHistoryTest, WriteAndReadMultipleSections) {
+  const std::string file_name = ::testing::TempDir() + "binary_history";
+  PriceHistory price_history;
+  PreparePriceHistory(price_history);
+  OhlcHistory ohlc_history_5min;
+  PrepareOhlcHistory(300, ohlc_history_5min);
+  OhlcHistory ohlc_history_1h;
+  PrepareOhlcHistory(3600, ohlc_history_1h);
+
+  BinaryHistoryWriter writer;
+  writer.AddPriceHistory(price_history);
+  writer.AddOhlcHistory(ohlc_history_5min, 300);
+  writer.AddOhlcHistory(ohlc_history_1h, 3600);
+  writer.AddOhlcHistory(OhlcHistory{}, 86400);
+  ASSERT_TRUE(writer.WriteToFile(file_name).ok());
+
+  absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(file_name);
+  ASSERT_TRUE(history_file_status.ok()) << history_file_status.status();
+  const BinaryHistoryFile& history_file = history_file_status.value();
+  ASSERT_EQ(history_file.num_sections(), 4);
+  EXPECT_EQ(history_file.section(0).record_type,
+            static_cast<uint32_t>(BinaryHistoryRecordType::kPrice));
+  EXPECT_EQ(history_file.section(0).num_records, 3);
+  EXPECT_EQ(history_file.section(0).start_timestamp_sec, 1483228800);
+  EXPECT_EQ(history_file.section(0).end_timestamp_sec, 1483228920);
+  EXPECT_EQ(history_file.section(2).record_type,
+            static_cast<uint32_t>(BinaryHistoryRecordType::kOhlc));
+  EXPECT_EQ(history_file.section(2).sampling_rate_sec, 3600);
+  EXPECT_EQ(history_file.section(2).end_timestamp_sec, 1483228800 + 7200);
+
+  absl::StatusOr<PriceHistory> price_history_status =
+      history_file.GetPriceHistory(0, 0);
+  ASSERT_TRUE(price_history_status.ok());
+  ASSERT_EQ(price_history_status.value().size(), price_history.size());
+  for (size_t i = 0; i < price_history.size(); ++i) {
+    EXPECT_EQ(price_history_status.value()[i].SerializeAsString(),
+              price_history[i].SerializeAsString());
+  }
+  int num_price_records = 0;
+  ASSERT_TRUE(history_file
+                  .ReadPriceRecords(
+                      /*start_timestamp_sec=*/1483228860,
+                      /*end_timestamp_sec=*/0,
+                      [&num_price_records](const PriceRecord& price_record) {
+                        EXPECT_GE(price_record.timestamp_sec(), 1483228860);
+                        ++num_price_records;
+                      })
+                  .ok());
+  EXPECT_EQ(num_price_records, price_history.size() - 1);
+  price_history_status = history_file.GetPriceHistory(1483228860, 1483228920);
+  ASSERT_TRUE(price_history_status.ok());
+  ASSERT_EQ(price_history_status.value().size(), 1);
+  EXPECT_EQ(price_history_status.value()[0].SerializeAsString(),
+            price_history[1].SerializeAsString());
+
+  absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+      history_file.GetOhlcHistory(/*sampling_rate_sec=*/0);
+  ASSERT_TRUE(ohlc_history_status.ok());
+  ExpectOhlcHistoryEq(ohlc_history_status.value(), ohlc_history_5min);
+  ohlc_history_status = history_file.GetOhlcHistory(3600);
+  ASSERT_TRUE(ohlc_history_status.ok());
+  ExpectOhlcHistoryEq(ohlc_history_status.value(), ohlc_history_1h);
+  ohlc_history_status = history_file.GetOhlcHistory(86400);
+  ASSERT_TRUE(ohlc_history_status.ok());
+  EXPECT_TRUE(ohlc_history_status.value().empty());
+  EXPECT_FALSE(history_file.GetOhlcHistory(60).ok());
+}
+
+TEST(BinaryHistoryTest, OhlcHistoryOutlivesFile) {
+  const std::string file_name = ::testing::TempDir() + "binary_history_ohlc";
+  OhlcHistory ohlc_history;
+  PrepareOhlcHistory(300, ohlc_history);
+  BinaryHistoryWriter writer;
+  writer.AddOhlcHistory(ohlc_history, 300);
+  ASSERT_TRUE(writer.WriteToFile(file_name).ok());
+
+  ColumnarOhlcHistory columnar_history;
+  {
+    absl::StatusOr<BinaryHistoryFile> history_file_status =
+        BinaryHistoryFile::Open(file_name);
+    ASSERT_TRUE(history_file_status.ok());
+    absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+        history_file_status.value().GetOhlcHistory(300);
+    ASSERT_TRUE(ohlc_history_status.ok());
+    columnar_history = ohlc_history_status.value().Slice(1, 3);
+  }
+  ohlc_history.erase(ohlc_history.begin());
+  ExpectOhlcHistoryEq(columnar_history, ohlc_history);
+}
+
+TEST(BinaryHistoryTest, OpenInvalidFile) {
+  const std::string file_name = ::testing::TempDir() + "binary_history_invalid";
+  {
+    std::ofstream outfile(file_name, std::ios::out | std::ios::binary);
+    outfile << "This is not a binary history file.";
+  }
+  EXPECT_FALSE(BinaryHistoryFile::Open(file_name).ok());
+  EXPECT_FALSE(
+      BinaryHistoryFile::Open(::testing::TempDir() + "binary_history_missing")
+          .ok());
+}
+
+TEST(BinaryHistoryTest, OpenTruncatedFile) {
+  const std::string file_name = ::testing::TempDir() + "binary_history_trunc";
+  OhlcHistory ohlc_history;
+  PrepareOhlcHistory(300, ohlc_history);
+  BinaryHistoryWriter writer;
+  writer.AddOhlcHistory(ohlc_history, 300);
+  ASSERT_TRUE(writer.WriteToFile(file_name).ok());
+  std::string content;
+  {
+    std::ifstream infile(file_name, std::ios::in | std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(infile),
+                   std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream outfile(file_name,
+                          std::ios::out | std::ios::trunc | std::ios::binary);
+    outfile.write(content.data(), content.size() - 8);
+  }
+  EXPECT_FALSE(BinaryHistoryFile::Open(file_name).ok());
+}
+
+}  // namespace trader
@@ -0,0 +1,95 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/columnar_history.h"
+
+#include <algorithm>
+
+namespace trader {
+
+void OhlcTickView::CopyTo(OhlcTick& ohlc_tick) const {
+  ohlc_tick.set_timestamp_sec(timestamp_sec_);
+  ohlc_tick.set_open(open_);
+  ohlc_tick.set_high(high_);
+  ohlc_tick.set_low(low_);
+  ohlc_tick.set_close(close_);
+  ohlc_tick.set_volume(volume_);
+}
+
+namespace {
+// Owned storage of the columnar OHLC history.
+struct OhlcColumns {
+  std::vector<int64_t> timestamp_sec;
+  std::vector<float> open;
+  std::vector<float> high;
+  std::vector<float> low;
+  std::vector<float> close;
+  std::vector<float> volume;
+};
+}  // namespace
+
+ColumnarOhlcHistory::ColumnarOhlcHistory(const OhlcHistory& ohlc_history) {
+  auto columns = std::make_shared<OhlcColumns>();
+  columns->timestamp_sec.reserve(ohlc_history.size());
+  columns->open.reserve(ohlc_history.size());
+  columns->high.reserve(ohlc_history.size());
+  columns->low.reserve(ohlc_history.size());
+  columns->close.reserve(ohlc_history.size());
+  columns->volume.reserve(ohlc_history.size());
+  for (const OhlcTick& ohlc_tick : ohlc_history) {
+    columns->timestamp_sec.push_back(ohlc_tick.timestamp_sec());
+    columns->open.push_back(ohlc_tick.open());
+    columns->high.push_back(ohlc_tick.high());
+    columns->low.push_back(ohlc_tick.low());
+    columns->close.push_back(ohlc_tick.close());
+    columns->volume.push_back(ohlc_tick.volume());
+  }
+  size_ = ohlc_history.size();
+  timestamp_sec_ = columns->timestamp_sec.data();
+  open_ = columns->open.data();
+  high_ = columns->high.data();
+  low_ = columns->low.data();
+  close_ = columns->close.data();
+  volume_ = columns->volume.data();
+  storage_ = std::move(columns);
+}
+
+std::pair<size_t, size_t> ColumnarOhlcHistory::Subset(
+    int64_t start_timestamp_sec, int64_t end_timestamp_sec) const {
+  const int64_t* begin = timestamp_sec_;
+  const int64_t* end = timestamp_sec_ + size_;
+  const int64_t* subset_begin =
+      start_timestamp_sec > 0
+          ? std::lower_bound(begin, end, start_timestamp_sec)
+          : begin;
+  const int64_t* subset_end =
+      end_timestamp_sec > 0 ? std::lower_bound(begin, end, end_timestamp_sec)
+                            : end;
+  return {static_cast<size_t>(subset_begin - begin),
+          static_cast<size_t>(subset_end - begin)};
+}
+
+ColumnarOhlcHistory ColumnarOhlcHistory::Slice(size_t begin_index,
+                                               size_t end_index) const {
+  assert(begin_index <= end_index && end_index <= size_);
+  if (begin_index == end_index) {
+    return ColumnarOhlcHistory();
+  }
+  return ColumnarOhlcHistory(
+      storage_, end_index - begin_index, timestamp_sec_ + begin_index,
+      open_ + begin_index, high_ + begin_index, low_ + begin_index,
+      close_ + begin_index, volume_ + begin_index);
+}
+
+OhlcHistory ColumnarOhlcHistory::ToOhlcHistory(size_t begin_index,
+                                               size_t end_index) const {
+  assert(begin_index <= end_index && end_index <= size());
+  OhlcHistory ohlc_history;
+  ohlc_history.reserve(end_index - begin_index);
+  for (size_t index = begin_index; index < end_index; ++index) {
+    ohlc_history.emplace_back();
+    (*this)[index].CopyTo(ohlc_history.back());
+  }
+  return ohlc_history;
+}
+
+}  // namespace trader
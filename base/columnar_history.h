@@ -0,0 +1,136 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef BASE_COLUMNAR_HISTORY_H
+#define BASE_COLUMNAR_HISTORY_H
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "base/base.h"
+
+namespace trader {
+
+// Lightweight (trivially copyable) read-only OHLC tick without any protobuf
+// overhead. The accessors mirror the OhlcTick proto accessors.
+class OhlcTickView {
+ public:
+  OhlcTickView() {}
+  OhlcTickView(int64_t timestamp_sec, float open, float high, float low,
+               float close, float volume)
+      : timestamp_sec_(timestamp_sec),
+        open_(open),
+        high_(high),
+        low_(low),
+        close_(close),
+        volume_(volume) {}
+  explicit OhlcTickView(const OhlcTick& ohlc_tick)
+      : OhlcTickView(ohlc_tick.timestamp_sec(), ohlc_tick.open(),
+                     ohlc_tick.high(), ohlc_tick.low(), ohlc_tick.close(),
+                     ohlc_tick.volume()) {}
+
+  // UNIX timestamp (in seconds) of the start of the time interval.
+  int64_t timestamp_sec() const { return timestamp_sec_; }
+  // Opening price at the start of the time interval.
+  float open() const { return open_; }
+  // Highest price during the time interval.
+  float high() const { return high_; }
+  // Lowest price during the time interval.
+  float low() const { return low_; }
+  // Closing price at the end of the time interval.
+  float close() const { return close_; }
+  // Total traded volume during the time interval.
+  float volume() const { return volume_; }
+
+  // Copies all fields into the given (possibly reused) ohlc_tick proto.
+  void CopyTo(OhlcTick& ohlc_tick) const;
+
+ private:
+  int64_t timestamp_sec_ = 0;
+  float open_ = 0;
+  float high_ = 0;
+  float low_ = 0;
+  float close_ = 0;
+  float volume_ = 0;
+};
+
+// Columnar (structure-of-arrays) representation of the OHLC history.
+// Every OhlcTick field is stored in its own contiguous array, so iterating over
+// the history streams only the raw values through the cache (without has-bits,
+// internal metadata and padding of the OhlcTick protos).
+// The columns are either owned by the history (when built from OhlcHistory) or
+// point into an external storage (e.g. a memory-mapped file) that is kept alive
+// by the history. Copies and slices share the same (immutable) storage.
+// The history is immutable after construction and thread-safe for reading.
+class ColumnarOhlcHistory {
+ public:
+  ColumnarOhlcHistory() {}
+  // Builds the columnar history from the given ohlc_history.
+  explicit ColumnarOhlcHistory(const OhlcHistory& ohlc_history);
+  // Wraps the given (externally owned) columns of the given size.
+  // The storage keeps the underlying columns alive.
+  ColumnarOhlcHistory(std::shared_ptr<const void> storage, size_t size,
+                      const int64_t* timestamp_sec, const float* open,
+                      const float* high, const float* low, const float* close,
+                      const float* volume)
+      : storage_(std::move(storage)),
+        size_(size),
+        timestamp_sec_(timestamp_sec),
+        open_(open),
+        high_(high),
+        low_(low),
+        close_(close),
+        volume_(volume) {}
+
+  // Returns the number of OHLC ticks.
+  size_t size() const { return size_; }
+  // Returns true iff there are no OHLC ticks.
+  bool empty() const { return size_ == 0; }
+
+  // Returns the OHLC tick at the given index.
+  OhlcTickView operator[](size_t index) const {
+    assert(index < size_);
+    return OhlcTickView(timestamp_sec_[index], open_[index], high_[index],
+                        low_[index], close_[index], volume_[index]);
+  }
+
+  // Returns the individual columns.
+  absl::Span<const int64_t> timestamp_sec() const {
+    return {timestamp_sec_, size_};
+  }
+  absl::Span<const float> open() const { return {open_, size_}; }
+  absl::Span<const float> high() const { return {high_, size_}; }
+  absl::Span<const float> low() const { return {low_, size_}; }
+  absl::Span<const float> close() const { return {close_, size_}; }
+  absl::Span<const float> volume() const { return {volume_, size_}; }
+
+  // Returns a pair of indices covering the time interval [start_timestamp_sec,
+  // end_timestamp_sec) of the history. Same semantics as HistorySubset.
+  std::pair<size_t, size_t> Subset(int64_t start_timestamp_sec,
+                                   int64_t end_timestamp_sec) const;
+
+  // Returns a view (sharing the same storage, without copying any data) of
+  // the history within the index range [begin_index, end_index).
+  ColumnarOhlcHistory Slice(size_t begin_index, size_t end_index) const;
+
+  // Returns the OHLC history (as OhlcTick protos) within the index range
+  // [begin_index, end_index).
+  OhlcHistory ToOhlcHistory(size_t begin_index, size_t end_index) const;
+
+ private:
+  // Keeps the underlying columns alive.
+  std::shared_ptr<const void> storage_;
+  size_t size_ = 0;
+  const int64_t* timestamp_sec_ = nullptr;
+  const float* open_ = nullptr;
+  const float* high_ = nullptr;
+  const float* low_ = nullptr;
+  const float* close_ = nullptr;
+  const float* volume_ = nullptr;
+};
+
+}  // namespace trader
+
+#endif  // BASE_COLUMNAR_HISTORY_H
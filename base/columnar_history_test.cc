@@ -0,0 +1,108 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/columnar_history.h"
+
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+void AddOhlcTick(int64_t timestamp_sec, float open, float high, float low,
+                 float close, float volume, OhlcHistory& ohlc_history) {
+  ohlc_history.emplace_back();
+  ohlc_history.back().set_timestamp_sec(timestamp_sec);
+  ohlc_history.back().set_open(open);
+  ohlc_history.back().set_high(high);
+  ohlc_history.back().set_low(low);
+  ohlc_history.back().set_close(close);
+  ohlc_history.back().set_volume(volume);
+}
+
+void ExpectOhlcTickEq(const OhlcTickView& actual, const OhlcTick& expected) {
+  EXPECT_EQ(actual.timestamp_sec(), expected.timestamp_sec());
+  EXPECT_FLOAT_EQ(actual.open(), expected.open());
+  EXPECT_FLOAT_EQ(actual.high(), expected.high());
+  EXPECT_FLOAT_EQ(actual.low(), expected.low());
+  EXPECT_FLOAT_EQ(actual.close(), expected.close());
+  EXPECT_FLOAT_EQ(actual.volume(), expected.volume());
+}
+
+void PrepareExampleOhlcHistory(OhlcHistory& ohlc_history) {
+  AddOhlcTick(1483228800, 100, 150, 80, 120, 1000, ohlc_history);
+  AddOhlcTick(1483229100, 120, 180, 100, 150, 500, ohlc_history);
+  AddOhlcTick(1483229400, 150, 150, 150, 150, 0, ohlc_history);
+  AddOhlcTick(1483229700, 150, 250, 100, 140, 2000, ohlc_history);
+  AddOhlcTick(1483230000, 140, 150, 80, 100, 1500, ohlc_history);
+}
+}  // namespace
+
+TEST(OhlcTickViewTest, CopyTo) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+  const OhlcTickView ohlc_tick_view(ohlc_history[1]);
+  ExpectOhlcTickEq(ohlc_tick_view, ohlc_history[1]);
+  OhlcTick ohlc_tick;
+  ohlc_tick_view.CopyTo(ohlc_tick);
+  EXPECT_EQ(ohlc_tick.SerializeAsString(),
+            ohlc_history[1].SerializeAsString());
+}
+
+TEST(ColumnarOhlcHistoryTest, Empty) {
+  ColumnarOhlcHistory columnar_history(OhlcHistory{});
+  EXPECT_TRUE(columnar_history.empty());
+  EXPECT_EQ(columnar_history.size(), 0);
+  EXPECT_EQ(columnar_history.Subset(0, 0).first, 0);
+  EXPECT_EQ(columnar_history.Subset(0, 0).second, 0);
+  EXPECT_TRUE(columnar_history.ToOhlcHistory(0, 0).empty());
+}
+
+TEST(ColumnarOhlcHistoryTest, Basic) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+  ColumnarOhlcHistory columnar_history(ohlc_history);
+  ASSERT_FALSE(columnar_history.empty());
+  ASSERT_EQ(columnar_history.size(), ohlc_history.size());
+  for (size_t i = 0; i < ohlc_history.size(); ++i) {
+    ExpectOhlcTickEq(columnar_history[i], ohlc_history[i]);
+    EXPECT_EQ(columnar_history.timestamp_sec()[i],
+              ohlc_history[i].timestamp_sec());
+    EXPECT_FLOAT_EQ(columnar_history.open()[i], ohlc_history[i].open());
+    EXPECT_FLOAT_EQ(columnar_history.high()[i], ohlc_history[i].high());
+    EXPECT_FLOAT_EQ(columnar_history.low()[i], ohlc_history[i].low());
+    EXPECT_FLOAT_EQ(columnar_history.close()[i], ohlc_history[i].close());
+    EXPECT_FLOAT_EQ(columnar_history.volume()[i], ohlc_history[i].volume());
+  }
+}
+
+TEST(ColumnarOhlcHistoryTest, Subset) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+  ColumnarOhlcHistory columnar_history(ohlc_history);
+  for (const int64_t start_timestamp_sec :
+       {0, 1483228800, 1483228860, 1483229400, 1483230000, 1483230060}) {
+    for (const int64_t end_timestamp_sec :
+         {0, 1483228800, 1483229100, 1483229500, 1483230000, 1483231000}) {
+      const auto expected_subset =
+          HistorySubset(ohlc_history, start_timestamp_sec, end_timestamp_sec);
+      const std::pair<size_t, size_t> subset =
+          columnar_history.Subset(start_timestamp_sec, end_timestamp_sec);
+      EXPECT_EQ(subset.first,
+                std::distance(ohlc_history.cbegin(), expected_subset.first));
+      EXPECT_EQ(subset.second,
+                std::distance(ohlc_history.cbegin(), expected_subset.second));
+    }
+  }
+}
+
+TEST(ColumnarOhlcHistoryTest, ToOhlcHistory) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+  ColumnarOhlcHistory columnar_history(ohlc_history);
+  const OhlcHistory ohlc_history_copy = columnar_history.ToOhlcHistory(1, 4);
+  ASSERT_EQ(ohlc_history_copy.size(), 3);
+  for (size_t i = 0; i < ohlc_history_copy.size(); ++i) {
+    EXPECT_EQ(ohlc_history_copy[i].SerializeAsString(),
+              ohlc_history[i + 1].SerializeAsString());
+  }
+}
+
+}  // namespace trader
@@ -0,0 +1,270 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/csv_history.h"
+
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <thread>
+
+#include "absl/strings/str_format.h"
+#include "util/mapped_file.h"
+
+namespace trader {
+namespace {
+// How often (in lines) the chunk parser checks whether it can stop early.
+constexpr size_t kStopCheckPeriod = 4096;
+
+// Parsed (and validated) chunk of the CSV content.
+struct PriceHistoryChunk {
+  // Selected (and validated) price records (unless passed to a consumer).
+  PriceHistory price_history;
+  // Number of lines in the chunk (valid only if the chunk was fully parsed).
+  size_t num_lines = 0;
+  // Whether there is a line within the selected time interval, its timestamp,
+  // its (1-based) line number within the chunk and its content.
+  bool has_first_line = false;
+  int64_t first_timestamp_sec = 0;
+  size_t first_line = 0;
+  std::string first_line_content;
+  // True iff the chunk contains a record at or after end_timestamp_sec.
+  bool ended = false;
+  // Reason (e.g. "Invalid price") of the first error within the chunk, its
+  // (1-based) line number within the chunk and the line content.
+  std::string error;
+  size_t error_line = 0;
+  std::string error_line_content;
+};
+
+// Skips leading spaces and parses a number of type T from [ptr, end).
+// Moves ptr after the parsed number (and the following comma, if any).
+// Returns false (and sets value to zero) if the number cannot be parsed.
+template <typename T>
+bool ParseField(const char*& ptr, const char* end, T& value) {
+  while (ptr < end && (*ptr == ' ' || *ptr == '\t')) {
+    ++ptr;
+  }
+  const std::from_chars_result result = std::from_chars(ptr, end, value);
+  if (result.ec != std::errc()) {
+    value = 0;
+    return false;
+  }
+  ptr = result.ptr;
+  if (ptr < end && *ptr == ',') {
+    ++ptr;
+  }
+  return true;
+}
+
+// Parses and validates the chunk [begin, end) of the CSV content. Passes the
+// selected price records to the consumer.
+// Stops early if a preceding chunk already terminated the parsing, i.e. if
+// chunk_index is larger than the value of the stopped_chunk_index.
+template <typename F>
+void ParsePriceHistoryChunk(const char* begin, const char* end,
+                            int64_t start_timestamp_sec,
+                            int64_t end_timestamp_sec, size_t chunk_index,
+                            std::atomic<size_t>& stopped_chunk_index,
+                            F consumer, PriceHistoryChunk& chunk) {
+  // Signals to the succeeding chunks that they do not need to be parsed.
+  const auto stop = [chunk_index, &stopped_chunk_index]() {
+    size_t index = stopped_chunk_index.load();
+    while (chunk_index < index &&
+           !stopped_chunk_index.compare_exchange_weak(index, chunk_index)) {
+    }
+  };
+  int64_t timestamp_sec_prev = 0;
+  PriceRecord price_record;
+  const char* line_begin = begin;
+  while (line_begin < end) {
+    if (chunk.num_lines % kStopCheckPeriod == 0 &&
+        stopped_chunk_index.load(std::memory_order_relaxed) < chunk_index) {
+      return;
+    }
+    const char* line_end = static_cast<const char*>(
+        std::memchr(line_begin, '\n', end - line_begin));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    ++chunk.num_lines;
+    const char* ptr = line_begin;
+    int64_t timestamp_sec = 0;
+    float price = 0;
+    float volume = 0;
+    // Stops at the first field that cannot be parsed.
+    if (ParseField(ptr, line_end, timestamp_sec) &&
+        ParseField(ptr, line_end, price)) {
+      ParseField(ptr, line_end, volume);
+    }
+    const absl::string_view line(line_begin, line_end - line_begin);
+    line_begin = line_end + 1;
+    if (start_timestamp_sec > 0 && timestamp_sec < start_timestamp_sec) {
+      continue;
+    }
+    if (end_timestamp_sec > 0 && timestamp_sec >= end_timestamp_sec) {
+      chunk.ended = true;
+      stop();
+      return;
+    }
+    if (!chunk.has_first_line) {
+      chunk.has_first_line = true;
+      chunk.first_timestamp_sec = timestamp_sec;
+      chunk.first_line = chunk.num_lines;
+      chunk.first_line_content = std::string(line);
+    }
+    if (timestamp_sec <= 0 || timestamp_sec < timestamp_sec_prev) {
+      chunk.error = "Invalid timestamp";
+    } else if (price <= 0) {
+      chunk.error = "Invalid price";
+    } else if (volume < 0) {
+      chunk.error = "Invalid volume";
+    }
+    if (!chunk.error.empty()) {
+      chunk.error_line = chunk.num_lines;
+      chunk.error_line_content = std::string(line);
+      stop();
+      return;
+    }
+    timestamp_sec_prev = timestamp_sec;
+    price_record.set_timestamp_sec(timestamp_sec);
+    price_record.set_price(price);
+    price_record.set_volume(volume);
+    consumer(price_record);
+  }
+}
+}  // namespace
+
+absl::StatusOr<PriceHistory> ParsePriceHistoryFromCsv(
+    absl::string_view csv_content, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec, int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  // Split the content into newline-aligned chunks.
+  std::vector<const char*> boundaries = {csv_content.data()};
+  const char* const content_end = csv_content.data() + csv_content.size();
+  for (int i = 1; i < num_threads; ++i) {
+    const size_t offset = csv_content.size() * i / num_threads;
+    const char* boundary =
+        std::max(boundaries.back(), csv_content.data() + offset);
+    if (boundary > csv_content.data() && boundary < content_end &&
+        *(boundary - 1) != '\n') {
+      const char* line_end = static_cast<const char*>(
+          std::memchr(boundary, '\n', content_end - boundary));
+      boundary = line_end == nullptr ? content_end : line_end + 1;
+    }
+    boundaries.push_back(boundary);
+  }
+  boundaries.push_back(content_end);
+  const size_t num_chunks = boundaries.size() - 1;
+  // Parse the chunks in parallel.
+  std::vector<PriceHistoryChunk> chunks(num_chunks);
+  std::atomic<size_t> stopped_chunk_index(num_chunks);
+  std::vector<std::future<void>> chunk_futures;
+  chunk_futures.reserve(num_chunks);
+  for (size_t chunk_index = 0; chunk_index < num_chunks; ++chunk_index) {
+    chunk_futures.emplace_back(std::async(
+        std::launch::async,
+        [&boundaries, &chunks, &stopped_chunk_index, start_timestamp_sec,
+         end_timestamp_sec, chunk_index]() {
+          PriceHistoryChunk& chunk = chunks[chunk_index];
+          ParsePriceHistoryChunk(
+              boundaries[chunk_index], boundaries[chunk_index + 1],
+              start_timestamp_sec, end_timestamp_sec, chunk_index,
+              stopped_chunk_index,
+              [&chunk](const PriceRecord& price_record) {
+                chunk.price_history.push_back(price_record);
+              },
+              chunk);
+        }));
+  }
+  for (auto& chunk_future : chunk_futures) {
+    chunk_future.get();
+  }
+  // Merge the chunks (and validate the timestamps across chunk boundaries).
+  size_t num_records = 0;
+  for (const PriceHistoryChunk& chunk : chunks) {
+    num_records += chunk.price_history.size();
+  }
+  PriceHistory price_history;
+  price_history.reserve(num_records);
+  size_t line_offset = 0;
+  int64_t timestamp_sec_prev = 0;
+  for (PriceHistoryChunk& chunk : chunks) {
+    if (chunk.has_first_line &&
+        chunk.first_timestamp_sec < timestamp_sec_prev) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid timestamp on the line %d: %s",
+                          line_offset + chunk.first_line,
+                          chunk.first_line_content));
+    }
+    if (!chunk.error.empty()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "%s on the line %d: %s", chunk.error, line_offset + chunk.error_line,
+          chunk.error_line_content));
+    }
+    std::move(chunk.price_history.begin(), chunk.price_history.end(),
+              std::back_inserter(price_history));
+    if (chunk.ended) {
+      break;
+    }
+    if (!price_history.empty()) {
+      timestamp_sec_prev = price_history.back().timestamp_sec();
+    }
+    line_offset += chunk.num_lines;
+  }
+  return price_history;
+}
+
+absl::StatusOr<PriceHistory> ReadPriceHistoryFromCsvFile(
+    const std::string& file_name, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec, int num_threads) {
+  absl::StatusOr<std::unique_ptr<MappedFile>> mapped_file_status =
+      MappedFile::Open(file_name);
+  if (!mapped_file_status.ok()) {
+    return mapped_file_status.status();
+  }
+  const MappedFile& mapped_file = *mapped_file_status.value();
+  return ParsePriceHistoryFromCsv(
+      absl::string_view(mapped_file.data(), mapped_file.size()),
+      start_timestamp_sec, end_timestamp_sec, num_threads);
+}
+
+absl::Status ParsePriceRecordsFromCsv(
+    absl::string_view csv_content, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec,
+    const std::function<void(const PriceRecord&)>& consumer) {
+  // The whole content is parsed as a single chunk.
+  PriceHistoryChunk chunk;
+  std::atomic<size_t> stopped_chunk_index(1);
+  ParsePriceHistoryChunk(csv_content.data(),
+                         csv_content.data() + csv_content.size(),
+                         start_timestamp_sec, end_timestamp_sec,
+                         /*chunk_index=*/0, stopped_chunk_index, consumer,
+                         chunk);
+  if (!chunk.error.empty()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("%s on the line %d: %s", chunk.error, chunk.error_line,
+                        chunk.error_line_content));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ReadPriceRecordsFromCsvFile(
+    const std::string& file_name, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec,
+    const std::function<void(const PriceRecord&)>& consumer) {
+  absl::StatusOr<std::unique_ptr<MappedFile>> mapped_file_status =
+      MappedFile::Open(file_name);
+  if (!mapped_file_status.ok()) {
+    return mapped_file_status.status();
+  }
+  const MappedFile& mapped_file = *mapped_file_status.value();
+  return ParsePriceRecordsFromCsv(
+      absl::string_view(mapped_file.data(), mapped_file.size()),
+      start_timestamp_sec, end_timestamp_sec, consumer);
+}
+
+}  // namespace trader
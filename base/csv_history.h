@@ -0,0 +1,55 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef BASE_CSV_HISTORY_H
+#define BASE_CSV_HISTORY_H
+
+#include <functional>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/base.h"
+
+namespace trader {
+
+// Parses the price history from the CSV content, where every line is of the
+// form: timestamp_sec,price,volume
+// Only the records within the time interval [start_timestamp_sec,
+// end_timestamp_sec) are returned (zero timestamps mean no restriction).
+// Parsing stops at the first record at or after end_timestamp_sec.
+// Returns an error (with the line number) if the selected records have
+// decreasing (or non-positive) timestamps, non-positive prices or negative
+// volumes. Fields that cannot be parsed are treated as zeros.
+//
+// The content is split into num_threads newline-aligned chunks that are parsed
+// (and validated) in parallel. The timestamp monotonicity across the chunk
+// boundaries is validated when merging the chunks. The result (including the
+// reported error) does not depend on num_threads. If num_threads is zero, the
+// number of hardware threads is used.
+absl::StatusOr<PriceHistory> ParsePriceHistoryFromCsv(
+    absl::string_view csv_content, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec, int num_threads);
+
+// Reads (memory-maps) the CSV file and parses the price history as above.
+absl::StatusOr<PriceHistory> ReadPriceHistoryFromCsvFile(
+    const std::string& file_name, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec, int num_threads);
+
+// Parses the price records from the CSV content (with the same semantics as
+// ParsePriceHistoryFromCsv above) in a single sequential pass, and passes them
+// one by one to the consumer. The price history is never materialized.
+// The price records parsed before an error are passed to the consumer.
+absl::Status ParsePriceRecordsFromCsv(
+    absl::string_view csv_content, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec,
+    const std::function<void(const PriceRecord&)>& consumer);
+
+// Reads (memory-maps) the CSV file and parses the price records as above.
+absl::Status ReadPriceRecordsFromCsvFile(
+    const std::string& file_name, int64_t start_timestamp_sec,
+    int64_t end_timestamp_sec,
+    const std::function<void(const PriceRecord&)>& consumer);
+
+}  // namespace trader
+
+#endif  // BASE_CSV_HISTORY_H
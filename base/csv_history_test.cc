@@ -0,0 +1,221 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/csv_history.h"
+
+#include <fstream>
+
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+constexpr int kNumThreads[] = {0, 1, 2, 3, 5, 16};
+
+void ExpectPriceRecordEq(const PriceRecord& price_record,
+                         int64_t timestamp_sec, float price, float volume) {
+  EXPECT_EQ(price_record.timestamp_sec(), timestamp_sec);
+  EXPECT_FLOAT_EQ(price_record.price(), price);
+  EXPECT_FLOAT_EQ(price_record.volume(), volume);
+}
+
+// Returns the CSV content with num_records records (one minute apart).
+std::string GetCsvContent(int num_records) {
+  std::string csv_content;
+  for (int i = 0; i < num_records; ++i) {
+    csv_content += absl::StrFormat("%d,%.2f,%.3f\n", 1483228800 + 60 * i,
+                                   100.0f + i, 0.5f * i);
+  }
+  return csv_content;
+}
+}  // namespace
+
+TEST(ParsePriceHistoryFromCsvTest, Empty) {
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv("", /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_TRUE(price_history_status.ok());
+    EXPECT_TRUE(price_history_status.value().empty());
+  }
+}
+
+TEST(ParsePriceHistoryFromCsvTest, Basic) {
+  const std::string csv_content =
+      "1483228800,100.5,1.25\n"
+      "1483228860, 101,0\n"
+      "1483228860,102.25,1e3\r\n"
+      "1483228980,99.75,2.5";
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_TRUE(price_history_status.ok()) << price_history_status.status();
+    const PriceHistory& price_history = price_history_status.value();
+    ASSERT_EQ(price_history.size(), 4);
+    ExpectPriceRecordEq(price_history[0], 1483228800, 100.5f, 1.25f);
+    ExpectPriceRecordEq(price_history[1], 1483228860, 101.0f, 0.0f);
+    ExpectPriceRecordEq(price_history[2], 1483228860, 102.25f, 1000.0f);
+    ExpectPriceRecordEq(price_history[3], 1483228980, 99.75f, 2.5f);
+  }
+}
+
+TEST(ParsePriceHistoryFromCsvTest, MatchesSequentialParsing) {
+  const std::string csv_content = GetCsvContent(1000);
+  const absl::StatusOr<PriceHistory> expected_status =
+      ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                               /*end_timestamp_sec=*/0, /*num_threads=*/1);
+  ASSERT_TRUE(expected_status.ok());
+  ASSERT_EQ(expected_status.value().size(), 1000);
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_TRUE(price_history_status.ok());
+    ASSERT_EQ(price_history_status.value().size(), 1000);
+    for (size_t i = 0; i < 1000; ++i) {
+      EXPECT_EQ(price_history_status.value()[i].SerializeAsString(),
+                expected_status.value()[i].SerializeAsString());
+    }
+  }
+}
+
+TEST(ParsePriceHistoryFromCsvTest, TimeInterval) {
+  // Records after the end_timestamp_sec are ignored (even if invalid).
+  const std::string csv_content = GetCsvContent(100) + "invalid\n";
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(
+            csv_content, /*start_timestamp_sec=*/1483228800 + 60 * 10,
+            /*end_timestamp_sec=*/1483228800 + 60 * 90, num_threads);
+    ASSERT_TRUE(price_history_status.ok()) << price_history_status.status();
+    const PriceHistory& price_history = price_history_status.value();
+    ASSERT_EQ(price_history.size(), 80);
+    ExpectPriceRecordEq(price_history.front(), 1483228800 + 60 * 10, 110.0f,
+                        5.0f);
+    ExpectPriceRecordEq(price_history.back(), 1483228800 + 60 * 89, 189.0f,
+                        44.5f);
+  }
+}
+
+TEST(ParsePriceHistoryFromCsvTest, InvalidTimestamp) {
+  std::string csv_content = GetCsvContent(50);
+  csv_content += "1483228800,100,1\n";  // Line 51.
+  csv_content += GetCsvContent(50);
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_FALSE(price_history_status.ok());
+    EXPECT_EQ(price_history_status.status().message(),
+              "Invalid timestamp on the line 51: 1483228800,100,1");
+  }
+}
+
+TEST(ParsePriceHistoryFromCsvTest, FirstInvalidLineReported) {
+  std::string csv_content = GetCsvContent(30);
+  csv_content += "1483230600,-1,1\n";  // Line 31.
+  csv_content += "1483230660,100,-1\n";
+  csv_content += "abc\n";
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_FALSE(price_history_status.ok());
+    EXPECT_EQ(price_history_status.status().message(),
+              "Invalid price on the line 31: 1483230600,-1,1");
+  }
+  csv_content = GetCsvContent(30) + "1483230600,100,-1\n";
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_FALSE(price_history_status.ok());
+    EXPECT_EQ(price_history_status.status().message(),
+              "Invalid volume on the line 31: 1483230600,100,-1");
+  }
+  csv_content = GetCsvContent(30) + "abc\n";
+  for (const int num_threads : kNumThreads) {
+    absl::StatusOr<PriceHistory> price_history_status =
+        ParsePriceHistoryFromCsv(csv_content, /*start_timestamp_sec=*/0,
+                                 /*end_timestamp_sec=*/0, num_threads);
+    ASSERT_FALSE(price_history_status.ok());
+    EXPECT_EQ(price_history_status.status().message(),
+              "Invalid timestamp on the line 31: abc");
+  }
+}
+
+TEST(ReadPriceHistoryFromCsvFileTest, Basic) {
+  const std::string file_name = ::testing::TempDir() + "csv_history_test.csv";
+  {
+    std::ofstream outfile(file_name);
+    outfile << GetCsvContent(100);
+  }
+  absl::StatusOr<PriceHistory> price_history_status =
+      ReadPriceHistoryFromCsvFile(file_name, /*start_timestamp_sec=*/0,
+                                  /*end_timestamp_sec=*/0, /*num_threads=*/4);
+  ASSERT_TRUE(price_history_status.ok());
+  ASSERT_EQ(price_history_status.value().size(), 100);
+  EXPECT_FALSE(ReadPriceHistoryFromCsvFile(::testing::TempDir() + "missing.csv",
+                                           /*start_timestamp_sec=*/0,
+                                           /*end_timestamp_sec=*/0,
+                                           /*num_threads=*/4)
+                   .ok());
+}
+
+TEST(ParsePriceRecordsFromCsvTest, MatchesParsePriceHistoryFromCsv) {
+  const std::string csv_content = GetCsvContent(1000);
+  const absl::StatusOr<PriceHistory> expected_status =
+      ParsePriceHistoryFromCsv(
+          csv_content, /*start_timestamp_sec=*/1483228800 + 60 * 10,
+          /*end_timestamp_sec=*/1483228800 + 60 * 900, /*num_threads=*/4);
+  ASSERT_TRUE(expected_status.ok());
+  PriceHistory price_history;
+  const absl::Status status = ParsePriceRecordsFromCsv(
+      csv_content, /*start_timestamp_sec=*/1483228800 + 60 * 10,
+      /*end_timestamp_sec=*/1483228800 + 60 * 900,
+      [&price_history](const PriceRecord& price_record) {
+        price_history.push_back(price_record);
+      });
+  ASSERT_TRUE(status.ok()) << status;
+  ASSERT_EQ(price_history.size(), expected_status.value().size());
+  for (size_t i = 0; i < price_history.size(); ++i) {
+    EXPECT_EQ(price_history[i].SerializeAsString(),
+              expected_status.value()[i].SerializeAsString());
+  }
+}
+
+TEST(ParsePriceRecordsFromCsvTest, InvalidLineReported) {
+  std::string csv_content = GetCsvContent(30);
+  csv_content += "1483230600,-1,1\n";  // Line 31.
+  csv_content += GetCsvContent(30);
+  int num_records = 0;
+  const absl::Status status = ParsePriceRecordsFromCsv(
+      csv_content, /*start_timestamp_sec=*/0, /*end_timestamp_sec=*/0,
+      [&num_records](const PriceRecord&) { ++num_records; });
+  ASSERT_FALSE(status.ok());
+  EXPECT_EQ(status.message(), "Invalid price on the line 31: 1483230600,-1,1");
+  EXPECT_EQ(num_records, 30);
+}
+
+TEST(ReadPriceRecordsFromCsvFileTest, Basic) {
+  const std::string file_name =
+      ::testing::TempDir() + "csv_history_records_test.csv";
+  {
+    std::ofstream outfile(file_name);
+    outfile << GetCsvContent(100);
+  }
+  int num_records = 0;
+  ASSERT_TRUE(ReadPriceRecordsFromCsvFile(
+                  file_name, /*start_timestamp_sec=*/0,
+                  /*end_timestamp_sec=*/0,
+                  [&num_records](const PriceRecord&) { ++num_records; })
+                  .ok());
+  EXPECT_EQ(num_records, 100);
+  EXPECT_FALSE(ReadPriceRecordsFromCsvFile(
+                   ::testing::TempDir() + "missing.csv",
+                   /*start_timestamp_sec=*/0, /*end_timestamp_sec=*/0,
+                   [](const PriceRecord&) {})
+                   .ok());
+}
+
+}  // namespace trader
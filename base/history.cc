@@ -61,61 +61,21 @@ PriceHistory RemoveOutliers(PriceHistory::const_iterator begin,
                             PriceHistory::const_iterator end,
                             float max_price_deviation_per_min,
                             std::vector<size_t>* outlier_indices) {
-  static constexpr int MAX_LOOKAHEAD = 10;
-  static constexpr int MIN_LOOKAHEAD_PERSISTENT = 3;
   PriceHistory price_history_clean;
-  for (auto it = begin; it != end; ++it) {
-    const PriceRecord& price_record = *it;
-    const size_t price_record_index = std::distance(begin, it);
-    if (price_record.price() <= 0 || price_record.volume() < 0) {
-      if (outlier_indices != nullptr) {
-        outlier_indices->push_back(price_record_index);
-      }
-      continue;
-    }
-    if (price_history_clean.empty()) {
-      price_history_clean.push_back(price_record);
-      continue;
-    }
-    const PriceRecord& price_record_prev = price_history_clean.back();
-    const float reference_price = price_record_prev.price();
-    const float duration_min =
-        std::max(1.0f, static_cast<float>(price_record.timestamp_sec() -
-                                          price_record_prev.timestamp_sec()) /
-                           60.0f);
-    const float jump_factor =
-        (1.0f + max_price_deviation_per_min) * std::sqrt(duration_min);
-    const float jump_up_price = reference_price * jump_factor;
-    const float jump_down_price = reference_price / jump_factor;
-    const bool jumped_up = price_record.price() > jump_up_price;
-    const bool jumped_down = price_record.price() < jump_down_price;
-    bool is_outlier = false;
-    if (jumped_up || jumped_down) {
-      // Let's look ahead if this jump persists.
-      int lookahead = 0;
-      int lookahead_persistent = 0;
-      const float middle_up_price =
-          0.8f * jump_up_price + 0.2f * reference_price;
-      const float middle_down_price =
-          0.8f * jump_down_price + 0.2f * reference_price;
-      for (auto jt = it + 1; jt != end && lookahead < MAX_LOOKAHEAD; ++jt) {
-        if (jt->price() <= 0 || jt->volume() < 0) {
-          continue;
+  OutlierFilter outlier_filter(
+      max_price_deviation_per_min,
+      [&price_history_clean](const PriceRecord& price_record) {
+        price_history_clean.push_back(price_record);
+      },
+      [outlier_indices](size_t price_record_index, const PriceRecord&) {
+        if (outlier_indices != nullptr) {
+          outlier_indices->push_back(price_record_index);
         }
-        if ((jumped_up && jt->price() > middle_up_price) ||
-            (jumped_down && jt->price() < middle_down_price)) {
-          ++lookahead_persistent;
-        }
-        ++lookahead;
-      }
-      is_outlier = lookahead_persistent < MIN_LOOKAHEAD_PERSISTENT;
-    }
-    if (!is_outlier) {
-      price_history_clean.push_back(price_record);
-    } else if (outlier_indices != nullptr) {
-      outlier_indices->push_back(price_record_index);
-    }
+      });
+  for (auto it = begin; it != end; ++it) {
+    outlier_filter.Add(*it);
   }
+  outlier_filter.Finish();
   return price_history_clean;
 }
 
@@ -142,46 +102,177 @@ std::map<size_t, bool> GetOutlierIndicesWithContext(
 OhlcHistory Resample(PriceHistory::const_iterator begin,
                      PriceHistory::const_iterator end, int sampling_rate_sec) {
   OhlcHistory resampled_ohlc_history;
+  Resampler resampler(sampling_rate_sec,
+                      [&resampled_ohlc_history](const OhlcTick& ohlc_tick) {
+                        resampled_ohlc_history.push_back(ohlc_tick);
+                      });
   for (auto it = begin; it != end; ++it) {
-    const int64_t downsampled_timestamp_sec =
-        sampling_rate_sec * (it->timestamp_sec() / sampling_rate_sec);
-    while (!resampled_ohlc_history.empty() &&
-           resampled_ohlc_history.back().timestamp_sec() + sampling_rate_sec <
-               downsampled_timestamp_sec) {
-      const int64_t prev_timestamp_sec =
-          resampled_ohlc_history.back().timestamp_sec();
-      const float prev_close = resampled_ohlc_history.back().close();
-      resampled_ohlc_history.emplace_back();
-      OhlcTick* ohlc_tick = &resampled_ohlc_history.back();
-      ohlc_tick->set_timestamp_sec(prev_timestamp_sec + sampling_rate_sec);
-      ohlc_tick->set_open(prev_close);
-      ohlc_tick->set_high(prev_close);
-      ohlc_tick->set_low(prev_close);
-      ohlc_tick->set_close(prev_close);
-      ohlc_tick->set_volume(0);
+    resampler.Add(*it);
+  }
+  resampler.Finish();
+  return resampled_ohlc_history;
+}
+
+bool PriceHistoryGapTracker::GapGreater::operator()(
+    const HistoryGap& lhs, const HistoryGap& rhs) const {
+  const int64_t length_delta = lhs.second - lhs.first - rhs.second + rhs.first;
+  return length_delta > 0 || (length_delta == 0 && lhs.first < rhs.first);
+}
+
+void PriceHistoryGapTracker::Add(int64_t timestamp_sec) {
+  if (has_prev_timestamp_sec_) {
+    gap_queue_.push(HistoryGap{prev_timestamp_sec_, timestamp_sec});
+    if (gap_queue_.size() > top_n_) {
+      gap_queue_.pop();
     }
-    if (resampled_ohlc_history.empty() ||
-        resampled_ohlc_history.back().timestamp_sec() <
-            downsampled_timestamp_sec) {
-      resampled_ohlc_history.emplace_back();
-      OhlcTick* ohlc_tick = &resampled_ohlc_history.back();
-      ohlc_tick->set_timestamp_sec(downsampled_timestamp_sec);
-      ohlc_tick->set_open(it->price());
-      ohlc_tick->set_high(it->price());
-      ohlc_tick->set_low(it->price());
-      ohlc_tick->set_close(it->price());
-      ohlc_tick->set_volume(it->volume());
-    } else {
-      assert(resampled_ohlc_history.back().timestamp_sec() ==
-             downsampled_timestamp_sec);
-      OhlcTick* ohlc_tick = &resampled_ohlc_history.back();
-      ohlc_tick->set_high(std::max(ohlc_tick->high(), it->price()));
-      ohlc_tick->set_low(std::min(ohlc_tick->low(), it->price()));
-      ohlc_tick->set_close(it->price());
-      ohlc_tick->set_volume(ohlc_tick->volume() + it->volume());
+  }
+  has_prev_timestamp_sec_ = true;
+  prev_timestamp_sec_ = timestamp_sec;
+}
+
+std::vector<HistoryGap> PriceHistoryGapTracker::GetGaps() const {
+  auto gap_queue = gap_queue_;
+  std::vector<HistoryGap> history_gaps;
+  history_gaps.reserve(gap_queue.size());
+  while (!gap_queue.empty()) {
+    history_gaps.push_back(gap_queue.top());
+    gap_queue.pop();
+  }
+  std::sort(history_gaps.begin(), history_gaps.end());
+  return history_gaps;
+}
+
+OutlierFilter::OutlierFilter(
+    float max_price_deviation_per_min,
+    std::function<void(const PriceRecord&)> consumer,
+    std::function<void(size_t, const PriceRecord&)> outlier_consumer)
+    : max_price_deviation_per_min_(max_price_deviation_per_min),
+      consumer_(std::move(consumer)),
+      outlier_consumer_(std::move(outlier_consumer)) {}
+
+void OutlierFilter::Add(const PriceRecord& price_record) {
+  pending_records_.emplace_back(num_records_, price_record);
+  ++num_records_;
+  DecidePendingRecords(/*finish=*/false);
+}
+
+void OutlierFilter::Finish() { DecidePendingRecords(/*finish=*/true); }
+
+void OutlierFilter::PopPendingRecord(bool is_outlier) {
+  const auto& [price_record_index, price_record] = pending_records_.front();
+  if (is_outlier) {
+    ++num_outliers_;
+    if (outlier_consumer_) {
+      outlier_consumer_(price_record_index, price_record);
     }
+  } else {
+    has_reference_record_ = true;
+    reference_record_ = price_record;
+    consumer_(price_record);
+  }
+  pending_records_.pop_front();
+}
+
+void OutlierFilter::DecidePendingRecords(bool finish) {
+  while (!pending_records_.empty()) {
+    const PriceRecord& price_record = pending_records_.front().second;
+    if (price_record.price() <= 0 || price_record.volume() < 0) {
+      PopPendingRecord(/*is_outlier=*/true);
+      continue;
+    }
+    if (!has_reference_record_) {
+      PopPendingRecord(/*is_outlier=*/false);
+      continue;
+    }
+    const float reference_price = reference_record_.price();
+    const float duration_min = std::max(
+        1.0f, static_cast<float>(price_record.timestamp_sec() -
+                                 reference_record_.timestamp_sec()) /
+                  60.0f);
+    const float jump_factor =
+        (1.0f + max_price_deviation_per_min_) * std::sqrt(duration_min);
+    const float jump_up_price = reference_price * jump_factor;
+    const float jump_down_price = reference_price / jump_factor;
+    const bool jumped_up = price_record.price() > jump_up_price;
+    const bool jumped_down = price_record.price() < jump_down_price;
+    if (!jumped_up && !jumped_down) {
+      PopPendingRecord(/*is_outlier=*/false);
+      continue;
+    }
+    // Let's look ahead if this jump persists.
+    int lookahead = 0;
+    int lookahead_persistent = 0;
+    const float middle_up_price = 0.8f * jump_up_price + 0.2f * reference_price;
+    const float middle_down_price =
+        0.8f * jump_down_price + 0.2f * reference_price;
+    for (auto jt = pending_records_.begin() + 1;
+         jt != pending_records_.end() && lookahead < kMaxLookahead; ++jt) {
+      const PriceRecord& next_record = jt->second;
+      if (next_record.price() <= 0 || next_record.volume() < 0) {
+        continue;
+      }
+      if ((jumped_up && next_record.price() > middle_up_price) ||
+          (jumped_down && next_record.price() < middle_down_price)) {
+        ++lookahead_persistent;
+      }
+      ++lookahead;
+    }
+    if (lookahead < kMaxLookahead && !finish) {
+      // Wait for more follow-up price records.
+      return;
+    }
+    PopPendingRecord(
+        /*is_outlier=*/lookahead_persistent < kMinLookaheadPersistent);
+  }
+}
+
+void Resampler::Emit() {
+  consumer_(ohlc_tick_);
+  ++num_ohlc_ticks_;
+}
+
+void Resampler::Add(const PriceRecord& price_record) {
+  const int64_t downsampled_timestamp_sec =
+      sampling_rate_sec_ * (price_record.timestamp_sec() / sampling_rate_sec_);
+  // Fill the gap (if any) with zero-volume OHLC ticks.
+  while (has_ohlc_tick_ && ohlc_tick_.timestamp_sec() + sampling_rate_sec_ <
+                               downsampled_timestamp_sec) {
+    Emit();
+    const float prev_close = ohlc_tick_.close();
+    ohlc_tick_.set_timestamp_sec(ohlc_tick_.timestamp_sec() +
+                                 sampling_rate_sec_);
+    ohlc_tick_.set_open(prev_close);
+    ohlc_tick_.set_high(prev_close);
+    ohlc_tick_.set_low(prev_close);
+    ohlc_tick_.set_close(prev_close);
+    ohlc_tick_.set_volume(0);
+  }
+  if (!has_ohlc_tick_ ||
+      ohlc_tick_.timestamp_sec() < downsampled_timestamp_sec) {
+    if (has_ohlc_tick_) {
+      Emit();
+    }
+    has_ohlc_tick_ = true;
+    ohlc_tick_.set_timestamp_sec(downsampled_timestamp_sec);
+    ohlc_tick_.set_open(price_record.price());
+    ohlc_tick_.set_high(price_record.price());
+    ohlc_tick_.set_low(price_record.price());
+    ohlc_tick_.set_close(price_record.price());
+    ohlc_tick_.set_volume(price_record.volume());
+  } else {
+    assert(ohlc_tick_.timestamp_sec() == downsampled_timestamp_sec);
+    ohlc_tick_.set_high(std::max(ohlc_tick_.high(), price_record.price()));
+    ohlc_tick_.set_low(std::min(ohlc_tick_.low(), price_record.price()));
+    ohlc_tick_.set_close(price_record.price());
+    ohlc_tick_.set_volume(ohlc_tick_.volume() + price_record.volume());
+  }
+}
+
+void Resampler::Finish() {
+  if (has_ohlc_tick_) {
+    Emit();
+    has_ohlc_tick_ = false;
   }
-  return resampled_ohlc_history;
 }
 
 }  // namespace trader
@@ -3,6 +3,10 @@
 #ifndef BASE_HISTORY_H
 #define BASE_HISTORY_H
 
+#include <deque>
+#include <functional>
+#include <queue>
+
 #include "base/base.h"
 
 namespace trader {
@@ -38,6 +42,114 @@ std::map<size_t, bool> GetOutlierIndicesWithContext(
 OhlcHistory Resample(PriceHistory::const_iterator begin,
                      PriceHistory::const_iterator end, int sampling_rate_sec);
 
+// Streaming version of GetPriceHistoryGaps (without the start and end gaps).
+// Keeps track of the top_n largest gaps between the consecutive timestamps.
+class PriceHistoryGapTracker {
+ public:
+  explicit PriceHistoryGapTracker(size_t top_n) : top_n_(top_n) {}
+
+  // Adds the next (non-decreasing) timestamp (in seconds).
+  void Add(int64_t timestamp_sec);
+  // Returns the top_n largest (chronologically sorted) gaps seen so far.
+  std::vector<HistoryGap> GetGaps() const;
+
+ private:
+  // Orders the gaps by their (decreasing) length, and then chronologically.
+  struct GapGreater {
+    bool operator()(const HistoryGap& lhs, const HistoryGap& rhs) const;
+  };
+
+  size_t top_n_ = 0;
+  bool has_prev_timestamp_sec_ = false;
+  int64_t prev_timestamp_sec_ = 0;
+  // Top (at most) top_n gaps with the shortest one on the top.
+  std::priority_queue<HistoryGap, std::vector<HistoryGap>, GapGreater>
+      gap_queue_;
+};
+
+// Streaming version of RemoveOutliers. The price records are added one by one
+// and every price record that is not an outlier is passed to the consumer.
+// Deciding whether a price record is an outlier requires (at most)
+// kMaxLookahead follow-up (valid) price records. Only these (not yet decided)
+// price records are buffered, so the memory footprint does not depend on the
+// length of the price history. The results are identical to RemoveOutliers.
+class OutlierFilter {
+ public:
+  // Maximum number of follow-up price records checked for each price jump.
+  static constexpr int kMaxLookahead = 10;
+  // Minimum number of follow-up price records persisting the price jump.
+  static constexpr int kMinLookaheadPersistent = 3;
+
+  // max_price_deviation_per_min is maximum allowed price deviation per minute.
+  // The (optional) outlier_consumer receives the removed outliers together
+  // with their (0-based) indices within the added price records.
+  OutlierFilter(
+      float max_price_deviation_per_min,
+      std::function<void(const PriceRecord&)> consumer,
+      std::function<void(size_t, const PriceRecord&)> outlier_consumer);
+
+  // Adds the next price record.
+  void Add(const PriceRecord& price_record);
+  // Decides the remaining (buffered) price records. Must be called after the
+  // last price record was added.
+  void Finish();
+
+  // Returns the number of removed outliers so far.
+  size_t num_outliers() const { return num_outliers_; }
+
+ private:
+  // Decides the buffered price records (while there is enough lookahead, or
+  // all of them if finish is true).
+  void DecidePendingRecords(bool finish);
+  // Passes the first buffered price record to the (outlier) consumer.
+  void PopPendingRecord(bool is_outlier);
+
+  float max_price_deviation_per_min_ = 0;
+  std::function<void(const PriceRecord&)> consumer_;
+  std::function<void(size_t, const PriceRecord&)> outlier_consumer_;
+  // Price records (and their indices) that were not decided yet.
+  std::deque<std::pair<size_t, PriceRecord>> pending_records_;
+  // Number of added price records.
+  size_t num_records_ = 0;
+  size_t num_outliers_ = 0;
+  // Last price record that was not an outlier.
+  bool has_reference_record_ = false;
+  PriceRecord reference_record_;
+};
+
+// Streaming version of Resample. The price records are added one by one and
+// every finished OHLC tick is passed to the consumer. Only the last (not yet
+// finished) OHLC tick is kept in memory. The results are identical to
+// Resample.
+class Resampler {
+ public:
+  Resampler(int sampling_rate_sec,
+            std::function<void(const OhlcTick&)> consumer)
+      : sampling_rate_sec_(sampling_rate_sec), consumer_(std::move(consumer)) {}
+
+  // Returns the sampling rate (in seconds).
+  int sampling_rate_sec() const { return sampling_rate_sec_; }
+  // Returns the number of OHLC ticks passed to the consumer so far.
+  size_t num_ohlc_ticks() const { return num_ohlc_ticks_; }
+
+  // Adds the next price record.
+  void Add(const PriceRecord& price_record);
+  // Passes the last OHLC tick (if any) to the consumer. Must be called after
+  // the last price record was added.
+  void Finish();
+
+ private:
+  // Passes the last OHLC tick to the consumer.
+  void Emit();
+
+  int sampling_rate_sec_ = 0;
+  std::function<void(const OhlcTick&)> consumer_;
+  size_t num_ohlc_ticks_ = 0;
+  // Last (not yet finished) OHLC tick.
+  bool has_ohlc_tick_ = false;
+  OhlcTick ohlc_tick_;
+};
+
 }  // namespace trader
 
 #endif  // BASE_HISTORY_H
@@ -641,4 +641,179 @@ TEST(ResampleTest, ResampleMultiplePriceRecords2) {
                      850.0f, 4.0e3f);
 }
 
+TEST(PriceHistoryGapTrackerTest, SameGapsAsGetPriceHistoryGaps) {
+  PriceHistory price_history;
+  AddPriceRecord(1483228800, 700.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483230000, 750.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483230600, 850.0f, 2.0e3f, price_history);
+  AddPriceRecord(1483230900, 800.0f, 1.5e3f, price_history);
+  AddPriceRecord(1483231500, 820.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483231800, 840.0f, 1.0e3f, price_history);
+  for (size_t top_n = 1; top_n <= 6; ++top_n) {
+    PriceHistoryGapTracker gap_tracker(top_n);
+    for (const PriceRecord& price_record : price_history) {
+      gap_tracker.Add(price_record.timestamp_sec());
+    }
+    EXPECT_EQ(gap_tracker.GetGaps(),
+              GetPriceHistoryGaps(
+                  /*begin=*/price_history.begin(), /*end=*/price_history.end(),
+                  /*start_timestamp_sec=*/0, /*end_timestamp_sec=*/0, top_n));
+  }
+}
+
+TEST(OutlierFilterTest, DecidesPriceRecordsIncrementally) {
+  PriceHistory price_history_clean;
+  std::vector<size_t> outlier_indices;
+  OutlierFilter outlier_filter(
+      /*max_price_deviation_per_min=*/0.05f,
+      [&price_history_clean](const PriceRecord& price_record) {
+        price_history_clean.push_back(price_record);
+      },
+      [&outlier_indices](size_t index, const PriceRecord& price_record) {
+        outlier_indices.push_back(index);
+      });
+  PriceHistory price_history;
+  AddPriceRecord(1483228800, 700.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483228860, 710.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483228920, 0.0f, 1.0e3f, price_history);
+  for (const PriceRecord& price_record : price_history) {
+    outlier_filter.Add(price_record);
+  }
+  // Price records without any price jump are decided immediately.
+  EXPECT_EQ(price_history_clean.size(), 2);
+  EXPECT_EQ(outlier_indices, std::vector<size_t>({2}));
+  // Price jump requires kMaxLookahead follow-up (valid) price records.
+  AddPriceRecord(1483228980, 2000.0f, 1.0e3f, price_history);
+  outlier_filter.Add(price_history.back());
+  for (int i = 0; i < OutlierFilter::kMaxLookahead; ++i) {
+    EXPECT_EQ(price_history_clean.size(), 2);
+    AddPriceRecord(1483229040 + 60 * i, 705.0f, 1.0e3f, price_history);
+    outlier_filter.Add(price_history.back());
+  }
+  EXPECT_EQ(outlier_indices, std::vector<size_t>({2, 3}));
+  EXPECT_EQ(price_history_clean.size(), 2 + OutlierFilter::kMaxLookahead);
+  outlier_filter.Finish();
+  EXPECT_EQ(outlier_filter.num_outliers(), 2);
+  std::vector<size_t> expected_outlier_indices;
+  const PriceHistory expected_price_history_clean =
+      RemoveOutliers(price_history.begin(), price_history.end(),
+                     /*max_price_deviation_per_min=*/0.05f,
+                     &expected_outlier_indices);
+  EXPECT_EQ(outlier_indices, expected_outlier_indices);
+  ASSERT_EQ(price_history_clean.size(), expected_price_history_clean.size());
+  for (size_t i = 0; i < price_history_clean.size(); ++i) {
+    ExpectNearPriceRecord(price_history_clean[i],
+                          expected_price_history_clean[i]);
+  }
+}
+
+TEST(OutlierFilterTest, UndecidedPriceRecordsAreDecidedOnFinish) {
+  PriceHistory price_history_clean;
+  OutlierFilter outlier_filter(
+      /*max_price_deviation_per_min=*/0.05f,
+      [&price_history_clean](const PriceRecord& price_record) {
+        price_history_clean.push_back(price_record);
+      },
+      /*outlier_consumer=*/nullptr);
+  PriceHistory price_history;
+  AddPriceRecord(1483228800, 700.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483228860, 1000.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483228920, 1010.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483228980, 1020.0f, 1.0e3f, price_history);
+  AddPriceRecord(1483229040, 1030.0f, 1.0e3f, price_history);
+  for (const PriceRecord& price_record : price_history) {
+    outlier_filter.Add(price_record);
+  }
+  EXPECT_EQ(price_history_clean.size(), 1);
+  outlier_filter.Finish();
+  // The price jump persists.
+  EXPECT_EQ(outlier_filter.num_outliers(), 0);
+  ASSERT_EQ(price_history_clean.size(), 5);
+  for (size_t i = 0; i < price_history.size(); ++i) {
+    ExpectNearPriceRecord(price_history_clean[i], price_history[i]);
+  }
+}
+
+TEST(ResamplerTest, EmitsFinishedOhlcTicks) {
+  OhlcHistory ohlc_history;
+  Resampler resampler(/*sampling_rate_sec=*/300,
+                      [&ohlc_history](const OhlcTick& ohlc_tick) {
+                        ohlc_history.push_back(ohlc_tick);
+                      });
+  EXPECT_EQ(resampler.sampling_rate_sec(), 300);
+  PriceRecord price_record;
+  price_record.set_timestamp_sec(1483228850);
+  price_record.set_price(700.0f);
+  price_record.set_volume(1.0e3f);
+  resampler.Add(price_record);
+  price_record.set_timestamp_sec(1483228900);
+  price_record.set_price(750.0f);
+  resampler.Add(price_record);
+  EXPECT_TRUE(ohlc_history.empty());
+  price_record.set_timestamp_sec(1483229450);
+  price_record.set_price(800.0f);
+  resampler.Add(price_record);
+  ASSERT_EQ(ohlc_history.size(), 2);
+  ExpectNearOhlcTick(ohlc_history[0], 1483228800, 700.0f, 750.0f, 700.0f,
+                     750.0f, 2.0e3f);
+  ExpectNearOhlcTick(ohlc_history[1], 1483229100, 750.0f, 750.0f, 750.0f,
+                     750.0f, 0.0f);
+  resampler.Finish();
+  EXPECT_EQ(resampler.num_ohlc_ticks(), 3);
+  ASSERT_EQ(ohlc_history.size(), 3);
+  ExpectNearOhlcTick(ohlc_history[2], 1483229400, 800.0f, 800.0f, 800.0f,
+                     800.0f, 1.0e3f);
+}
+
+TEST(ResamplerTest, MultipleSamplingRatesInSinglePass) {
+  PriceHistory price_history;
+  for (int i = 0; i < 1000; ++i) {
+    // Price jumps every 97 records (which are mostly outliers).
+    const float price = (i % 97 == 50) ? 2000.0f : 700.0f + (i % 13);
+    AddPriceRecord(1483228800 + 37 * i + (i / 100) * 3600, price,
+                   1.0f + (i % 7), price_history);
+  }
+  const std::vector<int> sampling_rates_sec = {60, 300, 3600};
+  std::vector<OhlcHistory> ohlc_histories(sampling_rates_sec.size());
+  std::vector<Resampler> resamplers;
+  for (size_t i = 0; i < sampling_rates_sec.size(); ++i) {
+    resamplers.emplace_back(sampling_rates_sec[i],
+                            [&ohlc_histories, i](const OhlcTick& ohlc_tick) {
+                              ohlc_histories[i].push_back(ohlc_tick);
+                            });
+  }
+  OutlierFilter outlier_filter(
+      /*max_price_deviation_per_min=*/0.05f,
+      [&resamplers](const PriceRecord& price_record) {
+        for (Resampler& resampler : resamplers) {
+          resampler.Add(price_record);
+        }
+      },
+      /*outlier_consumer=*/nullptr);
+  for (const PriceRecord& price_record : price_history) {
+    outlier_filter.Add(price_record);
+  }
+  outlier_filter.Finish();
+  for (Resampler& resampler : resamplers) {
+    resampler.Finish();
+  }
+  EXPECT_GT(outlier_filter.num_outliers(), 0);
+  const PriceHistory price_history_clean =
+      RemoveOutliers(price_history.begin(), price_history.end(),
+                     /*max_price_deviation_per_min=*/0.05f,
+                     /*outlier_indices=*/nullptr);
+  for (size_t i = 0; i < sampling_rates_sec.size(); ++i) {
+    const OhlcHistory expected_ohlc_history =
+        Resample(price_history_clean.begin(), price_history_clean.end(),
+                 sampling_rates_sec[i]);
+    ASSERT_EQ(ohlc_histories[i].size(), expected_ohlc_history.size());
+    for (size_t j = 0; j < expected_ohlc_history.size(); ++j) {
+      const OhlcTick& ohlc_tick = expected_ohlc_history[j];
+      ExpectNearOhlcTick(ohlc_histories[i][j], ohlc_tick.timestamp_sec(),
+                         ohlc_tick.open(), ohlc_tick.high(), ohlc_tick.low(),
+                         ohlc_tick.close(), ohlc_tick.volume());
+    }
+  }
+}
+
 }  // namespace trader
@@ -0,0 +1,159 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/ohlc_pyramid.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_format.h"
+
+namespace trader {
+namespace {
+// Verifies that the sampling rate is a (greater) multiple of the previous
+// level sampling rate (zero for the base level).
+absl::Status ValidateSamplingRate(int prev_sampling_rate_sec,
+                                  int sampling_rate_sec) {
+  if (sampling_rate_sec <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Invalid sampling rate: %d", sampling_rate_sec));
+  }
+  if (prev_sampling_rate_sec > 0 &&
+      (sampling_rate_sec <= prev_sampling_rate_sec ||
+       sampling_rate_sec % prev_sampling_rate_sec != 0)) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Sampling rate %d is not a multiple of the previous sampling rate %d",
+        sampling_rate_sec, prev_sampling_rate_sec));
+  }
+  return absl::OkStatus();
+}
+}  // namespace
+
+OhlcHistory AggregateOhlcHistory(const ColumnarOhlcHistory& ohlc_history,
+                                 int sampling_rate_sec) {
+  OhlcHistory aggregated_ohlc_history;
+  // Whether the last aggregated OHLC tick has any non-zero volume OHLC tick.
+  bool has_volume = false;
+  for (size_t i = 0; i < ohlc_history.size(); ++i) {
+    const OhlcTickView ohlc_tick = ohlc_history[i];
+    const int64_t aggregated_timestamp_sec =
+        sampling_rate_sec * (ohlc_tick.timestamp_sec() / sampling_rate_sec);
+    while (!aggregated_ohlc_history.empty() &&
+           aggregated_ohlc_history.back().timestamp_sec() + sampling_rate_sec <
+               aggregated_timestamp_sec) {
+      const int64_t prev_timestamp_sec =
+          aggregated_ohlc_history.back().timestamp_sec();
+      const float prev_close = aggregated_ohlc_history.back().close();
+      aggregated_ohlc_history.emplace_back();
+      OhlcTick* aggregated_ohlc_tick = &aggregated_ohlc_history.back();
+      aggregated_ohlc_tick->set_timestamp_sec(prev_timestamp_sec +
+                                              sampling_rate_sec);
+      aggregated_ohlc_tick->set_open(prev_close);
+      aggregated_ohlc_tick->set_high(prev_close);
+      aggregated_ohlc_tick->set_low(prev_close);
+      aggregated_ohlc_tick->set_close(prev_close);
+      aggregated_ohlc_tick->set_volume(0);
+    }
+    if (aggregated_ohlc_history.empty() ||
+        aggregated_ohlc_history.back().timestamp_sec() <
+            aggregated_timestamp_sec) {
+      aggregated_ohlc_history.emplace_back();
+      ohlc_tick.CopyTo(aggregated_ohlc_history.back());
+      aggregated_ohlc_history.back().set_timestamp_sec(
+          aggregated_timestamp_sec);
+      has_volume = ohlc_tick.volume() > 0;
+      continue;
+    }
+    if (ohlc_tick.volume() <= 0) {
+      // Zero volume OHLC tick (gap) does not affect the prices.
+      continue;
+    }
+    OhlcTick* aggregated_ohlc_tick = &aggregated_ohlc_history.back();
+    if (!has_volume) {
+      // Prices of the (preceding) zero volume OHLC ticks are ignored.
+      aggregated_ohlc_tick->set_open(ohlc_tick.open());
+      aggregated_ohlc_tick->set_high(ohlc_tick.high());
+      aggregated_ohlc_tick->set_low(ohlc_tick.low());
+      has_volume = true;
+    } else {
+      aggregated_ohlc_tick->set_high(
+          std::max(aggregated_ohlc_tick->high(), ohlc_tick.high()));
+      aggregated_ohlc_tick->set_low(
+          std::min(aggregated_ohlc_tick->low(), ohlc_tick.low()));
+    }
+    aggregated_ohlc_tick->set_close(ohlc_tick.close());
+    aggregated_ohlc_tick->set_volume(aggregated_ohlc_tick->volume() +
+                                     ohlc_tick.volume());
+  }
+  return aggregated_ohlc_history;
+}
+
+absl::StatusOr<OhlcPyramid> OhlcPyramid::Build(
+    const OhlcHistory& base_ohlc_history, int base_sampling_rate_sec,
+    const std::vector<int>& sampling_rates_sec) {
+  OhlcPyramid pyramid;
+  absl::Status status = ValidateSamplingRate(/*prev_sampling_rate_sec=*/0,
+                                             base_sampling_rate_sec);
+  if (!status.ok()) {
+    return status;
+  }
+  pyramid.levels_.push_back(
+      {base_sampling_rate_sec, ColumnarOhlcHistory(base_ohlc_history)});
+  for (const int sampling_rate_sec : sampling_rates_sec) {
+    const Level& prev_level = pyramid.levels_.back();
+    status =
+        ValidateSamplingRate(prev_level.sampling_rate_sec, sampling_rate_sec);
+    if (!status.ok()) {
+      return status;
+    }
+    // Every level is aggregated from the (much shorter) previous level.
+    ColumnarOhlcHistory ohlc_history(
+        AggregateOhlcHistory(prev_level.ohlc_history, sampling_rate_sec));
+    pyramid.levels_.push_back({sampling_rate_sec, std::move(ohlc_history)});
+  }
+  return pyramid;
+}
+
+absl::StatusOr<OhlcPyramid> OhlcPyramid::FromBinaryHistoryFile(
+    const BinaryHistoryFile& history_file) {
+  std::vector<int> sampling_rates_sec;
+  for (size_t i = 0; i < history_file.num_sections(); ++i) {
+    const BinaryHistorySectionHeader& section = history_file.section(i);
+    if (section.record_type ==
+        static_cast<uint32_t>(BinaryHistoryRecordType::kOhlc)) {
+      sampling_rates_sec.push_back(section.sampling_rate_sec);
+    }
+  }
+  if (sampling_rates_sec.empty()) {
+    return absl::NotFoundError("No OHLC section found");
+  }
+  std::sort(sampling_rates_sec.begin(), sampling_rates_sec.end());
+  OhlcPyramid pyramid;
+  for (const int sampling_rate_sec : sampling_rates_sec) {
+    absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+        history_file.GetOhlcHistory(sampling_rate_sec);
+    if (!ohlc_history_status.ok()) {
+      return ohlc_history_status.status();
+    }
+    const absl::Status status = ValidateSamplingRate(
+        pyramid.levels_.empty() ? 0 : pyramid.levels_.back().sampling_rate_sec,
+        sampling_rate_sec);
+    if (!status.ok()) {
+      return status;
+    }
+    pyramid.levels_.push_back(
+        {sampling_rate_sec, std::move(ohlc_history_status).value()});
+  }
+  return pyramid;
+}
+
+absl::Status OhlcPyramid::WriteToBinaryFile(
+    const std::string& file_name) const {
+  BinaryHistoryWriter writer;
+  for (const Level& level : levels_) {
+    writer.AddOhlcHistory(
+        level.ohlc_history.ToOhlcHistory(0, level.ohlc_history.size()),
+        level.sampling_rate_sec);
+  }
+  return writer.WriteToFile(file_name);
+}
+
+}  // namespace trader
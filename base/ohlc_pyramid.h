@@ -0,0 +1,75 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef BASE_OHLC_PYRAMID_H
+#define BASE_OHLC_PYRAMID_H
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "base/base.h"
+#include "base/binary_history.h"
+#include "base/columnar_history.h"
+
+namespace trader {
+
+// Aggregates the OHLC history into the coarser OHLC ticks with the given
+// sampling rate (in seconds), which needs to be a multiple of the sampling
+// rate of the ohlc_history. Zero volume OHLC ticks are treated as gaps in the
+// history, i.e. they do not contribute to the prices of the coarser OHLC tick
+// (unless the whole coarser OHLC tick has zero volume). Missing OHLC ticks are
+// filled in the same way as by Resample. Note that Resample does include the
+// prices of zero volume price records, so aggregating the resampled price
+// history is equivalent to resampling the price history with the coarser
+// sampling rate only if all price records have a positive volume.
+OhlcHistory AggregateOhlcHistory(const ColumnarOhlcHistory& ohlc_history,
+                                 int sampling_rate_sec);
+
+// Multi-resolution OHLC history. The first (base) level has the finest
+// sampling rate, every next level has a sampling rate that is a multiple of
+// the previous one (e.g. 1m -> 5m -> 15m -> 1h -> 1d). Coarser levels are
+// aggregated exactly from the previous level (see AggregateOhlcHistory).
+// The pyramid is stored as a binary history file with one OHLC section per
+// level. The levels are immutable (and thread-safe for reading).
+class OhlcPyramid {
+ public:
+  OhlcPyramid() {}
+
+  // Builds the pyramid from the base_ohlc_history (with the given sampling
+  // rate) and the (increasing) sampling rates of the coarser levels.
+  static absl::StatusOr<OhlcPyramid> Build(
+      const OhlcHistory& base_ohlc_history, int base_sampling_rate_sec,
+      const std::vector<int>& sampling_rates_sec);
+
+  // Returns the pyramid consisting of all OHLC sections of the binary history
+  // file (ordered by their sampling rates). Does not copy the OHLC ticks.
+  static absl::StatusOr<OhlcPyramid> FromBinaryHistoryFile(
+      const BinaryHistoryFile& history_file);
+
+  // Writes all levels (as OHLC sections) into the binary history file.
+  absl::Status WriteToBinaryFile(const std::string& file_name) const;
+
+  // Returns the number of levels.
+  size_t num_levels() const { return levels_.size(); }
+  // Returns the sampling rate (in seconds) of the given level.
+  int sampling_rate_sec(size_t level) const {
+    return levels_.at(level).sampling_rate_sec;
+  }
+  // Returns the OHLC history of the given level.
+  const ColumnarOhlcHistory& ohlc_history(size_t level) const {
+    return levels_.at(level).ohlc_history;
+  }
+
+ private:
+  struct Level {
+    int sampling_rate_sec = 0;
+    ColumnarOhlcHistory ohlc_history;
+  };
+
+  std::vector<Level> levels_;
+};
+
+}  // namespace trader
+
+#endif  // BASE_OHLC_PYRAMID_H
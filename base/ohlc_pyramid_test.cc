@@ -0,0 +1,180 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/ohlc_pyramid.h"
+
+#include "base/history.h"
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+void AddOhlcTick(int64_t timestamp_sec, float open, float high, float low,
+                 float close, float volume, OhlcHistory& ohlc_history) {
+  ohlc_history.emplace_back();
+  ohlc_history.back().set_timestamp_sec(timestamp_sec);
+  ohlc_history.back().set_open(open);
+  ohlc_history.back().set_high(high);
+  ohlc_history.back().set_low(low);
+  ohlc_history.back().set_close(close);
+  ohlc_history.back().set_volume(volume);
+}
+
+void ExpectOhlcTickEq(const OhlcTickView& actual, const OhlcTick& expected) {
+  EXPECT_EQ(actual.timestamp_sec(), expected.timestamp_sec());
+  EXPECT_FLOAT_EQ(actual.open(), expected.open());
+  EXPECT_FLOAT_EQ(actual.high(), expected.high());
+  EXPECT_FLOAT_EQ(actual.low(), expected.low());
+  EXPECT_FLOAT_EQ(actual.close(), expected.close());
+  EXPECT_FLOAT_EQ(actual.volume(), expected.volume());
+}
+
+void ExpectOhlcHistoryEq(const ColumnarOhlcHistory& actual,
+                         const OhlcHistory& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ExpectOhlcTickEq(actual[i], expected[i]);
+  }
+}
+
+// Returns the price history (with gaps) with num_records price records.
+PriceHistory GetPriceHistory(int num_records) {
+  PriceHistory price_history;
+  for (int i = 0; i < num_records; ++i) {
+    price_history.emplace_back();
+    // There is a 2 hour gap after every 200 price records.
+    price_history.back().set_timestamp_sec(1483228800 + 47 * i +
+                                           7200 * (i / 200));
+    price_history.back().set_price(1000.0f + (i * 37) % 101 - 50.0f);
+    price_history.back().set_volume(1.0f + (i % 5));
+  }
+  return price_history;
+}
+}  // namespace
+
+TEST(AggregateOhlcHistoryTest, Basic) {
+  OhlcHistory ohlc_history;
+  AddOhlcTick(1483228800, 100, 150, 80, 120, 1000, ohlc_history);
+  AddOhlcTick(1483229100, 120, 180, 100, 150, 500, ohlc_history);
+  AddOhlcTick(1483229400, 150, 150, 150, 150, 0, ohlc_history);
+  AddOhlcTick(1483229700, 150, 250, 140, 140, 2000, ohlc_history);
+  AddOhlcTick(1483232400, 140, 150, 80, 100, 1500, ohlc_history);
+  const OhlcHistory aggregated_ohlc_history = AggregateOhlcHistory(
+      ColumnarOhlcHistory(ohlc_history), /*sampling_rate_sec=*/900);
+  OhlcHistory expected_ohlc_history;
+  AddOhlcTick(1483228800, 100, 180, 80, 150, 1500, expected_ohlc_history);
+  AddOhlcTick(1483229700, 150, 250, 140, 140, 2000, expected_ohlc_history);
+  AddOhlcTick(1483230600, 140, 140, 140, 140, 0, expected_ohlc_history);
+  AddOhlcTick(1483231500, 140, 140, 140, 140, 0, expected_ohlc_history);
+  AddOhlcTick(1483232400, 140, 150, 80, 100, 1500, expected_ohlc_history);
+  ExpectOhlcHistoryEq(ColumnarOhlcHistory(aggregated_ohlc_history),
+                      expected_ohlc_history);
+}
+
+TEST(AggregateOhlcHistoryTest, ZeroVolumeTicksIgnored) {
+  OhlcHistory ohlc_history;
+  AddOhlcTick(1483228800, 100, 100, 100, 100, 0, ohlc_history);
+  AddOhlcTick(1483229100, 120, 180, 110, 150, 500, ohlc_history);
+  AddOhlcTick(1483229400, 150, 150, 150, 150, 0, ohlc_history);
+  const OhlcHistory aggregated_ohlc_history = AggregateOhlcHistory(
+      ColumnarOhlcHistory(ohlc_history), /*sampling_rate_sec=*/900);
+  OhlcHistory expected_ohlc_history;
+  AddOhlcTick(1483228800, 120, 180, 110, 150, 500, expected_ohlc_history);
+  ExpectOhlcHistoryEq(ColumnarOhlcHistory(aggregated_ohlc_history),
+                      expected_ohlc_history);
+}
+
+TEST(AggregateOhlcHistoryTest, SameAsResample) {
+  const PriceHistory price_history = GetPriceHistory(5000);
+  const OhlcHistory ohlc_history_1min =
+      Resample(price_history.begin(), price_history.end(), 60);
+  for (const int sampling_rate_sec : {300, 900, 3600, 86400}) {
+    const OhlcHistory expected_ohlc_history = Resample(
+        price_history.begin(), price_history.end(), sampling_rate_sec);
+    ExpectOhlcHistoryEq(
+        ColumnarOhlcHistory(AggregateOhlcHistory(
+            ColumnarOhlcHistory(ohlc_history_1min), sampling_rate_sec)),
+        expected_ohlc_history);
+  }
+}
+
+TEST(OhlcPyramidTest, Build) {
+  const PriceHistory price_history = GetPriceHistory(5000);
+  const OhlcHistory ohlc_history_1min =
+      Resample(price_history.begin(), price_history.end(), 60);
+  const absl::StatusOr<OhlcPyramid> pyramid_status = OhlcPyramid::Build(
+      ohlc_history_1min, /*base_sampling_rate_sec=*/60,
+      /*sampling_rates_sec=*/{300, 900, 3600, 86400});
+  ASSERT_TRUE(pyramid_status.ok()) << pyramid_status.status();
+  const OhlcPyramid& pyramid = pyramid_status.value();
+  ASSERT_EQ(pyramid.num_levels(), 5);
+  EXPECT_EQ(pyramid.sampling_rate_sec(0), 60);
+  ExpectOhlcHistoryEq(pyramid.ohlc_history(0), ohlc_history_1min);
+  const int expected_sampling_rates_sec[] = {60, 300, 900, 3600, 86400};
+  for (size_t level = 1; level < pyramid.num_levels(); ++level) {
+    EXPECT_EQ(pyramid.sampling_rate_sec(level),
+              expected_sampling_rates_sec[level]);
+    ExpectOhlcHistoryEq(
+        pyramid.ohlc_history(level),
+        Resample(price_history.begin(), price_history.end(),
+                 expected_sampling_rates_sec[level]));
+  }
+}
+
+TEST(OhlcPyramidTest, InvalidSamplingRates) {
+  OhlcHistory ohlc_history;
+  AddOhlcTick(1483228800, 100, 150, 80, 120, 1000, ohlc_history);
+  EXPECT_FALSE(OhlcPyramid::Build(ohlc_history, /*base_sampling_rate_sec=*/0,
+                                  /*sampling_rates_sec=*/{})
+                   .ok());
+  EXPECT_FALSE(OhlcPyramid::Build(ohlc_history, /*base_sampling_rate_sec=*/300,
+                                  /*sampling_rates_sec=*/{600, 900})
+                   .ok());
+  EXPECT_FALSE(OhlcPyramid::Build(ohlc_history, /*base_sampling_rate_sec=*/300,
+                                  /*sampling_rates_sec=*/{300})
+                   .ok());
+  EXPECT_TRUE(OhlcPyramid::Build(ohlc_history, /*base_sampling_rate_sec=*/300,
+                                 /*sampling_rates_sec=*/{})
+                  .ok());
+}
+
+TEST(OhlcPyramidTest, WriteAndReadBinaryFile) {
+  const PriceHistory price_history = GetPriceHistory(2000);
+  const absl::StatusOr<OhlcPyramid> pyramid_status = OhlcPyramid::Build(
+      Resample(price_history.begin(), price_history.end(), 300),
+      /*base_sampling_rate_sec=*/300,
+      /*sampling_rates_sec=*/{3600, 86400});
+  ASSERT_TRUE(pyramid_status.ok());
+  const OhlcPyramid& pyramid = pyramid_status.value();
+  const std::string file_name = ::testing::TempDir() + "ohlc_pyramid_test.bin";
+  ASSERT_TRUE(pyramid.WriteToBinaryFile(file_name).ok());
+
+  const absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(file_name);
+  ASSERT_TRUE(history_file_status.ok());
+  const absl::StatusOr<OhlcPyramid> read_pyramid_status =
+      OhlcPyramid::FromBinaryHistoryFile(history_file_status.value());
+  ASSERT_TRUE(read_pyramid_status.ok()) << read_pyramid_status.status();
+  const OhlcPyramid& read_pyramid = read_pyramid_status.value();
+  ASSERT_EQ(read_pyramid.num_levels(), 3);
+  for (size_t level = 0; level < pyramid.num_levels(); ++level) {
+    EXPECT_EQ(read_pyramid.sampling_rate_sec(level),
+              pyramid.sampling_rate_sec(level));
+    const ColumnarOhlcHistory& ohlc_history = pyramid.ohlc_history(level);
+    ExpectOhlcHistoryEq(read_pyramid.ohlc_history(level),
+                        ohlc_history.ToOhlcHistory(0, ohlc_history.size()));
+  }
+}
+
+TEST(OhlcPyramidTest, FromBinaryHistoryFileWithoutOhlcSection) {
+  BinaryHistoryWriter writer;
+  writer.AddPriceHistory(GetPriceHistory(10));
+  const std::string file_name =
+      ::testing::TempDir() + "ohlc_pyramid_price_test.bin";
+  ASSERT_TRUE(writer.WriteToFile(file_name).ok());
+  const absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(file_name);
+  ASSERT_TRUE(history_file_status.ok());
+  EXPECT_FALSE(
+      OhlcPyramid::FromBinaryHistoryFile(history_file_status.value()).ok());
+}
+
+}  // namespace trader
@@ -0,0 +1,33 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/order.h"
+
+namespace trader {
+
+OrderSpec ToOrderSpec(const Order& order) {
+  if (order.oneof_amount_case() == Order::kBaseAmount) {
+    return OrderSpec::Base(order.type(), order.side(), order.base_amount(),
+                           order.price());
+  }
+  assert(order.oneof_amount_case() == Order::kQuoteAmount);
+  return OrderSpec::Quote(order.type(), order.side(), order.quote_amount(),
+                          order.price());
+}
+
+Order ToOrder(const OrderSpec& order_spec) {
+  Order order;
+  order.set_type(order_spec.type);
+  order.set_side(order_spec.side);
+  if (order_spec.amount_kind == OrderSpec::AmountKind::kBase) {
+    order.set_base_amount(order_spec.amount);
+  } else {
+    assert(order_spec.amount_kind == OrderSpec::AmountKind::kQuote);
+    order.set_quote_amount(order_spec.amount);
+  }
+  if (order_spec.price != 0) {
+    order.set_price(order_spec.price);
+  }
+  return order;
+}
+
+}  // namespace trader
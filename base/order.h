@@ -0,0 +1,108 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef BASE_ORDER_H
+#define BASE_ORDER_H
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include "base/base.h"
+
+namespace trader {
+
+// Compact (trivially-copyable) representation of an exchange order.
+// Carries the same information as the Order proto message, but can be
+// emitted and executed without any allocations or has-bit checks.
+// The Order proto message is used only for logging.
+struct OrderSpec {
+  // Determines whether the amount is in base (crypto) or quote currency.
+  enum class AmountKind : uint8_t {
+    kBase,   // Amount in base (crypto) currency.
+    kQuote,  // Amount in quote currency.
+  };
+
+  // Returns the order of the given type and side for the base amount.
+  static OrderSpec Base(Order::Type type, Order::Side side, float base_amount,
+                        float price = 0) {
+    return {type, side, AmountKind::kBase, base_amount, price};
+  }
+  // Returns the order of the given type and side for the quote amount.
+  static OrderSpec Quote(Order::Type type, Order::Side side, float quote_amount,
+                         float price = 0) {
+    return {type, side, AmountKind::kQuote, quote_amount, price};
+  }
+
+  // Order type (market, stop, or limit).
+  Order::Type type;
+  // Order side (buy or sell).
+  Order::Side side;
+  // Determines the currency of the amount below.
+  AmountKind amount_kind;
+  // Positive amount (in base or quote currency, see amount_kind).
+  float amount;
+  // Positive target price. Ignored (and zero) for market orders.
+  float price;
+};
+static_assert(std::is_trivially_copyable<OrderSpec>::value,
+              "OrderSpec must be trivially copyable");
+
+// Returns the OrderSpec equivalent to the given (valid) order.
+OrderSpec ToOrderSpec(const Order& order);
+
+// Returns the Order proto message equivalent to the given order_spec.
+Order ToOrder(const OrderSpec& order_spec);
+
+// Buffer of orders emitted by a trader on a single OHLC tick with an inline
+// capacity. Traders emit only a handful of orders per OHLC tick, so the buffer
+// does not allocate unless more than kCapacity orders are emitted (in which
+// case all orders are moved to the heap).
+class OrderBuffer {
+ public:
+  // Maximum number of orders in the buffer without allocations.
+  static constexpr size_t kCapacity = 8;
+
+  OrderBuffer() {}
+
+  // Returns the number of orders in the buffer.
+  size_t size() const { return size_; }
+  // Returns true iff the buffer contains no orders.
+  bool empty() const { return size_ == 0; }
+  // Removes all orders from the buffer.
+  void clear() {
+    size_ = 0;
+    overflow_orders_.clear();
+  }
+
+  // Adds the order to the buffer.
+  void push_back(const OrderSpec& order) {
+    if (size_ < kCapacity) {
+      orders_[size_++] = order;
+      return;
+    }
+    if (overflow_orders_.empty()) {
+      overflow_orders_.assign(orders_.begin(), orders_.end());
+    }
+    overflow_orders_.push_back(order);
+    ++size_;
+  }
+
+  const OrderSpec& operator[](size_t index) const {
+    assert(index < size_);
+    return begin()[index];
+  }
+  const OrderSpec* begin() const {
+    return size_ <= kCapacity ? orders_.data() : overflow_orders_.data();
+  }
+  const OrderSpec* end() const { return begin() + size_; }
+
+ private:
+  std::array<OrderSpec, kCapacity> orders_;
+  // All orders of the buffer (iff there are more than kCapacity of them).
+  std::vector<OrderSpec> overflow_orders_;
+  size_t size_ = 0;
+};
+
+}  // namespace trader
+
+#endif  // BASE_ORDER_H
@@ -0,0 +1,104 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/order.h"
+
+#include "gtest/gtest.h"
+
+namespace trader {
+
+TEST(ToOrderSpecTest, BaseAmount) {
+  Order order;
+  order.set_type(Order::STOP);
+  order.set_side(Order::SELL);
+  order.set_base_amount(1.5f);
+  order.set_price(100.0f);
+  const OrderSpec order_spec = ToOrderSpec(order);
+  EXPECT_EQ(order_spec.type, Order::STOP);
+  EXPECT_EQ(order_spec.side, Order::SELL);
+  EXPECT_EQ(order_spec.amount_kind, OrderSpec::AmountKind::kBase);
+  EXPECT_FLOAT_EQ(order_spec.amount, 1.5f);
+  EXPECT_FLOAT_EQ(order_spec.price, 100.0f);
+}
+
+TEST(ToOrderSpecTest, QuoteAmount) {
+  Order order;
+  order.set_type(Order::MARKET);
+  order.set_side(Order::BUY);
+  order.set_quote_amount(250.0f);
+  const OrderSpec order_spec = ToOrderSpec(order);
+  EXPECT_EQ(order_spec.type, Order::MARKET);
+  EXPECT_EQ(order_spec.side, Order::BUY);
+  EXPECT_EQ(order_spec.amount_kind, OrderSpec::AmountKind::kQuote);
+  EXPECT_FLOAT_EQ(order_spec.amount, 250.0f);
+  EXPECT_FLOAT_EQ(order_spec.price, 0.0f);
+}
+
+TEST(ToOrderTest, RoundTrip) {
+  const OrderSpec limit_order =
+      OrderSpec::Quote(Order::LIMIT, Order::BUY, /*quote_amount=*/10.0f,
+                       /*price=*/20.0f);
+  Order order = ToOrder(limit_order);
+  EXPECT_EQ(order.type(), Order::LIMIT);
+  EXPECT_EQ(order.side(), Order::BUY);
+  EXPECT_EQ(order.oneof_amount_case(), Order::kQuoteAmount);
+  EXPECT_FLOAT_EQ(order.quote_amount(), 10.0f);
+  EXPECT_FLOAT_EQ(order.price(), 20.0f);
+  EXPECT_EQ(ToOrder(ToOrderSpec(order)).SerializeAsString(),
+            order.SerializeAsString());
+
+  const OrderSpec market_order =
+      OrderSpec::Base(Order::MARKET, Order::SELL, /*base_amount=*/2.0f);
+  order = ToOrder(market_order);
+  EXPECT_EQ(order.type(), Order::MARKET);
+  EXPECT_EQ(order.side(), Order::SELL);
+  EXPECT_EQ(order.oneof_amount_case(), Order::kBaseAmount);
+  EXPECT_FLOAT_EQ(order.base_amount(), 2.0f);
+  EXPECT_FALSE(order.has_price());
+}
+
+TEST(OrderBufferTest, PushBackAndClear) {
+  OrderBuffer orders;
+  EXPECT_TRUE(orders.empty());
+  EXPECT_EQ(orders.size(), 0);
+  for (size_t i = 0; i < OrderBuffer::kCapacity; ++i) {
+    orders.push_back(OrderSpec::Base(Order::LIMIT, Order::SELL,
+                                     /*base_amount=*/1.0f + i,
+                                     /*price=*/100.0f));
+  }
+  EXPECT_FALSE(orders.empty());
+  EXPECT_EQ(orders.size(), OrderBuffer::kCapacity);
+  float expected_amount = 1.0f;
+  for (const OrderSpec& order : orders) {
+    EXPECT_FLOAT_EQ(order.amount, expected_amount);
+    expected_amount += 1.0f;
+  }
+  EXPECT_FLOAT_EQ(orders[2].amount, 3.0f);
+  orders.clear();
+  EXPECT_TRUE(orders.empty());
+  EXPECT_EQ(orders.begin(), orders.end());
+}
+
+TEST(OrderBufferTest, PushBackBeyondCapacity) {
+  OrderBuffer orders;
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < 2 * OrderBuffer::kCapacity + 1; ++i) {
+      orders.push_back(OrderSpec::Base(Order::LIMIT, Order::SELL,
+                                       /*base_amount=*/1.0f + i,
+                                       /*price=*/100.0f));
+    }
+    EXPECT_EQ(orders.size(), 2 * OrderBuffer::kCapacity + 1);
+    EXPECT_EQ(orders.end() - orders.begin(), 2 * OrderBuffer::kCapacity + 1);
+    float expected_amount = 1.0f;
+    for (const OrderSpec& order : orders) {
+      EXPECT_FLOAT_EQ(order.amount, expected_amount);
+      expected_amount += 1.0f;
+    }
+    EXPECT_FLOAT_EQ(orders[OrderBuffer::kCapacity].amount,
+                    1.0f + OrderBuffer::kCapacity);
+    orders.clear();
+    EXPECT_TRUE(orders.empty());
+    EXPECT_EQ(orders.begin(), orders.end());
+  }
+}
+
+}  // namespace trader
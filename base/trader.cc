@@ -0,0 +1,31 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/trader.h"
+
+namespace trader {
+
+void Trader::UpdateAndEmit(const OhlcTick& ohlc_tick,
+                           const std::vector<float>& side_input_signals,
+                           float base_balance, float quote_balance,
+                           OrderBuffer& orders) {
+  std::vector<Order> proto_orders;
+  Update(ohlc_tick, side_input_signals, base_balance, quote_balance,
+         proto_orders);
+  for (const Order& order : proto_orders) {
+    orders.push_back(ToOrderSpec(order));
+  }
+}
+
+void OrderBufferTrader::Update(const OhlcTick& ohlc_tick,
+                               const std::vector<float>& side_input_signals,
+                               float base_balance, float quote_balance,
+                               std::vector<Order>& orders) {
+  OrderBuffer order_buffer;
+  UpdateAndEmit(ohlc_tick, side_input_signals, base_balance, quote_balance,
+                order_buffer);
+  for (const OrderSpec& order : order_buffer) {
+    orders.push_back(ToOrder(order));
+  }
+}
+
+}  // namespace trader
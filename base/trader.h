@@ -4,9 +4,24 @@
 #define BASE_TRADER_H
 
 #include "base/base.h"
+#include "base/order.h"
 
 namespace trader {
 
+class IndicatorRegistry;
+
+// Column of the structured internal trader state (see Trader::GetState).
+struct TraderStateColumn {
+  // Name of the column.
+  std::string name;
+  // Names of the values of an enum column (the column value is the index of
+  // the enum value), or empty for a numeric column.
+  std::vector<std::string> enum_values;
+};
+
+// Schema (fixed list of columns) of the structured internal trader state.
+using TraderStateSchema = std::vector<TraderStateColumn>;
+
 // The trader is executed as follows:
 // - At every step the trader receives the latest OHLC tick T[i], some
 //   additional side input signals (possibly an empty vector), and current
@@ -54,10 +69,54 @@ class Trader {
                       float base_balance, float quote_balance,
                       std::vector<Order>& orders) = 0;
 
+  // The same method as Update above, but emits the orders in the compact
+  // representation into the (empty) order buffer. This is the method called
+  // by the exchange on every OHLC tick. The default implementation calls
+  // Update (above) and converts the emitted Order proto messages.
+  // Performance-critical traders should derive from OrderBufferTrader (below)
+  // and emit the orders without any allocations.
+  virtual void UpdateAndEmit(const OhlcTick& ohlc_tick,
+                             const std::vector<float>& side_input_signals,
+                             float base_balance, float quote_balance,
+                             OrderBuffer& orders);
+
   // Returns the internal trader state (as a string).
   // Note that it is recommended to represent the internal state as a string of
   // (fixed number of) comma-separated values for easier analysis.
   virtual std::string GetInternalState() const = 0;
+
+  // Returns the schema of the structured internal trader state exported by
+  // GetState (below). Called once per trader (before logging its state).
+  // Returns an empty schema if the trader exports its internal state only as
+  // a string (via GetInternalState).
+  virtual TraderStateSchema GetStateSchema() const { return {}; }
+
+  // Writes the internal trader state (one value per column of the schema,
+  // the index of the enum value for the enum columns) into the provided
+  // buffer. When the trader exports the structured state, this method is
+  // called instead of GetInternalState on every OHLC tick (when logging), so
+  // it should not allocate.
+  virtual void GetState(float* state) const {}
+};
+
+// Trader emitting the orders in the compact representation (without any
+// allocations), i.e. implementing UpdateAndEmit instead of Update.
+class OrderBufferTrader : public Trader {
+ public:
+  OrderBufferTrader() {}
+  virtual ~OrderBufferTrader() {}
+
+  // Calls UpdateAndEmit (below) and converts the emitted orders into Order
+  // proto messages.
+  void Update(const OhlcTick& ohlc_tick,
+              const std::vector<float>& side_input_signals, float base_balance,
+              float quote_balance, std::vector<Order>& orders) override;
+
+  // See Trader::UpdateAndEmit.
+  void UpdateAndEmit(const OhlcTick& ohlc_tick,
+                     const std::vector<float>& side_input_signals,
+                     float base_balance, float quote_balance,
+                     OrderBuffer& orders) override = 0;
 };
 
 // Usually we want to evaluate the same trader over different time periods.
@@ -74,6 +133,18 @@ class TraderEmitter {
 
   // Returns a new (freshly initialized) instance of a trader.
   virtual std::unique_ptr<Trader> NewTrader() const = 0;
+
+  // Returns a new (freshly initialized) instance of a trader that reads its
+  // indicators from the given registry (shared by all traders executed in
+  // lockstep, e.g. in a batch). The registry is updated on every OHLC tick
+  // before the trader, and it outlives the trader. Traders that do not use
+  // any (shareable) indicators do not need to override this method.
+  // Note that emitters overriding this method need to add
+  // "using TraderEmitter::NewTrader;" to keep the above overload visible.
+  virtual std::unique_ptr<Trader> NewTrader(
+      IndicatorRegistry& indicator_registry) const {
+    return NewTrader();
+  }
 };
 
 }  // namespace trader
@@ -0,0 +1,107 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "absl/strings/str_format.h"
+#include "base/account.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_util.h"
+
+namespace trader {
+namespace {
+// Number of distinct OHLC ticks the orders are executed over.
+constexpr size_t kNumOhlcTicks = 1024;
+
+// Returns the order of the given type and side (with the price relative to
+// the ohlc_tick opening price, so that most of the orders get executed).
+Order GetOrder(Order::Type type, Order::Side side, const OhlcTick& ohlc_tick) {
+  Order order;
+  order.set_type(type);
+  order.set_side(side);
+  if (side == Order::BUY) {
+    order.set_quote_amount(10.0f);
+  } else {
+    order.set_base_amount(0.01f);
+  }
+  const bool above_open = (type == Order::STOP) == (side == Order::BUY);
+  if (type != Order::MARKET) {
+    order.set_price(ohlc_tick.open() * (above_open ? 1.001f : 0.999f));
+  }
+  return order;
+}
+
+// Benchmarks Account::ExecuteOrder for the order type state.range(0) and
+// the order side state.range(1).
+void BM_ExecuteOrder(benchmark::State& state) {
+  const Order::Type type = static_cast<Order::Type>(state.range(0));
+  const Order::Side side = static_cast<Order::Side>(state.range(1));
+  state.SetLabel(absl::StrFormat("%s %s", Order::Type_Name(type),
+                                 Order::Side_Name(side)));
+  AccountConfig account_config = GetBenchmarkAccountConfig();
+  account_config.set_start_base_balance(100.0f);
+  account_config.set_start_quote_balance(100000.0f);
+  const OhlcHistory ohlc_history =
+      GetSyntheticOhlcHistory(kNumOhlcTicks, /*period_size_sec=*/300);
+  std::vector<Order> orders;
+  orders.reserve(kNumOhlcTicks);
+  for (const OhlcTick& ohlc_tick : ohlc_history) {
+    orders.push_back(GetOrder(type, side, ohlc_tick));
+  }
+  Account account;
+  int64_t num_executed = 0;
+  for (auto _ : state) {
+    // The account is reset for every pass, so that it never runs out of funds.
+    account.InitAccount(account_config);
+    for (size_t i = 0; i < kNumOhlcTicks; ++i) {
+      num_executed +=
+          account.ExecuteOrder(account_config, orders[i], ohlc_history[i]);
+    }
+    benchmark::DoNotOptimize(account.base_balance);
+    benchmark::DoNotOptimize(account.quote_balance);
+  }
+  const int64_t num_orders = state.iterations() * kNumOhlcTicks;
+  state.counters["executed"] =
+      static_cast<double>(num_executed) / std::max<int64_t>(1, num_orders);
+  state.SetItemsProcessed(num_orders);
+  state.SetBytesProcessed(num_orders * kOhlcTickBytes);
+}
+BENCHMARK(BM_ExecuteOrder)
+    ->ArgsProduct({{Order::MARKET, Order::STOP, Order::LIMIT},
+                   {Order::BUY, Order::SELL}});
+
+// Benchmarks Account::ExecuteOrder over the compact OrderSpec (with the fee
+// coefficients resolved in InitAccount) for the order type state.range(0) and
+// the order side state.range(1).
+void BM_ExecuteOrderSpec(benchmark::State& state) {
+  const Order::Type type = static_cast<Order::Type>(state.range(0));
+  const Order::Side side = static_cast<Order::Side>(state.range(1));
+  state.SetLabel(absl::StrFormat("%s %s", Order::Type_Name(type),
+                                 Order::Side_Name(side)));
+  AccountConfig account_config = GetBenchmarkAccountConfig();
+  account_config.set_start_base_balance(100.0f);
+  account_config.set_start_quote_balance(100000.0f);
+  const OhlcHistory ohlc_history =
+      GetSyntheticOhlcHistory(kNumOhlcTicks, /*period_size_sec=*/300);
+  std::vector<OrderSpec> orders;
+  orders.reserve(kNumOhlcTicks);
+  for (const OhlcTick& ohlc_tick : ohlc_history) {
+    orders.push_back(ToOrderSpec(GetOrder(type, side, ohlc_tick)));
+  }
+  Account account;
+  for (auto _ : state) {
+    account.InitAccount(account_config);
+    for (size_t i = 0; i < kNumOhlcTicks; ++i) {
+      benchmark::DoNotOptimize(
+          account.ExecuteOrder(orders[i], ohlc_history[i]));
+    }
+    benchmark::DoNotOptimize(account.base_balance);
+    benchmark::DoNotOptimize(account.quote_balance);
+  }
+  const int64_t num_orders = state.iterations() * kNumOhlcTicks;
+  state.SetItemsProcessed(num_orders);
+  state.SetBytesProcessed(num_orders * kOhlcTickBytes);
+}
+BENCHMARK(BM_ExecuteOrderSpec)
+    ->ArgsProduct({{Order::MARKET, Order::STOP, Order::LIMIT},
+                   {Order::BUY, Order::SELL}});
+
+}  // namespace
+}  // namespace trader
@@ -0,0 +1,91 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "benchmarks/benchmark_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace trader {
+namespace {
+// Seed of the pseudo-random generator (so that all runs see the same data).
+constexpr unsigned int kSeed = 1234567;
+}  // namespace
+
+PriceHistory GetSyntheticPriceHistory(size_t num_records,
+                                      int record_spacing_sec) {
+  std::mt19937 generator(kSeed);
+  std::normal_distribution<float> log_return(0.0f, 0.001f);
+  std::exponential_distribution<float> volume(1.0f);
+  PriceHistory price_history;
+  price_history.reserve(num_records);
+  float price = 1000.0f;
+  for (size_t i = 0; i < num_records; ++i) {
+    price *= std::exp(log_return(generator));
+    price_history.emplace_back();
+    PriceRecord& price_record = price_history.back();
+    price_record.set_timestamp_sec(kBenchmarkStartTimestampSec +
+                                   i * record_spacing_sec);
+    price_record.set_price(price);
+    price_record.set_volume(volume(generator));
+  }
+  return price_history;
+}
+
+OhlcHistory GetSyntheticOhlcHistory(size_t num_ticks, int period_size_sec) {
+  std::mt19937 generator(kSeed);
+  std::normal_distribution<float> log_return(0.0f, 0.002f);
+  std::uniform_real_distribution<float> wick(0.0f, 0.002f);
+  std::exponential_distribution<float> volume(0.1f);
+  OhlcHistory ohlc_history;
+  ohlc_history.reserve(num_ticks);
+  float open = 1000.0f;
+  for (size_t i = 0; i < num_ticks; ++i) {
+    const float close = open * std::exp(log_return(generator));
+    ohlc_history.emplace_back();
+    OhlcTick& ohlc_tick = ohlc_history.back();
+    ohlc_tick.set_timestamp_sec(kBenchmarkStartTimestampSec +
+                                i * period_size_sec);
+    ohlc_tick.set_open(open);
+    ohlc_tick.set_high(std::max(open, close) * (1.0f + wick(generator)));
+    ohlc_tick.set_low(std::min(open, close) * (1.0f - wick(generator)));
+    ohlc_tick.set_close(close);
+    ohlc_tick.set_volume(volume(generator));
+    open = close;
+  }
+  return ohlc_history;
+}
+
+SideHistory GetSyntheticSideHistory(size_t num_records, int record_spacing_sec,
+                                    int num_signals) {
+  std::mt19937 generator(kSeed);
+  std::uniform_real_distribution<float> signal(0.0f, 1.0f);
+  SideHistory side_history;
+  side_history.reserve(num_records);
+  for (size_t i = 0; i < num_records; ++i) {
+    side_history.emplace_back();
+    SideInputRecord& side_input_record = side_history.back();
+    side_input_record.set_timestamp_sec(kBenchmarkStartTimestampSec +
+                                        i * record_spacing_sec);
+    for (int j = 0; j < num_signals; ++j) {
+      side_input_record.add_signal(signal(generator));
+    }
+  }
+  return side_history;
+}
+
+AccountConfig GetBenchmarkAccountConfig() {
+  AccountConfig config;
+  config.set_start_base_balance(1.0f);
+  config.set_start_quote_balance(0.0f);
+  config.set_base_unit(0.00001f);
+  config.set_quote_unit(0.01f);
+  config.mutable_market_order_fee_config()->set_relative_fee(0.005f);
+  config.mutable_limit_order_fee_config()->set_relative_fee(0.005f);
+  config.mutable_stop_order_fee_config()->set_relative_fee(0.005f);
+  config.set_market_liquidity(0.5f);
+  config.set_max_volume_ratio(0.5f);
+  return config;
+}
+
+}  // namespace trader
@@ -0,0 +1,38 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef BENCHMARKS_BENCHMARK_UTIL_H
+#define BENCHMARKS_BENCHMARK_UTIL_H
+
+#include "base/base.h"
+
+namespace trader {
+
+// Number of payload bytes of a single price record (timestamp, price, volume).
+constexpr size_t kPriceRecordBytes = sizeof(int64_t) + 2 * sizeof(float);
+// Number of payload bytes of a single OHLC tick (timestamp, OHLC, volume).
+constexpr size_t kOhlcTickBytes = sizeof(int64_t) + 5 * sizeof(float);
+
+// Start of the synthetic histories: 2017-01-01 00:00:00 UTC.
+constexpr int64_t kBenchmarkStartTimestampSec = 1483228800;
+
+// Returns a deterministic synthetic price history with num_records records
+// (spaced by record_spacing_sec seconds) following a random walk.
+PriceHistory GetSyntheticPriceHistory(size_t num_records,
+                                      int record_spacing_sec);
+
+// Returns a deterministic synthetic OHLC history with num_ticks consecutive
+// OHLC ticks (of period_size_sec seconds) following a random walk.
+OhlcHistory GetSyntheticOhlcHistory(size_t num_ticks, int period_size_sec);
+
+// Returns a synthetic side history with num_records records (spaced by
+// record_spacing_sec seconds), each with num_signals signals.
+SideHistory GetSyntheticSideHistory(size_t num_records, int record_spacing_sec,
+                                    int num_signals);
+
+// Returns the account configuration used by the benchmarks (the same as the
+// default account configuration of the trader binary).
+AccountConfig GetBenchmarkAccountConfig();
+
+}  // namespace trader
+
+#endif  // BENCHMARKS_BENCHMARK_UTIL_H
@@ -0,0 +1,129 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/columnar_history.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_util.h"
+#include "eval/eval.h"
+#include "traders/rebalancing_trader.h"
+#include "traders/stop_trader.h"
+
+namespace trader {
+namespace {
+// Number of OHLC ticks of the synthetic history.
+constexpr size_t kNumOhlcTicks = 1000000;
+
+// Returns the (shared) synthetic 5-minute OHLC history with 1M ticks.
+const OhlcHistory& GetOhlcHistory() {
+  static const OhlcHistory* ohlc_history = new OhlcHistory(
+      GetSyntheticOhlcHistory(kNumOhlcTicks, /*period_size_sec=*/300));
+  return *ohlc_history;
+}
+
+// Returns the (shared) columnar version of the OHLC history above.
+const ColumnarOhlcHistory& GetColumnarOhlcHistory() {
+  static const ColumnarOhlcHistory* ohlc_history =
+      new ColumnarOhlcHistory(GetOhlcHistory());
+  return *ohlc_history;
+}
+
+std::unique_ptr<Trader> NewStopTrader() {
+  StopTraderConfig trader_config;
+  trader_config.set_stop_order_margin(0.1f);
+  trader_config.set_stop_order_move_margin(0.1f);
+  trader_config.set_stop_order_increase_per_day(0.01f);
+  trader_config.set_stop_order_decrease_per_day(0.1f);
+  return std::unique_ptr<Trader>(new StopTrader(trader_config));
+}
+
+std::unique_ptr<Trader> NewRebalancingTrader() {
+  RebalancingTraderConfig trader_config;
+  trader_config.set_alpha(0.7f);
+  trader_config.set_epsilon(0.05f);
+  return std::unique_ptr<Trader>(new RebalancingTrader(trader_config));
+}
+
+// Benchmarks ExecuteTrader over the OhlcHistory. state.range(0) is fast_eval.
+void BM_ExecuteTrader(benchmark::State& state,
+                      std::unique_ptr<Trader> (*new_trader)()) {
+  const AccountConfig account_config = GetBenchmarkAccountConfig();
+  const OhlcHistory& ohlc_history = GetOhlcHistory();
+  for (auto _ : state) {
+    std::unique_ptr<Trader> trader = new_trader();
+    ExecutionResult result = ExecuteTrader(
+        account_config, ohlc_history.begin(), ohlc_history.end(),
+        /*side_input=*/nullptr, /*fast_eval=*/state.range(0) != 0, *trader,
+        /*logger=*/nullptr);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * ohlc_history.size());
+  state.SetBytesProcessed(state.iterations() * ohlc_history.size() *
+                          kOhlcTickBytes);
+}
+BENCHMARK_CAPTURE(BM_ExecuteTrader, StopTrader, &NewStopTrader)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExecuteTrader, RebalancingTrader, &NewRebalancingTrader)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmarks ExecuteTrader over the ColumnarOhlcHistory.
+// state.range(0) is fast_eval.
+void BM_ExecuteTraderColumnar(benchmark::State& state,
+                              std::unique_ptr<Trader> (*new_trader)()) {
+  const AccountConfig account_config = GetBenchmarkAccountConfig();
+  const ColumnarOhlcHistory& ohlc_history = GetColumnarOhlcHistory();
+  for (auto _ : state) {
+    std::unique_ptr<Trader> trader = new_trader();
+    ExecutionResult result =
+        ExecuteTrader(account_config, ohlc_history, /*begin_index=*/0,
+                      ohlc_history.size(), /*side_input=*/nullptr,
+                      /*fast_eval=*/state.range(0) != 0, *trader,
+                      /*logger=*/nullptr);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * ohlc_history.size());
+  state.SetBytesProcessed(state.iterations() * ohlc_history.size() *
+                          kOhlcTickBytes);
+}
+BENCHMARK_CAPTURE(BM_ExecuteTraderColumnar, StopTrader, &NewStopTrader)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExecuteTraderColumnar, RebalancingTrader,
+                  &NewRebalancingTrader)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmarks ExecuteTradersInLockstep over the ColumnarOhlcHistory with
+// state.range(0) stop traders executed within a single pass.
+void BM_ExecuteTradersInLockstep(benchmark::State& state) {
+  const AccountConfig account_config = GetBenchmarkAccountConfig();
+  const ColumnarOhlcHistory& ohlc_history = GetColumnarOhlcHistory();
+  const size_t num_traders = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    std::vector<std::unique_ptr<Trader>> traders;
+    for (size_t i = 0; i < num_traders; ++i) {
+      traders.push_back(NewStopTrader());
+    }
+    std::vector<ExecutionResult> results = ExecuteTradersInLockstep(
+        account_config, ohlc_history, /*begin_index=*/0, ohlc_history.size(),
+        /*side_input=*/nullptr, /*fast_eval=*/true, traders);
+    benchmark::DoNotOptimize(results.data());
+  }
+  // Every (trader, OHLC tick) pair is counted as a processed item.
+  state.SetItemsProcessed(state.iterations() * num_traders *
+                          ohlc_history.size());
+  state.SetBytesProcessed(state.iterations() * ohlc_history.size() *
+                          kOhlcTickBytes);
+}
+BENCHMARK(BM_ExecuteTradersInLockstep)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace trader
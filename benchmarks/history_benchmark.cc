@@ -0,0 +1,56 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/history.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_util.h"
+
+namespace trader {
+namespace {
+// Number of (1-minute) price records of the synthetic price history.
+constexpr size_t kNumPriceRecords = 1000000;
+
+// Returns the (shared) synthetic 1-minute price history.
+const PriceHistory& GetPriceHistory() {
+  static const PriceHistory* price_history = new PriceHistory(
+      GetSyntheticPriceHistory(kNumPriceRecords, /*record_spacing_sec=*/60));
+  return *price_history;
+}
+
+// Benchmarks Resample. state.range(0) is the sampling rate (in seconds).
+void BM_Resample(benchmark::State& state) {
+  const PriceHistory& price_history = GetPriceHistory();
+  for (auto _ : state) {
+    OhlcHistory ohlc_history =
+        Resample(price_history.begin(), price_history.end(),
+                 /*sampling_rate_sec=*/static_cast<int>(state.range(0)));
+    benchmark::DoNotOptimize(ohlc_history.data());
+  }
+  state.SetItemsProcessed(state.iterations() * price_history.size());
+  state.SetBytesProcessed(state.iterations() * price_history.size() *
+                          kPriceRecordBytes);
+}
+BENCHMARK(BM_Resample)
+    ->Arg(300)
+    ->Arg(3600)
+    ->Arg(86400)
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmarks RemoveOutliers (with the outlier indices being collected).
+void BM_RemoveOutliers(benchmark::State& state) {
+  const PriceHistory& price_history = GetPriceHistory();
+  std::vector<size_t> outlier_indices;
+  for (auto _ : state) {
+    outlier_indices.clear();
+    PriceHistory price_history_clean =
+        RemoveOutliers(price_history.begin(), price_history.end(),
+                       /*max_price_deviation_per_min=*/0.05f, &outlier_indices);
+    benchmark::DoNotOptimize(price_history_clean.data());
+  }
+  state.SetItemsProcessed(state.iterations() * price_history.size());
+  state.SetBytesProcessed(state.iterations() * price_history.size() *
+                          kPriceRecordBytes);
+}
+BENCHMARK(BM_RemoveOutliers)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace trader
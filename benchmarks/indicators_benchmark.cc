@@ -0,0 +1,238 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "base/columnar_history.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_util.h"
+#include "indicators/exponential_moving_average.h"
+#include "indicators/indicator_series.h"
+#include "indicators/last_n_ohlc_ticks.h"
+#include "indicators/moving_average_convergence_divergence.h"
+#include "indicators/relative_strength_index.h"
+#include "indicators/simple_moving_average.h"
+#include "indicators/stochastic_oscillator.h"
+#include "indicators/volatility.h"
+
+namespace trader {
+namespace {
+// Number of (5-minute) OHLC ticks fed to the indicators.
+constexpr size_t kNumOhlcTicks = 100000;
+
+// Returns the (shared) synthetic 5-minute OHLC history.
+const OhlcHistory& GetOhlcHistory() {
+  static const OhlcHistory* ohlc_history = new OhlcHistory(
+      GetSyntheticOhlcHistory(kNumOhlcTicks, /*period_size_sec=*/300));
+  return *ohlc_history;
+}
+
+// Returns the (shared) columnar version of the above OHLC history.
+const ColumnarOhlcHistory& GetColumnarOhlcHistory() {
+  static const ColumnarOhlcHistory* ohlc_history =
+      new ColumnarOhlcHistory(GetOhlcHistory());
+  return *ohlc_history;
+}
+
+// Feeds all OHLC ticks to the indicator (created by new_indicator for every
+// iteration) and reports the processed OHLC ticks (and bytes).
+// state.range(0) is the indicator period_size_sec. With 300 seconds every
+// OHLC tick starts a new period, with 3600 seconds most of the OHLC ticks
+// only update the last period.
+template <typename NewIndicator, typename UpdateIndicator>
+void RunIndicatorBenchmark(benchmark::State& state,
+                           NewIndicator new_indicator,
+                           UpdateIndicator update_indicator) {
+  const OhlcHistory& ohlc_history = GetOhlcHistory();
+  const int period_size_sec = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    // The indicators listen to their own LastNOhlcTicks (which keep a pointer
+    // to them), so they are allocated on the heap and never moved.
+    auto indicator = new_indicator(period_size_sec);
+    for (const OhlcTick& ohlc_tick : ohlc_history) {
+      update_indicator(*indicator, ohlc_tick);
+    }
+    benchmark::DoNotOptimize(indicator.get());
+  }
+  state.SetItemsProcessed(state.iterations() * ohlc_history.size());
+  state.SetBytesProcessed(state.iterations() * ohlc_history.size() *
+                          kOhlcTickBytes);
+}
+
+// Updates the indicator (that does not depend on the account balances).
+template <typename Indicator>
+void UpdateIndicator(Indicator& indicator, const OhlcTick& ohlc_tick) {
+  indicator.Update(ohlc_tick);
+}
+
+void BM_LastNOhlcTicks(benchmark::State& state) {
+  using LastNOhlcTicksT = LastNOhlcTicks<LastNOhlcTicksListener>;
+  LastNOhlcTicksListener listener;
+  RunIndicatorBenchmark(
+      state,
+      [&listener](int period_size_sec) {
+        return absl::make_unique<LastNOhlcTicksT>(
+            &listener, /*num_ohlc_ticks=*/20, period_size_sec);
+      },
+      UpdateIndicator<LastNOhlcTicksT>);
+}
+BENCHMARK(BM_LastNOhlcTicks)->Arg(300)->Arg(3600);
+
+void BM_SimpleMovingAverage(benchmark::State& state) {
+  RunIndicatorBenchmark(
+      state,
+      [](int period_size_sec) {
+        return absl::make_unique<SimpleMovingAverage>(/*num_ohlc_ticks=*/50,
+                                                      period_size_sec);
+      },
+      UpdateIndicator<SimpleMovingAverage>);
+}
+BENCHMARK(BM_SimpleMovingAverage)->Arg(300)->Arg(3600);
+
+void BM_ExponentialMovingAverage(benchmark::State& state) {
+  RunIndicatorBenchmark(
+      state,
+      [](int period_size_sec) {
+        return absl::make_unique<ExponentialMovingAverage>(
+            /*smoothing=*/2, /*ema_length=*/50, period_size_sec);
+      },
+      UpdateIndicator<ExponentialMovingAverage>);
+}
+BENCHMARK(BM_ExponentialMovingAverage)->Arg(300)->Arg(3600);
+
+void BM_MovingAverageConvergenceDivergence(benchmark::State& state) {
+  RunIndicatorBenchmark(
+      state,
+      [](int period_size_sec) {
+        return absl::make_unique<MovingAverageConvergenceDivergence>(
+            /*fast_length=*/12, /*slow_length=*/26, /*signal_smoothing=*/9,
+            period_size_sec);
+      },
+      UpdateIndicator<MovingAverageConvergenceDivergence>);
+}
+BENCHMARK(BM_MovingAverageConvergenceDivergence)->Arg(300)->Arg(3600);
+
+void BM_RelativeStrengthIndex(benchmark::State& state) {
+  RunIndicatorBenchmark(
+      state,
+      [](int period_size_sec) {
+        return absl::make_unique<RelativeStrengthIndex>(/*num_periods=*/14,
+                                                        period_size_sec);
+      },
+      UpdateIndicator<RelativeStrengthIndex>);
+}
+BENCHMARK(BM_RelativeStrengthIndex)->Arg(300)->Arg(3600);
+
+void BM_StochasticOscillator(benchmark::State& state) {
+  RunIndicatorBenchmark(
+      state,
+      [](int period_size_sec) {
+        return absl::make_unique<StochasticOscillator>(/*num_periods=*/14,
+                                                       period_size_sec);
+      },
+      UpdateIndicator<StochasticOscillator>);
+}
+BENCHMARK(BM_StochasticOscillator)->Arg(300)->Arg(3600);
+
+void BM_Volatility(benchmark::State& state) {
+  RunIndicatorBenchmark(
+      state,
+      [](int period_size_sec) {
+        return absl::make_unique<Volatility>(/*window_size=*/0,
+                                             period_size_sec);
+      },
+      [](Volatility& volatility, const OhlcTick& ohlc_tick) {
+        volatility.Update(ohlc_tick, /*base_balance=*/1.0f,
+                          /*quote_balance=*/0.0f);
+      });
+}
+BENCHMARK(BM_Volatility)->Arg(300)->Arg(3600);
+
+// Computes the whole indicator series (by compute_series) over the columnar
+// OHLC history and reports the processed OHLC ticks (and bytes), so that the
+// throughput is comparable with the streaming indicators above.
+template <typename ComputeSeries>
+void RunIndicatorSeriesBenchmark(benchmark::State& state,
+                                 ComputeSeries compute_series) {
+  const ColumnarOhlcHistory& ohlc_history = GetColumnarOhlcHistory();
+  std::vector<float> series_1(ohlc_history.size());
+  std::vector<float> series_2(ohlc_history.size());
+  std::vector<float> series_3(ohlc_history.size());
+  for (auto _ : state) {
+    compute_series(ohlc_history, absl::MakeSpan(series_1),
+                   absl::MakeSpan(series_2), absl::MakeSpan(series_3));
+    benchmark::DoNotOptimize(series_1.data());
+    benchmark::DoNotOptimize(series_2.data());
+    benchmark::DoNotOptimize(series_3.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ohlc_history.size());
+  state.SetBytesProcessed(state.iterations() * ohlc_history.size() *
+                          kOhlcTickBytes);
+}
+
+void BM_ComputeSimpleMovingAverage(benchmark::State& state) {
+  RunIndicatorSeriesBenchmark(
+      state, [](const ColumnarOhlcHistory& ohlc_history, absl::Span<float> sma,
+                absl::Span<float>, absl::Span<float>) {
+        ComputeSimpleMovingAverage(ohlc_history.close(), /*num_ohlc_ticks=*/50,
+                                   sma);
+      });
+}
+BENCHMARK(BM_ComputeSimpleMovingAverage);
+
+void BM_ComputeExponentialMovingAverage(benchmark::State& state) {
+  RunIndicatorSeriesBenchmark(
+      state, [](const ColumnarOhlcHistory& ohlc_history, absl::Span<float> ema,
+                absl::Span<float>, absl::Span<float>) {
+        ComputeExponentialMovingAverage(ohlc_history.close(), /*smoothing=*/2,
+                                        /*ema_length=*/50, ema);
+      });
+}
+BENCHMARK(BM_ComputeExponentialMovingAverage);
+
+void BM_ComputeMovingAverageConvergenceDivergence(benchmark::State& state) {
+  RunIndicatorSeriesBenchmark(
+      state, [](const ColumnarOhlcHistory& ohlc_history,
+                absl::Span<float> macd_series, absl::Span<float> macd_signal,
+                absl::Span<float>) {
+        ComputeMovingAverageConvergenceDivergence(
+            ohlc_history.close(), /*fast_length=*/12, /*slow_length=*/26,
+            /*signal_smoothing=*/9, macd_series, macd_signal);
+      });
+}
+BENCHMARK(BM_ComputeMovingAverageConvergenceDivergence);
+
+void BM_ComputeRelativeStrengthIndex(benchmark::State& state) {
+  RunIndicatorSeriesBenchmark(
+      state, [](const ColumnarOhlcHistory& ohlc_history, absl::Span<float> rsi,
+                absl::Span<float>, absl::Span<float>) {
+        ComputeRelativeStrengthIndex(ohlc_history.open(), ohlc_history.close(),
+                                     /*num_periods=*/14, rsi);
+      });
+}
+BENCHMARK(BM_ComputeRelativeStrengthIndex);
+
+void BM_ComputeStochasticOscillator(benchmark::State& state) {
+  RunIndicatorSeriesBenchmark(
+      state, [](const ColumnarOhlcHistory& ohlc_history, absl::Span<float> k,
+                absl::Span<float> fast_d, absl::Span<float> slow_d) {
+        ComputeStochasticOscillator(ohlc_history.high(), ohlc_history.low(),
+                                    ohlc_history.close(), /*num_periods=*/14,
+                                    k, fast_d, slow_d);
+      });
+}
+BENCHMARK(BM_ComputeStochasticOscillator);
+
+void BM_ComputeVolatility(benchmark::State& state) {
+  RunIndicatorSeriesBenchmark(
+      state,
+      [](const ColumnarOhlcHistory& ohlc_history, absl::Span<float> volatility,
+         absl::Span<float>, absl::Span<float>) {
+        ComputeVolatility(ohlc_history.open(), ohlc_history.close(),
+                          /*window_size=*/0, volatility);
+      });
+}
+BENCHMARK(BM_ComputeVolatility);
+
+}  // namespace
+}  // namespace trader
@@ -0,0 +1,54 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include <cstdio>
+#include <filesystem>
+
+#include "base/base.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_util.h"
+#include "util/proto.h"
+
+namespace trader {
+namespace {
+// Number of OHLC ticks in the benchmarked file.
+constexpr size_t kNumOhlcTicks = 100000;
+
+// Benchmarks ReadDelimitedMessagesFromFile over a file with OHLC ticks.
+// state.range(0) indicates whether the file is compressed.
+void BM_ReadDelimitedMessagesFromFile(benchmark::State& state) {
+  const bool compress = state.range(0) != 0;
+  const std::string file_name =
+      (std::filesystem::temp_directory_path() /
+       (compress ? "proto_benchmark.pb.gz" : "proto_benchmark.pb"))
+          .string();
+  const OhlcHistory ohlc_history =
+      GetSyntheticOhlcHistory(kNumOhlcTicks, /*period_size_sec=*/300);
+  absl::Status status = WriteDelimitedMessagesToFile(
+      ohlc_history.begin(), ohlc_history.end(), file_name, compress);
+  if (!status.ok()) {
+    state.SkipWithError(std::string(status.message()).c_str());
+    return;
+  }
+  const int64_t file_size = std::filesystem::file_size(file_name);
+  for (auto _ : state) {
+    OhlcHistory ohlc_history_read;
+    status = ReadDelimitedMessagesFromFile<OhlcTick>(file_name,
+                                                     ohlc_history_read);
+    if (!status.ok()) {
+      state.SkipWithError(std::string(status.message()).c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(ohlc_history_read.data());
+  }
+  std::remove(file_name.c_str());
+  state.SetItemsProcessed(state.iterations() * kNumOhlcTicks);
+  // Bytes of the (possibly compressed) file.
+  state.SetBytesProcessed(state.iterations() * file_size);
+}
+BENCHMARK(BM_ReadDelimitedMessagesFromFile)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace trader
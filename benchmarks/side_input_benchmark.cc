@@ -0,0 +1,67 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "base/side_input.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_util.h"
+
+namespace trader {
+namespace {
+// Number of (hourly) side input records.
+constexpr size_t kNumSideInputRecords = 100000;
+// Number of signals per side input record.
+constexpr int kNumSignals = 4;
+// Spacing of the side input records (in seconds).
+constexpr int kSideInputSpacingSec = 3600;
+// Spacing of the queried timestamps (in seconds), as for 5-minute OHLC ticks.
+constexpr int kQuerySpacingSec = 300;
+// Number of the queried timestamps.
+constexpr size_t kNumQueries =
+    kNumSideInputRecords * kSideInputSpacingSec / kQuerySpacingSec;
+
+// Returns the (shared) side input over the synthetic side history.
+const SideInput& GetSideInput() {
+  static const SideInput* side_input = new SideInput(GetSyntheticSideHistory(
+      kNumSideInputRecords, kSideInputSpacingSec, kNumSignals));
+  return *side_input;
+}
+
+// Bytes of a single side input record (timestamp and signals).
+constexpr size_t kSideInputRecordBytes =
+    sizeof(int64_t) + kNumSignals * sizeof(float);
+
+// Benchmarks the O(log N) lookup for increasing timestamps.
+void BM_GetSideInputIndex(benchmark::State& state) {
+  const SideInput& side_input = GetSideInput();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumQueries; ++i) {
+      benchmark::DoNotOptimize(side_input.GetSideInputIndex(
+          kBenchmarkStartTimestampSec + i * kQuerySpacingSec));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+  state.SetBytesProcessed(state.iterations() * kNumSideInputRecords *
+                          kSideInputRecordBytes);
+}
+BENCHMARK(BM_GetSideInputIndex);
+
+// Benchmarks the lookup with the hint about the previous side input index
+// (as used when iterating over the OHLC history).
+void BM_GetSideInputIndexWithHint(benchmark::State& state) {
+  const SideInput& side_input = GetSideInput();
+  for (auto _ : state) {
+    int side_input_index = -1;
+    for (size_t i = 0; i < kNumQueries; ++i) {
+      side_input_index = side_input.GetSideInputIndex(
+          kBenchmarkStartTimestampSec + i * kQuerySpacingSec,
+          side_input_index);
+    }
+    benchmark::DoNotOptimize(side_input_index);
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+  state.SetBytesProcessed(state.iterations() * kNumSideInputRecords *
+                          kSideInputRecordBytes);
+}
+BENCHMARK(BM_GetSideInputIndexWithHint);
+
+}  // namespace
+}  // namespace trader
@@ -4,10 +4,18 @@
 #include "absl/flags/parse.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/time.h"
 #include "base/base.h"
+#include "base/binary_history.h"
+#include "base/csv_history.h"
 #include "base/history.h"
+#include "base/ohlc_pyramid.h"
 #include "util/proto.h"
 #include "util/time.h"
 
@@ -17,6 +25,10 @@ ABSL_FLAG(std::string, input_price_history_delimited_proto_file, "",
           "Input file containing the delimited PriceRecord protos.");
 ABSL_FLAG(std::string, output_price_history_delimited_proto_file, "",
           "Output file containing the delimited PriceRecord protos.");
+ABSL_FLAG(std::string, input_price_history_binary_file, "",
+          "Input binary history file containing the price history.");
+ABSL_FLAG(std::string, output_price_history_binary_file, "",
+          "Output binary history file containing the price history.");
 
 ABSL_FLAG(std::string, input_ohlc_history_csv_file, "",
           "Input CSV file containing the OHLC prices.");
@@ -24,6 +36,14 @@ ABSL_FLAG(std::string, input_ohlc_history_delimited_proto_file, "",
           "Input file containing the delimited OhlcRecord protos.");
 ABSL_FLAG(std::string, output_ohlc_history_delimited_proto_file, "",
           "Output file containing the delimited OhlcRecord protos.");
+ABSL_FLAG(std::string, input_ohlc_history_binary_file, "",
+          "Input binary history file containing the OHLC history.");
+ABSL_FLAG(std::string, output_ohlc_history_binary_file, "",
+          "Output binary history file containing the OHLC history.");
+ABSL_FLAG(std::string, output_ohlc_pyramid_binary_file, "",
+          "Output binary history file containing the OHLC pyramid, i.e. the "
+          "OHLC history (with --sampling_rate_sec) together with its exact "
+          "aggregations to --ohlc_pyramid_sampling_rates_sec.");
 
 ABSL_FLAG(std::string, input_side_history_csv_file, "",
           "Input CSV file containing the historical side inputs.");
@@ -38,14 +58,32 @@ ABSL_FLAG(std::string, end_time, "2021-01-01",
 ABSL_FLAG(double, max_price_deviation_per_min, 0.05,
           "Maximum allowed price deviation per minute.");
 ABSL_FLAG(int, sampling_rate_sec, 300, "Sampling rate in seconds.");
+ABSL_FLAG(std::string, sampling_rates_sec, "",
+          "Comma-separated sampling rates in seconds (streaming mode only). "
+          "If empty, --sampling_rate_sec is used. With more than one sampling "
+          "rate the output OHLC delimited proto file name must contain the "
+          "{sampling_rate_sec} placeholder.");
+ABSL_FLAG(std::string, ohlc_pyramid_sampling_rates_sec, "900,3600,86400",
+          "Comma-separated (increasing) sampling rates in seconds of the "
+          "coarser OHLC pyramid levels. Every sampling rate needs to be a "
+          "multiple of the previous one (starting with --sampling_rate_sec).");
 
 ABSL_FLAG(int, top_n_gaps, 50, "Number of top biggest gaps to print.");
 ABSL_FLAG(int, last_n_outliers, 20,
           "Number of last removed outliers to print.");
 
+ABSL_FLAG(int, num_csv_threads, 0,
+          "Number of threads parsing the input price history CSV file "
+          "(0 = number of hardware threads).");
+
 ABSL_FLAG(bool, compress, true,
           "Whether to compress the output protobuf file.");
 
+ABSL_FLAG(bool, streaming, false,
+          "Whether to convert the input price history into the output OHLC "
+          "history (and price history delimited proto file) in a single pass "
+          "with constant memory, without loading the whole price history.");
+
 using namespace trader;
 
 namespace {
@@ -65,51 +103,18 @@ absl::StatusOr<PriceHistory> ReadPriceHistoryFromCsvFile(
   const absl::Time latency_start_time = absl::Now();
   LogInfo(
       absl::StrFormat("Reading price history from CSV file: %s", file_name));
-  std::ifstream infile(file_name);
-  if (!infile.is_open()) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("Cannot open the file: %s", file_name));
-  }
-  int row = 0;
-  std::string line;
-  const int64_t start_timestamp_sec = absl::ToUnixSeconds(start_time);
-  const int64_t end_timestamp_sec = absl::ToUnixSeconds(end_time);
-  int64_t timestamp_sec_prev = 0;
-  int64_t timestamp_sec = 0;
-  float price = 0;
-  float volume = 0;
-  PriceHistory price_history;
-  while (std::getline(infile, line)) {
-    ++row;
-    std::sscanf(line.c_str(), "%lld,%f,%f", &timestamp_sec, &price, &volume);
-    if (start_timestamp_sec > 0 && timestamp_sec < start_timestamp_sec) {
-      continue;
-    }
-    if (end_timestamp_sec > 0 && timestamp_sec >= end_timestamp_sec) {
-      break;
-    }
-    if (timestamp_sec <= 0 || timestamp_sec < timestamp_sec_prev) {
-      return absl::InvalidArgumentError(
-          absl::StrFormat("Invalid timestamp on the line %d: %s", row, line));
-    }
-    if (price <= 0) {
-      return absl::InvalidArgumentError(
-          absl::StrFormat("Invalid price on the line %d: %s", row, line));
-    }
-    if (volume < 0) {
-      return absl::InvalidArgumentError(
-          absl::StrFormat("Invalid volume on the line %d: %s", row, line));
-    }
-    timestamp_sec_prev = timestamp_sec;
-    price_history.emplace_back();
-    price_history.back().set_timestamp_sec(timestamp_sec);
-    price_history.back().set_price(price);
-    price_history.back().set_volume(volume);
+  absl::StatusOr<PriceHistory> price_history_status =
+      trader::ReadPriceHistoryFromCsvFile(
+          file_name, absl::ToUnixSeconds(start_time),
+          absl::ToUnixSeconds(end_time), absl::GetFlag(FLAGS_num_csv_threads));
+  if (!price_history_status.ok()) {
+    return price_history_status.status();
   }
   LogInfo(
-      absl::StrFormat("Loaded %d records in %.3f seconds", price_history.size(),
+      absl::StrFormat("Loaded %d records in %.3f seconds",
+                      price_history_status.value().size(),
                       absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
-  return price_history;
+  return price_history_status;
 }
 
 // Reads the input CSV file containing the OHLC prices.
@@ -231,23 +236,21 @@ absl::StatusOr<SideHistory> ReadSideHistoryFromCsvFile(
   return side_history;
 }
 
-// Reads and returns the price / OHLC history.
+// Reads the price / OHLC records (one by one) and passes the validated records
+// to the consumer.
 template <typename T>
-absl::StatusOr<std::vector<T>> ReadHistoryFromDelimitedProtoFile(
+absl::Status ReadRecordsFromDelimitedProtoFile(
     const std::string& file_name, const absl::Time start_time,
-    const absl::Time end_time, std::function<absl::Status(const T&)> validate) {
-  const absl::Time latency_start_time = absl::Now();
-  LogInfo(absl::StrFormat("Reading history from delimited proto file: %s",
-                          file_name));
+    const absl::Time end_time, std::function<absl::Status(const T&)> validate,
+    const std::function<void(const T&)>& consumer) {
   int record_index = 0;
   const int64_t start_timestamp_sec = absl::ToUnixSeconds(start_time);
   const int64_t end_timestamp_sec = absl::ToUnixSeconds(end_time);
   int64_t timestamp_sec_prev = 0;
-  std::vector<T> history;
-  const absl::Status read_status = ReadDelimitedMessagesFromFile<T>(
+  return ReadDelimitedMessagesFromFile<T>(
       file_name,
       /*reader=*/
-      [&history, start_timestamp_sec, end_timestamp_sec, validate,
+      [&consumer, start_timestamp_sec, end_timestamp_sec, validate,
        &record_index, &timestamp_sec_prev](const T& message) -> ReaderStatus {
         const int64_t timestamp_sec = message.timestamp_sec();
         if (start_timestamp_sec > 0 && timestamp_sec < start_timestamp_sec) {
@@ -268,10 +271,25 @@ absl::StatusOr<std::vector<T>> ReadHistoryFromDelimitedProtoFile(
               validation_status.message()));
         }
         timestamp_sec_prev = timestamp_sec;
-        history.push_back(message);
+        consumer(message);
         ++record_index;
         return ReaderSignal::kContinue;
       });
+}
+
+// Reads and returns the price / OHLC history.
+template <typename T>
+absl::StatusOr<std::vector<T>> ReadHistoryFromDelimitedProtoFile(
+    const std::string& file_name, const absl::Time start_time,
+    const absl::Time end_time, std::function<absl::Status(const T&)> validate) {
+  const absl::Time latency_start_time = absl::Now();
+  LogInfo(absl::StrFormat("Reading history from delimited proto file: %s",
+                          file_name));
+  std::vector<T> history;
+  const absl::Status read_status = ReadRecordsFromDelimitedProtoFile<T>(
+      file_name, start_time, end_time, std::move(validate),
+      /*consumer=*/
+      [&history](const T& message) { history.push_back(message); });
   if (!read_status.ok()) {
     return read_status;
   }
@@ -281,22 +299,23 @@ absl::StatusOr<std::vector<T>> ReadHistoryFromDelimitedProtoFile(
   return history;
 }
 
+// Validates the price record read from the delimited proto file.
+absl::Status ValidatePriceRecord(const PriceRecord& price_record) {
+  if (price_record.price() <= 0) {
+    return absl::InvalidArgumentError("Invalid price");
+  }
+  if (price_record.volume() < 0) {
+    return absl::InvalidArgumentError("Invalid volume");
+  }
+  return absl::OkStatus();
+}
+
 // Reads the input delimited proto file containing the PriceRecord protos.
 absl::StatusOr<PriceHistory> ReadPriceHistoryFromDelimitedProtoFile(
     const std::string& file_name, const absl::Time start_time,
     const absl::Time end_time) {
   return ReadHistoryFromDelimitedProtoFile<PriceRecord>(
-      file_name, start_time, end_time,
-      /*validate=*/
-      [](const PriceRecord& price_record) -> absl::Status {
-        if (price_record.price() <= 0) {
-          return absl::InvalidArgumentError("Invalid price");
-        }
-        if (price_record.volume() < 0) {
-          return absl::InvalidArgumentError("Invalid volume");
-        }
-        return absl::OkStatus();
-      });
+      file_name, start_time, end_time, ValidatePriceRecord);
 }
 
 // Reads the input delimited proto file containing the OhlcTick protos.
@@ -323,6 +342,59 @@ absl::StatusOr<OhlcHistory> ReadOhlcHistoryFromDelimitedProtoFile(
       });
 }
 
+// Reads the price history from the input binary history file.
+absl::StatusOr<PriceHistory> ReadPriceHistoryFromBinaryFile(
+    const std::string& file_name, const absl::Time start_time,
+    const absl::Time end_time) {
+  const absl::Time latency_start_time = absl::Now();
+  LogInfo(absl::StrFormat("Reading price history from binary file: %s",
+                          file_name));
+  const absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(file_name);
+  if (!history_file_status.ok()) {
+    return history_file_status.status();
+  }
+  absl::StatusOr<PriceHistory> price_history_status =
+      history_file_status.value().GetPriceHistory(
+          absl::ToUnixSeconds(start_time), absl::ToUnixSeconds(end_time));
+  if (!price_history_status.ok()) {
+    return price_history_status.status();
+  }
+  LogInfo(
+      absl::StrFormat("Loaded %d records in %.3f seconds",
+                      price_history_status.value().size(),
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  return price_history_status;
+}
+
+// Reads the OHLC history from the input binary history file.
+absl::StatusOr<OhlcHistory> ReadOhlcHistoryFromBinaryFile(
+    const std::string& file_name, const absl::Time start_time,
+    const absl::Time end_time) {
+  const absl::Time latency_start_time = absl::Now();
+  LogInfo(
+      absl::StrFormat("Reading OHLC history from binary file: %s", file_name));
+  const absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(file_name);
+  if (!history_file_status.ok()) {
+    return history_file_status.status();
+  }
+  const absl::StatusOr<ColumnarOhlcHistory> columnar_history_status =
+      history_file_status.value().GetOhlcHistory(/*sampling_rate_sec=*/0);
+  if (!columnar_history_status.ok()) {
+    return columnar_history_status.status();
+  }
+  const ColumnarOhlcHistory& columnar_history = columnar_history_status.value();
+  const std::pair<size_t, size_t> subset = columnar_history.Subset(
+      absl::ToUnixSeconds(start_time), absl::ToUnixSeconds(end_time));
+  OhlcHistory ohlc_history =
+      columnar_history.ToOhlcHistory(subset.first, subset.second);
+  LogInfo(absl::StrFormat(
+      "Loaded %d OHLC ticks in %.3f seconds", ohlc_history.size(),
+      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  return ohlc_history;
+}
+
 std::string DurationToString(const int64_t duration_sec) {
   const int64_t hours = duration_sec / 3600;
   const int64_t minutes = (duration_sec / 60) % 60;
@@ -417,6 +489,324 @@ absl::Status WriteHistoryToDelimitedProtoFile(
                       absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
   return status;
 }
+
+// Writes the price history to the binary history file.
+absl::Status WritePriceHistoryToBinaryFile(
+    const PriceHistory& price_history,
+    const std::string& output_history_binary_file) {
+  const absl::Time latency_start_time = absl::Now();
+  LogInfo(absl::StrFormat("Writing %d records to the binary file: %s",
+                          price_history.size(), output_history_binary_file));
+  BinaryHistoryWriter writer;
+  writer.AddPriceHistory(price_history);
+  const absl::Status status = writer.WriteToFile(output_history_binary_file);
+  LogInfo(
+      absl::StrFormat("Finished in %.3f seconds",
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  return status;
+}
+
+// Writes the OHLC history to the binary history file.
+absl::Status WriteOhlcHistoryToBinaryFile(
+    const OhlcHistory& ohlc_history,
+    const std::string& output_history_binary_file) {
+  const absl::Time latency_start_time = absl::Now();
+  LogInfo(absl::StrFormat("Writing %d OHLC ticks to the binary file: %s",
+                          ohlc_history.size(), output_history_binary_file));
+  BinaryHistoryWriter writer;
+  writer.AddOhlcHistory(ohlc_history, absl::GetFlag(FLAGS_sampling_rate_sec));
+  const absl::Status status = writer.WriteToFile(output_history_binary_file);
+  LogInfo(
+      absl::StrFormat("Finished in %.3f seconds",
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  return status;
+}
+
+// Reads the input price records (one by one) and passes them to the consumer.
+absl::Status ReadPriceRecords(
+    const absl::Time start_time, const absl::Time end_time,
+    const std::function<void(const PriceRecord&)>& consumer) {
+  const int64_t start_timestamp_sec = absl::ToUnixSeconds(start_time);
+  const int64_t end_timestamp_sec = absl::ToUnixSeconds(end_time);
+  const std::string csv_file =
+      absl::GetFlag(FLAGS_input_price_history_csv_file);
+  const std::string delimited_proto_file =
+      absl::GetFlag(FLAGS_input_price_history_delimited_proto_file);
+  const std::string binary_file =
+      absl::GetFlag(FLAGS_input_price_history_binary_file);
+  if (!csv_file.empty()) {
+    LogInfo(absl::StrFormat("Streaming price records from CSV file: %s",
+                            csv_file));
+    return ReadPriceRecordsFromCsvFile(csv_file, start_timestamp_sec,
+                                       end_timestamp_sec, consumer);
+  } else if (!delimited_proto_file.empty()) {
+    LogInfo(absl::StrFormat(
+        "Streaming price records from delimited proto file: %s",
+        delimited_proto_file));
+    return ReadRecordsFromDelimitedProtoFile<PriceRecord>(
+        delimited_proto_file, start_time, end_time, ValidatePriceRecord,
+        consumer);
+  } else if (!binary_file.empty()) {
+    LogInfo(absl::StrFormat("Streaming price records from binary file: %s",
+                            binary_file));
+    const absl::StatusOr<BinaryHistoryFile> history_file_status =
+        BinaryHistoryFile::Open(binary_file);
+    if (!history_file_status.ok()) {
+      return history_file_status.status();
+    }
+    return history_file_status.value().ReadPriceRecords(
+        start_timestamp_sec, end_timestamp_sec, consumer);
+  }
+  return absl::InvalidArgumentError("Input price history file not specified");
+}
+
+// Parses the comma-separated sampling rates (in seconds).
+absl::StatusOr<std::vector<int>> ParseSamplingRates(
+    absl::string_view sampling_rates_sec) {
+  std::vector<int> sampling_rates;
+  for (absl::string_view token :
+       absl::StrSplit(sampling_rates_sec, ',', absl::SkipWhitespace())) {
+    int sampling_rate_sec = 0;
+    if (!absl::SimpleAtoi(token, &sampling_rate_sec) ||
+        sampling_rate_sec <= 0) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid sampling rate: %s", token));
+    }
+    sampling_rates.push_back(sampling_rate_sec);
+  }
+  return sampling_rates;
+}
+
+// Returns the sampling rates for the streaming conversion.
+absl::StatusOr<std::vector<int>> GetSamplingRates() {
+  if (absl::GetFlag(FLAGS_sampling_rates_sec).empty()) {
+    return std::vector<int>{absl::GetFlag(FLAGS_sampling_rate_sec)};
+  }
+  absl::StatusOr<std::vector<int>> sampling_rates_status =
+      ParseSamplingRates(absl::GetFlag(FLAGS_sampling_rates_sec));
+  if (sampling_rates_status.ok() && sampling_rates_status.value().empty()) {
+    return absl::InvalidArgumentError("No sampling rate specified");
+  }
+  return sampling_rates_status;
+}
+
+// Builds the OHLC pyramid from the OHLC history and writes it to the binary
+// history file.
+absl::Status WriteOhlcPyramidToBinaryFile(
+    const OhlcHistory& ohlc_history,
+    const std::string& output_pyramid_binary_file) {
+  const absl::Time latency_start_time = absl::Now();
+  const absl::StatusOr<std::vector<int>> sampling_rates_status =
+      ParseSamplingRates(absl::GetFlag(FLAGS_ohlc_pyramid_sampling_rates_sec));
+  if (!sampling_rates_status.ok()) {
+    return sampling_rates_status.status();
+  }
+  const absl::StatusOr<OhlcPyramid> pyramid_status =
+      OhlcPyramid::Build(ohlc_history, absl::GetFlag(FLAGS_sampling_rate_sec),
+                         sampling_rates_status.value());
+  if (!pyramid_status.ok()) {
+    return pyramid_status.status();
+  }
+  const OhlcPyramid& pyramid = pyramid_status.value();
+  for (size_t level = 0; level < pyramid.num_levels(); ++level) {
+    LogInfo(absl::StrFormat("- Level %d: %d OHLC ticks (%d sec)", level,
+                            pyramid.ohlc_history(level).size(),
+                            pyramid.sampling_rate_sec(level)));
+  }
+  LogInfo(absl::StrFormat("Writing %d OHLC pyramid levels to the file: %s",
+                          pyramid.num_levels(), output_pyramid_binary_file));
+  const absl::Status status =
+      pyramid.WriteToBinaryFile(output_pyramid_binary_file);
+  LogInfo(
+      absl::StrFormat("Finished in %.3f seconds",
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  return status;
+}
+
+// Converts the input price records into the output OHLC history (with one or
+// more sampling rates) in a single pass: reader -> outlier filter -> resamplers
+// -> writers. Only the OHLC ticks written into the binary history file are
+// kept in memory (since the binary sections need to know their sizes upfront).
+absl::Status ConvertPriceRecordsStreaming(const absl::Time start_time,
+                                          const absl::Time end_time) {
+  const absl::Time latency_start_time = absl::Now();
+  if (!absl::GetFlag(FLAGS_output_price_history_binary_file).empty() ||
+      !absl::GetFlag(FLAGS_output_ohlc_pyramid_binary_file).empty()) {
+    return absl::InvalidArgumentError(
+        "Binary price history and OHLC pyramid outputs are not supported in "
+        "the streaming mode");
+  }
+  const absl::StatusOr<std::vector<int>> sampling_rates_status =
+      GetSamplingRates();
+  if (!sampling_rates_status.ok()) {
+    return sampling_rates_status.status();
+  }
+  const std::vector<int>& sampling_rates = sampling_rates_status.value();
+  const std::string ohlc_delimited_proto_file =
+      absl::GetFlag(FLAGS_output_ohlc_history_delimited_proto_file);
+  const std::string ohlc_binary_file =
+      absl::GetFlag(FLAGS_output_ohlc_history_binary_file);
+  const bool write_ohlc_history =
+      !ohlc_delimited_proto_file.empty() || !ohlc_binary_file.empty();
+  if (sampling_rates.size() > 1 && !ohlc_delimited_proto_file.empty() &&
+      !absl::StrContains(ohlc_delimited_proto_file, "{sampling_rate_sec}")) {
+    return absl::InvalidArgumentError(
+        "Output OHLC history delimited proto file is missing the "
+        "{sampling_rate_sec} placeholder");
+  }
+  // First write error (the consumers cannot return a status).
+  absl::Status write_status;
+  const auto write = [&write_status](DelimitedMessageWriter& writer,
+                                     const google::protobuf::Message& message) {
+    if (write_status.ok()) {
+      write_status = writer.Write(message);
+    }
+  };
+  std::unique_ptr<DelimitedMessageWriter> price_writer;
+  if (!absl::GetFlag(FLAGS_output_price_history_delimited_proto_file)
+           .empty()) {
+    absl::StatusOr<std::unique_ptr<DelimitedMessageWriter>> writer_status =
+        DelimitedMessageWriter::Open(
+            absl::GetFlag(FLAGS_output_price_history_delimited_proto_file),
+            absl::GetFlag(FLAGS_compress));
+    if (!writer_status.ok()) {
+      return writer_status.status();
+    }
+    price_writer = std::move(writer_status).value();
+  }
+  std::vector<std::unique_ptr<DelimitedMessageWriter>> ohlc_writers(
+      sampling_rates.size());
+  std::vector<OhlcHistory> ohlc_histories(sampling_rates.size());
+  std::vector<Resampler> resamplers;
+  resamplers.reserve(sampling_rates.size());
+  for (size_t i = 0; write_ohlc_history && i < sampling_rates.size(); ++i) {
+    if (!ohlc_delimited_proto_file.empty()) {
+      const std::string file_name = absl::StrReplaceAll(
+          ohlc_delimited_proto_file,
+          {{"{sampling_rate_sec}", absl::StrCat(sampling_rates[i])}});
+      absl::StatusOr<std::unique_ptr<DelimitedMessageWriter>> writer_status =
+          DelimitedMessageWriter::Open(file_name,
+                                       absl::GetFlag(FLAGS_compress));
+      if (!writer_status.ok()) {
+        return writer_status.status();
+      }
+      ohlc_writers[i] = std::move(writer_status).value();
+    }
+    resamplers.emplace_back(
+        sampling_rates[i],
+        [&write, &ohlc_writers, &ohlc_histories, &ohlc_binary_file,
+         i](const OhlcTick& ohlc_tick) {
+          if (ohlc_writers[i]) {
+            write(*ohlc_writers[i], ohlc_tick);
+          }
+          if (!ohlc_binary_file.empty()) {
+            ohlc_histories[i].push_back(ohlc_tick);
+          }
+        });
+  }
+  size_t num_records_clean = 0;
+  const size_t last_n_outliers = absl::GetFlag(FLAGS_last_n_outliers);
+  std::deque<std::pair<size_t, PriceRecord>> last_outliers;
+  OutlierFilter outlier_filter(
+      absl::GetFlag(FLAGS_max_price_deviation_per_min),
+      /*consumer=*/
+      [&resamplers, &num_records_clean](const PriceRecord& price_record) {
+        ++num_records_clean;
+        for (Resampler& resampler : resamplers) {
+          resampler.Add(price_record);
+        }
+      },
+      /*outlier_consumer=*/
+      [&last_outliers, last_n_outliers](size_t index,
+                                        const PriceRecord& price_record) {
+        last_outliers.emplace_back(index, price_record);
+        if (last_outliers.size() > last_n_outliers) {
+          last_outliers.pop_front();
+        }
+      });
+  PriceHistoryGapTracker gap_tracker(
+      /*top_n=*/absl::GetFlag(FLAGS_top_n_gaps));
+  size_t num_records = 0;
+  const absl::Status read_status = ReadPriceRecords(
+      start_time, end_time, [&](const PriceRecord& price_record) {
+        ++num_records;
+        gap_tracker.Add(price_record.timestamp_sec());
+        if (price_writer) {
+          write(*price_writer, price_record);
+        }
+        if (write_ohlc_history) {
+          outlier_filter.Add(price_record);
+        }
+      });
+  if (!read_status.ok()) {
+    return read_status;
+  }
+  outlier_filter.Finish();
+  for (Resampler& resampler : resamplers) {
+    resampler.Finish();
+  }
+  if (!write_status.ok()) {
+    return write_status;
+  }
+  LogInfo(absl::StrFormat("Streamed %d records", num_records));
+  LogInfo(absl::StrFormat("Top %d gaps:", absl::GetFlag(FLAGS_top_n_gaps)));
+  for (const HistoryGap& history_gap : gap_tracker.GetGaps()) {
+    LogInfo(absl::StrFormat(
+        "%d [%s] - %d [%s]: %s", history_gap.first,
+        FormatTimeUTC(absl::FromUnixSeconds(history_gap.first)),
+        history_gap.second,
+        FormatTimeUTC(absl::FromUnixSeconds(history_gap.second)),
+        DurationToString(history_gap.second - history_gap.first)));
+  }
+  if (write_ohlc_history) {
+    LogInfo(absl::StrFormat("Removed %d outliers",
+                            outlier_filter.num_outliers()));
+    LogInfo(absl::StrFormat("Last %d outliers:", last_n_outliers));
+    for (const auto& [index, price_record] : last_outliers) {
+      LogInfo(absl::StrFormat(
+          " x %d [%s]: %.2f [%.4f] (record %d)", price_record.timestamp_sec(),
+          FormatTimeUTC(absl::FromUnixSeconds(price_record.timestamp_sec())),
+          price_record.price(), price_record.volume(), index));
+    }
+  }
+  if (price_writer) {
+    const absl::Status status = price_writer->Close();
+    if (!status.ok()) {
+      return status;
+    }
+    LogInfo(absl::StrFormat(
+        "Written %d records to the file: %s", price_writer->num_messages(),
+        absl::GetFlag(FLAGS_output_price_history_delimited_proto_file)));
+  }
+  for (size_t i = 0; i < resamplers.size(); ++i) {
+    LogInfo(absl::StrFormat("Resampled %d records to %d OHLC ticks (%d sec)",
+                            num_records_clean, resamplers[i].num_ohlc_ticks(),
+                            sampling_rates[i]));
+    if (ohlc_writers[i]) {
+      const absl::Status status = ohlc_writers[i]->Close();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+  if (!ohlc_binary_file.empty()) {
+    BinaryHistoryWriter writer;
+    for (size_t i = 0; i < sampling_rates.size(); ++i) {
+      writer.AddOhlcHistory(ohlc_histories[i], sampling_rates[i]);
+      ohlc_histories[i] = OhlcHistory();
+    }
+    const absl::Status status = writer.WriteToFile(ohlc_binary_file);
+    if (!status.ok()) {
+      return status;
+    }
+    LogInfo(absl::StrFormat("Written %d OHLC sections to the binary file: %s",
+                            sampling_rates.size(), ohlc_binary_file));
+  }
+  LogInfo(
+      absl::StrFormat("Finished in %.3f seconds",
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  return absl::OkStatus();
+}
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -437,25 +827,41 @@ int main(int argc, char* argv[]) {
   LogInfo(absl::StrFormat("Selected time period:\n[%s - %s)",
                           FormatTimeUTC(start_time), FormatTimeUTC(end_time)));
 
-  if (!absl::GetFlag(FLAGS_input_price_history_csv_file).empty() &&
-      !absl::GetFlag(FLAGS_input_price_history_delimited_proto_file).empty()) {
+  const int num_price_history_files =
+      (absl::GetFlag(FLAGS_input_price_history_csv_file).empty() ? 0 : 1) +
+      (absl::GetFlag(FLAGS_input_price_history_delimited_proto_file).empty()
+           ? 0
+           : 1) +
+      (absl::GetFlag(FLAGS_input_price_history_binary_file).empty() ? 0 : 1);
+  if (num_price_history_files > 1) {
     LogError("Cannot have two input price history files");
     std::exit(EXIT_FAILURE);
   }
 
-  if (!absl::GetFlag(FLAGS_input_ohlc_history_csv_file).empty() &&
-      !absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file).empty()) {
+  const int num_ohlc_history_files =
+      (absl::GetFlag(FLAGS_input_ohlc_history_csv_file).empty() ? 0 : 1) +
+      (absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file).empty()
+           ? 0
+           : 1) +
+      (absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty() ? 0 : 1);
+  if (num_ohlc_history_files > 1) {
     LogError("Cannot have two input OHLC history files");
     std::exit(EXIT_FAILURE);
   }
 
-  const bool read_price_history =
-      !absl::GetFlag(FLAGS_input_price_history_csv_file).empty() ||
-      !absl::GetFlag(FLAGS_input_price_history_delimited_proto_file).empty();
+  const bool read_price_history = num_price_history_files > 0;
 
-  const bool read_ohlc_history =
-      !absl::GetFlag(FLAGS_input_ohlc_history_csv_file).empty() ||
-      !absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file).empty();
+  if (absl::GetFlag(FLAGS_streaming)) {
+    if (!read_price_history || num_ohlc_history_files > 0 ||
+        !absl::GetFlag(FLAGS_input_side_history_csv_file).empty()) {
+      LogError("Streaming mode requires (only) an input price history file");
+      std::exit(EXIT_FAILURE);
+    }
+    CheckOk(ConvertPriceRecordsStreaming(start_time, end_time));
+    google::protobuf::ShutdownProtobufLibrary();
+    return 0;
+  }
+  const bool read_ohlc_history = num_ohlc_history_files > 0;
 
   const bool read_side_history =
       !absl::GetFlag(FLAGS_input_side_history_csv_file).empty();
@@ -485,6 +891,10 @@ int main(int argc, char* argv[]) {
       return ReadPriceHistoryFromDelimitedProtoFile(
           absl::GetFlag(FLAGS_input_price_history_delimited_proto_file),
           start_time, end_time);
+    } else if (!absl::GetFlag(FLAGS_input_price_history_binary_file).empty()) {
+      return ReadPriceHistoryFromBinaryFile(
+          absl::GetFlag(FLAGS_input_price_history_binary_file), start_time,
+          end_time);
     }
     return PriceHistory{};
   }();
@@ -502,6 +912,10 @@ int main(int argc, char* argv[]) {
       return ReadOhlcHistoryFromDelimitedProtoFile(
           absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file),
           start_time, end_time);
+    } else if (!absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty()) {
+      return ReadOhlcHistoryFromBinaryFile(
+          absl::GetFlag(FLAGS_input_ohlc_history_binary_file), start_time,
+          end_time);
     }
     return OhlcHistory{};
   }();
@@ -527,7 +941,9 @@ int main(int argc, char* argv[]) {
   }
 
   if (!price_history.empty() && ohlc_history.empty() &&
-      !absl::GetFlag(FLAGS_output_ohlc_history_delimited_proto_file).empty()) {
+      (!absl::GetFlag(FLAGS_output_ohlc_history_delimited_proto_file).empty() ||
+       !absl::GetFlag(FLAGS_output_ohlc_history_binary_file).empty() ||
+       !absl::GetFlag(FLAGS_output_ohlc_pyramid_binary_file).empty())) {
     ohlc_history = ConvertPriceHistoryToOhlcHistory(price_history);
   }
 
@@ -545,6 +961,24 @@ int main(int argc, char* argv[]) {
         absl::GetFlag(FLAGS_output_ohlc_history_delimited_proto_file)));
   }
 
+  if (!price_history.empty() &&
+      !absl::GetFlag(FLAGS_output_price_history_binary_file).empty()) {
+    CheckOk(WritePriceHistoryToBinaryFile(
+        price_history, absl::GetFlag(FLAGS_output_price_history_binary_file)));
+  }
+
+  if (!ohlc_history.empty() &&
+      !absl::GetFlag(FLAGS_output_ohlc_history_binary_file).empty()) {
+    CheckOk(WriteOhlcHistoryToBinaryFile(
+        ohlc_history, absl::GetFlag(FLAGS_output_ohlc_history_binary_file)));
+  }
+
+  if (!ohlc_history.empty() &&
+      !absl::GetFlag(FLAGS_output_ohlc_pyramid_binary_file).empty()) {
+    CheckOk(WriteOhlcPyramidToBinaryFile(
+        ohlc_history, absl::GetFlag(FLAGS_output_ohlc_pyramid_binary_file)));
+  }
+
   if (!side_history.empty() &&
       !absl::GetFlag(FLAGS_output_side_history_delimited_proto_file).empty()) {
     CheckOk(WriteHistoryToDelimitedProtoFile(
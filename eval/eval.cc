@@ -2,7 +2,13 @@
 
 #include "eval/eval.h"
 
+#include <thread>
+#include <tuple>
+
+#include "indicators/indicator_registry.h"
 #include "indicators/volatility.h"
+#include "util/executor.h"
+#include "util/fingerprint.h"
 #include "util/time.h"
 
 namespace trader {
@@ -33,36 +39,73 @@ float GetGeometricAverage(const C& container, F selector) {
   assert(mul >= 0);
   return static_cast<float>(std::pow(mul, 1.0 / container.size()));
 }
-}  // namespace
 
-ExecutionResult ExecuteTrader(const AccountConfig& account_config,
-                              OhlcHistory::const_iterator ohlc_history_begin,
-                              OhlcHistory::const_iterator ohlc_history_end,
-                              const SideInput* side_input, bool fast_eval,
-                              Trader& trader, Logger* logger) {
-  ExecutionResult result;
-  if (ohlc_history_begin == ohlc_history_end) {
-    return {};
+// Execution state of a single trader (within ExecuteTradersImpl below).
+struct TraderExecutionState {
+  explicit TraderExecutionState(const AccountConfig& account_config)
+      : trader_volatility(/*period_size_sec=*/kSecondsPerDay) {
+    account.InitAccount(account_config);
   }
+
   Account account;
-  account.InitAccount(account_config);
+  // Orders emitted by the trader on the previous OHLC tick.
+  OrderBuffer orders;
+  int total_executed_orders = 0;
+  VolatilityAccumulator trader_volatility;
+};
+
+// Executes num_traders instances of traders in lockstep over num_ohlc_ticks
+// OHLC ticks, where get_ohlc_tick(i) returns a reference to the i-th OHLC
+// tick. The returned reference needs to be valid only until the next
+// get_ohlc_tick call. Every OHLC tick (and the corresponding side input) is
+// read only once and then used to advance all traders (each with its own
+// account and orders), so that the data is reused while still in the cache.
+// The indicator_registry (if any) is shared by all traders, and it is updated
+// on every (non-zero volume) OHLC tick right before the traders.
+// The logger (if any) requires num_traders == 1.
+// The base_volatility is computed only if compute_base_volatility is true (and
+// fast_eval is false).
+// Stores the ExecutionResult of the i-th trader into results[i].
+template <typename GetOhlcTick>
+void ExecuteTradersImpl(const AccountConfig& account_config,
+                        size_t num_ohlc_ticks, GetOhlcTick get_ohlc_tick,
+                        const SideInput* side_input, bool fast_eval,
+                        bool compute_base_volatility, Trader* const* traders,
+                        size_t num_traders,
+                        IndicatorRegistry* indicator_registry, Logger* logger,
+                        ExecutionResult* results) {
+  assert(logger == nullptr || num_traders == 1);
+  if (num_ohlc_ticks == 0) {
+    std::fill(results, results + num_traders, ExecutionResult());
+    return;
+  }
+  const float start_price = get_ohlc_tick(0).close();
+  std::vector<TraderExecutionState> states;
+  states.reserve(num_traders);
+  for (size_t trader_index = 0; trader_index < num_traders; ++trader_index) {
+    states.emplace_back(account_config);
+  }
+  // Reused buffer for the structured trader state (empty if the trader
+  // exports its state only as a string).
+  std::vector<float> trader_state;
+  if (logger != nullptr) {
+    const TraderStateSchema schema = traders[0]->GetStateSchema();
+    if (!schema.empty()) {
+      logger->SetTraderStateSchema(schema);
+      trader_state.resize(schema.size());
+    }
+  }
   std::vector<float> side_input_signals;
   if (side_input != nullptr) {
     // The last signal is the age (in seconds) of the side input signals.
     side_input_signals.reserve(side_input->GetNumberOfSignals() + 1);
   }
   int prev_side_input_index = -1;
-  std::vector<Order> orders;
-  constexpr size_t kEmittedOrdersReserve = 8;
-  orders.reserve(kEmittedOrdersReserve);
-  int total_executed_orders = 0;
-  Volatility base_volatility(/*window_size=*/0,
-                             /*period_size_sec=*/kSecondsPerDay);
-  Volatility trader_volatility(/*window_size=*/0,
-                               /*period_size_sec=*/kSecondsPerDay);
-  for (auto ohlc_tick_it = ohlc_history_begin; ohlc_tick_it != ohlc_history_end;
-       ++ohlc_tick_it) {
-    const OhlcTick& ohlc_tick = *ohlc_tick_it;
+  // The baseline volatility is shared by all traders.
+  VolatilityAccumulator base_volatility(/*period_size_sec=*/kSecondsPerDay);
+  for (size_t ohlc_tick_index = 0; ohlc_tick_index < num_ohlc_ticks;
+       ++ohlc_tick_index) {
+    const OhlcTick& ohlc_tick = get_ohlc_tick(ohlc_tick_index);
     if (side_input != nullptr) {
       const int side_input_index = side_input->GetSideInputIndex(
           ohlc_tick.timestamp_sec(), prev_side_input_index);
@@ -77,110 +120,405 @@ ExecutionResult ExecuteTrader(const AccountConfig& account_config,
         prev_side_input_index = side_input_index;
       }
     }
-    // Log the current OHLC tick T[i] and the trader account.
-    // Note: We do not explicitly log the side_input_signals as those can be
-    // easily logged through trader internal state.
-    if (logger != nullptr) {
-      logger->LogExchangeState(ohlc_tick, account);
-    }
-    // The trader was updated on the previous OHLC tick T[i-1] and emitted
-    // "orders". There are no other active orders on the exchange.
-    // Execute (or cancel) "orders" on the current OHLC tick T[i].
-    for (const Order& order : orders) {
-      const bool success =
-          account.ExecuteOrder(account_config, order, ohlc_tick);
-      if (success) {
-        ++total_executed_orders;
-        // Log only the executed orders and their impact on the trader account.
-        if (logger != nullptr) {
-          logger->LogExchangeState(ohlc_tick, account, order);
+    if (indicator_registry != nullptr && ohlc_tick.volume() != 0) {
+      indicator_registry->Update(ohlc_tick);
+    }
+    for (size_t trader_index = 0; trader_index < num_traders;
+         ++trader_index) {
+      Trader& trader = *traders[trader_index];
+      TraderExecutionState& state = states[trader_index];
+      Account& account = state.account;
+      // Log the current OHLC tick T[i] and the trader account.
+      // Note: We do not explicitly log the side_input_signals as those can be
+      // easily logged through trader internal state.
+      if (logger != nullptr) {
+        logger->LogExchangeState(ohlc_tick, account);
+      }
+      // The trader was updated on the previous OHLC tick T[i-1] and emitted
+      // "orders". There are no other active orders on the exchange.
+      // Execute (or cancel) "orders" on the current OHLC tick T[i].
+      for (const OrderSpec& order : state.orders) {
+        const bool success = account.ExecuteOrder(order, ohlc_tick);
+        if (success) {
+          ++state.total_executed_orders;
+          // Log only the executed orders and their impact on the account.
+          if (logger != nullptr) {
+            logger->LogExchangeState(ohlc_tick, account, ToOrder(order));
+          }
         }
       }
+      if (ohlc_tick.volume() == 0) {
+        // Zero volume OHLC tick indicates a gap in a price history. Such gap
+        // could have been caused by an unresponsive exchange (or its API).
+        // Therefore, we do not update the trader and simply keep the
+        // previously emitted orders.
+        continue;
+      }
+      // Update the trader internal state on the current OHLC tick T[i].
+      // Emit a new set of "orders" for the next OHLC tick T[i+1].
+      state.orders.clear();
+      trader.UpdateAndEmit(ohlc_tick, side_input_signals, account.base_balance,
+                           account.quote_balance, state.orders);
+      // Trader state is logged only if the logger does not discard it.
+      if (logger != nullptr && logger->LogsTraderState()) {
+        if (trader_state.empty()) {
+          logger->LogTraderState(trader.GetInternalState());
+        } else {
+          trader.GetState(trader_state.data());
+          logger->LogTraderState(trader_state.data());
+        }
+      }
+      if (!fast_eval) {
+        state.trader_volatility.Update(
+            ohlc_tick.timestamp_sec(), ohlc_tick.open(), ohlc_tick.close(),
+            account.base_balance, account.quote_balance);
+      }
     }
-    if (ohlc_tick.volume() == 0) {
-      // Zero volume OHLC tick indicates a gap in a price history. Such gap
-      // could have been caused by an unresponsive exchange (or its API).
-      // Therefore, we do not update the trader and simply keep the previously
-      // emitted orders.
-      continue;
-    }
-    // Update the trader internal state on the current OHLC tick T[i].
-    // Emit a new set of "orders" for the next OHLC tick T[i+1].
-    orders.clear();
-    trader.Update(ohlc_tick, side_input_signals, account.base_balance,
-                  account.quote_balance, orders);
-    if (logger != nullptr) {
-      logger->LogTraderState(trader.GetInternalState());
+    if (!fast_eval && compute_base_volatility && ohlc_tick.volume() != 0) {
+      base_volatility.Update(ohlc_tick.timestamp_sec(), ohlc_tick.open(),
+                             ohlc_tick.close(), /*base_balance=*/1.0f,
+                             /*quote_balance=*/0.0f);
     }
+  }
+  const float end_price = get_ohlc_tick(num_ohlc_ticks - 1).close();
+  for (size_t trader_index = 0; trader_index < num_traders; ++trader_index) {
+    const TraderExecutionState& state = states[trader_index];
+    ExecutionResult& result = results[trader_index];
+    result.Clear();
+    result.set_start_base_balance(account_config.start_base_balance());
+    result.set_start_quote_balance(account_config.start_quote_balance());
+    result.set_end_base_balance(state.account.base_balance);
+    result.set_end_quote_balance(state.account.quote_balance);
+    result.set_start_price(start_price);
+    result.set_end_price(end_price);
+    result.set_start_value(result.start_quote_balance() +
+                           result.start_price() * result.start_base_balance());
+    result.set_end_value(result.end_quote_balance() +
+                         result.end_price() * result.end_base_balance());
+    result.set_total_executed_orders(state.total_executed_orders);
+    result.set_total_fee(state.account.total_fee);
     if (!fast_eval) {
-      base_volatility.Update(ohlc_tick, /*base_balance=*/1.0f,
+      if (compute_base_volatility) {
+        result.set_base_volatility(base_volatility.GetVolatility() *
+                                   std::sqrt(365));
+      }
+      result.set_trader_volatility(state.trader_volatility.GetVolatility() *
+                                   std::sqrt(365));
+    }
+  }
+}
+
+// Executes the traders in lockstep over the OHLC ticks of the ohlc_history
+// within the index range [begin_index, end_index) (see ExecuteTradersImpl).
+void ExecuteTradersOverRange(const AccountConfig& account_config,
+                             const OhlcHistory& ohlc_history,
+                             size_t begin_index, size_t end_index,
+                             const SideInput* side_input, bool fast_eval,
+                             bool compute_base_volatility,
+                             Trader* const* traders, size_t num_traders,
+                             IndicatorRegistry* indicator_registry,
+                             Logger* logger, ExecutionResult* results) {
+  assert(begin_index <= end_index && end_index <= ohlc_history.size());
+  const OhlcHistory::const_iterator ohlc_history_begin =
+      ohlc_history.begin() + begin_index;
+  ExecuteTradersImpl(
+      account_config, end_index - begin_index,
+      [ohlc_history_begin](size_t index) -> const OhlcTick& {
+        return *(ohlc_history_begin + index);
+      },
+      side_input, fast_eval, compute_base_volatility, traders, num_traders,
+      indicator_registry, logger, results);
+}
+
+// The same method as above, but over the columnar ohlc_history.
+void ExecuteTradersOverRange(const AccountConfig& account_config,
+                             const ColumnarOhlcHistory& ohlc_history,
+                             size_t begin_index, size_t end_index,
+                             const SideInput* side_input, bool fast_eval,
+                             bool compute_base_volatility,
+                             Trader* const* traders, size_t num_traders,
+                             IndicatorRegistry* indicator_registry,
+                             Logger* logger, ExecutionResult* results) {
+  assert(begin_index <= end_index && end_index <= ohlc_history.size());
+  // All OHLC ticks are read from the (dense) columns into the same OhlcTick,
+  // which stays in the L1 cache during the whole execution.
+  OhlcTick ohlc_tick;
+  ExecuteTradersImpl(
+      account_config, end_index - begin_index,
+      [&ohlc_history, &ohlc_tick,
+       begin_index](size_t index) -> const OhlcTick& {
+        ohlc_history[begin_index + index].CopyTo(ohlc_tick);
+        return ohlc_tick;
+      },
+      side_input, fast_eval, compute_base_volatility, traders, num_traders,
+      indicator_registry, logger, results);
+}
+
+// Calls visitor(ohlc_tick) on every OHLC tick of the ohlc_history within the
+// index range [begin_index, end_index).
+template <typename F>
+void VisitOhlcTicks(const OhlcHistory& ohlc_history, size_t begin_index,
+                    size_t end_index, F visitor) {
+  for (size_t index = begin_index; index < end_index; ++index) {
+    visitor(ohlc_history[index]);
+  }
+}
+
+// Returns the annual volatility of the baseline (Buy and HODL) portfolio over
+// the OHLC ticks of the ohlc_history within the index range
+// [begin_index, end_index). Zero volume OHLC ticks (gaps) are skipped.
+float GetBaseVolatility(const OhlcHistory& ohlc_history, size_t begin_index,
+                        size_t end_index) {
+  VolatilityAccumulator base_volatility(/*period_size_sec=*/kSecondsPerDay);
+  for (size_t index = begin_index; index < end_index; ++index) {
+    const OhlcTick& ohlc_tick = ohlc_history[index];
+    if (ohlc_tick.volume() != 0) {
+      base_volatility.Update(ohlc_tick.timestamp_sec(), ohlc_tick.open(),
+                             ohlc_tick.close(), /*base_balance=*/1.0f,
                              /*quote_balance=*/0.0f);
-      trader_volatility.Update(ohlc_tick, account.base_balance,
-                               account.quote_balance);
-    }
-  }
-  result.set_start_base_balance(account_config.start_base_balance());
-  result.set_start_quote_balance(account_config.start_quote_balance());
-  result.set_end_base_balance(account.base_balance);
-  result.set_end_quote_balance(account.quote_balance);
-  result.set_start_price(ohlc_history_begin->close());
-  result.set_end_price((--ohlc_history_end)->close());
-  result.set_start_value(result.start_quote_balance() +
-                         result.start_price() * result.start_base_balance());
-  result.set_end_value(result.end_quote_balance() +
-                       result.end_price() * result.end_base_balance());
-  result.set_total_executed_orders(total_executed_orders);
-  result.set_total_fee(account.total_fee);
-  if (!fast_eval) {
-    result.set_base_volatility(base_volatility.GetVolatility() *
-                               std::sqrt(365));
-    result.set_trader_volatility(trader_volatility.GetVolatility() *
-                                 std::sqrt(365));
+    }
   }
-  return result;
+  return base_volatility.GetVolatility() * std::sqrt(365);
 }
 
-EvaluationResult EvaluateTrader(const AccountConfig& account_config,
-                                const EvaluationConfig& eval_config,
-                                const OhlcHistory& ohlc_history,
-                                const SideInput* side_input,
-                                const TraderEmitter& trader_emitter,
-                                Logger* logger) {
-  EvaluationResult eval_result;
-  *eval_result.mutable_account_config() = account_config;
-  *eval_result.mutable_eval_config() = eval_config;
-  eval_result.set_name(trader_emitter.GetName());
-  for (int month_offset = 0;; ++month_offset) {
+// The same method as above, but over the columnar ohlc_history. Scans only
+// the timestamp, open, close and volume columns (without any OhlcTick copies).
+float GetBaseVolatility(const ColumnarOhlcHistory& ohlc_history,
+                        size_t begin_index, size_t end_index) {
+  const int64_t* const timestamp_sec = ohlc_history.timestamp_sec().data();
+  const float* const open = ohlc_history.open().data();
+  const float* const close = ohlc_history.close().data();
+  const float* const volume = ohlc_history.volume().data();
+  VolatilityAccumulator base_volatility(/*period_size_sec=*/kSecondsPerDay);
+  for (size_t index = begin_index; index < end_index; ++index) {
+    if (volume[index] != 0) {
+      base_volatility.Update(timestamp_sec[index], open[index], close[index],
+                             /*base_balance=*/1.0f, /*quote_balance=*/0.0f);
+    }
+  }
+  return base_volatility.GetVolatility() * std::sqrt(365);
+}
+
+// The same method as above, but over the columnar ohlc_history.
+template <typename F>
+void VisitOhlcTicks(const ColumnarOhlcHistory& ohlc_history,
+                    size_t begin_index, size_t end_index, F visitor) {
+  OhlcTick ohlc_tick;
+  for (size_t index = begin_index; index < end_index; ++index) {
+    ohlc_history[index].CopyTo(ohlc_tick);
+    visitor(ohlc_tick);
+  }
+}
+
+// Evaluation period [start_timestamp_sec, end_timestamp_sec).
+using EvaluationPeriod = std::pair<int64_t, int64_t>;
+
+// Returns the evaluation periods as defined by the eval_config.
+std::vector<EvaluationPeriod> GetEvaluationPeriods(
+    const EvaluationConfig& eval_config) {
+  if (eval_config.evaluation_period_months() <= 0) {
+    return {{eval_config.start_timestamp_sec(),
+             eval_config.end_timestamp_sec()}};
+  }
+  const int period_stride = std::max(1, eval_config.period_stride());
+  std::vector<EvaluationPeriod> periods;
+  for (int month_offset = 0;; month_offset += period_stride) {
     const int64_t start_eval_timestamp_sec = AddMonthsToTimestampSec(
         eval_config.start_timestamp_sec(), month_offset);
-    const int64_t end_eval_timestamp_sec =
-        eval_config.evaluation_period_months() > 0
-            ? AddMonthsToTimestampSec(start_eval_timestamp_sec,
-                                      eval_config.evaluation_period_months())
-            : eval_config.end_timestamp_sec();
+    const int64_t end_eval_timestamp_sec = AddMonthsToTimestampSec(
+        start_eval_timestamp_sec, eval_config.evaluation_period_months());
     if (end_eval_timestamp_sec > eval_config.end_timestamp_sec()) {
       break;
     }
-    const auto ohlc_history_subset = HistorySubset(
-        ohlc_history, start_eval_timestamp_sec, end_eval_timestamp_sec);
-    if (ohlc_history_subset.first == ohlc_history_subset.second) {
+    periods.emplace_back(start_eval_timestamp_sec, end_eval_timestamp_sec);
+  }
+  return periods;
+}
+
+// Returns the index range [begin_index, end_index) of the OHLC ticks within
+// the given evaluation period of the ohlc_history.
+std::pair<size_t, size_t> GetPeriodRange(const OhlcHistory& ohlc_history,
+                                         const EvaluationPeriod& period) {
+  const auto ohlc_history_subset =
+      HistorySubset(ohlc_history, period.first, period.second);
+  return {std::distance(ohlc_history.begin(), ohlc_history_subset.first),
+          std::distance(ohlc_history.begin(), ohlc_history_subset.second)};
+}
+
+// The same method as above, but over the columnar ohlc_history.
+std::pair<size_t, size_t> GetPeriodRange(
+    const ColumnarOhlcHistory& ohlc_history, const EvaluationPeriod& period) {
+  return ohlc_history.Subset(period.first, period.second);
+}
+
+// Baseline (Buy and HODL) method over a single evaluation period. The baseline
+// does not depend on the trader, and is therefore computed only once per
+// evaluation period (and then shared by all evaluated traders).
+struct PeriodBaseline {
+  // Index range [begin_index, end_index) of the OHLC ticks within the period.
+  size_t begin_index = 0;
+  size_t end_index = 0;
+  // Base (crypto) currency price at the beginning and the end of the period.
+  float start_price = 0;
+  float end_price = 0;
+  // Annual volatility of the baseline's portfolio (unless fast_eval).
+  float base_volatility = 0;
+  // Fingerprint of the evaluation period (see EvaluationCache).
+  uint64_t fingerprint = 0;
+
+  // Returns true iff the evaluation period contains no OHLC ticks.
+  bool empty() const { return begin_index >= end_index; }
+};
+
+// Adds the side input records (which can be observed by the OHLC ticks within
+// the time range [first_timestamp_sec, last_timestamp_sec]) to the fingerprint.
+void AddSideInputToFingerprint(const SideInput& side_input,
+                               int64_t first_timestamp_sec,
+                               int64_t last_timestamp_sec,
+                               Fingerprinter& fingerprinter) {
+  fingerprinter.Add<int32_t>(side_input.GetNumberOfSignals());
+  const int first_index =
+      std::max(0, side_input.GetSideInputIndex(first_timestamp_sec));
+  const int last_index = side_input.GetSideInputIndex(last_timestamp_sec);
+  for (int index = first_index; index <= last_index; ++index) {
+    fingerprinter.Add<int64_t>(side_input.GetSideInputTimestamp(index));
+    for (int signal_index = 0; signal_index < side_input.GetNumberOfSignals();
+         ++signal_index) {
+      fingerprinter.Add<float>(
+          side_input.GetSideInputSignal(index, signal_index));
+    }
+  }
+}
+
+// Returns the baselines for all evaluation periods of the ohlc_history (of
+// type H). Computes the period fingerprints only if compute_fingerprints is
+// true (i.e. when evaluating with the EvaluationCache).
+template <typename H>
+std::vector<PeriodBaseline> GetPeriodBaselines(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const H& ohlc_history, const SideInput* side_input,
+    const std::vector<EvaluationPeriod>& periods, bool compute_fingerprints) {
+  Fingerprinter config_fingerprinter;
+  if (compute_fingerprints) {
+    config_fingerprinter.AddString(account_config.SerializeAsString());
+    config_fingerprinter.Add<bool>(eval_config.fast_eval());
+    config_fingerprinter.Add<bool>(side_input != nullptr);
+  }
+  std::vector<PeriodBaseline> baselines(periods.size());
+  for (size_t period_index = 0; period_index < periods.size();
+       ++period_index) {
+    PeriodBaseline& baseline = baselines[period_index];
+    std::tie(baseline.begin_index, baseline.end_index) =
+        GetPeriodRange(ohlc_history, periods[period_index]);
+    if (baseline.empty()) {
       continue;
     }
-    std::unique_ptr<Trader> trader = trader_emitter.NewTrader();
-    ExecutionResult result = ExecuteTrader(
-        account_config, ohlc_history_subset.first, ohlc_history_subset.second,
-        side_input, eval_config.fast_eval(), *trader, logger);
+    int64_t first_timestamp_sec = 0;
+    int64_t last_timestamp_sec = 0;
+    VisitOhlcTicks(ohlc_history, baseline.begin_index, baseline.begin_index + 1,
+                   [&](const OhlcTick& ohlc_tick) {
+                     first_timestamp_sec = ohlc_tick.timestamp_sec();
+                     baseline.start_price = ohlc_tick.close();
+                   });
+    VisitOhlcTicks(ohlc_history, baseline.end_index - 1, baseline.end_index,
+                   [&](const OhlcTick& ohlc_tick) {
+                     last_timestamp_sec = ohlc_tick.timestamp_sec();
+                     baseline.end_price = ohlc_tick.close();
+                   });
+    if (!eval_config.fast_eval()) {
+      baseline.base_volatility = GetBaseVolatility(
+          ohlc_history, baseline.begin_index, baseline.end_index);
+    }
+    if (compute_fingerprints) {
+      Fingerprinter fingerprinter = config_fingerprinter;
+      fingerprinter.Add<int64_t>(periods[period_index].first);
+      fingerprinter.Add<int64_t>(periods[period_index].second);
+      VisitOhlcTicks(ohlc_history, baseline.begin_index, baseline.end_index,
+                     [&fingerprinter](const OhlcTick& ohlc_tick) {
+                       fingerprinter.Add<int64_t>(ohlc_tick.timestamp_sec());
+                       fingerprinter.Add<float>(ohlc_tick.open());
+                       fingerprinter.Add<float>(ohlc_tick.high());
+                       fingerprinter.Add<float>(ohlc_tick.low());
+                       fingerprinter.Add<float>(ohlc_tick.close());
+                       fingerprinter.Add<float>(ohlc_tick.volume());
+                     });
+      if (side_input != nullptr) {
+        AddSideInputToFingerprint(*side_input, first_timestamp_sec,
+                                  last_timestamp_sec, fingerprinter);
+      }
+      baseline.fingerprint = fingerprinter.fingerprint();
+    }
+  }
+  return baselines;
+}
+
+// Executes the traders in lockstep over the (non-empty) evaluation period with
+// the given baseline. Stores the ExecutionResult of the i-th trader into
+// results[i]. The base_volatility is taken from the baseline.
+template <typename H>
+void ExecuteTradersOverPeriod(const AccountConfig& account_config,
+                              const EvaluationConfig& eval_config,
+                              const H& ohlc_history,
+                              const SideInput* side_input,
+                              const PeriodBaseline& baseline,
+                              Trader* const* traders, size_t num_traders,
+                              IndicatorRegistry* indicator_registry,
+                              Logger* logger, ExecutionResult* results) {
+  assert(!baseline.empty());
+  ExecuteTradersOverRange(account_config, ohlc_history, baseline.begin_index,
+                          baseline.end_index, side_input,
+                          eval_config.fast_eval(),
+                          /*compute_base_volatility=*/false, traders,
+                          num_traders, indicator_registry, logger, results);
+  if (!eval_config.fast_eval()) {
+    for (size_t trader_index = 0; trader_index < num_traders;
+         ++trader_index) {
+      results[trader_index].set_base_volatility(baseline.base_volatility);
+    }
+  }
+}
+
+// Returns the EvaluationCache entry for the trader's ExecutionResult over the
+// evaluation period with the given baseline.
+EvaluationCacheEntry GetEvaluationCacheEntry(const std::string& name,
+                                             const EvaluationPeriod& period,
+                                             const PeriodBaseline& baseline,
+                                             const ExecutionResult& result) {
+  EvaluationCacheEntry entry;
+  entry.set_name(name);
+  entry.set_start_timestamp_sec(period.first);
+  entry.set_end_timestamp_sec(period.second);
+  entry.set_fingerprint(baseline.fingerprint);
+  *entry.mutable_result() = result;
+  return entry;
+}
+
+// Aggregates the per-period ExecutionResults of a single (type of) trader into
+// its EvaluationResult. Periods without any OHLC ticks are skipped.
+EvaluationResult AggregateEvaluationResult(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const std::string& name, const std::vector<EvaluationPeriod>& periods,
+    const std::vector<PeriodBaseline>& baselines,
+    const ExecutionResult* results) {
+  EvaluationResult eval_result;
+  *eval_result.mutable_account_config() = account_config;
+  *eval_result.mutable_eval_config() = eval_config;
+  eval_result.set_name(name);
+  for (size_t period_index = 0; period_index < periods.size();
+       ++period_index) {
+    const PeriodBaseline& baseline = baselines[period_index];
+    if (baseline.empty()) {
+      continue;
+    }
+    const ExecutionResult& result = results[period_index];
     EvaluationResult::Period* period = eval_result.add_period();
-    period->set_start_timestamp_sec(start_eval_timestamp_sec);
-    period->set_end_timestamp_sec(end_eval_timestamp_sec);
+    period->set_start_timestamp_sec(periods[period_index].first);
+    period->set_end_timestamp_sec(periods[period_index].second);
     *period->mutable_result() = result;
     assert(result.start_value() > 0);
     period->set_final_gain(result.end_value() / result.start_value());
-    assert(result.start_price() > 0 && result.end_price() > 0);
-    period->set_base_final_gain(result.end_price() / result.start_price());
-    if (eval_config.evaluation_period_months() == 0) {
-      break;
-    }
+    assert(baseline.start_price > 0 && baseline.end_price > 0);
+    period->set_base_final_gain(baseline.end_price / baseline.start_price);
   }
   eval_result.set_score(GetGeometricAverage(
       eval_result.period(), [](const EvaluationResult::Period& period) {
@@ -205,26 +543,343 @@ EvaluationResult EvaluateTrader(const AccountConfig& account_config,
   return eval_result;
 }
 
-std::vector<EvaluationResult> EvaluateBatchOfTraders(
+// Evaluates a single (type of) trader over one or more regions of the given
+// OHLC history (of type H). Reuses (and stores) the per-period results from
+// (into) the cache (if any). The cache is bypassed when logging. Without the
+// logger, the (remaining) evaluation periods are executed in parallel by (at
+// most) eval_config.num_threads threads.
+template <typename H>
+EvaluationResult EvaluateTraderImpl(const AccountConfig& account_config,
+                                    const EvaluationConfig& eval_config,
+                                    const H& ohlc_history,
+                                    const SideInput* side_input,
+                                    const TraderEmitter& trader_emitter,
+                                    Logger* logger, EvaluationCache* cache) {
+  if (logger != nullptr) {
+    cache = nullptr;
+  }
+  const std::string name = trader_emitter.GetName();
+  const std::vector<EvaluationPeriod> periods =
+      GetEvaluationPeriods(eval_config);
+  const std::vector<PeriodBaseline> baselines =
+      GetPeriodBaselines(account_config, eval_config, ohlc_history, side_input,
+                         periods, /*compute_fingerprints=*/cache != nullptr);
+  std::vector<ExecutionResult> results(periods.size());
+  // Indices of the evaluation periods over which the trader is executed.
+  std::vector<size_t> pending_periods;
+  for (size_t period_index = 0; period_index < periods.size();
+       ++period_index) {
+    const PeriodBaseline& baseline = baselines[period_index];
+    if (!baseline.empty() &&
+        (cache == nullptr ||
+         !cache->Lookup(name, baseline.fingerprint, &results[period_index]))) {
+      pending_periods.push_back(period_index);
+    }
+  }
+  const auto execute_over_period = [&](size_t i) {
+    const size_t period_index = pending_periods[i];
+    ExecutionResult& result = results[period_index];
+    std::unique_ptr<Trader> trader = trader_emitter.NewTrader();
+    Trader* const traders[] = {trader.get()};
+    if (logger != nullptr) {
+      logger->BeginPeriod(periods[period_index].first,
+                          periods[period_index].second);
+    }
+    ExecuteTradersOverPeriod(account_config, eval_config, ohlc_history,
+                             side_input, baselines[period_index], traders,
+                             /*num_traders=*/1,
+                             /*indicator_registry=*/nullptr, logger, &result);
+    if (cache != nullptr) {
+      cache->Insert(GetEvaluationCacheEntry(name, periods[period_index],
+                                            baselines[period_index], result));
+    }
+  };
+  // The logger requires the periods to be executed sequentially (in order).
+  if (logger != nullptr || pending_periods.size() <= 1) {
+    for (size_t i = 0; i < pending_periods.size(); ++i) {
+      execute_over_period(i);
+    }
+  } else {
+    const int num_threads = static_cast<int>(std::min<size_t>(
+        eval_config.num_threads() > 0
+            ? eval_config.num_threads()
+            : std::max(1u, std::thread::hardware_concurrency()),
+        pending_periods.size()));
+    WorkStealingExecutor executor(num_threads);
+    executor.ParallelFor(pending_periods.size(), execute_over_period);
+  }
+  return AggregateEvaluationResult(account_config, eval_config, name, periods,
+                                   baselines, results.data());
+}
+
+// Maximum number of traders whose (per-period) results are kept in memory at
+// the same time by EvaluateBatchOfTradersImpl. Larger batches are evaluated
+// in consecutive chunks of traders, so that the memory stays flat however
+// large the batch is.
+constexpr size_t kMaxTradersPerChunk = 1024;
+
+// Evaluates (in parallel) a batch of traders over one or more regions of
+// the given OHLC history (of type H). The baselines of all evaluation periods
+// are computed upfront. The batch is evaluated in chunks of (at most)
+// kMaxTradersPerChunk traders. Within a chunk, the (per-period) results found
+// in the cache (if any) are reused, the remaining traders are split into
+// blocks of (at most) eval_config.lockstep_batch_size traders, which are
+// executed in lockstep (within a single pass over the OHLC history). Every
+// (block of traders, evaluation period) pair is a separate task for the
+// work-stealing executor, so that long multi-period evaluations are balanced
+// across all threads. The results of every chunk are passed to the callback
+// (in the order of the trader_emitters) before the next chunk is evaluated.
+template <typename H>
+void EvaluateBatchOfTradersImpl(
     const AccountConfig& account_config, const EvaluationConfig& eval_config,
-    const OhlcHistory& ohlc_history, const SideInput* side_input,
-    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters) {
-  std::vector<EvaluationResult> eval_results;
-  std::vector<std::future<EvaluationResult>> eval_result_futures;
-  for (const auto& trader_emitter_ptr : trader_emitters) {
-    const TraderEmitter& trader_emitter = *trader_emitter_ptr;
-    eval_result_futures.emplace_back(
-        std::async([&account_config, &eval_config, &ohlc_history, side_input,
-                    &trader_emitter]() {
-          return EvaluateTrader(account_config, eval_config, ohlc_history,
-                                side_input, trader_emitter,
-                                /*logger=*/nullptr);
-        }));
-  }
-  for (auto& eval_result_future : eval_result_futures) {
-    eval_results.emplace_back(eval_result_future.get());
+    const H& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache, const EvaluationResultCallback& callback) {
+  const std::vector<EvaluationPeriod> periods =
+      GetEvaluationPeriods(eval_config);
+  const size_t num_periods = periods.size();
+  const std::vector<PeriodBaseline> baselines =
+      GetPeriodBaselines(account_config, eval_config, ohlc_history, side_input,
+                         periods, /*compute_fingerprints=*/cache != nullptr);
+  const size_t block_size =
+      static_cast<size_t>(std::max(1, eval_config.lockstep_batch_size()));
+  WorkStealingExecutor executor(eval_config.num_threads());
+  for (size_t chunk_begin = 0; chunk_begin < trader_emitters.size();
+       chunk_begin += kMaxTradersPerChunk) {
+    const size_t num_traders =
+        std::min(kMaxTradersPerChunk, trader_emitters.size() - chunk_begin);
+    const std::unique_ptr<TraderEmitter>* const chunk_emitters =
+        trader_emitters.data() + chunk_begin;
+    std::vector<std::string> names;
+    names.reserve(num_traders);
+    for (size_t trader_index = 0; trader_index < num_traders; ++trader_index) {
+      names.push_back(chunk_emitters[trader_index]->GetName());
+    }
+    std::vector<ExecutionResult> results(num_traders * num_periods);
+    // Indices of the traders to be executed over every evaluation period.
+    std::vector<std::vector<size_t>> pending_traders(num_periods);
+    for (size_t period_index = 0; period_index < num_periods; ++period_index) {
+      const PeriodBaseline& baseline = baselines[period_index];
+      if (baseline.empty()) {
+        continue;
+      }
+      for (size_t trader_index = 0; trader_index < num_traders;
+           ++trader_index) {
+        if (cache == nullptr ||
+            !cache->Lookup(
+                names[trader_index], baseline.fingerprint,
+                &results[trader_index * num_periods + period_index])) {
+          pending_traders[period_index].push_back(trader_index);
+        }
+      }
+    }
+    // Block of (pending) traders [begin, end) over the evaluation period.
+    struct BlockTask {
+      size_t period_index;
+      size_t begin;
+      size_t end;
+    };
+    std::vector<BlockTask> tasks;
+    for (size_t period_index = 0; period_index < num_periods; ++period_index) {
+      const size_t num_pending = pending_traders[period_index].size();
+      for (size_t begin = 0; begin < num_pending; begin += block_size) {
+        tasks.push_back(
+            {period_index, begin, std::min(begin + block_size, num_pending)});
+      }
+    }
+    executor.ParallelFor(tasks.size(), [&](size_t task_index) {
+      const BlockTask& task = tasks[task_index];
+      const std::vector<size_t>& trader_indices =
+          pending_traders[task.period_index];
+      // Indicators shared by all traders in the block (e.g. the same moving
+      // average used by traders that differ only in their thresholds).
+      IndicatorRegistry indicator_registry;
+      std::vector<std::unique_ptr<Trader>> traders;
+      std::vector<Trader*> trader_ptrs;
+      traders.reserve(task.end - task.begin);
+      trader_ptrs.reserve(task.end - task.begin);
+      for (size_t i = task.begin; i < task.end; ++i) {
+        traders.push_back(
+            chunk_emitters[trader_indices[i]]->NewTrader(indicator_registry));
+        trader_ptrs.push_back(traders.back().get());
+      }
+      std::vector<ExecutionResult> block_results(traders.size());
+      ExecuteTradersOverPeriod(account_config, eval_config, ohlc_history,
+                               side_input, baselines[task.period_index],
+                               trader_ptrs.data(), trader_ptrs.size(),
+                               &indicator_registry, /*logger=*/nullptr,
+                               block_results.data());
+      for (size_t i = task.begin; i < task.end; ++i) {
+        results[trader_indices[i] * num_periods + task.period_index] =
+            std::move(block_results[i - task.begin]);
+      }
+    });
+    if (cache != nullptr) {
+      for (size_t period_index = 0; period_index < num_periods;
+           ++period_index) {
+        for (const size_t trader_index : pending_traders[period_index]) {
+          cache->Insert(GetEvaluationCacheEntry(
+              names[trader_index], periods[period_index],
+              baselines[period_index],
+              results[trader_index * num_periods + period_index]));
+        }
+      }
+    }
+    for (size_t trader_index = 0; trader_index < num_traders; ++trader_index) {
+      callback(chunk_begin + trader_index,
+               AggregateEvaluationResult(
+                   account_config, eval_config, names[trader_index], periods,
+                   baselines, results.data() + trader_index * num_periods));
+    }
   }
+}
+
+// Evaluates (in parallel) a batch of traders over the OHLC history (of type
+// H). Returns the results in the same order as the trader_emitters.
+template <typename H>
+std::vector<EvaluationResult> EvaluateBatchOfTradersImpl(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const H& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache) {
+  std::vector<EvaluationResult> eval_results;
+  eval_results.reserve(trader_emitters.size());
+  EvaluateBatchOfTradersImpl(
+      account_config, eval_config, ohlc_history, side_input, trader_emitters,
+      cache, [&eval_results](size_t, EvaluationResult eval_result) {
+        eval_results.push_back(std::move(eval_result));
+      });
   return eval_results;
 }
+}  // namespace
+
+ExecutionResult ExecuteTrader(const AccountConfig& account_config,
+                              OhlcHistory::const_iterator ohlc_history_begin,
+                              OhlcHistory::const_iterator ohlc_history_end,
+                              const SideInput* side_input, bool fast_eval,
+                              Trader& trader, Logger* logger) {
+  Trader* const traders[] = {&trader};
+  ExecutionResult result;
+  ExecuteTradersImpl(
+      account_config, std::distance(ohlc_history_begin, ohlc_history_end),
+      [ohlc_history_begin](size_t index) -> const OhlcTick& {
+        return *(ohlc_history_begin + index);
+      },
+      side_input, fast_eval, /*compute_base_volatility=*/true, traders,
+      /*num_traders=*/1, /*indicator_registry=*/nullptr, logger, &result);
+  return result;
+}
+
+ExecutionResult ExecuteTrader(const AccountConfig& account_config,
+                              const ColumnarOhlcHistory& ohlc_history,
+                              size_t begin_index, size_t end_index,
+                              const SideInput* side_input, bool fast_eval,
+                              Trader& trader, Logger* logger) {
+  Trader* const traders[] = {&trader};
+  ExecutionResult result;
+  ExecuteTradersOverRange(account_config, ohlc_history, begin_index, end_index,
+                          side_input, fast_eval,
+                          /*compute_base_volatility=*/true, traders,
+                          /*num_traders=*/1, /*indicator_registry=*/nullptr,
+                          logger, &result);
+  return result;
+}
+
+std::vector<ExecutionResult> ExecuteTradersInLockstep(
+    const AccountConfig& account_config,
+    OhlcHistory::const_iterator ohlc_history_begin,
+    OhlcHistory::const_iterator ohlc_history_end, const SideInput* side_input,
+    bool fast_eval, const std::vector<std::unique_ptr<Trader>>& traders) {
+  std::vector<Trader*> trader_ptrs;
+  trader_ptrs.reserve(traders.size());
+  for (const std::unique_ptr<Trader>& trader : traders) {
+    trader_ptrs.push_back(trader.get());
+  }
+  std::vector<ExecutionResult> results(traders.size());
+  ExecuteTradersImpl(
+      account_config, std::distance(ohlc_history_begin, ohlc_history_end),
+      [ohlc_history_begin](size_t index) -> const OhlcTick& {
+        return *(ohlc_history_begin + index);
+      },
+      side_input, fast_eval, /*compute_base_volatility=*/true,
+      trader_ptrs.data(), trader_ptrs.size(), /*indicator_registry=*/nullptr,
+      /*logger=*/nullptr, results.data());
+  return results;
+}
+
+std::vector<ExecutionResult> ExecuteTradersInLockstep(
+    const AccountConfig& account_config,
+    const ColumnarOhlcHistory& ohlc_history, size_t begin_index,
+    size_t end_index, const SideInput* side_input, bool fast_eval,
+    const std::vector<std::unique_ptr<Trader>>& traders) {
+  std::vector<Trader*> trader_ptrs;
+  trader_ptrs.reserve(traders.size());
+  for (const std::unique_ptr<Trader>& trader : traders) {
+    trader_ptrs.push_back(trader.get());
+  }
+  std::vector<ExecutionResult> results(traders.size());
+  ExecuteTradersOverRange(account_config, ohlc_history, begin_index, end_index,
+                          side_input, fast_eval,
+                          /*compute_base_volatility=*/true, trader_ptrs.data(),
+                          trader_ptrs.size(), /*indicator_registry=*/nullptr,
+                          /*logger=*/nullptr, results.data());
+  return results;
+}
+
+EvaluationResult EvaluateTrader(const AccountConfig& account_config,
+                                const EvaluationConfig& eval_config,
+                                const OhlcHistory& ohlc_history,
+                                const SideInput* side_input,
+                                const TraderEmitter& trader_emitter,
+                                Logger* logger, EvaluationCache* cache) {
+  return EvaluateTraderImpl(account_config, eval_config, ohlc_history,
+                            side_input, trader_emitter, logger, cache);
+}
+
+EvaluationResult EvaluateTrader(const AccountConfig& account_config,
+                                const EvaluationConfig& eval_config,
+                                const ColumnarOhlcHistory& ohlc_history,
+                                const SideInput* side_input,
+                                const TraderEmitter& trader_emitter,
+                                Logger* logger, EvaluationCache* cache) {
+  return EvaluateTraderImpl(account_config, eval_config, ohlc_history,
+                            side_input, trader_emitter, logger, cache);
+}
+
+std::vector<EvaluationResult> EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const OhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache) {
+  return EvaluateBatchOfTradersImpl(account_config, eval_config, ohlc_history,
+                                    side_input, trader_emitters, cache);
+}
+
+std::vector<EvaluationResult> EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const ColumnarOhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache) {
+  return EvaluateBatchOfTradersImpl(account_config, eval_config, ohlc_history,
+                                    side_input, trader_emitters, cache);
+}
+
+void EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const OhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache, const EvaluationResultCallback& callback) {
+  EvaluateBatchOfTradersImpl(account_config, eval_config, ohlc_history,
+                             side_input, trader_emitters, cache, callback);
+}
+
+void EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const ColumnarOhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache, const EvaluationResultCallback& callback) {
+  EvaluateBatchOfTradersImpl(account_config, eval_config, ohlc_history,
+                             side_input, trader_emitters, cache, callback);
+}
 
 }  // namespace trader
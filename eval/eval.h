@@ -3,11 +3,15 @@
 #ifndef EVAL_EVAL_H
 #define EVAL_EVAL_H
 
+#include <functional>
+
 #include "base/account.h"
 #include "base/base.h"
+#include "base/columnar_history.h"
 #include "base/side_input.h"
 #include "base/trader.h"
 #include "eval/eval.pb.h"
+#include "eval/evaluation_cache.h"
 #include "logging/logger.h"
 
 namespace trader {
@@ -20,22 +24,106 @@ ExecutionResult ExecuteTrader(const AccountConfig& account_config,
                               const SideInput* side_input, bool fast_eval,
                               Trader& trader, Logger* logger);
 
+// Executes an instance of a trader over the OHLC ticks of the (columnar)
+// ohlc_history within the index range [begin_index, end_index).
+// Returns the same ExecutionResult as the ExecuteTrader method above.
+ExecutionResult ExecuteTrader(const AccountConfig& account_config,
+                              const ColumnarOhlcHistory& ohlc_history,
+                              size_t begin_index, size_t end_index,
+                              const SideInput* side_input, bool fast_eval,
+                              Trader& trader, Logger* logger);
+
+// Executes the traders in lockstep over a region of the OHLC history, i.e.
+// all traders (each with its own account and orders) are advanced tick by tick
+// within a single pass over the OHLC history. Every OHLC tick (and the
+// corresponding side input) is therefore read only once for all traders.
+// Returns the same ExecutionResult for every trader (in the same order) as
+// the ExecuteTrader method above (without any logger).
+std::vector<ExecutionResult> ExecuteTradersInLockstep(
+    const AccountConfig& account_config,
+    OhlcHistory::const_iterator ohlc_history_begin,
+    OhlcHistory::const_iterator ohlc_history_end, const SideInput* side_input,
+    bool fast_eval, const std::vector<std::unique_ptr<Trader>>& traders);
+
+// The same method as ExecuteTradersInLockstep above, but over the OHLC ticks
+// of the (columnar) ohlc_history within the index range [begin_index,
+// end_index).
+std::vector<ExecutionResult> ExecuteTradersInLockstep(
+    const AccountConfig& account_config,
+    const ColumnarOhlcHistory& ohlc_history, size_t begin_index,
+    size_t end_index, const SideInput* side_input, bool fast_eval,
+    const std::vector<std::unique_ptr<Trader>>& traders);
+
 // Evaluates a single (type of) trader (as emitted by the trader_emitter)
 // over one or more regions of the OHLC history (as defined by the
 // eval_config). Returns trader's EvaluationResult.
+// The baseline (Buy and HODL) method is evaluated only once per evaluation
+// period. If the cache is not null (and the logger is null), then the trader's
+// per-period results are looked up in (and added to) the cache. If the logger
+// is null, then the evaluation periods are executed in parallel (using at most
+// eval_config.num_threads threads). Otherwise, the periods are executed
+// sequentially and the logger is notified at the beginning of every period
+// (see Logger::BeginPeriod). The periods of the result are always in
+// the chronological order.
 EvaluationResult EvaluateTrader(const AccountConfig& account_config,
                                 const EvaluationConfig& eval_config,
                                 const OhlcHistory& ohlc_history,
                                 const SideInput* side_input,
                                 const TraderEmitter& trader_emitter,
-                                Logger* logger);
+                                Logger* logger, EvaluationCache* cache);
+
+// The same method as EvaluateTrader above, but over the columnar ohlc_history.
+EvaluationResult EvaluateTrader(const AccountConfig& account_config,
+                                const EvaluationConfig& eval_config,
+                                const ColumnarOhlcHistory& ohlc_history,
+                                const SideInput* side_input,
+                                const TraderEmitter& trader_emitter,
+                                Logger* logger, EvaluationCache* cache);
 
 // Evaluates (in parallel) a batch of traders (as emitted by the vector of
 // trader_emitters) over one or more regions of the OHLC history.
+// Uses a bounded pool of eval_config.num_threads threads, each executing blocks
+// of eval_config.lockstep_batch_size traders in lockstep. If the cache is not
+// null, then only the traders' per-period results missing in the cache are
+// executed (and added to the cache). Returns the results in the same order as
+// the trader_emitters.
+std::vector<EvaluationResult> EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const OhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache);
+
+// The same method as EvaluateBatchOfTraders above, but over the columnar
+// ohlc_history.
 std::vector<EvaluationResult> EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const ColumnarOhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache);
+
+// Called with the index (within the batch) and the EvaluationResult of every
+// evaluated trader.
+using EvaluationResultCallback =
+    std::function<void(size_t trader_index, EvaluationResult eval_result)>;
+
+// The same method as EvaluateBatchOfTraders above, but instead of returning
+// all results at once, the batch is evaluated in chunks of traders and the
+// result of every trader is passed to the callback (in the order of the
+// trader_emitters, from the calling thread) as soon as its chunk is done.
+// Only the results of a single chunk are kept in memory.
+void EvaluateBatchOfTraders(
     const AccountConfig& account_config, const EvaluationConfig& eval_config,
     const OhlcHistory& ohlc_history, const SideInput* side_input,
-    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters);
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache, const EvaluationResultCallback& callback);
+
+// The same method as EvaluateBatchOfTraders above, but over the columnar
+// ohlc_history.
+void EvaluateBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const ColumnarOhlcHistory& ohlc_history, const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache, const EvaluationResultCallback& callback);
 
 }  // namespace trader
 
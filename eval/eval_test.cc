@@ -5,9 +5,12 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 
+#include <atomic>
+
 #include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
 #include "gtest/gtest.h"
+#include "indicators/indicator_registry.h"
 #include "logging/csv_logger.h"
 #include "util/time.h"
 
@@ -132,7 +135,7 @@ class TestTrader : public Trader {
                  : absl::StrFormat("IN_CASH,LIMIT_BUY@%.0f", buy_price_));
   }
 
- private:
+ protected:
   // Price at which we want to buy the base (crypto) currency.
   float buy_price_ = 0.0f;
   // Price at which we want to sell the base (crypto) currency.
@@ -148,6 +151,43 @@ class TestTrader : public Trader {
   bool is_long_ = false;
 };
 
+// TestTrader exporting the structured internal state.
+class StructuredTestTrader : public TestTrader {
+ public:
+  StructuredTestTrader(float buy_price, float sell_price)
+      : TestTrader(buy_price, sell_price) {}
+  virtual ~StructuredTestTrader() {}
+
+  std::string GetInternalState() const override {
+    ++num_get_internal_state_calls_;
+    return TestTrader::GetInternalState();
+  }
+
+  TraderStateSchema GetStateSchema() const override {
+    return {{"base_balance", {}},
+            {"quote_balance", {}},
+            {"close", {}},
+            {"mode", {"IN_CASH", "IN_LONG"}}};
+  }
+
+  void GetState(float* state) const override {
+    ++num_get_state_calls_;
+    state[0] = last_base_balance_;
+    state[1] = last_quote_balance_;
+    state[2] = last_close_;
+    state[3] = is_long_ ? 1 : 0;
+  }
+
+  int num_get_internal_state_calls() const {
+    return num_get_internal_state_calls_;
+  }
+  int num_get_state_calls() const { return num_get_state_calls_; }
+
+ private:
+  mutable int num_get_internal_state_calls_ = 0;
+  mutable int num_get_state_calls_ = 0;
+};
+
 // Emitter that emits TestTrader as defined above.
 class TestTraderEmitter : public TraderEmitter {
  public:
@@ -244,6 +284,54 @@ TEST(ExecuteTraderTest, LimitBuyAndSell) {
             "1483574400,32.300,21.000,50.000,IN_LONG,LIMIT_SELL@200\n");
 }
 
+TEST(ExecuteTraderTest, LogStructuredTraderState) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1)",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupDailyOhlcHistory(ohlc_history);
+
+  StructuredTestTrader trader(/*buy_price=*/50, /*sell_price=*/200);
+  std::stringstream trader_os;
+  CsvLogger logger(/*exchange_os=*/nullptr, &trader_os);
+  ExecuteTrader(account_config, ohlc_history.begin(), ohlc_history.end(),
+                /*side_input=*/nullptr,
+                /*fast_eval=*/false, trader, &logger);
+  EXPECT_EQ(trader_os.str(),
+            "1483228800,10.000,0.000,120.000,IN_LONG\n"
+            "1483315200,10.000,0.000,150.000,IN_LONG\n"
+            "1483401600,0.000,1799.000,140.000,IN_CASH\n"
+            "1483488000,0.000,1799.000,100.000,IN_CASH\n"
+            "1483574400,32.300,21.000,50.000,IN_LONG\n");
+  EXPECT_EQ(trader.num_get_internal_state_calls(), 0);
+  EXPECT_EQ(trader.num_get_state_calls(), 5);
+
+  // The trader state is not computed when the logger discards it.
+  StructuredTestTrader exchange_only_trader(/*buy_price=*/50,
+                                            /*sell_price=*/200);
+  std::stringstream exchange_os;
+  CsvLogger exchange_logger(&exchange_os, /*trader_os=*/nullptr);
+  ExecuteTrader(account_config, ohlc_history.begin(), ohlc_history.end(),
+                /*side_input=*/nullptr,
+                /*fast_eval=*/false, exchange_only_trader, &exchange_logger);
+  EXPECT_FALSE(exchange_os.str().empty());
+  EXPECT_EQ(exchange_only_trader.num_get_internal_state_calls(), 0);
+  EXPECT_EQ(exchange_only_trader.num_get_state_calls(), 0);
+}
+
 TEST(ExecuteTraderTest, LimitBuyAndSellFastEval) {
   AccountConfig account_config;
   ASSERT_TRUE(TextFormat::ParseFromString(
@@ -330,7 +418,8 @@ TEST(EvaluateTraderTest, LimitBuyAndSellOnePeriod) {
 
   EvaluationResult result =
       EvaluateTrader(account_config, eval_config, ohlc_history,
-                     /*side_input=*/nullptr, trader_emitter, &logger);
+                     /*side_input=*/nullptr, trader_emitter, &logger,
+                     /*cache=*/nullptr);
 
   EvaluationResult expected_result;
   ASSERT_TRUE(TextFormat::ParseFromString(
@@ -468,7 +557,7 @@ TEST(EvaluateTraderTest, LimitBuyAndSellOnePeriodFastEval) {
   EvaluationResult result =
       EvaluateTrader(account_config, eval_config, ohlc_history,
                      /*side_input=*/nullptr, trader_emitter,
-                     /*logger=*/nullptr);
+                     /*logger=*/nullptr, /*cache=*/nullptr);
 
   EvaluationResult expected_result;
   ASSERT_TRUE(TextFormat::ParseFromString(
@@ -559,7 +648,7 @@ TEST(EvaluateTraderTest, LimitBuyAndSellMultiple6MonthPeriods) {
   EvaluationResult result =
       EvaluateTrader(account_config, eval_config, ohlc_history,
                      /*side_input=*/nullptr, trader_emitter,
-                     /*logger=*/nullptr);
+                     /*logger=*/nullptr, /*cache=*/nullptr);
 
   EvaluationResult expected_result;
   ASSERT_TRUE(TextFormat::ParseFromString(
@@ -775,7 +864,8 @@ TEST(EvaluateBatchOfTradersTest, LimitBuyAndSellMultiple6MonthPeriods) {
 
   std::vector<EvaluationResult> eval_results =
       EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
-                             /*side_input=*/nullptr, trader_emitters);
+                             /*side_input=*/nullptr, trader_emitters,
+                             /*cache=*/nullptr);
 
   ASSERT_EQ(eval_results.size(), 3);
   EvaluationResult expected_result[3];
@@ -1003,6 +1093,295 @@ TEST(EvaluateBatchOfTradersTest, LimitBuyAndSellMultiple6MonthPeriods) {
                 /*full_scope=*/false);
 }
 
+TEST(EvaluateTraderTest, SameResultsForAnyNumberOfThreads) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 1
+        fast_eval: false
+        num_threads: 1
+        )",
+      &eval_config));
+
+  const TestTraderEmitter trader_emitter(/*buy_price=*/50, /*sell_price=*/350);
+  const EvaluationResult expected_result = EvaluateTrader(
+      account_config, eval_config, ohlc_history, /*side_input=*/nullptr,
+      trader_emitter, /*logger=*/nullptr, /*cache=*/nullptr);
+  ASSERT_GT(expected_result.period_size(), 1);
+  for (const int num_threads : {0, 2, 3, 8}) {
+    eval_config.set_num_threads(num_threads);
+    for (int i = 0; i < 2; ++i) {
+      const EvaluationResult result =
+          i == 0 ? EvaluateTrader(account_config, eval_config, ohlc_history,
+                                  /*side_input=*/nullptr, trader_emitter,
+                                  /*logger=*/nullptr, /*cache=*/nullptr)
+                 : EvaluateTrader(account_config, eval_config,
+                                  columnar_ohlc_history,
+                                  /*side_input=*/nullptr, trader_emitter,
+                                  /*logger=*/nullptr, /*cache=*/nullptr);
+      // The periods are in the chronological order.
+      ASSERT_EQ(result.period_size(), expected_result.period_size());
+      for (int j = 0; j < result.period_size(); ++j) {
+        EXPECT_EQ(result.period(j).start_timestamp_sec(),
+                  expected_result.period(j).start_timestamp_sec());
+        ExpectProtoEq(result.period(j), expected_result.period(j));
+      }
+      EXPECT_FLOAT_EQ(result.score(), expected_result.score());
+    }
+  }
+}
+
+namespace {
+// Logger recording the evaluation periods and the number of OHLC ticks
+// logged outside of the current evaluation period.
+class PeriodRecordingLogger : public Logger {
+ public:
+  void BeginPeriod(int64_t start_timestamp_sec,
+                   int64_t end_timestamp_sec) override {
+    periods.emplace_back(start_timestamp_sec, end_timestamp_sec);
+  }
+  void LogExchangeState(const OhlcTick& ohlc_tick,
+                        const Account& account) override {
+    if (periods.empty() ||
+        ohlc_tick.timestamp_sec() < periods.back().first ||
+        ohlc_tick.timestamp_sec() >= periods.back().second) {
+      ++num_ticks_outside_period;
+    }
+  }
+  void LogExchangeState(const OhlcTick& ohlc_tick, const Account& account,
+                        const Order& order) override {}
+  void LogTraderState(absl::string_view trader_state) override {}
+  void SetTraderStateSchema(const TraderStateSchema& schema) override {}
+  void LogTraderState(const float* trader_state) override {}
+
+  std::vector<std::pair<int64_t, int64_t>> periods;
+  int num_ticks_outside_period = 0;
+};
+}  // namespace
+
+TEST(EvaluateTraderTest, NotifiesLoggerOfEveryPeriod) {
+  AccountConfig account_config;
+  account_config.set_start_base_balance(10);
+  account_config.set_base_unit(0.1f);
+  account_config.set_quote_unit(1);
+  account_config.set_market_liquidity(0.5f);
+  account_config.set_max_volume_ratio(0.1f);
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+
+  EvaluationConfig eval_config;
+  eval_config.set_start_timestamp_sec(1483228800);  // 2017-01-01
+  eval_config.set_end_timestamp_sec(1514764800);    // 2018-01-01
+  eval_config.set_evaluation_period_months(6);
+  eval_config.set_num_threads(4);
+
+  const TestTraderEmitter trader_emitter(/*buy_price=*/50, /*sell_price=*/200);
+  PeriodRecordingLogger logger;
+  const EvaluationResult result = EvaluateTrader(
+      account_config, eval_config, ohlc_history, /*side_input=*/nullptr,
+      trader_emitter, &logger, /*cache=*/nullptr);
+
+  // The periods are executed sequentially (in the chronological order).
+  ASSERT_EQ(logger.periods.size(), result.period_size());
+  for (int i = 0; i < result.period_size(); ++i) {
+    EXPECT_EQ(logger.periods[i].first, result.period(i).start_timestamp_sec());
+    EXPECT_EQ(logger.periods[i].second, result.period(i).end_timestamp_sec());
+  }
+  EXPECT_EQ(logger.num_ticks_outside_period, 0);
+}
+
+TEST(EvaluateBatchOfTradersTest, SameResultsForAnyNumberOfThreads) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 3
+        fast_eval: false
+        )",
+      &eval_config));
+
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (int buy_price = 20; buy_price <= 100; buy_price += 10) {
+    for (int sell_price = 150; sell_price <= 550; sell_price += 100) {
+      trader_emitters.emplace_back(
+          new TestTraderEmitter(buy_price, sell_price));
+    }
+  }
+
+  std::vector<EvaluationResult> expected_results;
+  for (const auto& trader_emitter : trader_emitters) {
+    expected_results.push_back(EvaluateTrader(
+        account_config, eval_config, ohlc_history, /*side_input=*/nullptr,
+        *trader_emitter, /*logger=*/nullptr, /*cache=*/nullptr));
+  }
+  for (const int num_threads : {1, 2, 3, 8}) {
+    eval_config.set_num_threads(num_threads);
+    std::vector<EvaluationResult> results =
+        EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                               /*side_input=*/nullptr, trader_emitters,
+                               /*cache=*/nullptr);
+    ASSERT_EQ(results.size(), expected_results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(results[i].name(), expected_results[i].name());
+      ExpectProtoEq(results[i], expected_results[i], /*full_scope=*/false);
+      EXPECT_EQ(results[i].eval_config().num_threads(), num_threads);
+    }
+  }
+}
+
+TEST(ExecuteTraderTest, ColumnarLimitBuyAndSell) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1)",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupDailyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_history(ohlc_history);
+
+  for (const bool fast_eval : {false, true}) {
+    std::stringstream exchange_os;
+    std::stringstream trader_os;
+    CsvLogger logger(&exchange_os, &trader_os);
+    TestTrader trader(/*buy_price=*/50, /*sell_price=*/200);
+    ExecutionResult expected_result =
+        ExecuteTrader(account_config, ohlc_history.begin(), ohlc_history.end(),
+                      /*side_input=*/nullptr, fast_eval, trader, &logger);
+
+    std::stringstream columnar_exchange_os;
+    std::stringstream columnar_trader_os;
+    CsvLogger columnar_logger(&columnar_exchange_os, &columnar_trader_os);
+    TestTrader columnar_trader(/*buy_price=*/50, /*sell_price=*/200);
+    ExecutionResult result = ExecuteTrader(
+        account_config, columnar_history, /*begin_index=*/0,
+        columnar_history.size(), /*side_input=*/nullptr, fast_eval,
+        columnar_trader, &columnar_logger);
+
+    ExpectProtoEq(result, expected_result);
+    EXPECT_EQ(columnar_exchange_os.str(), exchange_os.str());
+    EXPECT_EQ(columnar_trader_os.str(), trader_os.str());
+  }
+}
+
+TEST(EvaluateBatchOfTradersTest, ColumnarLimitBuyAndSellMultiplePeriods) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 6
+        fast_eval: false
+        )",
+      &eval_config));
+
+  TestTraderEmitter trader_emitter(/*buy_price=*/50, /*sell_price=*/200);
+  ExpectProtoEq(
+      EvaluateTrader(account_config, eval_config, columnar_history,
+                     /*side_input=*/nullptr, trader_emitter,
+                     /*logger=*/nullptr, /*cache=*/nullptr),
+      EvaluateTrader(account_config, eval_config, ohlc_history,
+                     /*side_input=*/nullptr, trader_emitter,
+                     /*logger=*/nullptr, /*cache=*/nullptr));
+
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  trader_emitters.emplace_back(new TestTraderEmitter(/*buy_price=*/50,
+                                                     /*sell_price=*/200));
+  trader_emitters.emplace_back(new TestTraderEmitter(/*buy_price=*/40,
+                                                     /*sell_price=*/250));
+  trader_emitters.emplace_back(new TestTraderEmitter(/*buy_price=*/30,
+                                                     /*sell_price=*/500));
+
+  std::vector<EvaluationResult> expected_results =
+      EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                             /*side_input=*/nullptr, trader_emitters,
+                             /*cache=*/nullptr);
+  std::vector<EvaluationResult> results =
+      EvaluateBatchOfTraders(account_config, eval_config, columnar_history,
+                             /*side_input=*/nullptr, trader_emitters,
+                             /*cache=*/nullptr);
+  ASSERT_EQ(results.size(), expected_results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ExpectProtoEq(results[i], expected_results[i]);
+  }
+}
+
 namespace {
 // Adds signals to the side_history.
 void AddSignals(const std::vector<float>& signals, int64_t timestamp_sec,
@@ -1202,4 +1581,579 @@ TEST(ExecuteTraderWithSideInputTest, MarketBuyAndSell) {
             "1483574400,10.800,21.000,50.000,DO_NOTHING,0\n");
 }
 
+TEST(ExecuteTradersInLockstepTest, SameResultsAsExecuteTrader) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  // Zero volume OHLC tick (gap in the price history) keeps the orders.
+  ohlc_history[5].set_volume(0);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (int buy_price = 20; buy_price <= 100; buy_price += 20) {
+    for (int sell_price = 150; sell_price <= 550; sell_price += 200) {
+      trader_emitters.emplace_back(
+          new TestTraderEmitter(buy_price, sell_price));
+    }
+  }
+
+  for (const bool fast_eval : {false, true}) {
+    std::vector<ExecutionResult> expected_results;
+    std::vector<std::unique_ptr<Trader>> traders;
+    std::vector<std::unique_ptr<Trader>> columnar_traders;
+    for (const auto& trader_emitter : trader_emitters) {
+      std::unique_ptr<Trader> trader = trader_emitter->NewTrader();
+      expected_results.push_back(ExecuteTrader(
+          account_config, ohlc_history.begin(), ohlc_history.end(),
+          /*side_input=*/nullptr, fast_eval, *trader, /*logger=*/nullptr));
+      traders.push_back(trader_emitter->NewTrader());
+      columnar_traders.push_back(trader_emitter->NewTrader());
+    }
+    std::vector<ExecutionResult> results = ExecuteTradersInLockstep(
+        account_config, ohlc_history.begin(), ohlc_history.end(),
+        /*side_input=*/nullptr, fast_eval, traders);
+    std::vector<ExecutionResult> columnar_results = ExecuteTradersInLockstep(
+        account_config, columnar_ohlc_history, /*begin_index=*/0,
+        columnar_ohlc_history.size(), /*side_input=*/nullptr, fast_eval,
+        columnar_traders);
+    ASSERT_EQ(results.size(), expected_results.size());
+    ASSERT_EQ(columnar_results.size(), expected_results.size());
+    for (size_t i = 0; i < expected_results.size(); ++i) {
+      ExpectProtoEq(results[i], expected_results[i]);
+      ExpectProtoEq(columnar_results[i], expected_results[i]);
+    }
+  }
+}
+
+TEST(ExecuteTradersInLockstepTest, SharedSideInput) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        market_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.8
+        max_volume_ratio: 0.5)",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupDailyOhlcHistory(ohlc_history);
+
+  SideHistory side_history;
+  AddSignals(/*signals=*/{2},
+             /*timestamp_sec=*/1483315200 - kSecondsPerHour,
+             side_history);  // SHOULD_SELL on 2017-01-02 -1h
+  AddSignals(/*signals=*/{1}, /*timestamp_sec=*/1483488000,
+             side_history);  // SHOULD_BUY on 2017-01-04
+  AddSignals(/*signals=*/{0},
+             /*timestamp_sec=*/1483574400,
+             side_history);  // DO_NOTHING on 2017-01-05
+  SideInput side_input(side_history);
+
+  TestTraderWithSideInput trader;
+  const ExecutionResult expected_result = ExecuteTrader(
+      account_config, ohlc_history.begin(), ohlc_history.end(), &side_input,
+      /*fast_eval=*/false, trader, /*logger=*/nullptr);
+
+  std::vector<std::unique_ptr<Trader>> traders;
+  for (int i = 0; i < 3; ++i) {
+    traders.emplace_back(new TestTraderWithSideInput());
+  }
+  std::vector<ExecutionResult> results = ExecuteTradersInLockstep(
+      account_config, ohlc_history.begin(), ohlc_history.end(), &side_input,
+      /*fast_eval=*/false, traders);
+  ASSERT_EQ(results.size(), 3);
+  for (const ExecutionResult& result : results) {
+    ExpectProtoEq(result, expected_result);
+  }
+}
+
+TEST(EvaluateBatchOfTradersTest, SameResultsForAnyLockstepBatchSize) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 3
+        fast_eval: false
+        num_threads: 3
+        )",
+      &eval_config));
+
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (int buy_price = 20; buy_price <= 100; buy_price += 10) {
+    for (int sell_price = 150; sell_price <= 550; sell_price += 100) {
+      trader_emitters.emplace_back(
+          new TestTraderEmitter(buy_price, sell_price));
+    }
+  }
+
+  std::vector<EvaluationResult> expected_results;
+  for (const auto& trader_emitter : trader_emitters) {
+    expected_results.push_back(EvaluateTrader(
+        account_config, eval_config, ohlc_history, /*side_input=*/nullptr,
+        *trader_emitter, /*logger=*/nullptr, /*cache=*/nullptr));
+  }
+  for (const int lockstep_batch_size : {0, 1, 4, 7, 1000}) {
+    eval_config.set_lockstep_batch_size(lockstep_batch_size);
+    std::vector<EvaluationResult> results =
+        EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                               /*side_input=*/nullptr, trader_emitters,
+                               /*cache=*/nullptr);
+    std::vector<EvaluationResult> columnar_results = EvaluateBatchOfTraders(
+        account_config, eval_config, columnar_ohlc_history,
+        /*side_input=*/nullptr, trader_emitters, /*cache=*/nullptr);
+    ASSERT_EQ(results.size(), expected_results.size());
+    ASSERT_EQ(columnar_results.size(), expected_results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(results[i].name(), expected_results[i].name());
+      ExpectProtoEq(results[i], expected_results[i], /*full_scope=*/false);
+      ExpectProtoEq(columnar_results[i], expected_results[i],
+                    /*full_scope=*/false);
+    }
+  }
+}
+
+namespace {
+// Trader that buys below and sells above the simple moving average.
+class TestMovingAverageTrader : public Trader {
+ public:
+  // Constructor for the trader that owns (and updates) its own indicator.
+  TestMovingAverageTrader(float buy_ratio, float sell_ratio, int num_days)
+      : buy_ratio_(buy_ratio),
+        sell_ratio_(sell_ratio),
+        own_sma_(absl::make_unique<SimpleMovingAverage>(
+            num_days, /*period_size_sec=*/kSecondsPerDay)),
+        sma_(own_sma_.get()) {}
+  // Constructor for the trader reading the shared indicator (updated by the
+  // indicator registry).
+  TestMovingAverageTrader(float buy_ratio, float sell_ratio,
+                          const SimpleMovingAverage* sma)
+      : buy_ratio_(buy_ratio), sell_ratio_(sell_ratio), sma_(sma) {}
+  virtual ~TestMovingAverageTrader() {}
+
+  void Update(const OhlcTick& ohlc_tick,
+              const std::vector<float>& side_input_signals, float base_balance,
+              float quote_balance, std::vector<Order>& orders) override {
+    if (own_sma_ != nullptr) {
+      own_sma_->Update(ohlc_tick);
+    }
+    const float sma = sma_->GetSimpleMovingAverage();
+    orders.emplace_back();
+    Order& order = orders.back();
+    order.set_type(Order_Type_LIMIT);
+    if (ohlc_tick.close() * base_balance > quote_balance) {
+      order.set_side(Order_Side_SELL);
+      order.set_base_amount(base_balance);
+      order.set_price(sma * sell_ratio_);
+    } else {
+      order.set_side(Order_Side_BUY);
+      order.set_quote_amount(quote_balance);
+      order.set_price(sma * buy_ratio_);
+    }
+  }
+
+  std::string GetInternalState() const override { return ""; }
+
+ private:
+  float buy_ratio_ = 0.0f;
+  float sell_ratio_ = 0.0f;
+  // Indicator owned by this trader (if not shared).
+  std::unique_ptr<SimpleMovingAverage> own_sma_;
+  // Simple moving average (over daily closing prices).
+  const SimpleMovingAverage* sma_ = nullptr;
+};
+
+// Emitter that emits TestMovingAverageTrader as defined above.
+class TestMovingAverageTraderEmitter : public TraderEmitter {
+ public:
+  TestMovingAverageTraderEmitter(float buy_ratio, float sell_ratio,
+                                 int num_days)
+      : buy_ratio_(buy_ratio), sell_ratio_(sell_ratio), num_days_(num_days) {}
+  virtual ~TestMovingAverageTraderEmitter() {}
+
+  std::string GetName() const override {
+    return absl::StrFormat("test-sma-trader[%.2f|%.2f|%d]", buy_ratio_,
+                           sell_ratio_, num_days_);
+  }
+
+  std::unique_ptr<Trader> NewTrader() const override {
+    return absl::make_unique<TestMovingAverageTrader>(buy_ratio_, sell_ratio_,
+                                                      num_days_);
+  }
+
+  std::unique_ptr<Trader> NewTrader(
+      IndicatorRegistry& indicator_registry) const override {
+    return absl::make_unique<TestMovingAverageTrader>(
+        buy_ratio_, sell_ratio_,
+        indicator_registry.GetSimpleMovingAverage(
+            num_days_, /*period_size_sec=*/kSecondsPerDay));
+  }
+
+ private:
+  float buy_ratio_ = 0.0f;
+  float sell_ratio_ = 0.0f;
+  int num_days_ = 0;
+};
+}  // namespace
+
+TEST(EvaluateBatchOfTradersTest, SameResultsWithSharedIndicators) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 3
+        fast_eval: false
+        num_threads: 2
+        lockstep_batch_size: 8
+        )",
+      &eval_config));
+
+  // Many traders share the same simple moving average.
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (const int num_days : {30, 60, 90}) {
+    for (const float buy_ratio : {0.7f, 0.8f, 0.9f}) {
+      for (const float sell_ratio : {1.1f, 1.3f, 1.5f}) {
+        trader_emitters.emplace_back(new TestMovingAverageTraderEmitter(
+            buy_ratio, sell_ratio, num_days));
+      }
+    }
+  }
+
+  // EvaluateTrader emits the traders with their own indicators.
+  std::vector<EvaluationResult> expected_results;
+  for (const auto& trader_emitter : trader_emitters) {
+    expected_results.push_back(EvaluateTrader(
+        account_config, eval_config, ohlc_history, /*side_input=*/nullptr,
+        *trader_emitter, /*logger=*/nullptr, /*cache=*/nullptr));
+  }
+  std::vector<EvaluationResult> results =
+      EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                             /*side_input=*/nullptr, trader_emitters,
+                             /*cache=*/nullptr);
+  std::vector<EvaluationResult> columnar_results = EvaluateBatchOfTraders(
+      account_config, eval_config, columnar_ohlc_history,
+      /*side_input=*/nullptr, trader_emitters, /*cache=*/nullptr);
+  ASSERT_EQ(results.size(), expected_results.size());
+  ASSERT_EQ(columnar_results.size(), expected_results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ExpectProtoEq(results[i], expected_results[i], /*full_scope=*/false);
+    ExpectProtoEq(columnar_results[i], expected_results[i],
+                  /*full_scope=*/false);
+  }
+}
+
+namespace {
+// Emitter that emits TestTrader and counts the emitted traders.
+class CountingTraderEmitter : public TestTraderEmitter {
+ public:
+  CountingTraderEmitter(float buy_price, float sell_price)
+      : TestTraderEmitter(buy_price, sell_price) {}
+  virtual ~CountingTraderEmitter() {}
+
+  std::unique_ptr<Trader> NewTrader() const override {
+    ++num_traders_;
+    return TestTraderEmitter::NewTrader();
+  }
+
+  int num_traders() const { return num_traders_; }
+
+ private:
+  mutable std::atomic<int> num_traders_{0};
+};
+
+// Returns the total number of traders emitted by all trader_emitters.
+int GetNumberOfEmittedTraders(
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters) {
+  int num_traders = 0;
+  for (const auto& trader_emitter : trader_emitters) {
+    num_traders += static_cast<const CountingTraderEmitter&>(*trader_emitter)
+                       .num_traders();
+  }
+  return num_traders;
+}
+}  // namespace
+
+TEST(EvaluateTraderTest, SameResultsWithEvaluationCache) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 3
+        fast_eval: false
+        )",
+      &eval_config));
+
+  CountingTraderEmitter trader_emitter(/*buy_price=*/50, /*sell_price=*/250);
+  const EvaluationResult expected_result = EvaluateTrader(
+      account_config, eval_config, ohlc_history, /*side_input=*/nullptr,
+      trader_emitter, /*logger=*/nullptr, /*cache=*/nullptr);
+  const int num_periods = expected_result.period_size();
+  ASSERT_GT(num_periods, 0);
+  EXPECT_EQ(trader_emitter.num_traders(), num_periods);
+
+  EvaluationCache cache;
+  ExpectProtoEq(EvaluateTrader(account_config, eval_config, ohlc_history,
+                               /*side_input=*/nullptr, trader_emitter,
+                               /*logger=*/nullptr, &cache),
+                expected_result);
+  EXPECT_EQ(trader_emitter.num_traders(), 2 * num_periods);
+  EXPECT_EQ(cache.size(), num_periods);
+  // All periods are found in the cache.
+  ExpectProtoEq(EvaluateTrader(account_config, eval_config, ohlc_history,
+                               /*side_input=*/nullptr, trader_emitter,
+                               /*logger=*/nullptr, &cache),
+                expected_result);
+  ExpectProtoEq(EvaluateTrader(account_config, eval_config,
+                               columnar_ohlc_history, /*side_input=*/nullptr,
+                               trader_emitter, /*logger=*/nullptr, &cache),
+                expected_result);
+  EXPECT_EQ(trader_emitter.num_traders(), 2 * num_periods);
+  EXPECT_EQ(cache.size(), num_periods);
+
+  // Different account config (or fast_eval) yields different cache entries.
+  account_config.set_max_volume_ratio(0.2f);
+  EvaluateTrader(account_config, eval_config, ohlc_history,
+                 /*side_input=*/nullptr, trader_emitter, /*logger=*/nullptr,
+                 &cache);
+  EXPECT_EQ(trader_emitter.num_traders(), 3 * num_periods);
+  EXPECT_EQ(cache.size(), 2 * num_periods);
+  eval_config.set_fast_eval(true);
+  EvaluateTrader(account_config, eval_config, ohlc_history,
+                 /*side_input=*/nullptr, trader_emitter, /*logger=*/nullptr,
+                 &cache);
+  EXPECT_EQ(trader_emitter.num_traders(), 4 * num_periods);
+  EXPECT_EQ(cache.size(), 3 * num_periods);
+}
+
+TEST(EvaluateBatchOfTradersTest, SameResultsWithEvaluationCache) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        limit_order_fee_config {
+            relative_fee: 0.1
+            fixed_fee: 1
+            minimum_fee: 1.5
+        }
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 3
+        fast_eval: false
+        num_threads: 3
+        lockstep_batch_size: 4
+        )",
+      &eval_config));
+
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (int buy_price = 20; buy_price <= 100; buy_price += 10) {
+    for (int sell_price = 150; sell_price <= 550; sell_price += 100) {
+      trader_emitters.emplace_back(
+          new CountingTraderEmitter(buy_price, sell_price));
+    }
+  }
+  const std::vector<EvaluationResult> expected_results =
+      EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                             /*side_input=*/nullptr, trader_emitters,
+                             /*cache=*/nullptr);
+  ASSERT_EQ(expected_results.size(), trader_emitters.size());
+  const int num_periods = expected_results[0].period_size();
+  const int num_traders = trader_emitters.size() * num_periods;
+  ASSERT_GT(num_periods, 0);
+  EXPECT_EQ(GetNumberOfEmittedTraders(trader_emitters), num_traders);
+
+  // Populates the cache with the first few traders only.
+  EvaluationCache cache;
+  for (size_t i = 0; i < 10; ++i) {
+    ExpectProtoEq(EvaluateTrader(account_config, eval_config, ohlc_history,
+                                 /*side_input=*/nullptr, *trader_emitters[i],
+                                 /*logger=*/nullptr, &cache),
+                  expected_results[i], /*full_scope=*/false);
+  }
+  EXPECT_EQ(cache.size(), 10 * num_periods);
+  EXPECT_EQ(GetNumberOfEmittedTraders(trader_emitters),
+            num_traders + 10 * num_periods);
+
+  // Only the remaining traders are executed.
+  std::vector<EvaluationResult> results = EvaluateBatchOfTraders(
+      account_config, eval_config, columnar_ohlc_history,
+      /*side_input=*/nullptr, trader_emitters, &cache);
+  EXPECT_EQ(GetNumberOfEmittedTraders(trader_emitters), 2 * num_traders);
+  EXPECT_EQ(cache.size(), num_traders);
+  ASSERT_EQ(results.size(), expected_results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ExpectProtoEq(results[i], expected_results[i], /*full_scope=*/false);
+  }
+
+  // All traders are found in the cache.
+  results = EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                                   /*side_input=*/nullptr, trader_emitters,
+                                   &cache);
+  EXPECT_EQ(GetNumberOfEmittedTraders(trader_emitters), 2 * num_traders);
+  ASSERT_EQ(results.size(), expected_results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    ExpectProtoEq(results[i], expected_results[i], /*full_scope=*/false);
+  }
+}
+
+TEST(EvaluateBatchOfTradersTest, StreamsResultsInOrder) {
+  AccountConfig account_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_base_balance: 10
+        start_quote_balance: 0
+        base_unit: 0.1
+        quote_unit: 1
+        market_liquidity: 0.5
+        max_volume_ratio: 0.1
+        )",
+      &account_config));
+
+  OhlcHistory ohlc_history;
+  SetupMonthlyOhlcHistory(ohlc_history);
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+
+  EvaluationConfig eval_config;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"(
+        start_timestamp_sec: 1483228800
+        end_timestamp_sec: 1514764800
+        evaluation_period_months: 3
+        fast_eval: false
+        num_threads: 4
+        lockstep_batch_size: 16
+        )",
+      &eval_config));
+
+  // More traders than fit into a single chunk.
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (int buy_price = 10; buy_price < 110; buy_price += 2) {
+    for (int sell_price = 150; sell_price < 590; sell_price += 20) {
+      trader_emitters.emplace_back(
+          new TestTraderEmitter(buy_price, sell_price));
+    }
+  }
+  ASSERT_GT(trader_emitters.size(), 1024);
+  std::vector<size_t> trader_indices;
+  std::vector<EvaluationResult> results;
+  EvaluateBatchOfTraders(account_config, eval_config, columnar_ohlc_history,
+                         /*side_input=*/nullptr, trader_emitters,
+                         /*cache=*/nullptr,
+                         [&](size_t trader_index, EvaluationResult result) {
+                           trader_indices.push_back(trader_index);
+                           results.push_back(std::move(result));
+                         });
+  ASSERT_EQ(results.size(), trader_emitters.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(trader_indices[i], i);
+    ExpectProtoEq(results[i],
+                  EvaluateTrader(account_config, eval_config, ohlc_history,
+                                 /*side_input=*/nullptr, *trader_emitters[i],
+                                 /*logger=*/nullptr, /*cache=*/nullptr),
+                  /*full_scope=*/false);
+  }
+}
+
 }  // namespace trader
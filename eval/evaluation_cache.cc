@@ -0,0 +1,148 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/evaluation_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+#include "util/proto.h"
+
+namespace trader {
+namespace {
+// Exclusive lock (shared across processes) on the lock file, held from Lock
+// until destroyed. The lock is released by the operating system even if
+// the process crashes, so the lock file is never removed (otherwise two
+// processes could lock two different lock files with the same name).
+class FileLock {
+ public:
+  explicit FileLock(std::string lock_file_name)
+      : lock_file_name_(std::move(lock_file_name)) {}
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+  ~FileLock() {
+    if (fd_ >= 0) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+    }
+  }
+
+  // Blocks until the lock is acquired.
+  absl::Status Lock() {
+    fd_ = open(lock_file_name_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+      return absl::InternalError(
+          absl::StrFormat("Cannot open the file %s", lock_file_name_));
+    }
+    while (flock(fd_, LOCK_EX) != 0) {
+      if (errno != EINTR) {
+        return absl::InternalError(
+            absl::StrFormat("Cannot lock the file %s", lock_file_name_));
+      }
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  std::string lock_file_name_;
+  int fd_ = -1;
+};
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<EvaluationCache>> EvaluationCache::ReadFromFile(
+    const std::string& file_name) {
+  auto cache = absl::make_unique<EvaluationCache>();
+  std::error_code error_code;
+  if (!std::filesystem::exists(file_name, error_code)) {
+    return cache;
+  }
+  absl::Status status = ReadDelimitedMessagesFromFile<EvaluationCacheEntry>(
+      file_name, [&cache](const EvaluationCacheEntry& entry) -> ReaderStatus {
+        cache->Insert(entry);
+        return ReaderSignal::kContinue;
+      });
+  if (!status.ok()) {
+    return status;
+  }
+  return cache;
+}
+
+absl::Status EvaluationCache::WriteToFile(const std::string& file_name) const {
+  FileLock file_lock(file_name + ".lock");
+  absl::Status status = file_lock.Lock();
+  if (!status.ok()) {
+    return status;
+  }
+  // Entries written to the file (e.g. by other processes) since this cache
+  // was read are preserved.
+  absl::StatusOr<std::unique_ptr<EvaluationCache>> file_cache_status =
+      ReadFromFile(file_name);
+  if (!file_cache_status.ok()) {
+    return file_cache_status.status();
+  }
+  std::map<Key, EvaluationCacheEntry> entries =
+      std::move(file_cache_status.value()->entries_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [key, entry] : entries_) {
+      entries[key] = entry;
+    }
+  }
+  std::vector<EvaluationCacheEntry> entry_list;
+  entry_list.reserve(entries.size());
+  for (auto& [key, entry] : entries) {
+    entry_list.push_back(std::move(entry));
+  }
+  // The temporary file is unique per writer, so that the writers never write
+  // into the same temporary file (even if the lock is not honored, e.g. by
+  // some network file systems).
+  const std::string temp_file_name = absl::StrFormat(
+      "%s.tmp.%d.%08x", file_name, getpid(), std::random_device()());
+  status = WriteDelimitedMessagesToFile(entry_list.begin(), entry_list.end(),
+                                        temp_file_name, /*compress=*/true);
+  if (!status.ok()) {
+    std::remove(temp_file_name.c_str());
+    return status;
+  }
+  if (std::rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+    std::remove(temp_file_name.c_str());
+    return absl::InternalError(
+        absl::StrFormat("Cannot rename the file %s to %s", temp_file_name,
+                        file_name));
+  }
+  return absl::OkStatus();
+}
+
+size_t EvaluationCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+bool EvaluationCache::Lookup(const std::string& name, uint64_t fingerprint,
+                             ExecutionResult* result) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = entries_.find(Key(name, fingerprint));
+  if (it == entries_.end()) {
+    return false;
+  }
+  *result = it->second.result();
+  return true;
+}
+
+void EvaluationCache::Insert(EvaluationCacheEntry entry) {
+  Key key(entry.name(), entry.fingerprint());
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[std::move(key)] = std::move(entry);
+}
+
+}  // namespace trader
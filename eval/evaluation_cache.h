@@ -0,0 +1,66 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef EVAL_EVALUATION_CACHE_H
+#define EVAL_EVALUATION_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "eval/eval.pb.h"
+
+namespace trader {
+
+// Cache of trader ExecutionResults over evaluation periods, which can be
+// persisted on disk (and reused across runs).
+// Every entry is keyed by the trader name and by the fingerprint of the
+// evaluation period, which covers the account configuration, the fast_eval
+// flag, the period boundaries, and the OHLC ticks (and the side input) within
+// the period. Thread-safe.
+class EvaluationCache {
+ public:
+  EvaluationCache() {}
+  EvaluationCache(const EvaluationCache&) = delete;
+  EvaluationCache& operator=(const EvaluationCache&) = delete;
+
+  // Reads the cache from the file with the delimited EvaluationCacheEntry
+  // protos. Returns an empty cache if the file does not exist.
+  static absl::StatusOr<std::unique_ptr<EvaluationCache>> ReadFromFile(
+      const std::string& file_name);
+
+  // Writes all cache entries (as delimited EvaluationCacheEntry protos) to the
+  // file, merged with the entries already in the file (the entries of this
+  // cache take precedence). The entries are first written into a temporary
+  // file, which then replaces the original file (so that the original file is
+  // never left partially written). Concurrent writers (e.g. sweep workers
+  // sharing the file) are serialized by locking the "<file_name>.lock" file,
+  // so that their entries are not lost.
+  absl::Status WriteToFile(const std::string& file_name) const;
+
+  // Returns the number of cache entries.
+  size_t size() const;
+
+  // Looks up the ExecutionResult of the trader (with the given name) over the
+  // evaluation period with the given fingerprint. Returns false on cache miss.
+  bool Lookup(const std::string& name, uint64_t fingerprint,
+              ExecutionResult* result) const;
+
+  // Inserts (or replaces) the cache entry.
+  void Insert(EvaluationCacheEntry entry);
+
+ private:
+  using Key = std::pair<std::string, uint64_t>;
+
+  // Guards the entries below.
+  mutable std::mutex mutex_;
+  std::map<Key, EvaluationCacheEntry> entries_;
+};
+
+}  // namespace trader
+
+#endif  // EVAL_EVALUATION_CACHE_H
@@ -0,0 +1,146 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/evaluation_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+EvaluationCacheEntry GetEntry(const std::string& name, uint64_t fingerprint,
+                              float end_base_balance) {
+  EvaluationCacheEntry entry;
+  entry.set_name(name);
+  entry.set_start_timestamp_sec(1483228800);
+  entry.set_end_timestamp_sec(1485907200);
+  entry.set_fingerprint(fingerprint);
+  entry.mutable_result()->set_end_base_balance(end_base_balance);
+  return entry;
+}
+}  // namespace
+
+TEST(EvaluationCacheTest, InsertAndLookup) {
+  EvaluationCache cache;
+  EXPECT_EQ(cache.size(), 0);
+  ExecutionResult result;
+  EXPECT_FALSE(cache.Lookup("trader", 1, &result));
+  cache.Insert(GetEntry("trader", 1, 10.0f));
+  cache.Insert(GetEntry("trader", 2, 20.0f));
+  cache.Insert(GetEntry("other", 1, 30.0f));
+  EXPECT_EQ(cache.size(), 3);
+  ASSERT_TRUE(cache.Lookup("trader", 1, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 10.0f);
+  ASSERT_TRUE(cache.Lookup("trader", 2, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 20.0f);
+  ASSERT_TRUE(cache.Lookup("other", 1, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 30.0f);
+  EXPECT_FALSE(cache.Lookup("other", 2, &result));
+  // Existing entries are replaced.
+  cache.Insert(GetEntry("trader", 1, 40.0f));
+  EXPECT_EQ(cache.size(), 3);
+  ASSERT_TRUE(cache.Lookup("trader", 1, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 40.0f);
+}
+
+TEST(EvaluationCacheTest, WriteAndReadFromFile) {
+  const std::string file_name =
+      ::testing::TempDir() + "evaluation_cache_test.pb";
+  std::remove(file_name.c_str());
+  // Missing file yields an empty cache.
+  absl::StatusOr<std::unique_ptr<EvaluationCache>> cache_status =
+      EvaluationCache::ReadFromFile(file_name);
+  ASSERT_TRUE(cache_status.ok()) << cache_status.status();
+  EXPECT_EQ(cache_status.value()->size(), 0);
+  {
+    EvaluationCache cache;
+    cache.Insert(GetEntry("trader", 1, 10.0f));
+    cache.Insert(GetEntry("trader", 2, 20.0f));
+    ASSERT_TRUE(cache.WriteToFile(file_name).ok());
+  }
+  cache_status = EvaluationCache::ReadFromFile(file_name);
+  ASSERT_TRUE(cache_status.ok()) << cache_status.status();
+  EvaluationCache& cache = *cache_status.value();
+  EXPECT_EQ(cache.size(), 2);
+  ExecutionResult result;
+  ASSERT_TRUE(cache.Lookup("trader", 1, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 10.0f);
+  ASSERT_TRUE(cache.Lookup("trader", 2, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 20.0f);
+  // The cache can be extended and written again (to the same file).
+  cache.Insert(GetEntry("other", 3, 30.0f));
+  ASSERT_TRUE(cache.WriteToFile(file_name).ok());
+  cache_status = EvaluationCache::ReadFromFile(file_name);
+  ASSERT_TRUE(cache_status.ok()) << cache_status.status();
+  EXPECT_EQ(cache_status.value()->size(), 3);
+}
+
+TEST(EvaluationCacheTest, WriteToFileMergesEntries) {
+  const std::string file_name =
+      ::testing::TempDir() + "evaluation_cache_merge_test.pb";
+  std::remove(file_name.c_str());
+  // Caches of two (concurrent) runs sharing the same file.
+  EvaluationCache cache_1;
+  EvaluationCache cache_2;
+  cache_1.Insert(GetEntry("trader", 1, 10.0f));
+  cache_1.Insert(GetEntry("trader", 2, 20.0f));
+  cache_2.Insert(GetEntry("trader", 2, 40.0f));
+  cache_2.Insert(GetEntry("other", 3, 30.0f));
+  ASSERT_TRUE(cache_1.WriteToFile(file_name).ok());
+  ASSERT_TRUE(cache_2.WriteToFile(file_name).ok());
+  absl::StatusOr<std::unique_ptr<EvaluationCache>> cache_status =
+      EvaluationCache::ReadFromFile(file_name);
+  ASSERT_TRUE(cache_status.ok()) << cache_status.status();
+  EvaluationCache& cache = *cache_status.value();
+  EXPECT_EQ(cache.size(), 3);
+  ExecutionResult result;
+  ASSERT_TRUE(cache.Lookup("trader", 1, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 10.0f);
+  // The entries of the last writer take precedence.
+  ASSERT_TRUE(cache.Lookup("trader", 2, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 40.0f);
+  ASSERT_TRUE(cache.Lookup("other", 3, &result));
+  EXPECT_FLOAT_EQ(result.end_base_balance(), 30.0f);
+}
+
+TEST(EvaluationCacheTest, WriteToFileWaitsForLock) {
+  const std::string file_name =
+      ::testing::TempDir() + "evaluation_cache_lock_test.pb";
+  std::remove(file_name.c_str());
+  // The lock file left by a previous (possibly crashed) writer does not block
+  // the writers.
+  std::ofstream((file_name + ".lock").c_str()).close();
+  // Simulates another writer holding the lock.
+  const int fd = open((file_name + ".lock").c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(flock(fd, LOCK_EX), 0);
+  EvaluationCache cache;
+  cache.Insert(GetEntry("trader", 1, 10.0f));
+  std::atomic<bool> written{false};
+  std::thread writer([&]() {
+    EXPECT_TRUE(cache.WriteToFile(file_name).ok());
+    written = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(written);
+  EXPECT_FALSE(std::filesystem::exists(file_name));
+  ASSERT_EQ(flock(fd, LOCK_UN), 0);
+  close(fd);
+  writer.join();
+  EXPECT_TRUE(written);
+  absl::StatusOr<std::unique_ptr<EvaluationCache>> cache_status =
+      EvaluationCache::ReadFromFile(file_name);
+  ASSERT_TRUE(cache_status.ok()) << cache_status.status();
+  EXPECT_EQ(cache_status.value()->size(), 1);
+}
+
+}  // namespace trader
@@ -0,0 +1,352 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/results.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+#include "absl/strings/str_format.h"
+
+namespace trader {
+
+namespace {
+// Consumes the rest of the input stream. Returns true iff it contains only
+// zero bytes (or no bytes at all).
+bool ConsumeZeroBytes(google::protobuf::io::ZeroCopyInputStream& stream) {
+  const void* data;
+  int size;
+  while (stream.Next(&data, &size)) {
+    const char* bytes = static_cast<const char*>(data);
+    if (std::any_of(bytes, bytes + size, [](char c) { return c != 0; })) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads the EvaluationResults from the first num_bytes of the file written by
+// the EvaluationResultsWriter and applies the function "reader" on them.
+// The account_config and eval_config of the first result are restored in all
+// results. Returns DataLossError (after reading all complete results) if the
+// file ends with a damaged tail left by a crashed writer: a truncated last
+// result, or zero bytes (e.g. preallocated by the file system), which are
+// parsed as empty results (never written by the EvaluationResultsWriter).
+// Returns InvalidArgumentError if the file cannot be parsed (or decompressed)
+// for any other reason.
+absl::Status ReadEvaluationResultsFromFilePrefix(
+    const std::string& file_name, int64_t num_bytes,
+    std::function<ReaderStatus(const EvaluationResult&)> reader) {
+  std::fstream in_fstream(file_name, std::ios::in | std::ios::binary);
+  if (!in_fstream) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot open the input file: %s", file_name));
+  }
+  google::protobuf::io::IstreamInputStream in_stream(&in_fstream);
+  google::protobuf::io::LimitingInputStream limited_stream(&in_stream,
+                                                           num_bytes);
+  DecompressingInputStream input_stream(&limited_stream);
+  AccountConfig account_config;
+  EvaluationConfig eval_config;
+  bool first = true;
+  while (true) {
+    EvaluationResult eval_result;
+    bool clean_eof;
+    const bool parsed =
+        google::protobuf::util::ParseDelimitedFromZeroCopyStream(
+            &eval_result, &input_stream, &clean_eof);
+    if (!parsed && clean_eof && !input_stream.failed()) {
+      return absl::OkStatus();
+    }
+    if (!parsed || eval_result.ByteSizeLong() == 0) {
+      // A truncated last result ends the input stream.
+      if (ConsumeZeroBytes(input_stream) && !input_stream.failed()) {
+        return absl::DataLossError(
+            absl::StrFormat("Damaged tail of the file: %s", file_name));
+      }
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Cannot parse the file: %s", file_name));
+    }
+    if (first) {
+      account_config = eval_result.account_config();
+      eval_config = eval_result.eval_config();
+      first = false;
+    } else {
+      *eval_result.mutable_account_config() = account_config;
+      *eval_result.mutable_eval_config() = eval_config;
+    }
+    ReaderStatus reader_status = reader(eval_result);
+    if (!reader_status.ok()) {
+      return absl::AbortedError(reader_status.status().message());
+    }
+    switch (reader_status.value()) {
+      case ReaderSignal::kContinue:
+        break;
+      case ReaderSignal::kBreak:
+        return absl::OkStatus();
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Returns the evaluation config without the fields which do not affect
+// the evaluation results (i.e. num_threads and lockstep_batch_size).
+EvaluationConfig GetResultsEvaluationConfig(EvaluationConfig eval_config) {
+  eval_config.clear_num_threads();
+  eval_config.clear_lockstep_batch_size();
+  return eval_config;
+}
+
+// Returns true iff the evaluation result was computed with the given configs
+// (up to the fields which do not affect the evaluation results).
+bool HasConfigs(const EvaluationResult& eval_result,
+                const AccountConfig& account_config,
+                const EvaluationConfig& eval_config) {
+  return eval_result.account_config().SerializeAsString() ==
+             account_config.SerializeAsString() &&
+         GetResultsEvaluationConfig(eval_result.eval_config())
+                 .SerializeAsString() ==
+             GetResultsEvaluationConfig(eval_config).SerializeAsString();
+}
+
+// Returns the size of the file without its trailing zero bytes.
+absl::StatusOr<int64_t> GetSizeWithoutTrailingZeros(
+    const std::string& file_name) {
+  std::fstream in_fstream(file_name, std::ios::in | std::ios::binary);
+  if (!in_fstream) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot open the input file: %s", file_name));
+  }
+  in_fstream.seekg(0, std::ios::end);
+  int64_t size = in_fstream.tellg();
+  char buffer[4096];
+  while (size > 0) {
+    const int64_t chunk_size =
+        std::min<int64_t>(size, static_cast<int64_t>(sizeof(buffer)));
+    in_fstream.seekg(size - chunk_size);
+    if (!in_fstream.read(buffer, chunk_size)) {
+      return absl::InternalError(
+          absl::StrFormat("Cannot read the file: %s", file_name));
+    }
+    int64_t num_non_zero = chunk_size;
+    while (num_non_zero > 0 && buffer[num_non_zero - 1] == 0) {
+      --num_non_zero;
+    }
+    size -= chunk_size - num_non_zero;
+    if (num_non_zero > 0) {
+      break;
+    }
+  }
+  return size;
+}
+
+// Returns the number of bytes (from the beginning of the file written, but
+// possibly not closed, by the EvaluationResultsWriter) which can be read
+// without errors, apart from the damaged tail left by a crash (see
+// ReadEvaluationResultsFromFilePrefix). Returns an error if the file is
+// corrupted.
+absl::StatusOr<int64_t> GetRecoverableSize(const std::string& file_name) {
+  std::error_code error_code;
+  const int64_t file_size = std::filesystem::file_size(file_name, error_code);
+  if (error_code) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot read the file: %s", file_name));
+  }
+  auto read_status = [&file_name](int64_t num_bytes) {
+    return ReadEvaluationResultsFromFilePrefix(
+        file_name, num_bytes,
+        [](const EvaluationResult&) -> ReaderStatus {
+          return ReaderSignal::kContinue;
+        });
+  };
+  const absl::Status status = read_status(file_size);
+  if (status.ok() || absl::IsDataLoss(status)) {
+    return file_size;
+  }
+  // Zero bytes following the last complete gzip member cannot be decompressed,
+  // so they are cut off (possibly together with a part of the gzip trailer).
+  const absl::StatusOr<int64_t> size_status =
+      GetSizeWithoutTrailingZeros(file_name);
+  if (!size_status.ok()) {
+    return size_status.status();
+  }
+  if (size_status.value() < file_size) {
+    const absl::Status prefix_status = read_status(size_status.value());
+    if (prefix_status.ok() || absl::IsDataLoss(prefix_status)) {
+      return size_status.value();
+    }
+  }
+  return status;
+}
+}  // namespace
+
+absl::StatusOr<EvaluationResultMetric> GetEvaluationResultMetric(
+    absl::string_view metric_name) {
+  if (metric_name == "score") {
+    return EvaluationResultMetric([](const EvaluationResult& eval_result) {
+      return eval_result.score();
+    });
+  }
+  if (metric_name == "avg_gain") {
+    return EvaluationResultMetric([](const EvaluationResult& eval_result) {
+      return eval_result.avg_gain();
+    });
+  }
+  if (metric_name == "avg_total_executed_orders") {
+    return EvaluationResultMetric([](const EvaluationResult& eval_result) {
+      return -eval_result.avg_total_executed_orders();
+    });
+  }
+  if (metric_name == "avg_total_fee") {
+    return EvaluationResultMetric([](const EvaluationResult& eval_result) {
+      return -eval_result.avg_total_fee();
+    });
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown evaluation result metric: %s", metric_name));
+}
+
+bool TopEvaluationResults::IsBetter(const Entry& lhs, const Entry& rhs) {
+  if (lhs.value != rhs.value) {
+    return lhs.value > rhs.value;
+  }
+  return lhs.trader_index < rhs.trader_index;
+}
+
+void TopEvaluationResults::Add(size_t trader_index,
+                               EvaluationResult eval_result) {
+  if (capacity_ == 0) {
+    return;
+  }
+  Entry entry{metric_(eval_result), trader_index, {}};
+  if (heap_.size() == capacity_) {
+    if (!IsBetter(entry, heap_.front())) {
+      return;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), IsBetter);
+    heap_.pop_back();
+  }
+  eval_result.clear_account_config();
+  eval_result.clear_eval_config();
+  entry.eval_result = std::move(eval_result);
+  heap_.push_back(std::move(entry));
+  std::push_heap(heap_.begin(), heap_.end(), IsBetter);
+}
+
+std::vector<EvaluationResult> TopEvaluationResults::GetSortedResults() const {
+  std::vector<const Entry*> entries;
+  entries.reserve(heap_.size());
+  for (const Entry& entry : heap_) {
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry* lhs, const Entry* rhs) {
+              return IsBetter(*lhs, *rhs);
+            });
+  std::vector<EvaluationResult> eval_results;
+  eval_results.reserve(entries.size());
+  for (const Entry* entry : entries) {
+    eval_results.push_back(entry->eval_result);
+  }
+  return eval_results;
+}
+
+absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>>
+EvaluationResultsWriter::Open(const std::string& file_name) {
+  absl::StatusOr<std::unique_ptr<DelimitedMessageWriter>> writer_status =
+      DelimitedMessageWriter::Open(file_name, /*compress=*/true);
+  if (!writer_status.ok()) {
+    return writer_status.status();
+  }
+  return std::unique_ptr<EvaluationResultsWriter>(
+      new EvaluationResultsWriter(std::move(writer_status).value()));
+}
+
+absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>>
+EvaluationResultsWriter::Resume(
+    const std::string& file_name, const AccountConfig& account_config,
+    const EvaluationConfig& eval_config,
+    const std::function<void(const EvaluationResult&)>& recovered) {
+  std::error_code error_code;
+  if (!std::filesystem::exists(file_name, error_code)) {
+    return Open(file_name);
+  }
+  // The file is validated first, so that it stays untouched on errors.
+  const absl::StatusOr<int64_t> recoverable_size_status =
+      GetRecoverableSize(file_name);
+  if (!recoverable_size_status.ok()) {
+    return recoverable_size_status.status();
+  }
+  const std::string temp_file_name = file_name + ".tmp";
+  absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+      Open(temp_file_name);
+  if (!writer_status.ok()) {
+    return writer_status.status();
+  }
+  std::unique_ptr<EvaluationResultsWriter> writer =
+      std::move(writer_status).value();
+  absl::Status config_status;
+  absl::Status status = ReadEvaluationResultsFromFilePrefix(
+      file_name, recoverable_size_status.value(),
+      [&](const EvaluationResult& eval_result) -> ReaderStatus {
+        // All results share the configs of the first result.
+        if (writer->writer_->num_messages() == 0 &&
+            !HasConfigs(eval_result, account_config, eval_config)) {
+          config_status = absl::FailedPreconditionError(absl::StrFormat(
+              "The results in %s were evaluated with a different "
+              "account_config or eval_config",
+              file_name));
+          return ReaderSignal::kBreak;
+        }
+        const absl::Status write_status = writer->Write(eval_result);
+        if (!write_status.ok()) {
+          return write_status;
+        }
+        recovered(eval_result);
+        return ReaderSignal::kContinue;
+      });
+  if (absl::IsDataLoss(status)) {
+    // The damaged tail (e.g. a truncated last result) is dropped.
+    status = absl::OkStatus();
+  }
+  if (status.ok()) {
+    status = config_status;
+  }
+  if (status.ok()) {
+    status = writer->Flush();
+  }
+  if (!status.ok()) {
+    writer.reset();
+    std::filesystem::remove(temp_file_name, error_code);
+    return status;
+  }
+  // The (open) temporary file replaces the original file.
+  std::filesystem::rename(temp_file_name, file_name, error_code);
+  if (error_code) {
+    return absl::InternalError(absl::StrFormat(
+        "Cannot rename the file %s to %s", temp_file_name, file_name));
+  }
+  return writer;
+}
+
+absl::Status EvaluationResultsWriter::Write(
+    const EvaluationResult& eval_result) {
+  if (writer_->num_messages() == 0 ||
+      (!eval_result.has_account_config() && !eval_result.has_eval_config())) {
+    return writer_->Write(eval_result);
+  }
+  EvaluationResult stripped_result = eval_result;
+  stripped_result.clear_account_config();
+  stripped_result.clear_eval_config();
+  return writer_->Write(stripped_result);
+}
+
+absl::Status ReadEvaluationResultsFromFile(
+    const std::string& file_name,
+    std::function<ReaderStatus(const EvaluationResult&)> reader) {
+  return ReadEvaluationResultsFromFilePrefix(
+      file_name, std::numeric_limits<int64_t>::max(), std::move(reader));
+}
+
+}  // namespace trader
@@ -0,0 +1,120 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef EVAL_RESULTS_H
+#define EVAL_RESULTS_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "eval/eval.pb.h"
+#include "util/proto.h"
+
+namespace trader {
+
+// Metric of an EvaluationResult (the higher the better).
+using EvaluationResultMetric = std::function<float(const EvaluationResult&)>;
+
+// Returns the metric with the given name, i.e. the name of the EvaluationResult
+// field: "score", "avg_gain", "avg_total_executed_orders", or "avg_total_fee".
+// The last two (lower is better) are negated.
+absl::StatusOr<EvaluationResultMetric> GetEvaluationResultMetric(
+    absl::string_view metric_name);
+
+// Keeps the (at most) capacity best EvaluationResults (according to the
+// metric) out of a stream of results, so that the memory stays bounded however
+// many results are added. The account_config and eval_config (shared by all
+// results of the batch) are not kept.
+class TopEvaluationResults {
+ public:
+  TopEvaluationResults(size_t capacity, EvaluationResultMetric metric)
+      : capacity_(capacity), metric_(std::move(metric)) {}
+  TopEvaluationResults(const TopEvaluationResults&) = delete;
+  TopEvaluationResults& operator=(const TopEvaluationResults&) = delete;
+
+  // Adds the result of the trader with the given index (within the batch).
+  // Ties are broken in favor of the lower trader_index.
+  void Add(size_t trader_index, EvaluationResult eval_result);
+
+  // Returns the number of kept results.
+  size_t size() const { return heap_.size(); }
+
+  // Returns the kept results from the best to the worst.
+  std::vector<EvaluationResult> GetSortedResults() const;
+
+ private:
+  struct Entry {
+    float value;
+    size_t trader_index;
+    EvaluationResult eval_result;
+  };
+
+  // Returns true if the lhs entry is better than the rhs entry.
+  static bool IsBetter(const Entry& lhs, const Entry& rhs);
+
+  size_t capacity_;
+  EvaluationResultMetric metric_;
+  // Heap of the kept entries with the worst entry in front.
+  std::vector<Entry> heap_;
+};
+
+// Incrementally writes EvaluationResults (as delimited protos) to the file.
+// The account_config and eval_config (shared by all results of the batch) are
+// written only with the first result.
+class EvaluationResultsWriter {
+ public:
+  // Opens (truncates) the output file.
+  static absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> Open(
+      const std::string& file_name);
+  EvaluationResultsWriter(const EvaluationResultsWriter&) = delete;
+  EvaluationResultsWriter& operator=(const EvaluationResultsWriter&) = delete;
+
+  // Resumes writing into the output file written (but possibly not closed,
+  // e.g. due to a crash) by a previous EvaluationResultsWriter. The results
+  // recovered from the file are passed to the function "recovered" and copied
+  // into a temporary file, which then replaces the output file. Only the
+  // damaged tail left by a crash (a truncated last result, or trailing zero
+  // bytes) is dropped. Returns an error (leaving the output file untouched)
+  // if the output file cannot be read or is corrupted. Returns
+  // FailedPreconditionError (leaving the output file untouched) if the results
+  // were evaluated with different account_config or eval_config (ignoring
+  // num_threads and lockstep_batch_size). Opens a new output file if it does
+  // not exist.
+  static absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> Resume(
+      const std::string& file_name, const AccountConfig& account_config,
+      const EvaluationConfig& eval_config,
+      const std::function<void(const EvaluationResult&)>& recovered);
+
+  // Writes the result to the output file.
+  absl::Status Write(const EvaluationResult& eval_result);
+
+  // Flushes all results written so far to the output file (checkpoint).
+  absl::Status Flush() { return writer_->Flush(); }
+
+  // Flushes (and closes) the output file.
+  absl::Status Close() { return writer_->Close(); }
+
+ private:
+  explicit EvaluationResultsWriter(
+      std::unique_ptr<DelimitedMessageWriter> writer)
+      : writer_(std::move(writer)) {}
+
+  std::unique_ptr<DelimitedMessageWriter> writer_;
+};
+
+// Reads the EvaluationResults written by the EvaluationResultsWriter and
+// applies the function "reader" on them. The account_config and eval_config
+// of the first result are restored in all results. Returns DataLossError
+// (after reading all complete results) if the file ends with a damaged tail
+// left by a crashed writer (a truncated last result, or zero bytes).
+absl::Status ReadEvaluationResultsFromFile(
+    const std::string& file_name,
+    std::function<ReaderStatus(const EvaluationResult&)> reader);
+
+}  // namespace trader
+
+#endif  // EVAL_RESULTS_H
@@ -0,0 +1,301 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/results.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+AccountConfig GetAccountConfig() {
+  AccountConfig account_config;
+  account_config.set_start_base_balance(1.0f);
+  return account_config;
+}
+
+EvaluationConfig GetEvaluationConfig() {
+  EvaluationConfig eval_config;
+  eval_config.set_evaluation_period_months(1);
+  return eval_config;
+}
+
+EvaluationResult GetEvaluationResult(size_t trader_index, float score) {
+  EvaluationResult eval_result;
+  *eval_result.mutable_account_config() = GetAccountConfig();
+  *eval_result.mutable_eval_config() = GetEvaluationConfig();
+  eval_result.set_name(absl::StrFormat("trader-%d", trader_index));
+  eval_result.set_score(score);
+  eval_result.set_avg_total_fee(score);
+  eval_result.add_period()->set_final_gain(score);
+  return eval_result;
+}
+}  // namespace
+
+TEST(GetEvaluationResultMetricTest, KnownAndUnknownMetrics) {
+  const EvaluationResult eval_result = GetEvaluationResult(0, 2.0f);
+  absl::StatusOr<EvaluationResultMetric> metric_status =
+      GetEvaluationResultMetric("score");
+  ASSERT_TRUE(metric_status.ok());
+  EXPECT_FLOAT_EQ(metric_status.value()(eval_result), 2.0f);
+  metric_status = GetEvaluationResultMetric("avg_total_fee");
+  ASSERT_TRUE(metric_status.ok());
+  EXPECT_FLOAT_EQ(metric_status.value()(eval_result), -2.0f);
+  EXPECT_FALSE(GetEvaluationResultMetric("unknown").ok());
+}
+
+TEST(TopEvaluationResultsTest, KeepsBestResults) {
+  TopEvaluationResults top_results(
+      /*capacity=*/3, GetEvaluationResultMetric("score").value());
+  const std::vector<float> scores = {0, 7, 4, 1, 8, 5, 2, 9, 6, 3, 9};
+  for (size_t i = 0; i < scores.size(); ++i) {
+    top_results.Add(i, GetEvaluationResult(i, scores[i]));
+    EXPECT_EQ(top_results.size(), std::min<size_t>(i + 1, 3));
+  }
+  const std::vector<EvaluationResult> eval_results =
+      top_results.GetSortedResults();
+  ASSERT_EQ(eval_results.size(), 3);
+  // Ties are broken in favor of the lower trader index.
+  EXPECT_EQ(eval_results[0].name(), "trader-7");
+  EXPECT_EQ(eval_results[1].name(), "trader-10");
+  EXPECT_EQ(eval_results[2].name(), "trader-4");
+  EXPECT_FLOAT_EQ(eval_results[2].score(), 8.0f);
+  for (const EvaluationResult& eval_result : eval_results) {
+    EXPECT_FALSE(eval_result.has_account_config());
+    EXPECT_FALSE(eval_result.has_eval_config());
+    EXPECT_EQ(eval_result.period_size(), 1);
+  }
+}
+
+TEST(TopEvaluationResultsTest, ZeroCapacity) {
+  TopEvaluationResults top_results(
+      /*capacity=*/0, GetEvaluationResultMetric("score").value());
+  top_results.Add(0, GetEvaluationResult(0, 1.0f));
+  EXPECT_EQ(top_results.size(), 0);
+  EXPECT_TRUE(top_results.GetSortedResults().empty());
+}
+
+TEST(EvaluationResultsWriterTest, WriteAndRead) {
+  const std::string file_name =
+      (std::filesystem::temp_directory_path() / "results_test.dpb").string();
+  absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+      EvaluationResultsWriter::Open(file_name);
+  ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+  for (size_t i = 0; i < 5; ++i) {
+    ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(i, i)).ok());
+  }
+  ASSERT_TRUE(writer_status.value()->Close().ok());
+
+  // Only the first result is written together with the configs.
+  std::vector<EvaluationResult> raw_results;
+  ASSERT_TRUE(ReadDelimitedMessagesFromFile(file_name, raw_results).ok());
+  ASSERT_EQ(raw_results.size(), 5);
+  EXPECT_TRUE(raw_results[0].has_account_config());
+  EXPECT_TRUE(raw_results[0].has_eval_config());
+  for (size_t i = 1; i < 5; ++i) {
+    EXPECT_FALSE(raw_results[i].has_account_config());
+    EXPECT_FALSE(raw_results[i].has_eval_config());
+  }
+
+  std::vector<EvaluationResult> eval_results;
+  ASSERT_TRUE(ReadEvaluationResultsFromFile(
+                  file_name,
+                  [&eval_results](const EvaluationResult& eval_result)
+                      -> ReaderStatus {
+                    eval_results.push_back(eval_result);
+                    return ReaderSignal::kContinue;
+                  })
+                  .ok());
+  ASSERT_EQ(eval_results.size(), 5);
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(eval_results[i].SerializeAsString(),
+              GetEvaluationResult(i, i).SerializeAsString());
+  }
+  std::filesystem::remove(file_name);
+}
+
+TEST(EvaluationResultsWriterTest, ReadTruncatedFile) {
+  const std::string file_name =
+      (std::filesystem::temp_directory_path() / "results_truncated_test.dpb")
+          .string();
+  absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+      EvaluationResultsWriter::Open(file_name);
+  ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(i, i)).ok());
+  }
+  ASSERT_TRUE(writer_status.value()->Flush().ok());
+  const int64_t flushed_size = std::filesystem::file_size(file_name);
+  ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(3, 3)).ok());
+  ASSERT_TRUE(writer_status.value()->Close().ok());
+  // Truncates the last result.
+  std::filesystem::resize_file(
+      file_name,
+      (flushed_size + std::filesystem::file_size(file_name)) / 2);
+
+  std::vector<std::string> names;
+  const absl::Status status = ReadEvaluationResultsFromFile(
+      file_name, [&names](const EvaluationResult& eval_result) -> ReaderStatus {
+        names.push_back(eval_result.name());
+        return ReaderSignal::kContinue;
+      });
+  EXPECT_TRUE(absl::IsDataLoss(status)) << status;
+  EXPECT_EQ(names,
+            std::vector<std::string>({"trader-0", "trader-1", "trader-2"}));
+  std::filesystem::remove(file_name);
+}
+
+TEST(EvaluationResultsWriterTest, ResumeAfterCrash) {
+  const std::string file_name =
+      (std::filesystem::temp_directory_path() / "results_resume_test.dpb")
+          .string();
+  std::filesystem::remove(file_name);
+  // Resuming a missing file starts from scratch.
+  std::vector<std::string> recovered_names;
+  absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+      EvaluationResultsWriter::Resume(
+          file_name, GetAccountConfig(), GetEvaluationConfig(),
+          [&](const EvaluationResult& eval_result) {
+            recovered_names.push_back(eval_result.name());
+          });
+  ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+  EXPECT_TRUE(recovered_names.empty());
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(i, i)).ok());
+  }
+  ASSERT_TRUE(writer_status.value()->Flush().ok());
+  // Simulates a crash after a partially written result.
+  ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(3, 3)).ok());
+  const std::string partial_file_name = file_name + ".partial";
+  std::filesystem::copy_file(
+      file_name, partial_file_name,
+      std::filesystem::copy_options::overwrite_existing);
+  std::filesystem::resize_file(partial_file_name,
+                               std::filesystem::file_size(file_name) + 5);
+  writer_status.value().reset();
+  std::filesystem::rename(partial_file_name, file_name);
+
+  writer_status = EvaluationResultsWriter::Resume(
+      file_name, GetAccountConfig(), GetEvaluationConfig(),
+      [&](const EvaluationResult& eval_result) {
+        recovered_names.push_back(eval_result.name());
+      });
+  ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+  EXPECT_EQ(recovered_names,
+            std::vector<std::string>({"trader-0", "trader-1", "trader-2"}));
+  for (size_t i = 3; i < 5; ++i) {
+    ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(i, i)).ok());
+  }
+  ASSERT_TRUE(writer_status.value()->Close().ok());
+
+  std::vector<EvaluationResult> eval_results;
+  ASSERT_TRUE(ReadEvaluationResultsFromFile(
+                  file_name,
+                  [&eval_results](const EvaluationResult& eval_result)
+                      -> ReaderStatus {
+                    eval_results.push_back(eval_result);
+                    return ReaderSignal::kContinue;
+                  })
+                  .ok());
+  ASSERT_EQ(eval_results.size(), 5);
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(eval_results[i].SerializeAsString(),
+              GetEvaluationResult(i, i).SerializeAsString());
+  }
+  std::filesystem::remove(file_name);
+}
+
+TEST(EvaluationResultsWriterTest, ResumeCorruptedFile) {
+  const std::string file_name =
+      (std::filesystem::temp_directory_path() / "results_corrupted_test.dpb")
+          .string();
+  {
+    absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+        EvaluationResultsWriter::Open(file_name);
+    ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+    for (size_t i = 0; i < 20; ++i) {
+      ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(i, i)).ok());
+    }
+    ASSERT_TRUE(writer_status.value()->Close().ok());
+  }
+  std::string content;
+  {
+    std::ifstream in_fstream(file_name, std::ios::in | std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in_fstream), {});
+  }
+  // Corrupts the results in the middle of the file.
+  content.replace(content.size() / 2, 8, std::string(8, '\xff'));
+  {
+    std::ofstream out_fstream(file_name, std::ios::out | std::ios::binary);
+    out_fstream << content;
+  }
+
+  std::vector<std::string> recovered_names;
+  absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+      EvaluationResultsWriter::Resume(
+          file_name, GetAccountConfig(), GetEvaluationConfig(),
+          [&](const EvaluationResult& eval_result) {
+            recovered_names.push_back(eval_result.name());
+          });
+  EXPECT_FALSE(writer_status.ok());
+  EXPECT_TRUE(recovered_names.empty());
+  // The original file stays untouched.
+  std::ifstream in_fstream(file_name, std::ios::in | std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in_fstream), {}),
+            content);
+  EXPECT_FALSE(std::filesystem::exists(file_name + ".tmp"));
+  std::filesystem::remove(file_name);
+}
+
+TEST(EvaluationResultsWriterTest, ResumeWithDifferentConfigs) {
+  const std::string file_name =
+      (std::filesystem::temp_directory_path() / "results_configs_test.dpb")
+          .string();
+  {
+    absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+        EvaluationResultsWriter::Open(file_name);
+    ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+    for (size_t i = 0; i < 3; ++i) {
+      ASSERT_TRUE(writer_status.value()->Write(GetEvaluationResult(i, i)).ok());
+    }
+    ASSERT_TRUE(writer_status.value()->Close().ok());
+  }
+  const uintmax_t file_size = std::filesystem::file_size(file_name);
+  std::vector<std::string> recovered_names;
+  auto recovered = [&](const EvaluationResult& eval_result) {
+    recovered_names.push_back(eval_result.name());
+  };
+  AccountConfig account_config = GetAccountConfig();
+  account_config.set_market_liquidity(0.5f);
+  absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>> writer_status =
+      EvaluationResultsWriter::Resume(file_name, account_config,
+                                      GetEvaluationConfig(), recovered);
+  EXPECT_TRUE(absl::IsFailedPrecondition(writer_status.status()))
+      << writer_status.status();
+  EvaluationConfig eval_config = GetEvaluationConfig();
+  eval_config.set_end_timestamp_sec(1483228800);
+  writer_status = EvaluationResultsWriter::Resume(
+      file_name, GetAccountConfig(), eval_config, recovered);
+  EXPECT_TRUE(absl::IsFailedPrecondition(writer_status.status()))
+      << writer_status.status();
+  EXPECT_TRUE(recovered_names.empty());
+  // The output file stays untouched.
+  EXPECT_EQ(std::filesystem::file_size(file_name), file_size);
+  EXPECT_FALSE(std::filesystem::exists(file_name + ".tmp"));
+
+  // The number of threads does not affect the results.
+  eval_config = GetEvaluationConfig();
+  eval_config.set_num_threads(8);
+  eval_config.set_lockstep_batch_size(4);
+  writer_status = EvaluationResultsWriter::Resume(
+      file_name, GetAccountConfig(), eval_config, recovered);
+  ASSERT_TRUE(writer_status.ok()) << writer_status.status();
+  EXPECT_EQ(recovered_names,
+            std::vector<std::string>({"trader-0", "trader-1", "trader-2"}));
+  std::filesystem::remove(file_name);
+}
+
+}  // namespace trader
@@ -0,0 +1,171 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/search.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "eval/eval.h"
+#include "util/time.h"
+
+namespace trader {
+namespace {
+// Emitter that forwards to another (not owned) emitter, so that a subset of
+// the candidates can be passed to the EvaluateBatchOfTraders.
+class TraderEmitterRef : public TraderEmitter {
+ public:
+  explicit TraderEmitterRef(const TraderEmitter& trader_emitter)
+      : trader_emitter_(trader_emitter) {}
+  virtual ~TraderEmitterRef() {}
+
+  std::string GetName() const override { return trader_emitter_.GetName(); }
+
+  std::unique_ptr<Trader> NewTrader() const override {
+    return trader_emitter_.NewTrader();
+  }
+
+  std::unique_ptr<Trader> NewTrader(
+      IndicatorRegistry& indicator_registry) const override {
+    return trader_emitter_.NewTrader(indicator_registry);
+  }
+
+ private:
+  const TraderEmitter& trader_emitter_;
+};
+
+// Returns the number of monthly evaluation periods defined by the eval_config.
+int GetNumberOfEvaluationPeriods(const EvaluationConfig& eval_config) {
+  int num_periods = 0;
+  while (AddMonthsToTimestampSec(
+             AddMonthsToTimestampSec(eval_config.start_timestamp_sec(),
+                                     num_periods),
+             eval_config.evaluation_period_months()) <=
+         eval_config.end_timestamp_sec()) {
+    ++num_periods;
+  }
+  return num_periods;
+}
+
+// Successive halving search over the OHLC history (of type H).
+template <typename H>
+std::vector<EvaluationResult> SearchBatchOfTradersImpl(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const SearchConfig& search_config, const H& ohlc_history,
+    const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache) {
+  std::unique_ptr<EvaluationCache> search_cache;
+  if (cache == nullptr) {
+    search_cache.reset(new EvaluationCache());
+    cache = search_cache.get();
+  }
+  const std::vector<SearchRung> rungs = GetSearchRungs(
+      eval_config, search_config, static_cast<int>(trader_emitters.size()));
+  // Indices of the candidates (in increasing order) evaluated in the rung.
+  std::vector<size_t> candidates(trader_emitters.size());
+  std::iota(candidates.begin(), candidates.end(), 0);
+  std::vector<EvaluationResult> eval_results;
+  for (size_t rung_index = 0; rung_index < rungs.size(); ++rung_index) {
+    const SearchRung& rung = rungs[rung_index];
+    if (rung_index > 0) {
+      // Keeps the top candidates (by their score in the previous rung).
+      std::vector<size_t> order(candidates.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return eval_results[a].score() > eval_results[b].score();
+      });
+      order.resize(std::min(order.size(),
+                            static_cast<size_t>(rung.num_candidates)));
+      std::sort(order.begin(), order.end());
+      std::vector<size_t> survivors;
+      survivors.reserve(order.size());
+      for (const size_t i : order) {
+        survivors.push_back(candidates[i]);
+      }
+      candidates = std::move(survivors);
+    }
+    std::vector<std::unique_ptr<TraderEmitter>> rung_trader_emitters;
+    rung_trader_emitters.reserve(candidates.size());
+    for (const size_t candidate : candidates) {
+      rung_trader_emitters.emplace_back(
+          new TraderEmitterRef(*trader_emitters[candidate]));
+    }
+    eval_results =
+        EvaluateBatchOfTraders(account_config, rung.eval_config, ohlc_history,
+                               side_input, rung_trader_emitters, cache);
+  }
+  return eval_results;
+}
+}  // namespace
+
+std::vector<SearchRung> GetSearchRungs(const EvaluationConfig& eval_config,
+                                       const SearchConfig& search_config,
+                                       int num_candidates) {
+  const int eta = std::max(2, search_config.eta());
+  const bool monthly = eval_config.evaluation_period_months() > 0;
+  const int num_periods =
+      monthly ? GetNumberOfEvaluationPeriods(eval_config) : 1;
+  int num_rungs = search_config.num_rungs();
+  if (num_rungs <= 0) {
+    num_rungs = 1;
+    int64_t first_rung_stride = 1;
+    for (int n = num_candidates; n > eta; n = (n + eta - 1) / eta) {
+      if (monthly && first_rung_stride * eta > num_periods) {
+        break;
+      }
+      first_rung_stride *= eta;
+      ++num_rungs;
+    }
+  }
+  std::vector<SearchRung> rungs(num_rungs);
+  const int64_t max_budget_divisor =
+      monthly ? std::max(1, num_periods)
+              : std::max<int64_t>(1, eval_config.end_timestamp_sec() -
+                                         eval_config.start_timestamp_sec());
+  // Budget of the rung relative to the full budget is 1 / budget_divisor.
+  int64_t budget_divisor = 1;
+  for (int rung_index = num_rungs - 1; rung_index >= 0; --rung_index) {
+    SearchRung& rung = rungs[rung_index];
+    rung.eval_config = eval_config;
+    if (budget_divisor > 1 && monthly) {
+      rung.eval_config.set_period_stride(static_cast<int>(budget_divisor));
+    } else if (budget_divisor > 1) {
+      rung.eval_config.set_end_timestamp_sec(
+          eval_config.start_timestamp_sec() +
+          (eval_config.end_timestamp_sec() -
+           eval_config.start_timestamp_sec()) /
+              budget_divisor);
+    }
+    budget_divisor = std::min(budget_divisor * eta, max_budget_divisor);
+  }
+  int rung_num_candidates = num_candidates;
+  for (SearchRung& rung : rungs) {
+    rung.num_candidates = rung_num_candidates;
+    rung_num_candidates = std::max(1, (rung_num_candidates + eta - 1) / eta);
+  }
+  return rungs;
+}
+
+std::vector<EvaluationResult> SearchBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const SearchConfig& search_config, const OhlcHistory& ohlc_history,
+    const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache) {
+  return SearchBatchOfTradersImpl(account_config, eval_config, search_config,
+                                  ohlc_history, side_input, trader_emitters,
+                                  cache);
+}
+
+std::vector<EvaluationResult> SearchBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const SearchConfig& search_config, const ColumnarOhlcHistory& ohlc_history,
+    const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache) {
+  return SearchBatchOfTradersImpl(account_config, eval_config, search_config,
+                                  ohlc_history, side_input, trader_emitters,
+                                  cache);
+}
+
+}  // namespace trader
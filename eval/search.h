@@ -0,0 +1,63 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef EVAL_SEARCH_H
+#define EVAL_SEARCH_H
+
+#include "base/account.h"
+#include "base/base.h"
+#include "base/columnar_history.h"
+#include "base/side_input.h"
+#include "base/trader.h"
+#include "eval/eval.pb.h"
+#include "eval/evaluation_cache.h"
+
+namespace trader {
+
+// Budget of a single rung of the successive halving search.
+struct SearchRung {
+  // Evaluation configuration of the rung (i.e. a subset of the monthly
+  // evaluation periods, or a shorter time window).
+  EvaluationConfig eval_config;
+  // Number of candidates evaluated in the rung.
+  int num_candidates = 0;
+};
+
+// Returns the rungs of the successive halving search (as defined by the
+// search_config) over num_candidates candidates. The last rung has the full
+// budget (i.e. its eval_config is the same as the given eval_config).
+// If the eval_config has monthly evaluation periods, then the rungs evaluate
+// nested subsets of the periods (every eta^k-th period), otherwise the rungs
+// evaluate (nested) prefixes of the evaluation time window (of length
+// 1 / eta^k of the full window).
+std::vector<SearchRung> GetSearchRungs(const EvaluationConfig& eval_config,
+                                       const SearchConfig& search_config,
+                                       int num_candidates);
+
+// Searches (in parallel) for the best traders among the batch of candidate
+// traders (as emitted by the vector of trader_emitters) by successive halving
+// (see GetSearchRungs). Every rung is evaluated by EvaluateBatchOfTraders,
+// and only the top candidates (by their score) advance to the next rung.
+// The per-period results are kept in the cache (a temporary one if the cache
+// is null), so that the survivors are not re-executed over the periods
+// already evaluated in the previous rungs. Returns the results of the
+// candidates in the last rung, i.e. the same results as EvaluateBatchOfTraders
+// (in the same relative order as the trader_emitters).
+std::vector<EvaluationResult> SearchBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const SearchConfig& search_config, const OhlcHistory& ohlc_history,
+    const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache);
+
+// The same method as SearchBatchOfTraders above, but over the columnar
+// ohlc_history.
+std::vector<EvaluationResult> SearchBatchOfTraders(
+    const AccountConfig& account_config, const EvaluationConfig& eval_config,
+    const SearchConfig& search_config, const ColumnarOhlcHistory& ohlc_history,
+    const SideInput* side_input,
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters,
+    EvaluationCache* cache);
+
+}  // namespace trader
+
+#endif  // EVAL_SEARCH_H
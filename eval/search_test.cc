@@ -0,0 +1,294 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/search.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+#include "eval/eval.h"
+#include "gtest/gtest.h"
+#include "util/time.h"
+
+namespace trader {
+using ::google::protobuf::util::MessageDifferencer;
+
+namespace {
+constexpr int64_t kStartTimestampSec = 1483228800;  // 2017-01-01
+constexpr int64_t kEndTimestampSec = 1514764800;    // 2018-01-01
+
+// Returns the daily OHLC history over the year 2017 (of an oscillating price).
+OhlcHistory GetOhlcHistory() {
+  OhlcHistory ohlc_history;
+  float close = 100.0f;
+  for (int64_t timestamp_sec = kStartTimestampSec;
+       timestamp_sec < kEndTimestampSec; timestamp_sec += kSecondsPerDay) {
+    const int i = static_cast<int>(ohlc_history.size());
+    const float open = close;
+    close = 100.0f + 40.0f * std::sin(0.3f * i) + 0.1f * i;
+    ohlc_history.emplace_back();
+    OhlcTick& ohlc_tick = ohlc_history.back();
+    ohlc_tick.set_timestamp_sec(timestamp_sec);
+    ohlc_tick.set_open(open);
+    ohlc_tick.set_high(std::max(open, close) + 5.0f);
+    ohlc_tick.set_low(std::min(open, close) - 5.0f);
+    ohlc_tick.set_close(close);
+    ohlc_tick.set_volume(1000.0f);
+  }
+  return ohlc_history;
+}
+
+AccountConfig GetAccountConfig() {
+  AccountConfig account_config;
+  account_config.set_start_base_balance(10);
+  account_config.set_start_quote_balance(0);
+  account_config.set_base_unit(0.1f);
+  account_config.set_quote_unit(1);
+  account_config.mutable_limit_order_fee_config()->set_relative_fee(0.01f);
+  account_config.set_market_liquidity(0.5f);
+  account_config.set_max_volume_ratio(0.1f);
+  return account_config;
+}
+
+EvaluationConfig GetEvaluationConfig(int evaluation_period_months) {
+  EvaluationConfig eval_config;
+  eval_config.set_start_timestamp_sec(kStartTimestampSec);
+  eval_config.set_end_timestamp_sec(kEndTimestampSec);
+  eval_config.set_evaluation_period_months(evaluation_period_months);
+  eval_config.set_num_threads(3);
+  eval_config.set_lockstep_batch_size(4);
+  return eval_config;
+}
+
+// Trader that buys and sells the base (crypto) currency at fixed prices.
+class TestTrader : public Trader {
+ public:
+  TestTrader(float buy_price, float sell_price)
+      : buy_price_(buy_price), sell_price_(sell_price) {}
+  virtual ~TestTrader() {}
+
+  void Update(const OhlcTick& ohlc_tick,
+              const std::vector<float>& side_input_signals, float base_balance,
+              float quote_balance, std::vector<Order>& orders) override {
+    orders.emplace_back();
+    Order& order = orders.back();
+    order.set_type(Order_Type_LIMIT);
+    if (ohlc_tick.close() * base_balance > quote_balance) {
+      order.set_side(Order_Side_SELL);
+      order.set_base_amount(base_balance);
+      order.set_price(sell_price_);
+    } else {
+      order.set_side(Order_Side_BUY);
+      order.set_quote_amount(quote_balance);
+      order.set_price(buy_price_);
+    }
+  }
+
+  std::string GetInternalState() const override { return ""; }
+
+ private:
+  // Price at which we want to buy the base (crypto) currency.
+  float buy_price_ = 0.0f;
+  // Price at which we want to sell the base (crypto) currency.
+  float sell_price_ = 0.0f;
+};
+
+// Emitter that emits TestTrader and counts the emitted traders.
+class TestTraderEmitter : public TraderEmitter {
+ public:
+  TestTraderEmitter(float buy_price, float sell_price)
+      : buy_price_(buy_price), sell_price_(sell_price) {}
+  virtual ~TestTraderEmitter() {}
+
+  std::string GetName() const override {
+    return absl::StrFormat("test-trader[%.0f|%.0f]", buy_price_, sell_price_);
+  }
+
+  std::unique_ptr<Trader> NewTrader() const override {
+    ++num_traders_;
+    return absl::make_unique<TestTrader>(buy_price_, sell_price_);
+  }
+
+  int num_traders() const { return num_traders_; }
+
+ private:
+  // Price at which we want to buy the base (crypto) currency.
+  float buy_price_ = 0.0f;
+  // Price at which we want to sell the base (crypto) currency.
+  float sell_price_ = 0.0f;
+  mutable std::atomic<int> num_traders_{0};
+};
+
+// Returns 45 candidate trader emitters.
+std::vector<std::unique_ptr<TraderEmitter>> GetTraderEmitters() {
+  std::vector<std::unique_ptr<TraderEmitter>> trader_emitters;
+  for (int buy_price = 60; buy_price <= 100; buy_price += 5) {
+    for (int sell_price = 110; sell_price <= 150; sell_price += 10) {
+      trader_emitters.emplace_back(
+          new TestTraderEmitter(buy_price, sell_price));
+    }
+  }
+  return trader_emitters;
+}
+
+// Returns the total number of traders emitted by all trader_emitters.
+int GetNumberOfEmittedTraders(
+    const std::vector<std::unique_ptr<TraderEmitter>>& trader_emitters) {
+  int num_traders = 0;
+  for (const auto& trader_emitter : trader_emitters) {
+    num_traders +=
+        static_cast<const TestTraderEmitter&>(*trader_emitter).num_traders();
+  }
+  return num_traders;
+}
+
+// Returns the result with the given name (or nullptr if there is none).
+const EvaluationResult* FindResult(const std::vector<EvaluationResult>& results,
+                                   const std::string& name) {
+  for (const EvaluationResult& result : results) {
+    if (result.name() == name) {
+      return &result;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+TEST(GetSearchRungsTest, MonthlyPeriods) {
+  const EvaluationConfig eval_config =
+      GetEvaluationConfig(/*evaluation_period_months=*/1);
+  SearchConfig search_config;
+  search_config.set_eta(3);
+  std::vector<SearchRung> rungs =
+      GetSearchRungs(eval_config, search_config, /*num_candidates=*/45);
+  // The first rung has stride 9 (out of 12 periods), the next one would have
+  // stride 27 (i.e. less than one evaluation period).
+  ASSERT_EQ(rungs.size(), 3);
+  EXPECT_EQ(rungs[0].num_candidates, 45);
+  EXPECT_EQ(rungs[0].eval_config.period_stride(), 9);
+  EXPECT_EQ(rungs[1].num_candidates, 15);
+  EXPECT_EQ(rungs[1].eval_config.period_stride(), 3);
+  EXPECT_EQ(rungs[2].num_candidates, 5);
+  EXPECT_TRUE(MessageDifferencer::Equals(rungs[2].eval_config, eval_config));
+
+  search_config.set_num_rungs(2);
+  rungs = GetSearchRungs(eval_config, search_config, /*num_candidates=*/45);
+  ASSERT_EQ(rungs.size(), 2);
+  EXPECT_EQ(rungs[0].num_candidates, 45);
+  EXPECT_EQ(rungs[0].eval_config.period_stride(), 3);
+  EXPECT_EQ(rungs[1].num_candidates, 15);
+  EXPECT_TRUE(MessageDifferencer::Equals(rungs[1].eval_config, eval_config));
+}
+
+TEST(GetSearchRungsTest, SingleWindow) {
+  const EvaluationConfig eval_config =
+      GetEvaluationConfig(/*evaluation_period_months=*/0);
+  SearchConfig search_config;
+  search_config.set_eta(3);
+  const std::vector<SearchRung> rungs =
+      GetSearchRungs(eval_config, search_config, /*num_candidates=*/45);
+  ASSERT_EQ(rungs.size(), 4);
+  const int64_t window_sec = kEndTimestampSec - kStartTimestampSec;
+  const int expected_num_candidates[] = {45, 15, 5, 2};
+  const int64_t expected_window_sec[] = {window_sec / 27, window_sec / 9,
+                                         window_sec / 3, window_sec};
+  for (size_t i = 0; i < rungs.size(); ++i) {
+    EXPECT_EQ(rungs[i].num_candidates, expected_num_candidates[i]);
+    EXPECT_EQ(rungs[i].eval_config.start_timestamp_sec(), kStartTimestampSec);
+    EXPECT_EQ(rungs[i].eval_config.end_timestamp_sec(),
+              kStartTimestampSec + expected_window_sec[i]);
+    EXPECT_FALSE(rungs[i].eval_config.has_period_stride());
+  }
+}
+
+TEST(SearchBatchOfTradersTest, SameResultsAsEvaluateBatchOfTraders) {
+  const OhlcHistory ohlc_history = GetOhlcHistory();
+  const ColumnarOhlcHistory columnar_ohlc_history(ohlc_history);
+  const AccountConfig account_config = GetAccountConfig();
+  const EvaluationConfig eval_config =
+      GetEvaluationConfig(/*evaluation_period_months=*/1);
+  const std::vector<std::unique_ptr<TraderEmitter>> trader_emitters =
+      GetTraderEmitters();
+  const std::vector<EvaluationResult> expected_results =
+      EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
+                             /*side_input=*/nullptr, trader_emitters,
+                             /*cache=*/nullptr);
+  ASSERT_EQ(expected_results.size(), 45);
+  ASSERT_EQ(expected_results[0].period_size(), 12);
+  ASSERT_EQ(GetNumberOfEmittedTraders(trader_emitters), 45 * 12);
+
+  SearchConfig search_config;
+  search_config.set_eta(3);
+  const std::vector<EvaluationResult> results = SearchBatchOfTraders(
+      account_config, eval_config, search_config, columnar_ohlc_history,
+      /*side_input=*/nullptr, trader_emitters, /*cache=*/nullptr);
+  ASSERT_EQ(results.size(), 5);
+  for (const EvaluationResult& result : results) {
+    const EvaluationResult* expected_result =
+        FindResult(expected_results, result.name());
+    ASSERT_NE(expected_result, nullptr) << result.name();
+    EXPECT_TRUE(MessageDifferencer::Equals(result, *expected_result))
+        << result.name();
+  }
+  // Rungs evaluate 45 candidates over 2 periods, then 15 candidates over 4
+  // periods, and finally 5 candidates over all 12 periods. The periods
+  // evaluated in the previous rungs are not executed again.
+  EXPECT_EQ(GetNumberOfEmittedTraders(trader_emitters),
+            45 * 12 + 45 * 2 + 15 * (4 - 2) + 5 * (12 - 4));
+
+  // A single rung evaluates all candidates with the full budget.
+  search_config.set_num_rungs(1);
+  const std::vector<EvaluationResult> full_results = SearchBatchOfTraders(
+      account_config, eval_config, search_config, ohlc_history,
+      /*side_input=*/nullptr, trader_emitters, /*cache=*/nullptr);
+  ASSERT_EQ(full_results.size(), expected_results.size());
+  for (size_t i = 0; i < full_results.size(); ++i) {
+    EXPECT_TRUE(MessageDifferencer::Equals(full_results[i],
+                                           expected_results[i]))
+        << full_results[i].name();
+  }
+}
+
+TEST(SearchBatchOfTradersTest, SurvivorsAreTopCandidates) {
+  const OhlcHistory ohlc_history = GetOhlcHistory();
+  const AccountConfig account_config = GetAccountConfig();
+  const EvaluationConfig eval_config =
+      GetEvaluationConfig(/*evaluation_period_months=*/0);
+  const std::vector<std::unique_ptr<TraderEmitter>> trader_emitters =
+      GetTraderEmitters();
+  SearchConfig search_config;
+  search_config.set_eta(3);
+  search_config.set_num_rungs(2);
+  const std::vector<SearchRung> rungs =
+      GetSearchRungs(eval_config, search_config, trader_emitters.size());
+  ASSERT_EQ(rungs.size(), 2);
+  const std::vector<EvaluationResult> first_rung_results =
+      EvaluateBatchOfTraders(account_config, rungs[0].eval_config,
+                             ohlc_history, /*side_input=*/nullptr,
+                             trader_emitters, /*cache=*/nullptr);
+  const std::vector<EvaluationResult> results = SearchBatchOfTraders(
+      account_config, eval_config, search_config, ohlc_history,
+      /*side_input=*/nullptr, trader_emitters, /*cache=*/nullptr);
+  ASSERT_EQ(results.size(), 15);
+  // Every survivor has at least the same first rung score as every pruned
+  // candidate.
+  float min_survivor_score = std::numeric_limits<float>::max();
+  for (const EvaluationResult& result : results) {
+    const EvaluationResult* first_rung_result =
+        FindResult(first_rung_results, result.name());
+    ASSERT_NE(first_rung_result, nullptr) << result.name();
+    min_survivor_score =
+        std::min(min_survivor_score, first_rung_result->score());
+  }
+  for (const EvaluationResult& first_rung_result : first_rung_results) {
+    if (FindResult(results, first_rung_result.name()) == nullptr) {
+      EXPECT_LE(first_rung_result.score(), min_survivor_score);
+    }
+  }
+}
+
+}  // namespace trader
@@ -0,0 +1,289 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/sweep.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "util/proto.h"
+
+namespace trader {
+namespace fs = std::filesystem;
+
+namespace {
+constexpr char kShardPrefix[] = "shard-";
+constexpr char kTodoSuffix[] = "todo";
+constexpr char kClaimedSuffix[] = "claimed.";
+constexpr char kResultsSuffix[] = "results";
+constexpr char kDoneFileName[] = "sweep.done";
+
+// Returns the name of the shard of traders [begin, end).
+std::string GetShardName(size_t begin, size_t end) {
+  return absl::StrFormat("%s%d-%d", kShardPrefix, begin, end);
+}
+
+// Splits the file name "<shard_name>.<suffix>" into the shard name and the
+// suffix and parses the shard's trader range [begin, end). Returns false if
+// the file name does not belong to a shard.
+bool ParseShardFileName(const std::string& file_name, std::string& shard_name,
+                        std::string& suffix, size_t& begin, size_t& end) {
+  if (!absl::StartsWith(file_name, kShardPrefix)) {
+    return false;
+  }
+  const std::vector<std::string> parts =
+      absl::StrSplit(file_name, absl::MaxSplits('.', 1));
+  if (parts.size() != 2) {
+    return false;
+  }
+  const std::vector<absl::string_view> range = absl::StrSplit(
+      absl::string_view(parts[0]).substr(sizeof(kShardPrefix) - 1), '-');
+  if (range.size() != 2 || !absl::SimpleAtoi(range[0], &begin) ||
+      !absl::SimpleAtoi(range[1], &end) || begin >= end) {
+    return false;
+  }
+  shard_name = parts[0];
+  suffix = parts[1];
+  return true;
+}
+
+// Creates an empty file.
+absl::Status CreateEmptyFile(const fs::path& path) {
+  std::ofstream stream(path);
+  if (!stream) {
+    return absl::InternalError(
+        absl::StrFormat("Cannot create the file %s", path.string()));
+  }
+  return absl::OkStatus();
+}
+
+// Sleeps for the polling interval.
+void Sleep(const SweepConfig& sweep_config) {
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(std::max(1, sweep_config.poll_interval_ms())));
+}
+
+// Refreshes the last write time of the claimed shard file (heartbeat) four
+// times per claim timeout, from a background thread, until destroyed.
+class ClaimHeartbeat {
+ public:
+  ClaimHeartbeat(const SweepConfig& sweep_config, fs::path claim_path)
+      : claim_path_(std::move(claim_path)),
+        interval_(std::max<int64_t>(
+            1, int64_t{1000} * sweep_config.claim_timeout_sec() / 4)),
+        thread_([this]() { Run(); }) {}
+  ClaimHeartbeat(const ClaimHeartbeat&) = delete;
+  ClaimHeartbeat& operator=(const ClaimHeartbeat&) = delete;
+  ~ClaimHeartbeat() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    stopped_.notify_one();
+    thread_.join();
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (
+        !stopped_.wait_for(lock, interval_, [this]() { return stopping_; })) {
+      // The claim might have been handed out again meanwhile.
+      std::error_code error_code;
+      fs::last_write_time(claim_path_, fs::file_time_type::clock::now(),
+                          error_code);
+    }
+  }
+
+  fs::path claim_path_;
+  std::chrono::milliseconds interval_;
+  std::mutex mutex_;
+  // Signaled when the heartbeat is stopping.
+  std::condition_variable stopped_;
+  bool stopping_ = false;
+  // Started last (after all fields above are initialized).
+  std::thread thread_;
+};
+}  // namespace
+
+absl::StatusOr<std::vector<EvaluationResult>> CoordinateSweep(
+    const SweepConfig& sweep_config, size_t num_traders) {
+  const fs::path work_dir(sweep_config.work_dir());
+  std::error_code error_code;
+  fs::create_directories(work_dir, error_code);
+  if (error_code || !fs::is_empty(work_dir, error_code)) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Cannot use the work directory %s (it needs to be empty)",
+        work_dir.string()));
+  }
+  struct Shard {
+    size_t begin = 0;
+    size_t end = 0;
+    // Number of times the shard was handed out again.
+    int num_retries = 0;
+    bool done = false;
+  };
+  std::map<std::string, Shard> shards;
+  const size_t shard_size =
+      static_cast<size_t>(std::max(1, sweep_config.shard_size()));
+  for (size_t begin = 0; begin < num_traders; begin += shard_size) {
+    const size_t end = std::min(begin + shard_size, num_traders);
+    const std::string shard_name = GetShardName(begin, end);
+    shards[shard_name] = {begin, end};
+    const absl::Status status =
+        CreateEmptyFile(work_dir / (shard_name + "." + kTodoSuffix));
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  std::vector<EvaluationResult> eval_results(num_traders);
+  size_t num_pending = shards.size();
+  while (num_pending > 0) {
+    for (auto& [shard_name, shard] : shards) {
+      const fs::path results_path =
+          work_dir / (shard_name + "." + kResultsSuffix);
+      if (shard.done || !fs::exists(results_path, error_code)) {
+        continue;
+      }
+      std::vector<EvaluationResult> shard_results;
+      const absl::Status status =
+          ReadDelimitedMessagesFromFile<EvaluationResult>(
+              results_path.string(), shard_results);
+      if (status.ok() && shard_results.size() == shard.end - shard.begin) {
+        std::move(shard_results.begin(), shard_results.end(),
+                  eval_results.begin() + shard.begin);
+        shard.done = true;
+        --num_pending;
+        // The shard might have been handed out again meanwhile.
+        fs::remove(work_dir / (shard_name + "." + kTodoSuffix), error_code);
+        continue;
+      }
+      // Invalid results are discarded and the shard is handed out again.
+      if (++shard.num_retries > sweep_config.max_retries()) {
+        return absl::DataLossError(
+            absl::StrFormat("Invalid results of the shard %s", shard_name));
+      }
+      fs::remove(results_path, error_code);
+      const absl::Status todo_status =
+          CreateEmptyFile(work_dir / (shard_name + "." + kTodoSuffix));
+      if (!todo_status.ok()) {
+        return todo_status;
+      }
+    }
+    // Hands out again the shards whose heartbeat stopped.
+    const fs::file_time_type claim_deadline =
+        fs::file_time_type::clock::now() -
+        std::chrono::seconds(sweep_config.claim_timeout_sec());
+    for (fs::directory_iterator it(work_dir, error_code);
+         !error_code && it != fs::directory_iterator();
+         it.increment(error_code)) {
+      std::string shard_name;
+      std::string suffix;
+      size_t begin = 0;
+      size_t end = 0;
+      if (!ParseShardFileName(it->path().filename().string(), shard_name,
+                              suffix, begin, end) ||
+          !absl::StartsWith(suffix, kClaimedSuffix)) {
+        continue;
+      }
+      const auto shard_it = shards.find(shard_name);
+      std::error_code claim_error_code;
+      if (shard_it == shards.end() || shard_it->second.done ||
+          fs::last_write_time(it->path(), claim_error_code) > claim_deadline ||
+          claim_error_code) {
+        continue;
+      }
+      // The worker might have finished (and removed its claim) meanwhile.
+      fs::rename(it->path(), work_dir / (shard_name + "." + kTodoSuffix),
+                 claim_error_code);
+      if (!claim_error_code &&
+          ++shard_it->second.num_retries > sweep_config.max_retries()) {
+        return absl::DeadlineExceededError(absl::StrFormat(
+            "The shard %s timed out %d times", shard_name,
+            shard_it->second.num_retries));
+      }
+    }
+    if (num_pending > 0) {
+      Sleep(sweep_config);
+    }
+  }
+  const absl::Status status = CreateEmptyFile(work_dir / kDoneFileName);
+  if (!status.ok()) {
+    return status;
+  }
+  return eval_results;
+}
+
+absl::StatusOr<int> RunSweepWorker(
+    const SweepConfig& sweep_config, const std::string& worker_id,
+    const EvaluateShardFunction& evaluate_shard) {
+  const fs::path work_dir(sweep_config.work_dir());
+  int num_shards = 0;
+  std::error_code error_code;
+  while (!fs::exists(work_dir / kDoneFileName, error_code)) {
+    // Claims the first available shard (if any).
+    std::string shard_name;
+    size_t begin = 0;
+    size_t end = 0;
+    fs::path claim_path;
+    for (fs::directory_iterator it(work_dir, error_code);
+         !error_code && it != fs::directory_iterator();
+         it.increment(error_code)) {
+      std::string suffix;
+      if (!ParseShardFileName(it->path().filename().string(), shard_name,
+                              suffix, begin, end) ||
+          suffix != kTodoSuffix) {
+        continue;
+      }
+      // The last write time of the claimed shard file is its heartbeat.
+      std::error_code claim_error_code;
+      fs::last_write_time(it->path(), fs::file_time_type::clock::now(),
+                          claim_error_code);
+      const fs::path path =
+          work_dir / (shard_name + "." + kClaimedSuffix + worker_id);
+      fs::rename(it->path(), path, claim_error_code);
+      if (!claim_error_code) {
+        claim_path = path;
+        break;
+      }
+    }
+    if (claim_path.empty()) {
+      Sleep(sweep_config);
+      continue;
+    }
+    std::vector<EvaluationResult> shard_results;
+    {
+      ClaimHeartbeat heartbeat(sweep_config, claim_path);
+      shard_results = evaluate_shard(begin, end);
+    }
+    const fs::path results_path =
+        work_dir / (shard_name + "." + kResultsSuffix);
+    const fs::path temp_results_path =
+        work_dir / (shard_name + "." + kResultsSuffix + ".tmp." + worker_id);
+    const absl::Status status = WriteDelimitedMessagesToFile(
+        shard_results.begin(), shard_results.end(), temp_results_path.string(),
+        /*compress=*/true);
+    if (!status.ok()) {
+      return status;
+    }
+    fs::rename(temp_results_path, results_path, error_code);
+    if (error_code) {
+      return absl::InternalError(
+          absl::StrFormat("Cannot rename the file %s to %s",
+                          temp_results_path.string(), results_path.string()));
+    }
+    fs::remove(claim_path, error_code);
+    ++num_shards;
+  }
+  return num_shards;
+}
+
+}  // namespace trader
@@ -0,0 +1,55 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef EVAL_SWEEP_H
+#define EVAL_SWEEP_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "eval/eval.pb.h"
+
+namespace trader {
+
+// Distributed sweep over a batch of traders (e.g. by several processes on one
+// or more nodes), coordinated via a shared work directory.
+//
+// The coordinator splits the batch into shards of consecutive traders
+// [begin, end) and creates the file "shard-<begin>-<end>.todo" per shard.
+// A worker claims a shard by (atomically) renaming its file to
+// "shard-<begin>-<end>.claimed.<worker_id>", evaluates the traders of the
+// shard, and publishes their EvaluationResults (as delimited protos) by
+// (atomically) renaming a temporary file to "shard-<begin>-<end>.results".
+// While evaluating the shard, the worker periodically refreshes the last write
+// time of the claimed file (heartbeat). The coordinator hands out again the
+// shards whose heartbeat stopped (e.g. shards of crashed workers), merges
+// the results of all shards, and finally creates the "sweep.done" file, after
+// which the workers exit.
+//
+// All processes need to emit the same batch of traders (and evaluate them
+// in the same way), since only the trader indices are exchanged.
+
+// Coordinates the sweep over num_traders traders in the (empty or not yet
+// existing) sweep_config.work_dir. Blocks until the results of all shards
+// are available. Returns the merged results in the order of the traders.
+absl::StatusOr<std::vector<EvaluationResult>> CoordinateSweep(
+    const SweepConfig& sweep_config, size_t num_traders);
+
+// Evaluates the traders [begin, end) of the batch. Returns their results
+// (in the same order).
+using EvaluateShardFunction =
+    std::function<std::vector<EvaluationResult>(size_t begin, size_t end)>;
+
+// Claims and evaluates shards of the sweep in the sweep_config.work_dir until
+// the coordinator marks the sweep as done. The worker_id must be unique and
+// usable within a file name (e.g. "<hostname>.<pid>"). Returns the number of
+// shards evaluated by this worker.
+absl::StatusOr<int> RunSweepWorker(const SweepConfig& sweep_config,
+                                   const std::string& worker_id,
+                                   const EvaluateShardFunction& evaluate_shard);
+
+}  // namespace trader
+
+#endif  // EVAL_SWEEP_H
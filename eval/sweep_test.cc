@@ -0,0 +1,252 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "eval/sweep.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "absl/strings/str_format.h"
+#include "eval/evaluation_cache.h"
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace fs = std::filesystem;
+
+namespace {
+// Returns a fresh (non-existing) work directory for the test.
+std::string GetWorkDir(const std::string& test_name) {
+  const fs::path work_dir = fs::temp_directory_path() /
+                            absl::StrFormat("sweep_test_%s", test_name);
+  fs::remove_all(work_dir);
+  return work_dir.string();
+}
+
+SweepConfig GetSweepConfig(const std::string& work_dir) {
+  SweepConfig sweep_config;
+  sweep_config.set_work_dir(work_dir);
+  sweep_config.set_shard_size(3);
+  sweep_config.set_claim_timeout_sec(1);
+  sweep_config.set_max_retries(1);
+  sweep_config.set_poll_interval_ms(10);
+  return sweep_config;
+}
+
+// Returns the (fake) results of the traders [begin, end).
+std::vector<EvaluationResult> EvaluateShard(size_t begin, size_t end) {
+  std::vector<EvaluationResult> results(end - begin);
+  for (size_t i = begin; i < end; ++i) {
+    results[i - begin].set_name(absl::StrFormat("trader-%d", i));
+    results[i - begin].set_score(static_cast<float>(i));
+  }
+  return results;
+}
+
+// Waits until the file exists.
+void WaitForFile(const fs::path& path) {
+  while (!fs::exists(path)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void ExpectResults(const std::vector<EvaluationResult>& results,
+                   size_t num_traders) {
+  ASSERT_EQ(results.size(), num_traders);
+  for (size_t i = 0; i < num_traders; ++i) {
+    EXPECT_EQ(results[i].name(), absl::StrFormat("trader-%d", i));
+    EXPECT_EQ(results[i].score(), static_cast<float>(i));
+  }
+}
+}  // namespace
+
+TEST(SweepTest, MultipleWorkers) {
+  const SweepConfig sweep_config = GetSweepConfig(GetWorkDir("workers"));
+  constexpr size_t kNumTraders = 20;
+  constexpr int kNumWorkers = 4;
+  // Number of evaluations of every trader.
+  std::vector<std::atomic<int>> num_evaluations(kNumTraders);
+  std::vector<int> num_shards(kNumWorkers);
+  std::vector<std::thread> workers;
+  for (int worker = 0; worker < kNumWorkers; ++worker) {
+    workers.emplace_back([&, worker]() {
+      const absl::StatusOr<int> num_shards_status = RunSweepWorker(
+          sweep_config, absl::StrFormat("worker-%d", worker),
+          [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+              ++num_evaluations[i];
+            }
+            return EvaluateShard(begin, end);
+          });
+      ASSERT_TRUE(num_shards_status.ok()) << num_shards_status.status();
+      num_shards[worker] = num_shards_status.value();
+    });
+  }
+  const absl::StatusOr<std::vector<EvaluationResult>> results_status =
+      CoordinateSweep(sweep_config, kNumTraders);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  ASSERT_TRUE(results_status.ok()) << results_status.status();
+  ExpectResults(results_status.value(), kNumTraders);
+  // Every trader is evaluated exactly once (in one of the 7 shards).
+  for (size_t i = 0; i < kNumTraders; ++i) {
+    EXPECT_EQ(num_evaluations[i], 1) << i;
+  }
+  int total_num_shards = 0;
+  for (const int worker_num_shards : num_shards) {
+    total_num_shards += worker_num_shards;
+  }
+  EXPECT_EQ(total_num_shards, 7);
+}
+
+TEST(SweepTest, MultipleWorkerProcesses) {
+  const SweepConfig sweep_config = GetSweepConfig(GetWorkDir("processes"));
+  const std::string cache_file_name =
+      (fs::temp_directory_path() / "sweep_test_processes_cache.pb").string();
+  fs::remove(cache_file_name);
+  constexpr size_t kNumTraders = 20;
+  constexpr int kNumWorkers = 4;
+  std::vector<pid_t> workers;
+  for (int worker = 0; worker < kNumWorkers; ++worker) {
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      // Every worker process shares the evaluation cache file, which it
+      // updates after every shard.
+      EvaluationCache cache;
+      bool cache_ok = true;
+      const absl::StatusOr<int> num_shards_status = RunSweepWorker(
+          sweep_config, absl::StrFormat("worker-%d", getpid()),
+          [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+              EvaluationCacheEntry entry;
+              entry.set_name(absl::StrFormat("trader-%d", i));
+              entry.set_fingerprint(i);
+              cache.Insert(std::move(entry));
+            }
+            cache_ok = cache_ok && cache.WriteToFile(cache_file_name).ok();
+            return EvaluateShard(begin, end);
+          });
+      _exit(num_shards_status.ok() && cache_ok ? 0 : 1);
+    }
+    workers.push_back(pid);
+  }
+  const absl::StatusOr<std::vector<EvaluationResult>> results_status =
+      CoordinateSweep(sweep_config, kNumTraders);
+  for (const pid_t pid : workers) {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+  ASSERT_TRUE(results_status.ok()) << results_status.status();
+  ExpectResults(results_status.value(), kNumTraders);
+  // The cache entries of all workers are preserved.
+  const absl::StatusOr<std::unique_ptr<EvaluationCache>> cache_status =
+      EvaluationCache::ReadFromFile(cache_file_name);
+  ASSERT_TRUE(cache_status.ok()) << cache_status.status();
+  EXPECT_EQ(cache_status.value()->size(), kNumTraders);
+  ExecutionResult result;
+  for (size_t i = 0; i < kNumTraders; ++i) {
+    EXPECT_TRUE(cache_status.value()->Lookup(absl::StrFormat("trader-%d", i),
+                                             i, &result))
+        << i;
+  }
+}
+
+TEST(SweepTest, HeartbeatKeepsLongShardClaimed) {
+  SweepConfig sweep_config = GetSweepConfig(GetWorkDir("heartbeat"));
+  sweep_config.set_max_retries(0);
+  constexpr size_t kNumTraders = 3;
+  std::atomic<int> num_calls{0};
+  std::thread worker([&]() {
+    const absl::StatusOr<int> num_shards_status = RunSweepWorker(
+        sweep_config, "worker", [&](size_t begin, size_t end) {
+          ++num_calls;
+          // The shard is evaluated for longer than the claim timeout.
+          std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+          return EvaluateShard(begin, end);
+        });
+    ASSERT_TRUE(num_shards_status.ok()) << num_shards_status.status();
+    EXPECT_EQ(num_shards_status.value(), 1);
+  });
+  const absl::StatusOr<std::vector<EvaluationResult>> results_status =
+      CoordinateSweep(sweep_config, kNumTraders);
+  worker.join();
+  ASSERT_TRUE(results_status.ok()) << results_status.status();
+  ExpectResults(results_status.value(), kNumTraders);
+  EXPECT_EQ(num_calls, 1);
+}
+
+TEST(SweepTest, RetriesTimedOutShard) {
+  const SweepConfig sweep_config = GetSweepConfig(GetWorkDir("retry"));
+  constexpr size_t kNumTraders = 6;
+  std::thread coordinator_and_worker([&]() {
+    // Simulates a crashed worker that claimed the first shard.
+    WaitForFile(fs::path(sweep_config.work_dir()) / "shard-0-3.todo");
+    fs::rename(fs::path(sweep_config.work_dir()) / "shard-0-3.todo",
+               fs::path(sweep_config.work_dir()) / "shard-0-3.claimed.crashed");
+    const absl::StatusOr<int> num_shards_status =
+        RunSweepWorker(sweep_config, "worker", EvaluateShard);
+    ASSERT_TRUE(num_shards_status.ok()) << num_shards_status.status();
+    EXPECT_EQ(num_shards_status.value(), 2);
+  });
+  const absl::StatusOr<std::vector<EvaluationResult>> results_status =
+      CoordinateSweep(sweep_config, kNumTraders);
+  coordinator_and_worker.join();
+  ASSERT_TRUE(results_status.ok()) << results_status.status();
+  ExpectResults(results_status.value(), kNumTraders);
+}
+
+TEST(SweepTest, FailsAfterMaxRetries) {
+  SweepConfig sweep_config = GetSweepConfig(GetWorkDir("max_retries"));
+  sweep_config.set_max_retries(0);
+  std::thread crashed_worker([&]() {
+    WaitForFile(fs::path(sweep_config.work_dir()) / "shard-0-2.todo");
+    fs::rename(fs::path(sweep_config.work_dir()) / "shard-0-2.todo",
+               fs::path(sweep_config.work_dir()) / "shard-0-2.claimed.crashed");
+  });
+  const absl::StatusOr<std::vector<EvaluationResult>> results_status =
+      CoordinateSweep(sweep_config, /*num_traders=*/2);
+  crashed_worker.join();
+  EXPECT_EQ(results_status.status().code(),
+            absl::StatusCode::kDeadlineExceeded);
+}
+
+TEST(SweepTest, RetriesInvalidResults) {
+  const SweepConfig sweep_config = GetSweepConfig(GetWorkDir("invalid"));
+  constexpr size_t kNumTraders = 5;
+  std::atomic<int> num_calls{0};
+  std::thread worker([&]() {
+    const absl::StatusOr<int> num_shards_status = RunSweepWorker(
+        sweep_config, "worker", [&](size_t begin, size_t end) {
+          // The first shard evaluation returns too few results.
+          if (num_calls++ == 0) {
+            return EvaluateShard(begin, end - 1);
+          }
+          return EvaluateShard(begin, end);
+        });
+    ASSERT_TRUE(num_shards_status.ok()) << num_shards_status.status();
+    EXPECT_EQ(num_shards_status.value(), 3);
+  });
+  const absl::StatusOr<std::vector<EvaluationResult>> results_status =
+      CoordinateSweep(sweep_config, kNumTraders);
+  worker.join();
+  ASSERT_TRUE(results_status.ok()) << results_status.status();
+  ExpectResults(results_status.value(), kNumTraders);
+}
+
+TEST(SweepTest, RequiresEmptyWorkDir) {
+  const SweepConfig sweep_config = GetSweepConfig(GetWorkDir("non_empty"));
+  fs::create_directories(sweep_config.work_dir());
+  std::ofstream(fs::path(sweep_config.work_dir()) / "sweep.done");
+  EXPECT_EQ(CoordinateSweep(sweep_config, /*num_traders=*/10).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+}  // namespace trader
@@ -0,0 +1,175 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "base/base.h"
+#include "base/binary_history.h"
+#include "base/columnar_history.h"
+#include "indicators/features.h"
+#include "util/proto.h"
+#include "util/time.h"
+
+ABSL_FLAG(std::string, input_ohlc_history_delimited_proto_file, "",
+          "Input file containing the delimited OhlcRecord protos.");
+ABSL_FLAG(std::string, input_ohlc_history_binary_file, "",
+          "Input binary history file containing the OHLC history.");
+ABSL_FLAG(std::string, output_side_history_delimited_proto_file, "",
+          "Output file containing the delimited SideInputRecord protos.");
+
+ABSL_FLAG(std::string, start_time, "2017-01-01",
+          "Start date-time YYYY-MM-DD [hh:mm:ss] (included).");
+ABSL_FLAG(std::string, end_time, "2021-01-01",
+          "End date-time YYYY-MM-DD [hh:mm:ss] (excluded).");
+
+ABSL_FLAG(int, sampling_rate_sec, 300,
+          "Sampling rate of the input OHLC history in seconds.");
+ABSL_FLAG(int, period_size_sec, 0,
+          "Period in seconds of the OHLC ticks the indicators are computed "
+          "over (0 = --sampling_rate_sec). Needs to be a multiple of "
+          "--sampling_rate_sec.");
+ABSL_FLAG(std::string, features,
+          "sma:50,ema:50,macd:12:26:9,rsi:14,stochastic:14,volatility:0",
+          "Comma-separated indicator features <name>:<param>[:<param>...], "
+          "where the name is one of: sma, ema, macd, rsi, stochastic, "
+          "volatility.");
+
+ABSL_FLAG(bool, compress, true,
+          "Whether to compress the output protobuf file.");
+
+using namespace trader;
+
+namespace {
+void LogInfo(absl::string_view str) { absl::PrintF("%s\n", str); }
+void LogError(absl::string_view str) { absl::FPrintF(stderr, "%s\n", str); }
+void CheckOk(const absl::Status status) {
+  if (!status.ok()) {
+    LogError(status.message());
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+// Returns the columnar OHLC history (within the given time period) read from
+// either the binary history file or the delimited proto file.
+absl::StatusOr<ColumnarOhlcHistory> ReadOhlcHistory(absl::Time start_time,
+                                                    absl::Time end_time) {
+  const absl::Time latency_start_time = absl::Now();
+  ColumnarOhlcHistory ohlc_history;
+  if (!absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty()) {
+    LogInfo(absl::StrFormat(
+        "Reading OHLC history from: %s",
+        absl::GetFlag(FLAGS_input_ohlc_history_binary_file)));
+    const absl::StatusOr<BinaryHistoryFile> history_file_status =
+        BinaryHistoryFile::Open(
+            absl::GetFlag(FLAGS_input_ohlc_history_binary_file));
+    if (!history_file_status.ok()) {
+      return history_file_status.status();
+    }
+    // OHLC pyramid files contain more sampling rates.
+    absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+        history_file_status.value().GetOhlcHistory(
+            absl::GetFlag(FLAGS_sampling_rate_sec));
+    if (!ohlc_history_status.ok()) {
+      return ohlc_history_status.status();
+    }
+    ohlc_history = std::move(ohlc_history_status).value();
+  } else {
+    LogInfo(absl::StrFormat(
+        "Reading OHLC history from: %s",
+        absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file)));
+    OhlcHistory history;
+    const absl::Status status = ReadDelimitedMessagesFromFile<OhlcTick>(
+        absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file),
+        history);
+    if (!status.ok()) {
+      return status;
+    }
+    ohlc_history = ColumnarOhlcHistory(history);
+  }
+  LogInfo(absl::StrFormat(
+      "- Loaded %d records in %.3f seconds", ohlc_history.size(),
+      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  const std::pair<size_t, size_t> subset = ohlc_history.Subset(
+      absl::ToUnixSeconds(start_time), absl::ToUnixSeconds(end_time));
+  LogInfo(
+      absl::StrFormat("- Selected %d records within the time period: [%s - %s)",
+                      subset.second - subset.first,  // nowrap
+                      FormatTimeUTC(start_time),     // nowrap
+                      FormatTimeUTC(end_time)));
+  return ohlc_history.Slice(subset.first, subset.second);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // Verify that the version of the library that we linked against is
+  // compatible with the version of the headers we compiled against.
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+  absl::ParseCommandLine(argc, argv);
+
+  if (absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty() ==
+      absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file).empty()) {
+    LogError("Expected exactly one input OHLC history file");
+    std::exit(EXIT_FAILURE);
+  }
+  if (absl::GetFlag(FLAGS_output_side_history_delimited_proto_file).empty()) {
+    LogError("Missing output_side_history_delimited_proto_file");
+    std::exit(EXIT_FAILURE);
+  }
+
+  const absl::StatusOr<absl::Time> start_time_status =
+      ParseTime(absl::GetFlag(FLAGS_start_time));
+  CheckOk(start_time_status.status());
+  const absl::StatusOr<absl::Time> end_time_status =
+      ParseTime(absl::GetFlag(FLAGS_end_time));
+  CheckOk(end_time_status.status());
+  const absl::Time start_time = start_time_status.value();
+  const absl::Time end_time = end_time_status.value();
+  LogInfo(absl::StrFormat("Selected time period:\n[%s - %s)",
+                          FormatTimeUTC(start_time), FormatTimeUTC(end_time)));
+
+  const absl::StatusOr<std::vector<IndicatorFeature>> features_status =
+      ParseIndicatorFeatures(absl::GetFlag(FLAGS_features));
+  CheckOk(features_status.status());
+  const std::vector<IndicatorFeature>& features = features_status.value();
+
+  const absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+      ReadOhlcHistory(start_time, end_time);
+  CheckOk(ohlc_history_status.status());
+
+  const int sampling_rate_sec = absl::GetFlag(FLAGS_sampling_rate_sec);
+  const int period_size_sec = absl::GetFlag(FLAGS_period_size_sec) > 0
+                                  ? absl::GetFlag(FLAGS_period_size_sec)
+                                  : sampling_rate_sec;
+  LogInfo(absl::StrFormat("Computing features over %d sec periods:",
+                          period_size_sec));
+  const std::vector<std::string> signal_names =
+      GetIndicatorFeatureSignalNames(features);
+  for (size_t i = 0; i < signal_names.size(); ++i) {
+    LogInfo(absl::StrFormat("- signal %d: %s", i, signal_names[i]));
+  }
+  const absl::Time latency_start_time = absl::Now();
+  const absl::StatusOr<SideHistory> side_history_status =
+      ComputeIndicatorFeatures(ohlc_history_status.value(), sampling_rate_sec,
+                               period_size_sec, features);
+  CheckOk(side_history_status.status());
+  const SideHistory& side_history = side_history_status.value();
+  LogInfo(
+      absl::StrFormat("- Computed %d records in %.3f seconds",
+                      side_history.size(),
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+
+  LogInfo(absl::StrFormat(
+      "Writing %d records to the file: %s", side_history.size(),
+      absl::GetFlag(FLAGS_output_side_history_delimited_proto_file)));
+  CheckOk(WriteDelimitedMessagesToFile(
+      side_history.begin(), side_history.end(),
+      absl::GetFlag(FLAGS_output_side_history_delimited_proto_file),
+      absl::GetFlag(FLAGS_compress)));
+
+  return 0;
+}
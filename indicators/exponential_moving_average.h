@@ -38,8 +38,16 @@ class ExponentialMovingAverage {
   virtual void Update(const OhlcTick& ohlc_tick);
 
  private:
+  friend class LastNOhlcTicks<ExponentialMovingAverage>;
+  // LastNOhlcTicks listener methods (see LastNOhlcTicks).
+  void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                       const OhlcTickView& new_ohlc_tick);
+  void NewTickAdded(const OhlcTickView& new_ohlc_tick);
+  void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+                                        const OhlcTickView& new_ohlc_tick);
+
   // Keeps track of the current OHLC tick.
-  LastNOhlcTicks last_n_ohlc_ticks_;
+  LastNOhlcTicks<ExponentialMovingAverage> last_n_ohlc_ticks_;
 
   // Weight of the new closing prices in the Exponential Moving Average.
   float weight_ = 0;
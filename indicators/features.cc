@@ -0,0 +1,208 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "indicators/features.h"
+
+#include <cassert>
+#include <utility>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "base/ohlc_pyramid.h"
+#include "indicators/indicator_series.h"
+
+namespace trader {
+namespace {
+// Description of a single indicator feature type.
+struct IndicatorFeatureInfo {
+  // Name used in the feature specification.
+  const char* name;
+  IndicatorFeature::Type type;
+  // Number of (integer) parameters.
+  size_t num_params;
+  // Suffixes of the produced side input signals (one per signal).
+  std::vector<const char*> signal_suffixes;
+};
+
+const std::vector<IndicatorFeatureInfo>& GetIndicatorFeatureInfos() {
+  static const std::vector<IndicatorFeatureInfo>* infos =
+      new std::vector<IndicatorFeatureInfo>{
+          {"sma", IndicatorFeature::Type::kSimpleMovingAverage, 1, {""}},
+          {"ema", IndicatorFeature::Type::kExponentialMovingAverage, 1, {""}},
+          {"macd",
+           IndicatorFeature::Type::kMovingAverageConvergenceDivergence,
+           3,
+           {"/series", "/signal"}},
+          {"rsi", IndicatorFeature::Type::kRelativeStrengthIndex, 1, {""}},
+          {"stochastic",
+           IndicatorFeature::Type::kStochasticOscillator,
+           1,
+           {"/k", "/fast_d", "/slow_d"}},
+          {"volatility", IndicatorFeature::Type::kVolatility, 1, {""}}};
+  return *infos;
+}
+
+const IndicatorFeatureInfo& GetIndicatorFeatureInfo(
+    IndicatorFeature::Type type) {
+  for (const IndicatorFeatureInfo& info : GetIndicatorFeatureInfos()) {
+    if (info.type == type) {
+      return info;
+    }
+  }
+  assert(false);
+  return GetIndicatorFeatureInfos().front();
+}
+
+// Parses a single indicator feature specification.
+absl::StatusOr<IndicatorFeature> ParseIndicatorFeature(absl::string_view spec) {
+  if (spec.empty()) {
+    return absl::InvalidArgumentError("Empty indicator feature specification");
+  }
+  const std::vector<absl::string_view> parts = absl::StrSplit(spec, ':');
+  for (const IndicatorFeatureInfo& info : GetIndicatorFeatureInfos()) {
+    if (parts[0] != info.name) {
+      continue;
+    }
+    if (parts.size() != info.num_params + 1) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Indicator feature %s expects %d parameter(s): %s",
+                          info.name, info.num_params, spec));
+    }
+    IndicatorFeature feature;
+    feature.spec = std::string(spec);
+    feature.type = info.type;
+    for (size_t i = 1; i < parts.size(); ++i) {
+      int param = 0;
+      if (!absl::SimpleAtoi(parts[i], &param) || param < 0 ||
+          (param == 0 && info.type != IndicatorFeature::Type::kVolatility)) {
+        return absl::InvalidArgumentError(
+            absl::StrFormat("Invalid indicator feature parameter: %s", spec));
+      }
+      feature.params.push_back(param);
+    }
+    return feature;
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown indicator feature: %s", spec));
+}
+
+// Computes the side input signals of the feature over the ohlc_history.
+// Every signal is appended to signals as a separate column.
+void ComputeIndicatorFeature(const ColumnarOhlcHistory& ohlc_history,
+                             const IndicatorFeature& feature,
+                             std::vector<std::vector<float>>& signals) {
+  const size_t num_signals =
+      GetIndicatorFeatureInfo(feature.type).signal_suffixes.size();
+  for (size_t i = 0; i < num_signals; ++i) {
+    signals.emplace_back(ohlc_history.size());
+  }
+  const absl::Span<float> signal =
+      absl::MakeSpan(signals[signals.size() - num_signals]);
+  const std::vector<int>& params = feature.params;
+  switch (feature.type) {
+    case IndicatorFeature::Type::kSimpleMovingAverage:
+      ComputeSimpleMovingAverage(ohlc_history.close(),
+                                 /*num_ohlc_ticks=*/params[0], signal);
+      break;
+    case IndicatorFeature::Type::kExponentialMovingAverage:
+      ComputeExponentialMovingAverage(ohlc_history.close(), /*smoothing=*/2,
+                                      /*ema_length=*/params[0], signal);
+      break;
+    case IndicatorFeature::Type::kMovingAverageConvergenceDivergence:
+      ComputeMovingAverageConvergenceDivergence(
+          ohlc_history.close(), /*fast_length=*/params[0],
+          /*slow_length=*/params[1], /*signal_smoothing=*/params[2], signal,
+          absl::MakeSpan(signals.back()));
+      break;
+    case IndicatorFeature::Type::kRelativeStrengthIndex:
+      ComputeRelativeStrengthIndex(ohlc_history.open(), ohlc_history.close(),
+                                   /*num_periods=*/params[0], signal);
+      break;
+    case IndicatorFeature::Type::kStochasticOscillator:
+      ComputeStochasticOscillator(
+          ohlc_history.high(), ohlc_history.low(), ohlc_history.close(),
+          /*num_periods=*/params[0], signal,
+          absl::MakeSpan(signals[signals.size() - 2]),
+          absl::MakeSpan(signals.back()));
+      break;
+    case IndicatorFeature::Type::kVolatility:
+      ComputeVolatility(ohlc_history.open(), ohlc_history.close(),
+                        /*window_size=*/params[0], signal);
+      break;
+  }
+}
+}  // namespace
+
+absl::StatusOr<std::vector<IndicatorFeature>> ParseIndicatorFeatures(
+    absl::string_view specs) {
+  std::vector<IndicatorFeature> features;
+  for (const absl::string_view spec :
+       absl::StrSplit(specs, ',', absl::SkipWhitespace())) {
+    absl::StatusOr<IndicatorFeature> feature_status =
+        ParseIndicatorFeature(spec);
+    if (!feature_status.ok()) {
+      return feature_status.status();
+    }
+    features.push_back(std::move(feature_status).value());
+  }
+  if (features.empty()) {
+    return absl::InvalidArgumentError("No indicator feature specified");
+  }
+  return features;
+}
+
+std::vector<std::string> GetIndicatorFeatureSignalNames(
+    const std::vector<IndicatorFeature>& features) {
+  std::vector<std::string> names;
+  for (const IndicatorFeature& feature : features) {
+    for (const char* suffix :
+         GetIndicatorFeatureInfo(feature.type).signal_suffixes) {
+      names.push_back(feature.spec + suffix);
+    }
+  }
+  return names;
+}
+
+absl::StatusOr<SideHistory> ComputeIndicatorFeatures(
+    const ColumnarOhlcHistory& ohlc_history, int sampling_rate_sec,
+    int period_size_sec, const std::vector<IndicatorFeature>& features) {
+  if (sampling_rate_sec <= 0 || period_size_sec < sampling_rate_sec ||
+      period_size_sec % sampling_rate_sec != 0) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Period %d sec is not a multiple of the sampling rate %d sec",
+        period_size_sec, sampling_rate_sec));
+  }
+  const absl::Span<const int64_t> timestamp_sec = ohlc_history.timestamp_sec();
+  for (size_t i = 1; i < timestamp_sec.size(); ++i) {
+    if (timestamp_sec[i] - timestamp_sec[i - 1] != sampling_rate_sec) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Unexpected gap between OHLC ticks at %d and %d (expected OHLC "
+          "history resampled with %d sec)",
+          timestamp_sec[i - 1], timestamp_sec[i], sampling_rate_sec));
+    }
+  }
+  const ColumnarOhlcHistory history =
+      period_size_sec == sampling_rate_sec
+          ? ohlc_history
+          : ColumnarOhlcHistory(
+                AggregateOhlcHistory(ohlc_history, period_size_sec));
+  // Side input signals (one column per signal).
+  std::vector<std::vector<float>> signals;
+  for (const IndicatorFeature& feature : features) {
+    ComputeIndicatorFeature(history, feature, signals);
+  }
+  SideHistory side_history;
+  side_history.reserve(history.size());
+  for (size_t i = 0; i < history.size(); ++i) {
+    side_history.emplace_back();
+    SideInputRecord& record = side_history.back();
+    record.set_timestamp_sec(history.timestamp_sec()[i] + period_size_sec -
+                             sampling_rate_sec);
+    for (const std::vector<float>& signal : signals) {
+      record.add_signal(signal[i]);
+    }
+  }
+  return side_history;
+}
+
+}  // namespace trader
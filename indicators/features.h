@@ -0,0 +1,69 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef INDICATORS_FEATURES_H
+#define INDICATORS_FEATURES_H
+
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/base.h"
+#include "base/columnar_history.h"
+
+namespace trader {
+
+// Indicator precomputed over the whole OHLC history (see indicator_series.h),
+// producing one or more side input signals per OHLC tick.
+struct IndicatorFeature {
+  enum class Type {
+    // Simple Moving Average. Parameters: num_ohlc_ticks.
+    kSimpleMovingAverage,
+    // Exponential Moving Average (with smoothing 2). Parameters: ema_length.
+    kExponentialMovingAverage,
+    // MACD series and signal. Parameters: fast_length, slow_length,
+    // signal_smoothing.
+    kMovingAverageConvergenceDivergence,
+    // Relative Strength Index. Parameters: num_periods.
+    kRelativeStrengthIndex,
+    // Stochastic %K, fast %D and slow %D. Parameters: num_periods.
+    kStochasticOscillator,
+    // Volatility of the base (crypto) currency. Parameters: window_size.
+    kVolatility,
+  };
+
+  // Specification, e.g. "sma:50" (see ParseIndicatorFeatures).
+  std::string spec;
+  Type type = Type::kSimpleMovingAverage;
+  std::vector<int> params;
+};
+
+// Parses the comma-separated indicator feature specifications of the form
+// <name>:<param>[:<param>...], where the name is one of: sma, ema, macd, rsi,
+// stochastic, volatility, e.g. "sma:50,macd:12:26:9,rsi:14,volatility:30".
+absl::StatusOr<std::vector<IndicatorFeature>> ParseIndicatorFeatures(
+    absl::string_view specs);
+
+// Returns the names of the side input signals (in the same order as in the
+// computed side history), e.g. "sma:50", "macd:12:26:9/signal".
+std::vector<std::string> GetIndicatorFeatureSignalNames(
+    const std::vector<IndicatorFeature>& features);
+
+// Computes the features over the ohlc_history with the given sampling rate,
+// which needs to be without gaps (i.e. missing OHLC ticks are filled in as
+// by Resample). If period_size_sec is larger than sampling_rate_sec (and
+// divisible by it), then the features are computed over the OHLC history
+// aggregated to period_size_sec (see AggregateOhlcHistory).
+// Returns the side history with one record per (aggregated) OHLC tick. The
+// record is timestamped by the last (non-aggregated) OHLC tick of the period,
+// i.e. the first OHLC tick at which the trader (updated at the end of the
+// OHLC tick) knows all the prices used by the features. Hence the traders
+// can read the features as side input without any look-ahead, and the
+// warm-up of the features depends only on the start of the ohlc_history.
+absl::StatusOr<SideHistory> ComputeIndicatorFeatures(
+    const ColumnarOhlcHistory& ohlc_history, int sampling_rate_sec,
+    int period_size_sec, const std::vector<IndicatorFeature>& features);
+
+}  // namespace trader
+
+#endif  // INDICATORS_FEATURES_H
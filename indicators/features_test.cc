@@ -0,0 +1,147 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "indicators/features.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/columnar_history.h"
+#include "gtest/gtest.h"
+#include "indicators/indicator_series.h"
+
+namespace trader {
+namespace {
+constexpr int kSamplingRateSec = 300;
+constexpr int kStartTimestampSec = 1483228800;  // 2017-01-01.
+
+// Returns the OHLC history (of a zig-zag price) with num_ohlc_ticks OHLC
+// ticks sampled every kSamplingRateSec seconds (without gaps).
+OhlcHistory GetOhlcHistory(int num_ohlc_ticks) {
+  OhlcHistory ohlc_history;
+  for (int i = 0; i < num_ohlc_ticks; ++i) {
+    const float open = 100.0f + (i * 7) % 13;
+    const float close = 100.0f + (i * 5) % 11;
+    ohlc_history.emplace_back();
+    OhlcTick& ohlc_tick = ohlc_history.back();
+    ohlc_tick.set_timestamp_sec(kStartTimestampSec + i * kSamplingRateSec);
+    ohlc_tick.set_open(open);
+    ohlc_tick.set_high(std::max(open, close) + 1.0f);
+    ohlc_tick.set_low(std::min(open, close) - 1.0f);
+    ohlc_tick.set_close(close);
+    ohlc_tick.set_volume(1000.0f);
+  }
+  return ohlc_history;
+}
+}  // namespace
+
+TEST(ParseIndicatorFeaturesTest, Basic) {
+  absl::StatusOr<std::vector<IndicatorFeature>> features_status =
+      ParseIndicatorFeatures("sma:50,ema:20,macd:12:26:9,rsi:14,"
+                             "stochastic:14,volatility:0");
+  ASSERT_TRUE(features_status.ok()) << features_status.status();
+  const std::vector<IndicatorFeature>& features = features_status.value();
+  ASSERT_EQ(features.size(), 6);
+  EXPECT_EQ(features[0].spec, "sma:50");
+  EXPECT_EQ(features[0].type, IndicatorFeature::Type::kSimpleMovingAverage);
+  EXPECT_EQ(features[0].params, std::vector<int>({50}));
+  EXPECT_EQ(features[1].type,
+            IndicatorFeature::Type::kExponentialMovingAverage);
+  EXPECT_EQ(features[2].type,
+            IndicatorFeature::Type::kMovingAverageConvergenceDivergence);
+  EXPECT_EQ(features[2].params, std::vector<int>({12, 26, 9}));
+  EXPECT_EQ(features[3].type, IndicatorFeature::Type::kRelativeStrengthIndex);
+  EXPECT_EQ(features[4].type, IndicatorFeature::Type::kStochasticOscillator);
+  EXPECT_EQ(features[5].type, IndicatorFeature::Type::kVolatility);
+  EXPECT_EQ(features[5].params, std::vector<int>({0}));
+  EXPECT_EQ(GetIndicatorFeatureSignalNames(features),
+            std::vector<std::string>(
+                {"sma:50", "ema:20", "macd:12:26:9/series",
+                 "macd:12:26:9/signal", "rsi:14", "stochastic:14/k",
+                 "stochastic:14/fast_d", "stochastic:14/slow_d",
+                 "volatility:0"}));
+}
+
+TEST(ParseIndicatorFeaturesTest, InvalidSpecs) {
+  EXPECT_FALSE(ParseIndicatorFeatures("").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("foo:10").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("sma").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("sma:0").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("sma:-5").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("sma:abc").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("macd:12:26").ok());
+  EXPECT_FALSE(ParseIndicatorFeatures("rsi:14,sma:10:20").ok());
+}
+
+TEST(ComputeIndicatorFeaturesTest, SameAsIndicatorSeries) {
+  const ColumnarOhlcHistory history(GetOhlcHistory(100));
+  absl::StatusOr<std::vector<IndicatorFeature>> features_status =
+      ParseIndicatorFeatures("sma:10,macd:12:26:9");
+  ASSERT_TRUE(features_status.ok()) << features_status.status();
+  absl::StatusOr<SideHistory> side_history_status = ComputeIndicatorFeatures(
+      history, kSamplingRateSec, /*period_size_sec=*/kSamplingRateSec,
+      features_status.value());
+  ASSERT_TRUE(side_history_status.ok()) << side_history_status.status();
+  const SideHistory& side_history = side_history_status.value();
+  std::vector<float> sma(history.size());
+  std::vector<float> macd_series(history.size());
+  std::vector<float> macd_signal(history.size());
+  ComputeSimpleMovingAverage(history.close(), /*num_ohlc_ticks=*/10,
+                             absl::MakeSpan(sma));
+  ComputeMovingAverageConvergenceDivergence(
+      history.close(), /*fast_length=*/12, /*slow_length=*/26,
+      /*signal_smoothing=*/9, absl::MakeSpan(macd_series),
+      absl::MakeSpan(macd_signal));
+  ASSERT_EQ(side_history.size(), history.size());
+  for (size_t i = 0; i < side_history.size(); ++i) {
+    EXPECT_EQ(side_history[i].timestamp_sec(), history.timestamp_sec()[i]);
+    ASSERT_EQ(side_history[i].signal_size(), 3);
+    EXPECT_EQ(side_history[i].signal(0), sma[i]);
+    EXPECT_EQ(side_history[i].signal(1), macd_series[i]);
+    EXPECT_EQ(side_history[i].signal(2), macd_signal[i]);
+  }
+}
+
+TEST(ComputeIndicatorFeaturesTest, AggregatedPeriod) {
+  // 10 OHLC ticks aggregated into 5 OHLC ticks (of 2 OHLC ticks each).
+  const ColumnarOhlcHistory history(GetOhlcHistory(10));
+  absl::StatusOr<std::vector<IndicatorFeature>> features_status =
+      ParseIndicatorFeatures("sma:1");
+  ASSERT_TRUE(features_status.ok()) << features_status.status();
+  absl::StatusOr<SideHistory> side_history_status = ComputeIndicatorFeatures(
+      history, kSamplingRateSec, /*period_size_sec=*/2 * kSamplingRateSec,
+      features_status.value());
+  ASSERT_TRUE(side_history_status.ok()) << side_history_status.status();
+  const SideHistory& side_history = side_history_status.value();
+  ASSERT_EQ(side_history.size(), 5);
+  for (size_t i = 0; i < side_history.size(); ++i) {
+    // Timestamped by the last OHLC tick of the period.
+    EXPECT_EQ(side_history[i].timestamp_sec(),
+              history.timestamp_sec()[2 * i + 1]);
+    ASSERT_EQ(side_history[i].signal_size(), 1);
+    // SMA over 1 OHLC tick is the closing price of the period.
+    EXPECT_EQ(side_history[i].signal(0), history.close()[2 * i + 1]);
+  }
+}
+
+TEST(ComputeIndicatorFeaturesTest, InvalidArguments) {
+  absl::StatusOr<std::vector<IndicatorFeature>> features_status =
+      ParseIndicatorFeatures("sma:10");
+  ASSERT_TRUE(features_status.ok()) << features_status.status();
+  const std::vector<IndicatorFeature>& features = features_status.value();
+  const ColumnarOhlcHistory history(GetOhlcHistory(10));
+  EXPECT_FALSE(ComputeIndicatorFeatures(history, kSamplingRateSec,
+                                        /*period_size_sec=*/450, features)
+                   .ok());
+  EXPECT_FALSE(ComputeIndicatorFeatures(history, kSamplingRateSec,
+                                        /*period_size_sec=*/0, features)
+                   .ok());
+  OhlcHistory ohlc_history = GetOhlcHistory(10);
+  ohlc_history.erase(ohlc_history.begin() + 5);
+  EXPECT_FALSE(ComputeIndicatorFeatures(ColumnarOhlcHistory(ohlc_history),
+                                        kSamplingRateSec, kSamplingRateSec,
+                                        features)
+                   .ok());
+}
+
+}  // namespace trader
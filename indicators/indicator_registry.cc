@@ -0,0 +1,95 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "indicators/indicator_registry.h"
+
+#include <cassert>
+
+#include "absl/memory/memory.h"
+
+namespace trader {
+namespace {
+// Returns the indicator with the given key. If there is no such indicator,
+// then creates it with the given constructor arguments.
+template <typename Indicator, typename Key, typename... Args>
+const Indicator* GetOrCreateIndicator(
+    std::map<Key, std::unique_ptr<Indicator>>& indicators, const Key& key,
+    Args... args) {
+  std::unique_ptr<Indicator>& indicator = indicators[key];
+  if (indicator == nullptr) {
+    indicator = absl::make_unique<Indicator>(args...);
+  }
+  return indicator.get();
+}
+
+// Updates all indicators in the map on the given OHLC tick.
+template <typename Indicator, typename Key>
+void UpdateIndicators(
+    const std::map<Key, std::unique_ptr<Indicator>>& indicators,
+    const OhlcTick& ohlc_tick) {
+  for (const auto& key_and_indicator : indicators) {
+    key_and_indicator.second->Update(ohlc_tick);
+  }
+}
+}  // namespace
+
+const SimpleMovingAverage* IndicatorRegistry::GetSimpleMovingAverage(
+    int num_ohlc_ticks, int period_size_sec) {
+  assert(!updated_);
+  return GetOrCreateIndicator(simple_moving_averages_,
+                              std::make_tuple(num_ohlc_ticks, period_size_sec),
+                              num_ohlc_ticks, period_size_sec);
+}
+
+const ExponentialMovingAverage* IndicatorRegistry::GetExponentialMovingAverage(
+    float smoothing, int ema_length, int period_size_sec) {
+  assert(!updated_);
+  return GetOrCreateIndicator(
+      exponential_moving_averages_,
+      std::make_tuple(smoothing, ema_length, period_size_sec), smoothing,
+      ema_length, period_size_sec);
+}
+
+const MovingAverageConvergenceDivergence*
+IndicatorRegistry::GetMovingAverageConvergenceDivergence(
+    int fast_length, int slow_length, int signal_smoothing,
+    int period_size_sec) {
+  assert(!updated_);
+  return GetOrCreateIndicator(
+      moving_average_convergence_divergences_,
+      std::make_tuple(fast_length, slow_length, signal_smoothing,
+                      period_size_sec),
+      fast_length, slow_length, signal_smoothing, period_size_sec);
+}
+
+const RelativeStrengthIndex* IndicatorRegistry::GetRelativeStrengthIndex(
+    int num_periods, int period_size_sec) {
+  assert(!updated_);
+  return GetOrCreateIndicator(relative_strength_indices_,
+                              std::make_tuple(num_periods, period_size_sec),
+                              num_periods, period_size_sec);
+}
+
+const StochasticOscillator* IndicatorRegistry::GetStochasticOscillator(
+    int num_periods, int period_size_sec) {
+  assert(!updated_);
+  return GetOrCreateIndicator(stochastic_oscillators_,
+                              std::make_tuple(num_periods, period_size_sec),
+                              num_periods, period_size_sec);
+}
+
+size_t IndicatorRegistry::size() const {
+  return simple_moving_averages_.size() + exponential_moving_averages_.size() +
+         moving_average_convergence_divergences_.size() +
+         relative_strength_indices_.size() + stochastic_oscillators_.size();
+}
+
+void IndicatorRegistry::Update(const OhlcTick& ohlc_tick) {
+  updated_ = true;
+  UpdateIndicators(simple_moving_averages_, ohlc_tick);
+  UpdateIndicators(exponential_moving_averages_, ohlc_tick);
+  UpdateIndicators(moving_average_convergence_divergences_, ohlc_tick);
+  UpdateIndicators(relative_strength_indices_, ohlc_tick);
+  UpdateIndicators(stochastic_oscillators_, ohlc_tick);
+}
+
+}  // namespace trader
@@ -0,0 +1,80 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef INDICATORS_INDICATOR_REGISTRY_H
+#define INDICATORS_INDICATOR_REGISTRY_H
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "base/base.h"
+#include "indicators/exponential_moving_average.h"
+#include "indicators/moving_average_convergence_divergence.h"
+#include "indicators/relative_strength_index.h"
+#include "indicators/simple_moving_average.h"
+#include "indicators/stochastic_oscillator.h"
+
+namespace trader {
+
+// Registry of indicators shared by traders executed in lockstep (i.e. over
+// the same OHLC ticks), e.g. a batch of traders sweeping a parameter grid.
+// Every indicator is keyed by its type and parameters, and it is created (and
+// updated) only once, regardless of how many traders use it. Hence the
+// indicator work is proportional to the number of unique indicators (rather
+// than to the number of traders).
+// Traders request the indicators when they are emitted (see TraderEmitter),
+// i.e. before the first Update, and keep only read-only pointers to them.
+// The owner of the registry (e.g. the evaluation) updates all indicators on
+// every (non-zero volume) OHLC tick, right before the traders are updated on
+// the same OHLC tick. The returned pointers are valid during the whole
+// lifetime of the registry.
+// Note that the Volatility indicator depends on the trader's portfolio, and
+// therefore cannot be shared.
+class IndicatorRegistry {
+ public:
+  IndicatorRegistry() {}
+  // The indicators (listening to their own OHLC ticks) are never moved.
+  IndicatorRegistry(const IndicatorRegistry&) = delete;
+  IndicatorRegistry& operator=(const IndicatorRegistry&) = delete;
+
+  // Returns the shared indicator with the given parameters (see the
+  // corresponding indicator constructor). Creates it if it does not exist.
+  const SimpleMovingAverage* GetSimpleMovingAverage(int num_ohlc_ticks,
+                                                    int period_size_sec);
+  const ExponentialMovingAverage* GetExponentialMovingAverage(
+      float smoothing, int ema_length, int period_size_sec);
+  const MovingAverageConvergenceDivergence*
+  GetMovingAverageConvergenceDivergence(int fast_length, int slow_length,
+                                        int signal_smoothing,
+                                        int period_size_sec);
+  const RelativeStrengthIndex* GetRelativeStrengthIndex(int num_periods,
+                                                        int period_size_sec);
+  const StochasticOscillator* GetStochasticOscillator(int num_periods,
+                                                      int period_size_sec);
+
+  // Returns the number of unique indicators in the registry.
+  size_t size() const;
+
+  // Updates all indicators on the given OHLC tick.
+  void Update(const OhlcTick& ohlc_tick);
+
+ private:
+  std::map<std::tuple<int, int>, std::unique_ptr<SimpleMovingAverage>>
+      simple_moving_averages_;
+  std::map<std::tuple<float, int, int>,
+           std::unique_ptr<ExponentialMovingAverage>>
+      exponential_moving_averages_;
+  std::map<std::tuple<int, int, int, int>,
+           std::unique_ptr<MovingAverageConvergenceDivergence>>
+      moving_average_convergence_divergences_;
+  std::map<std::tuple<int, int>, std::unique_ptr<RelativeStrengthIndex>>
+      relative_strength_indices_;
+  std::map<std::tuple<int, int>, std::unique_ptr<StochasticOscillator>>
+      stochastic_oscillators_;
+  // Whether the indicators were already updated on some OHLC tick.
+  bool updated_ = false;
+};
+
+}  // namespace trader
+
+#endif  // INDICATORS_INDICATOR_REGISTRY_H
@@ -0,0 +1,107 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "indicators/indicator_registry.h"
+
+#include "gtest/gtest.h"
+#include "indicators/test_util.h"
+
+namespace trader {
+using ::trader::testing::PrepareExampleOhlcHistory;
+
+TEST(IndicatorRegistryTest, SameParametersReturnSameIndicator) {
+  IndicatorRegistry registry;
+  EXPECT_EQ(registry.size(), 0);
+
+  const SimpleMovingAverage* sma = registry.GetSimpleMovingAverage(
+      /*num_ohlc_ticks=*/3, /*period_size_sec=*/kSecondsPerDay);
+  EXPECT_EQ(registry.GetSimpleMovingAverage(
+                /*num_ohlc_ticks=*/3, /*period_size_sec=*/kSecondsPerDay),
+            sma);
+  EXPECT_NE(registry.GetSimpleMovingAverage(
+                /*num_ohlc_ticks=*/4, /*period_size_sec=*/kSecondsPerDay),
+            sma);
+  EXPECT_NE(registry.GetSimpleMovingAverage(
+                /*num_ohlc_ticks=*/3, /*period_size_sec=*/kSecondsPerHour),
+            sma);
+  EXPECT_EQ(registry.size(), 3);
+
+  const ExponentialMovingAverage* ema = registry.GetExponentialMovingAverage(
+      /*smoothing=*/2, /*ema_length=*/3, /*period_size_sec=*/kSecondsPerDay);
+  EXPECT_EQ(registry.GetExponentialMovingAverage(
+                /*smoothing=*/2, /*ema_length=*/3,
+                /*period_size_sec=*/kSecondsPerDay),
+            ema);
+  const MovingAverageConvergenceDivergence* macd =
+      registry.GetMovingAverageConvergenceDivergence(
+          /*fast_length=*/12, /*slow_length=*/26, /*signal_smoothing=*/9,
+          /*period_size_sec=*/kSecondsPerDay);
+  EXPECT_EQ(registry.GetMovingAverageConvergenceDivergence(
+                /*fast_length=*/12, /*slow_length=*/26,
+                /*signal_smoothing=*/9, /*period_size_sec=*/kSecondsPerDay),
+            macd);
+  const RelativeStrengthIndex* rsi = registry.GetRelativeStrengthIndex(
+      /*num_periods=*/14, /*period_size_sec=*/kSecondsPerDay);
+  EXPECT_EQ(registry.GetRelativeStrengthIndex(
+                /*num_periods=*/14, /*period_size_sec=*/kSecondsPerDay),
+            rsi);
+  const StochasticOscillator* stoch = registry.GetStochasticOscillator(
+      /*num_periods=*/14, /*period_size_sec=*/kSecondsPerDay);
+  EXPECT_EQ(registry.GetStochasticOscillator(
+                /*num_periods=*/14, /*period_size_sec=*/kSecondsPerDay),
+            stoch);
+  EXPECT_EQ(registry.size(), 7);
+}
+
+TEST(IndicatorRegistryTest, SharedIndicatorsSameAsStandalone) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+
+  IndicatorRegistry registry;
+  const SimpleMovingAverage* shared_sma = registry.GetSimpleMovingAverage(
+      /*num_ohlc_ticks=*/3, /*period_size_sec=*/kSecondsPerDay);
+  const ExponentialMovingAverage* shared_ema =
+      registry.GetExponentialMovingAverage(/*smoothing=*/2, /*ema_length=*/3,
+                                           /*period_size_sec=*/kSecondsPerDay);
+  const MovingAverageConvergenceDivergence* shared_macd =
+      registry.GetMovingAverageConvergenceDivergence(
+          /*fast_length=*/2, /*slow_length=*/3, /*signal_smoothing=*/2,
+          /*period_size_sec=*/kSecondsPerDay);
+  const RelativeStrengthIndex* shared_rsi = registry.GetRelativeStrengthIndex(
+      /*num_periods=*/3, /*period_size_sec=*/kSecondsPerDay);
+  const StochasticOscillator* shared_stoch = registry.GetStochasticOscillator(
+      /*num_periods=*/3, /*period_size_sec=*/kSecondsPerDay);
+
+  SimpleMovingAverage sma(/*num_ohlc_ticks=*/3,
+                          /*period_size_sec=*/kSecondsPerDay);
+  ExponentialMovingAverage ema(/*smoothing=*/2, /*ema_length=*/3,
+                               /*period_size_sec=*/kSecondsPerDay);
+  MovingAverageConvergenceDivergence macd(
+      /*fast_length=*/2, /*slow_length=*/3, /*signal_smoothing=*/2,
+      /*period_size_sec=*/kSecondsPerDay);
+  RelativeStrengthIndex rsi(/*num_periods=*/3,
+                            /*period_size_sec=*/kSecondsPerDay);
+  StochasticOscillator stoch(/*num_periods=*/3,
+                             /*period_size_sec=*/kSecondsPerDay);
+
+  for (const OhlcTick& ohlc_tick : ohlc_history) {
+    registry.Update(ohlc_tick);
+    sma.Update(ohlc_tick);
+    ema.Update(ohlc_tick);
+    macd.Update(ohlc_tick);
+    rsi.Update(ohlc_tick);
+    stoch.Update(ohlc_tick);
+    EXPECT_EQ(shared_sma->GetSimpleMovingAverage(),
+              sma.GetSimpleMovingAverage());
+    EXPECT_EQ(shared_sma->GetNumOhlcTicks(), sma.GetNumOhlcTicks());
+    EXPECT_EQ(shared_ema->GetExponentialMovingAverage(),
+              ema.GetExponentialMovingAverage());
+    EXPECT_EQ(shared_macd->GetMACDSeries(), macd.GetMACDSeries());
+    EXPECT_EQ(shared_macd->GetMACDSignal(), macd.GetMACDSignal());
+    EXPECT_EQ(shared_rsi->GetRelativeStrengthIndex(),
+              rsi.GetRelativeStrengthIndex());
+    EXPECT_EQ(shared_stoch->GetK(), stoch.GetK());
+    EXPECT_EQ(shared_stoch->GetSlowD(), stoch.GetSlowD());
+  }
+}
+
+}  // namespace trader
@@ -0,0 +1,262 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "indicators/indicator_series.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace trader {
+namespace {
+// Computes the Exponential Moving Average of values (in the same way as the
+// ExponentialMovingAverageHelper). The first EMA value is the first value.
+// ema can be the same span as values.
+void ComputeExponentialMovingAverageImpl(absl::Span<const float> values,
+                                         float weight, absl::Span<float> ema) {
+  assert(values.size() == ema.size());
+  if (values.empty()) {
+    return;
+  }
+  ema[0] = values[0];
+  for (size_t i = 1; i < values.size(); ++i) {
+    ema[i] = weight * values[i] + (1.0f - weight) * ema[i - 1];
+  }
+}
+
+// Computes the sliding window standard deviation of values (in the same way
+// as the SlidingWindowMeanAndVariance). Ignores the window if window_size is
+// zero. stddev cannot be the same span as values.
+void ComputeSlidingWindowStandardDeviation(absl::Span<const float> values,
+                                           int window_size,
+                                           absl::Span<float> stddev) {
+  assert(window_size >= 0);
+  assert(values.size() == stddev.size());
+  const size_t window = static_cast<size_t>(window_size);
+  // Sums over the sliding window (excluding the current value).
+  float window_sum = 0;
+  float window_sum_2 = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0 && window != 1) {
+      window_sum += values[i - 1];
+      window_sum_2 += std::pow(values[i - 1], 2);
+      if (window > 1 && i >= window) {
+        window_sum -= values[i - window];
+        window_sum_2 -= std::pow(values[i - window], 2);
+      }
+    }
+    const int current_window_size =
+        static_cast<int>(window == 0 ? i + 1 : std::min(i + 1, window));
+    const float mean = (values[i] + window_sum) / current_window_size;
+    const float variance =
+        (std::pow(values[i], 2) + window_sum_2) / current_window_size -
+        std::pow(mean, 2);
+    stddev[i] = std::sqrt(variance);
+  }
+}
+
+// Computes the sliding window minimum of low and the sliding window maximum of
+// high by the van Herk / Gil-Werman algorithm. The values are split into
+// blocks of window_size values. The prefix (resp. suffix) minima and maxima
+// are computed within every block (both in the same loop, so that their
+// recurrences overlap), and every window (spanning at most two blocks) is
+// the minimum (resp. maximum) of a block suffix and a block prefix. The last
+// (element-wise) pass vectorizes.
+void ComputeSlidingWindowMinMax(absl::Span<const float> low,
+                                absl::Span<const float> high, int window_size,
+                                absl::Span<float> low_min,
+                                absl::Span<float> high_max) {
+  assert(window_size > 0);
+  assert(low.size() == high.size());
+  assert(low.size() == low_min.size() && high.size() == high_max.size());
+  const size_t size = low.size();
+  const size_t window = static_cast<size_t>(window_size);
+  std::vector<float> prefix_min(size);
+  std::vector<float> prefix_max(size);
+  std::vector<float> suffix_min(size);
+  std::vector<float> suffix_max(size);
+  for (size_t block_begin = 0; block_begin < size; block_begin += window) {
+    const size_t block_end = std::min(block_begin + window, size);
+    prefix_min[block_begin] = low[block_begin];
+    prefix_max[block_begin] = high[block_begin];
+    for (size_t i = block_begin + 1; i < block_end; ++i) {
+      prefix_min[i] = std::min(prefix_min[i - 1], low[i]);
+      prefix_max[i] = std::max(prefix_max[i - 1], high[i]);
+    }
+    suffix_min[block_end - 1] = low[block_end - 1];
+    suffix_max[block_end - 1] = high[block_end - 1];
+    for (size_t i = block_end - 1; i-- > block_begin;) {
+      suffix_min[i] = std::min(suffix_min[i + 1], low[i]);
+      suffix_max[i] = std::max(suffix_max[i + 1], high[i]);
+    }
+  }
+  // The window [0, i] of the first window_size values is within one block.
+  const size_t num_partial = std::min(size, window - 1);
+  std::copy(prefix_min.begin(), prefix_min.begin() + num_partial,
+            low_min.begin());
+  std::copy(prefix_max.begin(), prefix_max.begin() + num_partial,
+            high_max.begin());
+  for (size_t i = num_partial; i < size; ++i) {
+    low_min[i] = std::min(suffix_min[i + 1 - window], prefix_min[i]);
+    high_max[i] = std::max(suffix_max[i + 1 - window], prefix_max[i]);
+  }
+}
+}  // namespace
+
+void ComputeSimpleMovingAverage(absl::Span<const float> close,
+                                int num_ohlc_ticks, absl::Span<float> sma) {
+  assert(num_ohlc_ticks > 0);
+  assert(close.size() == sma.size());
+  const size_t window = static_cast<size_t>(num_ohlc_ticks);
+  float sum_close_price = 0;
+  for (size_t i = 0; i < close.size(); ++i) {
+    if (i < window) {
+      sum_close_price += close[i];
+    } else {
+      sum_close_price += close[i] - close[i - window];
+    }
+    sma[i] = sum_close_price / static_cast<int>(std::min(i + 1, window));
+  }
+}
+
+void ComputeExponentialMovingAverage(absl::Span<const float> close,
+                                     float smoothing, int ema_length,
+                                     absl::Span<float> ema) {
+  ComputeExponentialMovingAverageImpl(
+      close, /*weight=*/smoothing / (1.0f + ema_length), ema);
+}
+
+void ComputeMovingAverageConvergenceDivergence(
+    absl::Span<const float> close, int fast_length, int slow_length,
+    int signal_smoothing, absl::Span<float> macd_series,
+    absl::Span<float> macd_signal) {
+  assert(close.size() == macd_series.size());
+  assert(close.size() == macd_signal.size());
+  if (close.empty()) {
+    return;
+  }
+  const float fast_weight = /*smoothing=*/2.0f / (1.0f + fast_length);
+  const float slow_weight = /*smoothing=*/2.0f / (1.0f + slow_length);
+  const float signal_weight = /*smoothing=*/2.0f / (1.0f + signal_smoothing);
+  // All three EMAs are computed in a single pass, so that their (independent)
+  // recurrences overlap.
+  float fast_ema = close[0];
+  float slow_ema = close[0];
+  macd_series[0] = fast_ema - slow_ema;
+  macd_signal[0] = macd_series[0];
+  for (size_t i = 1; i < close.size(); ++i) {
+    fast_ema = fast_weight * close[i] + (1.0f - fast_weight) * fast_ema;
+    slow_ema = slow_weight * close[i] + (1.0f - slow_weight) * slow_ema;
+    macd_series[i] = fast_ema - slow_ema;
+    macd_signal[i] = signal_weight * macd_series[i] +
+                     (1.0f - signal_weight) * macd_signal[i - 1];
+  }
+}
+
+void ComputeRelativeStrengthIndex(absl::Span<const float> open,
+                                  absl::Span<const float> close,
+                                  int num_periods, absl::Span<float> rsi) {
+  assert(num_periods > 0);
+  assert(open.size() == close.size());
+  assert(close.size() == rsi.size());
+  const size_t size = close.size();
+  if (size == 0) {
+    return;
+  }
+  // Upward and downward changes. The first OHLC tick has no previous OHLC
+  // tick, so we use its opening price instead.
+  std::vector<float> upward_change(size);
+  std::vector<float> downward_change(size);
+  upward_change[0] = close[0] >= open[0] ? close[0] - open[0] : 0;
+  downward_change[0] = close[0] >= open[0] ? 0 : open[0] - close[0];
+  // Branch-free (i.e. vectorizable) split of the price changes. Note that
+  // close[i - 1] - close[i] == -(close[i] - close[i - 1]) in floats.
+  for (size_t i = 1; i < size; ++i) {
+    const float change = close[i] - close[i - 1];
+    upward_change[i] = std::max(0.0f, change);
+    downward_change[i] = std::max(0.0f, -change);
+  }
+  // Modified moving averages (computed in place), where the weight of the
+  // i-th change is 1 / min(i + 1, num_periods).
+  const size_t num_warmup = std::min(size, static_cast<size_t>(num_periods));
+  for (size_t i = 1; i < size; ++i) {
+    const float weight =
+        i < num_warmup ? 1.0f / static_cast<int>(i + 1) : 1.0f / num_periods;
+    upward_change[i] =
+        weight * upward_change[i] + (1.0f - weight) * upward_change[i - 1];
+    downward_change[i] =
+        weight * downward_change[i] + (1.0f - weight) * downward_change[i - 1];
+  }
+  // Branch-free (i.e. vectorizable) selection of the RSI value.
+  for (size_t i = 0; i < size; ++i) {
+    const float upward_change_mma = upward_change[i];
+    const float downward_change_mma = downward_change[i];
+    const float rsi_value =
+        100.0f - 100.0f / (1.0f + upward_change_mma / downward_change_mma);
+    rsi[i] = (upward_change_mma < 1.0e-6f && downward_change_mma < 1.0e-6f)
+                 ? 50.0f
+             : downward_change_mma < upward_change_mma * 1.0e-6f ? 100.0f
+                                                                 : rsi_value;
+  }
+}
+
+void ComputeStochasticOscillator(absl::Span<const float> high,
+                                 absl::Span<const float> low,
+                                 absl::Span<const float> close,
+                                 int num_periods, absl::Span<float> k,
+                                 absl::Span<float> fast_d,
+                                 absl::Span<float> slow_d) {
+  assert(num_periods > 0);
+  assert(high.size() == close.size() && low.size() == close.size());
+  assert(k.size() == close.size());
+  assert(fast_d.size() == close.size() && slow_d.size() == close.size());
+  // The sliding window minimum and maximum are kept in fast_d and slow_d
+  // until they are replaced by the fast and slow %D.
+  ComputeSlidingWindowMinMax(low, high, num_periods, fast_d, slow_d);
+  for (size_t i = 0; i < close.size(); ++i) {
+    const float price_min = fast_d[i];
+    const float price_span = slow_d[i] - price_min;
+    k[i] = price_span < 1.0e-6f ? 50.0f
+                                : 100.0f * (close[i] - price_min) / price_span;
+  }
+  // The fast %D is the mean of the last 3 %K values, the slow %D is the mean
+  // of the last 3 fast %D values. Both sliding window sums (excluding the
+  // current value) are updated in the same order as by the
+  // SlidingWindowMeanAndVariance.
+  float k_window_sum = 0;
+  float fast_d_window_sum = 0;
+  for (size_t i = 0; i < close.size(); ++i) {
+    if (i > 0) {
+      k_window_sum += k[i - 1];
+      fast_d_window_sum += fast_d[i - 1];
+      if (i >= 3) {
+        k_window_sum -= k[i - 3];
+        fast_d_window_sum -= fast_d[i - 3];
+      }
+    }
+    const int window_size = static_cast<int>(std::min<size_t>(i + 1, 3));
+    fast_d[i] = (k[i] + k_window_sum) / window_size;
+    slow_d[i] = (fast_d[i] + fast_d_window_sum) / window_size;
+  }
+}
+
+void ComputeVolatility(absl::Span<const float> open,
+                       absl::Span<const float> close, int window_size,
+                       absl::Span<float> volatility) {
+  assert(open.size() == close.size());
+  assert(close.size() == volatility.size());
+  const size_t size = close.size();
+  if (size == 0) {
+    return;
+  }
+  // Logarithmic returns. The first OHLC tick has no previous OHLC tick, so we
+  // use its opening price instead.
+  std::vector<float> log_returns(size);
+  log_returns[0] = std::log(open[0] / close[0]);
+  for (size_t i = 1; i < size; ++i) {
+    log_returns[i] = std::log(close[i - 1] / close[i]);
+  }
+  ComputeSlidingWindowStandardDeviation(log_returns, window_size, volatility);
+}
+
+}  // namespace trader
@@ -0,0 +1,65 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef INDICATORS_INDICATOR_SERIES_H
+#define INDICATORS_INDICATOR_SERIES_H
+
+#include "absl/types/span.h"
+
+namespace trader {
+
+// Whole-series versions of the (streaming) indicators, intended for offline
+// precomputation of indicator columns (e.g. once per dataset, to be fed to
+// the traders as side input).
+//
+// All methods below compute the indicator over the columns (e.g. of the
+// ColumnarOhlcHistory) of OHLC ticks with a fixed period and without gaps
+// (i.e. missing OHLC ticks are filled in as by Resample). The i-th output
+// value is bit-for-bit the value of the corresponding streaming indicator
+// (with period_size_sec equal to the period of the OHLC ticks) after it was
+// updated on the OHLC ticks 0, 1, ..., i. All input and output spans need
+// to have the same size.
+//
+// Element-wise steps run as separate branch-free loops over contiguous arrays
+// (so that the compiler can vectorize them), while the (inherently
+// sequential) float recurrences are evaluated in exactly the same order as
+// in the streaming indicators.
+
+// Computes the Simple Moving Average (see SimpleMovingAverage).
+void ComputeSimpleMovingAverage(absl::Span<const float> close,
+                                int num_ohlc_ticks, absl::Span<float> sma);
+
+// Computes the Exponential Moving Average (see ExponentialMovingAverage).
+void ComputeExponentialMovingAverage(absl::Span<const float> close,
+                                     float smoothing, int ema_length,
+                                     absl::Span<float> ema);
+
+// Computes the MACD series and the MACD signal (see
+// MovingAverageConvergenceDivergence). The divergence is their difference.
+void ComputeMovingAverageConvergenceDivergence(
+    absl::Span<const float> close, int fast_length, int slow_length,
+    int signal_smoothing, absl::Span<float> macd_series,
+    absl::Span<float> macd_signal);
+
+// Computes the Relative Strength Index (see RelativeStrengthIndex).
+void ComputeRelativeStrengthIndex(absl::Span<const float> open,
+                                  absl::Span<const float> close,
+                                  int num_periods, absl::Span<float> rsi);
+
+// Computes the %K, fast %D and slow %D (see StochasticOscillator).
+void ComputeStochasticOscillator(absl::Span<const float> high,
+                                 absl::Span<const float> low,
+                                 absl::Span<const float> close,
+                                 int num_periods, absl::Span<float> k,
+                                 absl::Span<float> fast_d,
+                                 absl::Span<float> slow_d);
+
+// Computes the (non-annualized) volatility of the base (crypto) currency,
+// i.e. the Volatility of the portfolio with base_balance 1 and quote_balance
+// 0. See Volatility for the window_size.
+void ComputeVolatility(absl::Span<const float> open,
+                       absl::Span<const float> close, int window_size,
+                       absl::Span<float> volatility);
+
+}  // namespace trader
+
+#endif  // INDICATORS_INDICATOR_SERIES_H
@@ -0,0 +1,183 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "indicators/indicator_series.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "base/columnar_history.h"
+#include "gtest/gtest.h"
+#include "indicators/exponential_moving_average.h"
+#include "indicators/moving_average_convergence_divergence.h"
+#include "indicators/relative_strength_index.h"
+#include "indicators/simple_moving_average.h"
+#include "indicators/stochastic_oscillator.h"
+#include "indicators/volatility.h"
+
+namespace trader {
+namespace {
+constexpr int kPeriodSizeSec = kSecondsPerDay;
+
+// Returns a pseudo-random integer in [-range / 2, range / 2) and advances the
+// seed (of the linear congruential generator).
+int GetRandomInt(uint32_t& seed, int range) {
+  seed = seed * 1103515245 + 12345;
+  return static_cast<int>((seed >> 16) % range) - range / 2;
+}
+
+// Returns the daily OHLC history (of a pseudo-random walk) with num_ohlc_ticks
+// OHLC ticks. Every 50th OHLC tick is a gap (i.e. zero volume OHLC tick, with
+// all prices equal to the previous closing price), as filled in by Resample.
+OhlcHistory GetOhlcHistory(int num_ohlc_ticks) {
+  OhlcHistory ohlc_history;
+  uint32_t seed = 12345;
+  float close = 1000.0f;
+  for (int i = 0; i < num_ohlc_ticks; ++i) {
+    ohlc_history.emplace_back();
+    OhlcTick& ohlc_tick = ohlc_history.back();
+    ohlc_tick.set_timestamp_sec(1483228800 + i * kPeriodSizeSec);
+    if (i > 0 && i % 50 == 0) {
+      ohlc_tick.set_open(close);
+      ohlc_tick.set_high(close);
+      ohlc_tick.set_low(close);
+      ohlc_tick.set_close(close);
+      ohlc_tick.set_volume(0);
+      continue;
+    }
+    const float open = close * (1.0f + GetRandomInt(seed, 200) / 5000.0f);
+    close = open * (1.0f + GetRandomInt(seed, 200) / 2000.0f);
+    const float spread = 1.0f + (GetRandomInt(seed, 100) + 50) / 4000.0f;
+    ohlc_tick.set_open(open);
+    ohlc_tick.set_high(std::max(open, close) * spread);
+    ohlc_tick.set_low(std::min(open, close) / spread);
+    ohlc_tick.set_close(close);
+    ohlc_tick.set_volume(1000.0f + GetRandomInt(seed, 1000));
+  }
+  return ohlc_history;
+}
+
+// Sizes of the tested OHLC histories.
+constexpr int kHistorySizes[] = {0, 1, 2, 10, 1000};
+
+// Returns true iff both values are the same (or both are NaN).
+bool SameFloat(float actual, float expected) {
+  return actual == expected || (std::isnan(actual) && std::isnan(expected));
+}
+}  // namespace
+
+TEST(IndicatorSeriesTest, SimpleMovingAverage) {
+  for (const int history_size : kHistorySizes) {
+    const OhlcHistory ohlc_history = GetOhlcHistory(history_size);
+    const ColumnarOhlcHistory history(ohlc_history);
+    std::vector<float> series(ohlc_history.size());
+    for (const int num_ohlc_ticks : {1, 3, 50}) {
+      ComputeSimpleMovingAverage(history.close(), num_ohlc_ticks,
+                                 absl::MakeSpan(series));
+      SimpleMovingAverage sma(num_ohlc_ticks, kPeriodSizeSec);
+      for (size_t i = 0; i < ohlc_history.size(); ++i) {
+        sma.Update(ohlc_history[i]);
+        ASSERT_EQ(series[i], sma.GetSimpleMovingAverage()) << i;
+      }
+    }
+  }
+}
+
+TEST(IndicatorSeriesTest, ExponentialMovingAverage) {
+  for (const int history_size : kHistorySizes) {
+    const OhlcHistory ohlc_history = GetOhlcHistory(history_size);
+    const ColumnarOhlcHistory history(ohlc_history);
+    std::vector<float> series(ohlc_history.size());
+    for (const int ema_length : {1, 12, 50}) {
+      ComputeExponentialMovingAverage(history.close(), /*smoothing=*/2,
+                                      ema_length, absl::MakeSpan(series));
+      ExponentialMovingAverage ema(/*smoothing=*/2, ema_length,
+                                   kPeriodSizeSec);
+      for (size_t i = 0; i < ohlc_history.size(); ++i) {
+        ema.Update(ohlc_history[i]);
+        ASSERT_EQ(series[i], ema.GetExponentialMovingAverage()) << i;
+      }
+    }
+  }
+}
+
+TEST(IndicatorSeriesTest, MovingAverageConvergenceDivergence) {
+  for (const int history_size : kHistorySizes) {
+    const OhlcHistory ohlc_history = GetOhlcHistory(history_size);
+    const ColumnarOhlcHistory history(ohlc_history);
+    std::vector<float> macd_series(ohlc_history.size());
+    std::vector<float> macd_signal(ohlc_history.size());
+    ComputeMovingAverageConvergenceDivergence(
+        history.close(), /*fast_length=*/12, /*slow_length=*/26,
+        /*signal_smoothing=*/9, absl::MakeSpan(macd_series),
+        absl::MakeSpan(macd_signal));
+    MovingAverageConvergenceDivergence macd(
+        /*fast_length=*/12, /*slow_length=*/26, /*signal_smoothing=*/9,
+        kPeriodSizeSec);
+    for (size_t i = 0; i < ohlc_history.size(); ++i) {
+      macd.Update(ohlc_history[i]);
+      ASSERT_EQ(macd_series[i], macd.GetMACDSeries()) << i;
+      ASSERT_EQ(macd_signal[i], macd.GetMACDSignal()) << i;
+    }
+  }
+}
+
+TEST(IndicatorSeriesTest, RelativeStrengthIndex) {
+  for (const int history_size : kHistorySizes) {
+    const OhlcHistory ohlc_history = GetOhlcHistory(history_size);
+    const ColumnarOhlcHistory history(ohlc_history);
+    std::vector<float> series(ohlc_history.size());
+    for (const int num_periods : {1, 14}) {
+      ComputeRelativeStrengthIndex(history.open(), history.close(),
+                                   num_periods, absl::MakeSpan(series));
+      RelativeStrengthIndex rsi(num_periods, kPeriodSizeSec);
+      for (size_t i = 0; i < ohlc_history.size(); ++i) {
+        rsi.Update(ohlc_history[i]);
+        ASSERT_EQ(series[i], rsi.GetRelativeStrengthIndex()) << i;
+      }
+    }
+  }
+}
+
+TEST(IndicatorSeriesTest, StochasticOscillator) {
+  for (const int history_size : kHistorySizes) {
+    const OhlcHistory ohlc_history = GetOhlcHistory(history_size);
+    const ColumnarOhlcHistory history(ohlc_history);
+    std::vector<float> k(ohlc_history.size());
+    std::vector<float> fast_d(ohlc_history.size());
+    std::vector<float> slow_d(ohlc_history.size());
+    for (const int num_periods : {1, 3, 14}) {
+      ComputeStochasticOscillator(
+          history.high(), history.low(), history.close(), num_periods,
+          absl::MakeSpan(k), absl::MakeSpan(fast_d), absl::MakeSpan(slow_d));
+      StochasticOscillator stoch(num_periods, kPeriodSizeSec);
+      for (size_t i = 0; i < ohlc_history.size(); ++i) {
+        stoch.Update(ohlc_history[i]);
+        ASSERT_EQ(k[i], stoch.GetK()) << i;
+        ASSERT_EQ(fast_d[i], stoch.GetFastD()) << i;
+        ASSERT_EQ(slow_d[i], stoch.GetSlowD()) << i;
+      }
+    }
+  }
+}
+
+TEST(IndicatorSeriesTest, Volatility) {
+  for (const int history_size : kHistorySizes) {
+    const OhlcHistory ohlc_history = GetOhlcHistory(history_size);
+    const ColumnarOhlcHistory history(ohlc_history);
+    std::vector<float> series(ohlc_history.size());
+    for (const int window_size : {0, 1, 2, 30}) {
+      ComputeVolatility(history.open(), history.close(), window_size,
+                        absl::MakeSpan(series));
+      Volatility volatility(window_size, kPeriodSizeSec);
+      for (size_t i = 0; i < ohlc_history.size(); ++i) {
+        volatility.Update(ohlc_history[i], /*base_balance=*/1.0f,
+                          /*quote_balance=*/0.0f);
+        ASSERT_TRUE(SameFloat(series[i], volatility.GetVolatility()))
+            << i << ": " << series[i] << " vs " << volatility.GetVolatility();
+      }
+    }
+  }
+}
+
+}  // namespace trader
@@ -3,78 +3,207 @@
 #ifndef INDICATORS_LAST_N_OHLC_TICKS_H
 #define INDICATORS_LAST_N_OHLC_TICKS_H
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
 #include "base/base.h"
+#include "base/columnar_history.h"
 
 namespace trader {
 
+// Fixed-capacity ring buffer of (trivially copyable) OHLC ticks.
+// When full, adding a new OHLC tick overwrites the oldest one.
+class OhlcTickRingBuffer {
+ public:
+  // capacity: Maximum number of OHLC ticks kept in the ring buffer.
+  explicit OhlcTickRingBuffer(int capacity) : ticks_(capacity) {
+    assert(capacity > 0);
+  }
+
+  // Returns the number of OHLC ticks in the ring buffer.
+  size_t size() const { return size_; }
+  // Returns true iff there are no OHLC ticks in the ring buffer.
+  bool empty() const { return size_ == 0; }
+  // Returns true iff the ring buffer is full.
+  bool full() const { return size_ == ticks_.size(); }
+
+  // Returns the index-th oldest OHLC tick (i.e. 0 for the oldest one).
+  const OhlcTickView& operator[](size_t index) const {
+    return ticks_[GetPosition(index)];
+  }
+  const OhlcTickView& at(size_t index) const { return (*this)[index]; }
+  // Returns the oldest OHLC tick.
+  const OhlcTickView& front() const { return (*this)[0]; }
+  // Returns the most recent OHLC tick.
+  const OhlcTickView& back() const { return (*this)[size_ - 1]; }
+  OhlcTickView& back() { return ticks_[GetPosition(size_ - 1)]; }
+
+  // Adds a new OHLC tick (with the given fields) to the ring buffer.
+  // Assumes that the ring buffer is not full.
+  void emplace_back(int64_t timestamp_sec, float open, float high, float low,
+                    float close, float volume) {
+    assert(!full());
+    ++size_;
+    back() = OhlcTickView(timestamp_sec, open, high, low, close, volume);
+  }
+
+  // Removes the oldest OHLC tick and adds a new OHLC tick (with the given
+  // fields) in its place. Assumes that the ring buffer is full.
+  void pop_front_and_emplace_back(int64_t timestamp_sec, float open,
+                                  float high, float low, float close,
+                                  float volume) {
+    assert(full());
+    ticks_[begin_] =
+        OhlcTickView(timestamp_sec, open, high, low, close, volume);
+    if (++begin_ == ticks_.size()) {
+      begin_ = 0;
+    }
+  }
+
+ private:
+  // Returns the position (within ticks_) of the index-th oldest OHLC tick.
+  size_t GetPosition(size_t index) const {
+    assert(index < size_);
+    const size_t position = begin_ + index;
+    return position < ticks_.size() ? position : position - ticks_.size();
+  }
+
+  std::vector<OhlcTickView> ticks_;
+  // Position of the oldest OHLC tick.
+  size_t begin_ = 0;
+  size_t size_ = 0;
+};
+
 // Keeps track of the last N OHLC ticks with a specified period (in seconds).
 // We assume that this period is divisible by the period of update OHLC ticks.
+// The OHLC ticks are kept in a fixed-capacity ring buffer (allocated only
+// once), and the listener (typically the indicator that owns this object)
+// is notified via the following (statically dispatched) methods:
+//
+// void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+//                      const OhlcTickView& new_ohlc_tick);
+//   Called after the last OHLC tick was updated, but no OHLC tick was added.
+//   This happens when the OHLC tick provided in the Update method (below)
+//   is fully contained in the period of the most recent OHLC tick.
+//   old_ohlc_tick: The previous OHLC tick that was updated.
+//   new_ohlc_tick: The updated (most recent) OHLC tick.
+//
+// void NewTickAdded(const OhlcTickView& new_ohlc_tick);
+//   Called after a new OHLC tick was added (and no OHLC tick was removed).
+//   This happens when the OHLC tick provided in the Update method (below)
+//   starts after the period of the most recent OHLC tick.
+//   new_ohlc_tick: The newly added (most recent) OHLC tick.
+//
+// void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+//                                       const OhlcTickView& new_ohlc_tick);
+//   Called after a new OHLC tick was added and the oldest OHLC tick was
+//   removed, i.e. when we would have more than N OHLC ticks.
+//   removed_ohlc_tick: The oldest OHLC tick that was removed.
+//   new_ohlc_tick: The newly added (most recent) OHLC tick.
+//
+// LastNOhlcTicksListener provides no-op implementations of all the methods.
+template <typename Listener>
 class LastNOhlcTicks {
  public:
-  // Called after the last OHLC tick was updated, but no OHLC tick was added.
-  // This happens when the OHLC tick provided in the Update method (below)
-  // is fully contained in the period of the most recent OHLC tick in the deque.
-  // old_ohlc_tick: The previous OHLC tick in the deque that was updated.
-  // new_ohlc_tick: The updated (most recent) OHLC tick in the deque.
-  using LastTickUpdatedCallback = std::function<void(
-      const OhlcTick& old_ohlc_tick, const OhlcTick& new_ohlc_tick)>;
-  // Called after a new OHLC tick was added to the deque.
-  // This happens when the OHLC tick provided in the Update method (below)
-  // starts after the period of the most recent OHLC tick in the deque.
-  // new_ohlc_tick: The newly added (most recent) OHLC tick in the deque.
-  using NewTickAddedCallback =
-      std::function<void(const OhlcTick& new_ohlc_tick)>;
-  // Called after a new OHLC tick was added to the deque and the oldest OHLC
-  // tick was removed from the deque.
-  // This happens when the deque grows beyond N OHLC ticks, so we need to remove
-  // the oldest one.
-  // removed_ohlc_tick: The oldest OHLC tick that was removed from deque.
-  // new_ohlc_tick: The newly added (most recent) OHLC tick in the deque.
-  using NewTickAddedAndOldestTickRemovedCallback = std::function<void(
-      const OhlcTick& removed_ohlc_tick, const OhlcTick& new_ohlc_tick)>;
-
   // Constructor.
-  // num_ohlc_ticks: Number N of OHLC ticks that we want to keep in the deque.
+  // listener: Notified about all changes. Needs to outlive this object.
+  // num_ohlc_ticks: Number N of OHLC ticks that we want to keep.
   // period_size_sec: Period of the kept OHLC ticks (in seconds).
-  LastNOhlcTicks(int num_ohlc_ticks, int period_size_sec)
-      : num_ohlc_ticks_(num_ohlc_ticks), period_size_sec_(period_size_sec) {
+  LastNOhlcTicks(Listener* listener, int num_ohlc_ticks, int period_size_sec)
+      : listener_(listener),
+        period_size_sec_(period_size_sec),
+        last_n_ohlc_ticks_(num_ohlc_ticks) {
+    assert(listener != nullptr);
     assert(num_ohlc_ticks > 0);
     assert(period_size_sec > 0);
   }
-  virtual ~LastNOhlcTicks() {}
 
-  virtual void RegisterLastTickUpdatedCallback(
-      LastTickUpdatedCallback last_tick_updated_callback);
-  virtual void RegisterNewTickAddedCallback(
-      NewTickAddedCallback new_tick_added_callback);
-  virtual void RegisterNewTickAddedAndOldestTickRemovedCallback(
-      NewTickAddedAndOldestTickRemovedCallback
-          new_tick_added_and_oldest_tick_removed_callback);
-
-  // Returns the deque of last N OHLC ticks.
-  virtual const std::deque<OhlcTick>& GetLastNOhlcTicks() const;
+  // Returns the ring buffer of last N OHLC ticks.
+  const OhlcTickRingBuffer& GetLastNOhlcTicks() const {
+    return last_n_ohlc_ticks_;
+  }
 
-  // Updates the deque of last N OHLC ticks.
+  // Updates the last N OHLC ticks.
   // Under normal circumstances this method runs in O(1) time.
   // The only exception is when the given OHLC tick is far in the future, in
   // which case we need to backfill all the intermediate zero volume OHLC ticks.
   // We assume that period_size_sec_ is divisible by the period of ohlc_tick.
-  virtual void Update(const OhlcTick& ohlc_tick);
+  // T is either OhlcTick or OhlcTickView.
+  template <typename T>
+  void Update(const T& ohlc_tick);
 
  private:
-  int num_ohlc_ticks_ = 0;
+  // Adds the new OHLC tick (removing the oldest one if necessary).
+  // The fields are written directly into the ring buffer, since copying an
+  // OhlcTickView that was just written field by field stalls on the
+  // store-to-load forwarding.
+  void AddNewOhlcTick(int64_t timestamp_sec, float open, float high, float low,
+                      float close, float volume);
+
+  Listener* listener_ = nullptr;
   int period_size_sec_ = 0;
+  OhlcTickRingBuffer last_n_ohlc_ticks_;
+};
 
-  std::deque<OhlcTick> last_n_ohlc_ticks_;
+// Listener ignoring all LastNOhlcTicks notifications.
+struct LastNOhlcTicksListener {
+  void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                       const OhlcTickView& new_ohlc_tick) {}
+  void NewTickAdded(const OhlcTickView& new_ohlc_tick) {}
+  void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+                                        const OhlcTickView& new_ohlc_tick) {}
+};
 
-  LastTickUpdatedCallback last_tick_updated_callback_;
-  NewTickAddedCallback new_tick_added_callback_;
-  NewTickAddedAndOldestTickRemovedCallback
-      new_tick_added_and_oldest_tick_removed_callback_;
+template <typename Listener>
+template <typename T>
+void LastNOhlcTicks<Listener>::Update(const T& ohlc_tick) {
+  const int64_t adjusted_timestamp_sec =
+      period_size_sec_ * (ohlc_tick.timestamp_sec() / period_size_sec_);
+  while (!last_n_ohlc_ticks_.empty() &&
+         last_n_ohlc_ticks_.back().timestamp_sec() + period_size_sec_ <
+             adjusted_timestamp_sec) {
+    const int64_t prev_timestamp_sec =
+        last_n_ohlc_ticks_.back().timestamp_sec();
+    const float prev_close = last_n_ohlc_ticks_.back().close();
+    AddNewOhlcTick(prev_timestamp_sec + period_size_sec_, prev_close,
+                   prev_close, prev_close, prev_close, /*volume=*/0);
+  }
+  if (last_n_ohlc_ticks_.empty() ||
+      last_n_ohlc_ticks_.back().timestamp_sec() < adjusted_timestamp_sec) {
+    AddNewOhlcTick(adjusted_timestamp_sec, ohlc_tick.open(), ohlc_tick.high(),
+                   ohlc_tick.low(), ohlc_tick.close(), ohlc_tick.volume());
+  } else {
+    assert(last_n_ohlc_ticks_.back().timestamp_sec() == adjusted_timestamp_sec);
+    OhlcTickView& top_ohlc_tick = last_n_ohlc_ticks_.back();
+    const OhlcTickView old_ohlc_tick = top_ohlc_tick;
+    top_ohlc_tick = OhlcTickView(
+        old_ohlc_tick.timestamp_sec(), old_ohlc_tick.open(),
+        std::max(old_ohlc_tick.high(), ohlc_tick.high()),
+        std::min(old_ohlc_tick.low(), ohlc_tick.low()), ohlc_tick.close(),
+        old_ohlc_tick.volume() + ohlc_tick.volume());
+    listener_->LastTickUpdated(old_ohlc_tick, top_ohlc_tick);
+  }
+}
 
-  void NewOhlcTickAdded();
-  void LastOhlcTickUpdated(const OhlcTick& old_ohlc_tick);
-};
+template <typename Listener>
+void LastNOhlcTicks<Listener>::AddNewOhlcTick(int64_t timestamp_sec,
+                                              float open, float high,
+                                              float low, float close,
+                                              float volume) {
+  if (!last_n_ohlc_ticks_.full()) {
+    last_n_ohlc_ticks_.emplace_back(timestamp_sec, open, high, low, close,
+                                    volume);
+    listener_->NewTickAdded(last_n_ohlc_ticks_.back());
+  } else {
+    const OhlcTickView removed_ohlc_tick = last_n_ohlc_ticks_.front();
+    last_n_ohlc_ticks_.pop_front_and_emplace_back(timestamp_sec, open, high,
+                                                  low, close, volume);
+    listener_->NewTickAddedAndOldestTickRemoved(removed_ohlc_tick,
+                                                last_n_ohlc_ticks_.back());
+  }
+}
 
 }  // namespace trader
 
@@ -6,31 +6,10 @@ namespace trader {
 
 MovingAverageConvergenceDivergence::MovingAverageConvergenceDivergence(
     int fast_length, int slow_length, int signal_smoothing, int period_size_sec)
-    : last_n_ohlc_ticks_(/*num_ohlc_ticks=*/1, period_size_sec),
+    : last_n_ohlc_ticks_(this, /*num_ohlc_ticks=*/1, period_size_sec),
       fast_weight_(/*smoothing=*/2.0f / (1.0f + fast_length)),
       slow_weight_(/*smoothing=*/2.0f / (1.0f + slow_length)),
-      signal_weight_(/*smoothing=*/2.0f / (1.0f + signal_smoothing)) {
-  last_n_ohlc_ticks_.RegisterLastTickUpdatedCallback(
-      [this](const OhlcTick& old_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        // We have observed at least 1 OHLC tick.
-        // The most recent OHLC tick was updated.
-        assert(num_ohlc_ticks_ >= 1);
-        LastTickUpdated(new_ohlc_tick);
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedCallback(
-      [this](const OhlcTick& new_ohlc_tick) {
-        // This is the very first observed OHLC tick.
-        assert(num_ohlc_ticks_ == 0);
-        NewTickAdded(new_ohlc_tick);
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedAndOldestTickRemovedCallback(
-      [this](const OhlcTick& removed_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        // We have observed at least 1 OHLC tick.
-        // New OHLC tick was added.
-        assert(num_ohlc_ticks_ >= 1);
-        NewTickAdded(new_ohlc_tick);
-      });
-}
+      signal_weight_(/*smoothing=*/2.0f / (1.0f + signal_smoothing)) {}
 
 float MovingAverageConvergenceDivergence::GetFastExponentialMovingAverage()
     const {
@@ -63,14 +42,32 @@ void MovingAverageConvergenceDivergence::Update(const OhlcTick& ohlc_tick) {
 }
 
 void MovingAverageConvergenceDivergence::LastTickUpdated(
-    const OhlcTick& ohlc_tick) {
-  fast_ema_.UpdateCurrentValue(ohlc_tick.close(), fast_weight_);
-  slow_ema_.UpdateCurrentValue(ohlc_tick.close(), slow_weight_);
+    const OhlcTickView& old_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  // We have observed at least 1 OHLC tick.
+  // The most recent OHLC tick was updated.
+  assert(num_ohlc_ticks_ >= 1);
+  fast_ema_.UpdateCurrentValue(new_ohlc_tick.close(), fast_weight_);
+  slow_ema_.UpdateCurrentValue(new_ohlc_tick.close(), slow_weight_);
   signal_ema_.UpdateCurrentValue(GetMACDSeries(), signal_weight_);
 }
 
 void MovingAverageConvergenceDivergence::NewTickAdded(
-    const OhlcTick& ohlc_tick) {
+    const OhlcTickView& new_ohlc_tick) {
+  // This is the very first observed OHLC tick.
+  assert(num_ohlc_ticks_ == 0);
+  AddNewOhlcTick(new_ohlc_tick);
+}
+
+void MovingAverageConvergenceDivergence::NewTickAddedAndOldestTickRemoved(
+    const OhlcTickView& removed_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  // We have observed at least 1 OHLC tick.
+  // New OHLC tick was added.
+  assert(num_ohlc_ticks_ >= 1);
+  AddNewOhlcTick(new_ohlc_tick);
+}
+
+void MovingAverageConvergenceDivergence::AddNewOhlcTick(
+    const OhlcTickView& ohlc_tick) {
   ++num_ohlc_ticks_;
   fast_ema_.AddNewValue(ohlc_tick.close(), fast_weight_);
   slow_ema_.AddNewValue(ohlc_tick.close(), slow_weight_);
@@ -49,13 +49,18 @@ class MovingAverageConvergenceDivergence {
   virtual void Update(const OhlcTick& ohlc_tick);
 
  private:
-  // Auxiliary method called when the last OHLC tick was updated.
-  void LastTickUpdated(const OhlcTick& ohlc_tick);
+  friend class LastNOhlcTicks<MovingAverageConvergenceDivergence>;
+  // LastNOhlcTicks listener methods (see LastNOhlcTicks).
+  void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                       const OhlcTickView& new_ohlc_tick);
+  void NewTickAdded(const OhlcTickView& new_ohlc_tick);
+  void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+                                        const OhlcTickView& new_ohlc_tick);
   // Auxiliary method called when a new OHLC tick was added.
-  void NewTickAdded(const OhlcTick& ohlc_tick);
+  void AddNewOhlcTick(const OhlcTickView& ohlc_tick);
 
   // Keeps track of the current OHLC tick.
-  LastNOhlcTicks last_n_ohlc_ticks_;
+  LastNOhlcTicks<MovingAverageConvergenceDivergence> last_n_ohlc_ticks_;
 
   // Number of observed OHLC ticks.
   int num_ohlc_ticks_ = 0;
@@ -7,28 +7,7 @@ namespace trader {
 RelativeStrengthIndex::RelativeStrengthIndex(int num_periods,
                                              int period_size_sec)
     : num_periods_(num_periods),
-      last_n_ohlc_ticks_(/*num_ohlc_ticks=*/2, period_size_sec) {
-  last_n_ohlc_ticks_.RegisterLastTickUpdatedCallback(
-      [this](const OhlcTick& old_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        // We have observed at least 1 OHLC tick.
-        // The most recent OHLC tick was updated.
-        assert(num_ohlc_ticks_ >= 1);
-        LastTickUpdated();
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedCallback(
-      [this](const OhlcTick& new_ohlc_tick) {
-        // This is the first or second observed OHLC tick.
-        assert(num_ohlc_ticks_ <= 1);
-        NewTickAdded();
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedAndOldestTickRemovedCallback(
-      [this](const OhlcTick& removed_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        // We have observed at least 2 OHLC ticks.
-        // New OHLC tick was added.
-        assert(num_ohlc_ticks_ >= 2);
-        NewTickAdded();
-      });
-}
+      last_n_ohlc_ticks_(this, /*num_ohlc_ticks=*/2, period_size_sec) {}
 
 float RelativeStrengthIndex::GetUpwardChangeModifiedMovingAverage() const {
   return upward_change_mma_.GetExponentialMovingAverage();
@@ -58,14 +37,32 @@ void RelativeStrengthIndex::Update(const OhlcTick& ohlc_tick) {
   last_n_ohlc_ticks_.Update(ohlc_tick);
 }
 
-void RelativeStrengthIndex::LastTickUpdated() {
+void RelativeStrengthIndex::LastTickUpdated(
+    const OhlcTickView& old_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  // We have observed at least 1 OHLC tick.
+  // The most recent OHLC tick was updated.
+  assert(num_ohlc_ticks_ >= 1);
   const float weight = GetModifiedMovingAverageWeight();
   const auto change = GetUpwardDownwardChange();
   upward_change_mma_.UpdateCurrentValue(change.first, weight);
   downward_change_mma_.UpdateCurrentValue(change.second, weight);
 }
 
-void RelativeStrengthIndex::NewTickAdded() {
+void RelativeStrengthIndex::NewTickAdded(const OhlcTickView& new_ohlc_tick) {
+  // This is the first or second observed OHLC tick.
+  assert(num_ohlc_ticks_ <= 1);
+  AddNewOhlcTick();
+}
+
+void RelativeStrengthIndex::NewTickAddedAndOldestTickRemoved(
+    const OhlcTickView& removed_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  // We have observed at least 2 OHLC ticks.
+  // New OHLC tick was added.
+  assert(num_ohlc_ticks_ >= 2);
+  AddNewOhlcTick();
+}
+
+void RelativeStrengthIndex::AddNewOhlcTick() {
   ++num_ohlc_ticks_;
   const float weight = GetModifiedMovingAverageWeight();
   const auto change = GetUpwardDownwardChange();
@@ -80,12 +77,12 @@ float RelativeStrengthIndex::GetModifiedMovingAverageWeight() const {
 std::pair<float, float> RelativeStrengthIndex::GetUpwardDownwardChange() const {
   float upward_change = 0;
   float downward_change = 0;
-  const std::deque<OhlcTick>& last_n_ohlc_ticks =
+  const OhlcTickRingBuffer& last_n_ohlc_ticks =
       last_n_ohlc_ticks_.GetLastNOhlcTicks();
   if (last_n_ohlc_ticks.size() == 1) {
     // We do not have a previous OHLC tick, so we use the opening and closing
     // price of the current OHLC tick.
-    const OhlcTick& ohlc_tick = last_n_ohlc_ticks.at(0);
+    const OhlcTickView& ohlc_tick = last_n_ohlc_ticks.at(0);
     if (ohlc_tick.close() >= ohlc_tick.open()) {
       upward_change = ohlc_tick.close() - ohlc_tick.open();
     } else {
@@ -95,8 +92,8 @@ std::pair<float, float> RelativeStrengthIndex::GetUpwardDownwardChange() const {
     assert(last_n_ohlc_ticks.size() == 2);
     // We do have a previous OHLC tick, so we use the closing price of both
     // the previous and the current OHLC tick.
-    const OhlcTick& prev_ohlc_tick = last_n_ohlc_ticks.at(0);
-    const OhlcTick& ohlc_tick = last_n_ohlc_ticks.at(1);
+    const OhlcTickView& prev_ohlc_tick = last_n_ohlc_ticks.at(0);
+    const OhlcTickView& ohlc_tick = last_n_ohlc_ticks.at(1);
     if (ohlc_tick.close() >= prev_ohlc_tick.close()) {
       upward_change = ohlc_tick.close() - prev_ohlc_tick.close();
     } else {
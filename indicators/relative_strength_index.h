@@ -44,10 +44,15 @@ class RelativeStrengthIndex {
   virtual void Update(const OhlcTick& ohlc_tick);
 
  private:
-  // Auxiliary method called when the last OHLC tick was updated.
-  void LastTickUpdated();
+  friend class LastNOhlcTicks<RelativeStrengthIndex>;
+  // LastNOhlcTicks listener methods (see LastNOhlcTicks).
+  void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                       const OhlcTickView& new_ohlc_tick);
+  void NewTickAdded(const OhlcTickView& new_ohlc_tick);
+  void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+                                        const OhlcTickView& new_ohlc_tick);
   // Auxiliary method called when a new OHLC tick was added.
-  void NewTickAdded();
+  void AddNewOhlcTick();
   // Computes the weight for the smoothed or modified moving average.
   float GetModifiedMovingAverageWeight() const;
   // Computes the most recent upward change U and downward change D.
@@ -56,7 +61,7 @@ class RelativeStrengthIndex {
   // Number N of periods over which we want to compute the RSI.
   int num_periods_ = 0;
   // Keeps track of the current and the previous OHLC tick.
-  LastNOhlcTicks last_n_ohlc_ticks_;
+  LastNOhlcTicks<RelativeStrengthIndex> last_n_ohlc_ticks_;
 
   // Number of observed OHLC ticks.
   int num_ohlc_ticks_ = 0;
@@ -6,20 +6,7 @@ namespace trader {
 
 SimpleMovingAverage::SimpleMovingAverage(int num_ohlc_ticks,
                                          int period_size_sec)
-    : last_n_ohlc_ticks_(num_ohlc_ticks, period_size_sec) {
-  last_n_ohlc_ticks_.RegisterLastTickUpdatedCallback(
-      [this](const OhlcTick& old_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        sum_close_price_ += new_ohlc_tick.close() - old_ohlc_tick.close();
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedCallback(
-      [this](const OhlcTick& new_ohlc_tick) {
-        sum_close_price_ += new_ohlc_tick.close();
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedAndOldestTickRemovedCallback(
-      [this](const OhlcTick& removed_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        sum_close_price_ += new_ohlc_tick.close() - removed_ohlc_tick.close();
-      });
-}
+    : last_n_ohlc_ticks_(this, num_ohlc_ticks, period_size_sec) {}
 
 float SimpleMovingAverage::GetSimpleMovingAverage() const {
   const int num_ohlc_ticks = GetNumOhlcTicks();
@@ -37,4 +24,18 @@ void SimpleMovingAverage::Update(const OhlcTick& ohlc_tick) {
   last_n_ohlc_ticks_.Update(ohlc_tick);
 }
 
+void SimpleMovingAverage::LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                                          const OhlcTickView& new_ohlc_tick) {
+  sum_close_price_ += new_ohlc_tick.close() - old_ohlc_tick.close();
+}
+
+void SimpleMovingAverage::NewTickAdded(const OhlcTickView& new_ohlc_tick) {
+  sum_close_price_ += new_ohlc_tick.close();
+}
+
+void SimpleMovingAverage::NewTickAddedAndOldestTickRemoved(
+    const OhlcTickView& removed_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  sum_close_price_ += new_ohlc_tick.close() - removed_ohlc_tick.close();
+}
+
 }  // namespace trader
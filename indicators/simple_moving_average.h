@@ -36,8 +36,16 @@ class SimpleMovingAverage {
   virtual void Update(const OhlcTick& ohlc_tick);
 
  private:
+  friend class LastNOhlcTicks<SimpleMovingAverage>;
+  // LastNOhlcTicks listener methods (see LastNOhlcTicks).
+  void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                       const OhlcTickView& new_ohlc_tick);
+  void NewTickAdded(const OhlcTickView& new_ohlc_tick);
+  void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+                                        const OhlcTickView& new_ohlc_tick);
+
   // Keeps track of the last N OHLC ticks.
-  LastNOhlcTicks last_n_ohlc_ticks_;
+  LastNOhlcTicks<SimpleMovingAverage> last_n_ohlc_ticks_;
 
   // Sum of the closing prices over the last N OHLC ticks (in the deque).
   float sum_close_price_ = 0;
@@ -5,32 +5,11 @@
 namespace trader {
 
 StochasticOscillator::StochasticOscillator(int num_periods, int period_size_sec)
-    : last_n_ohlc_ticks_(/*num_ohlc_ticks=*/1, period_size_sec),
+    : last_n_ohlc_ticks_(this, /*num_ohlc_ticks=*/1, period_size_sec),
       sliding_window_min_(/*window_size=*/num_periods),
       sliding_window_max_(/*window_size=*/num_periods),
       d_fast_(/*window_size=*/3),
-      d_slow_(/*window_size=*/3) {
-  last_n_ohlc_ticks_.RegisterLastTickUpdatedCallback(
-      [this](const OhlcTick& old_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        // We have observed at least 1 OHLC tick.
-        // The most recent OHLC tick was updated.
-        assert(num_ohlc_ticks_ >= 1);
-        LastTickUpdated(new_ohlc_tick);
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedCallback(
-      [this](const OhlcTick& new_ohlc_tick) {
-        // This is the very first observed OHLC tick.
-        assert(num_ohlc_ticks_ == 0);
-        NewTickAdded(new_ohlc_tick);
-      });
-  last_n_ohlc_ticks_.RegisterNewTickAddedAndOldestTickRemovedCallback(
-      [this](const OhlcTick& removed_ohlc_tick, const OhlcTick& new_ohlc_tick) {
-        // We have observed at least 1 OHLC tick.
-        // New OHLC tick was added.
-        assert(num_ohlc_ticks_ >= 1);
-        NewTickAdded(new_ohlc_tick);
-      });
-}
+      d_slow_(/*window_size=*/3) {}
 
 float StochasticOscillator::GetLow() const {
   return sliding_window_min_.GetSlidingWindowMinimum();
@@ -52,15 +31,33 @@ void StochasticOscillator::Update(const OhlcTick& ohlc_tick) {
   last_n_ohlc_ticks_.Update(ohlc_tick);
 }
 
-void StochasticOscillator::LastTickUpdated(const OhlcTick& ohlc_tick) {
-  sliding_window_min_.UpdateCurrentValue(ohlc_tick.low());
-  sliding_window_max_.UpdateCurrentValue(ohlc_tick.high());
-  UpdateK(ohlc_tick.close());
+void StochasticOscillator::LastTickUpdated(
+    const OhlcTickView& old_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  // We have observed at least 1 OHLC tick.
+  // The most recent OHLC tick was updated.
+  assert(num_ohlc_ticks_ >= 1);
+  sliding_window_min_.UpdateCurrentValue(new_ohlc_tick.low());
+  sliding_window_max_.UpdateCurrentValue(new_ohlc_tick.high());
+  UpdateK(new_ohlc_tick.close());
   d_fast_.UpdateCurrentValue(GetK());
   d_slow_.UpdateCurrentValue(GetFastD());
 }
 
-void StochasticOscillator::NewTickAdded(const OhlcTick& ohlc_tick) {
+void StochasticOscillator::NewTickAdded(const OhlcTickView& new_ohlc_tick) {
+  // This is the very first observed OHLC tick.
+  assert(num_ohlc_ticks_ == 0);
+  AddNewOhlcTick(new_ohlc_tick);
+}
+
+void StochasticOscillator::NewTickAddedAndOldestTickRemoved(
+    const OhlcTickView& removed_ohlc_tick, const OhlcTickView& new_ohlc_tick) {
+  // We have observed at least 1 OHLC tick.
+  // New OHLC tick was added.
+  assert(num_ohlc_ticks_ >= 1);
+  AddNewOhlcTick(new_ohlc_tick);
+}
+
+void StochasticOscillator::AddNewOhlcTick(const OhlcTickView& ohlc_tick) {
   ++num_ohlc_ticks_;
   sliding_window_min_.AddNewValue(ohlc_tick.low());
   sliding_window_max_.AddNewValue(ohlc_tick.high());
@@ -3,6 +3,9 @@
 #ifndef INDICATORS_VOLATILITY_H
 #define INDICATORS_VOLATILITY_H
 
+#include <cmath>
+#include <cstdint>
+
 #include "base/base.h"
 #include "indicators/last_n_ohlc_ticks.h"
 #include "indicators/util.h"
@@ -35,6 +38,15 @@ class Volatility {
                       float quote_balance);
 
  private:
+  friend class LastNOhlcTicks<Volatility>;
+  // LastNOhlcTicks listener methods (see LastNOhlcTicks).
+  void LastTickUpdated(const OhlcTickView& old_ohlc_tick,
+                       const OhlcTickView& new_ohlc_tick);
+  void NewTickAdded(const OhlcTickView& new_ohlc_tick);
+  void NewTickAddedAndOldestTickRemoved(const OhlcTickView& removed_ohlc_tick,
+                                        const OhlcTickView& new_ohlc_tick);
+  // Auxiliary method called when a new OHLC tick was added.
+  void AddNewOhlcTick(const OhlcTickView& ohlc_tick);
   // Returns the logarithmic return w.r.t. the previous portfolio value.
   float GetLogarithmicReturn() const;
 
@@ -42,11 +54,12 @@ class Volatility {
   float latest_base_balance_ = 0;
   float latest_quote_balance_ = 0;
   // Keeps track of the current and the previous OHLC tick.
-  LastNOhlcTicks last_n_ohlc_ticks_;
-  // Keeps track of the current and the previous portfolio value.
+  LastNOhlcTicks<Volatility> last_n_ohlc_ticks_;
+  // Keeps track of the previous and the current portfolio value.
   // At the beginning we use the opening price of the very first OHLC tick
   // to estimate the previous portfolio value.
-  std::deque<float> portfolio_value_;
+  float prev_portfolio_value_ = 0;
+  float portfolio_value_ = 0;
 
   // Number of observed OHLC ticks.
   int num_ohlc_ticks_ = 0;
@@ -55,6 +68,73 @@ class Volatility {
   SlidingWindowMeanAndVariance sliding_window_variance_;
 };
 
+// Lean equivalent of Volatility(/*window_size=*/0, period_size_sec), i.e. the
+// volatility over the whole history, used when executing traders. Keeps only
+// the latest period and the running sums (without any OhlcTick copies, deques
+// or callbacks), and computes exactly the same (bit-identical) volatility.
+class VolatilityAccumulator {
+ public:
+  // period_size_sec: Period of the logarithmic returns. Typically daily.
+  explicit VolatilityAccumulator(int period_size_sec)
+      : period_size_sec_(period_size_sec), variance_(/*window_size=*/0) {}
+
+  // Returns the standard deviation of the logarithmic returns.
+  float GetVolatility() const { return variance_.GetStandardDeviation(); }
+
+  // Returns the number of seen periods (including the gaps).
+  int GetNumPeriods() const { return num_periods_; }
+
+  // Updates the volatility based on the latest OHLC tick (given by its
+  // timestamp, opening and closing price) and portfolio balances.
+  // Same semantics as Volatility::Update.
+  void Update(int64_t timestamp_sec, float open, float close,
+              float base_balance, float quote_balance) {
+    const int64_t period_timestamp_sec =
+        period_size_sec_ * (timestamp_sec / period_size_sec_);
+    if (num_periods_ == 0) {
+      prev_value_ = base_balance * open + quote_balance;
+      AddPeriod(period_timestamp_sec, close, base_balance, quote_balance);
+      return;
+    }
+    // Periods without any OHLC tick keep the previous closing price.
+    while (period_timestamp_sec_ + period_size_sec_ < period_timestamp_sec) {
+      prev_value_ = value_;
+      AddPeriod(period_timestamp_sec_ + period_size_sec_, close_, base_balance,
+                quote_balance);
+    }
+    if (period_timestamp_sec_ < period_timestamp_sec) {
+      prev_value_ = value_;
+      AddPeriod(period_timestamp_sec, close, base_balance, quote_balance);
+      return;
+    }
+    close_ = close;
+    value_ = base_balance * close + quote_balance;
+    variance_.UpdateCurrentValue(std::log(prev_value_ / value_));
+  }
+
+ private:
+  // Adds a new period with the given closing price.
+  void AddPeriod(int64_t period_timestamp_sec, float close, float base_balance,
+                 float quote_balance) {
+    period_timestamp_sec_ = period_timestamp_sec;
+    close_ = close;
+    value_ = base_balance * close + quote_balance;
+    ++num_periods_;
+    variance_.AddNewValue(std::log(prev_value_ / value_));
+  }
+
+  int period_size_sec_ = 0;
+  int num_periods_ = 0;
+  // Start timestamp and closing price of the latest period.
+  int64_t period_timestamp_sec_ = 0;
+  float close_ = 0;
+  // Portfolio value at the end of the previous and the latest period.
+  float prev_value_ = 0;
+  float value_ = 0;
+  // Mean and variance of the logarithmic returns.
+  SlidingWindowMeanAndVariance variance_;
+};
+
 }  // namespace trader
 
 #endif  // INDICATORS_VOLATILITY_H
@@ -228,4 +228,32 @@ TEST(RelativeStrengthIndexTest, GetVolatilityWhenAdding8HourOhlcTicks) {
   EXPECT_EQ(volatility.GetNumOhlcTicks(), 6);
 }
 
+TEST(VolatilityAccumulatorTest, SameAsVolatilityOverWholeHistory) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+
+  Volatility volatility(
+      /*window_size=*/0,
+      /*period_size_sec=*/kSecondsPerDay);
+  VolatilityAccumulator volatility_accumulator(
+      /*period_size_sec=*/kSecondsPerDay);
+
+  EXPECT_EQ(volatility_accumulator.GetVolatility(), 0.0f);
+  EXPECT_EQ(volatility_accumulator.GetNumPeriods(), 0);
+
+  for (size_t i = 0; i < ohlc_history.size(); ++i) {
+    // Balances change over time (as if the trader was trading).
+    const float base_balance = 5.0f + (i % 3);
+    const float quote_balance = 1000.0f - 100.0f * (i % 3);
+    volatility.Update(ohlc_history[i], base_balance, quote_balance);
+    volatility_accumulator.Update(
+        ohlc_history[i].timestamp_sec(), ohlc_history[i].open(),
+        ohlc_history[i].close(), base_balance, quote_balance);
+    EXPECT_EQ(volatility_accumulator.GetVolatility(),
+              volatility.GetVolatility());
+    EXPECT_EQ(volatility_accumulator.GetNumPeriods(),
+              volatility.GetNumOhlcTicks());
+  }
+}
+
 }  // namespace trader
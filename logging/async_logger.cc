@@ -0,0 +1,208 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/async_logger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace trader {
+namespace {
+// Number of busy-wait iterations before falling back to the condition
+// variable (when the ring buffer is empty or full).
+constexpr int kSpinIterations = 64;
+// Maximum waiting time on the condition variable. Bounds the latency of
+// a (rare) missed notification, since the waiting is not fully synchronized
+// with the lock-free publishing.
+constexpr std::chrono::microseconds kMaxWaitTime(500);
+// Number of recorded events after which they are published.
+constexpr uint64_t kPublishBatchSize = 64;
+// Number of dispatched events after which their slots are freed.
+constexpr uint64_t kReleaseBatchSize = 256;
+}  // namespace
+
+AsyncLogger::AsyncLogger(Logger* logger, size_t capacity)
+    : logger_(logger), slots_(std::max<size_t>(capacity, 1)) {
+  thread_ = std::thread(&AsyncLogger::Run, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+  head_.store(next_head_, std::memory_order_release);
+  stopping_.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_available_.notify_one();
+  }
+  thread_.join();
+}
+
+void AsyncLogger::BeginPeriod(int64_t start_timestamp_sec,
+                              int64_t end_timestamp_sec) {
+  Flush();
+  logger_->BeginPeriod(start_timestamp_sec, end_timestamp_sec);
+}
+
+void AsyncLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                   const Account& account) {
+  Event& event = AcquireSlot();
+  event.type = Event::Type::kExchangeState;
+  RecordExchangeState(ohlc_tick, account, event);
+  PublishSlot();
+}
+
+void AsyncLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                   const Account& account, const Order& order) {
+  Event& event = AcquireSlot();
+  event.type = Event::Type::kOrder;
+  RecordExchangeState(ohlc_tick, account, event);
+  event.order_type = order.type();
+  event.order_side = order.side();
+  event.order_amount_case = order.oneof_amount_case();
+  event.order_amount = order.oneof_amount_case() == Order::kBaseAmount
+                           ? order.base_amount()
+                           : order.quote_amount();
+  event.order_price = order.price();
+  PublishSlot();
+}
+
+void AsyncLogger::LogTraderState(absl::string_view trader_state) {
+  Event& event = AcquireSlot();
+  event.type = Event::Type::kTraderState;
+  event.trader_state.assign(trader_state.data(), trader_state.size());
+  PublishSlot();
+}
+
+void AsyncLogger::SetTraderStateSchema(const TraderStateSchema& schema) {
+  // The background thread does not call the decorated logger once all events
+  // are handed over (until new events are published).
+  Flush();
+  logger_->SetTraderStateSchema(schema);
+  num_trader_state_columns_ = schema.size();
+}
+
+void AsyncLogger::LogTraderState(const float* trader_state) {
+  Event& event = AcquireSlot();
+  event.type = Event::Type::kStructuredTraderState;
+  event.trader_state_values.assign(trader_state,
+                                   trader_state + num_trader_state_columns_);
+  PublishSlot();
+}
+
+void AsyncLogger::Flush() {
+  head_.store(next_head_, std::memory_order_release);
+  while (tail_.load(std::memory_order_acquire) < next_head_) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    events_available_.notify_one();
+    slots_available_.wait_for(lock, kMaxWaitTime);
+  }
+}
+
+AsyncLogger::Event& AsyncLogger::AcquireSlot() {
+  if (next_head_ - cached_tail_ >= slots_.size()) {
+    // Publishes all pending events, so that the background thread can free
+    // their slots.
+    head_.store(next_head_, std::memory_order_release);
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    int spin = 0;
+    // Back-pressure: waits until the background thread frees a slot.
+    while (next_head_ - cached_tail_ >= slots_.size()) {
+      if (++spin < kSpinIterations) {
+        std::this_thread::yield();
+      } else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        events_available_.notify_one();
+        slots_available_.wait_for(lock, kMaxWaitTime);
+      }
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+  }
+  return slots_[next_head_ % slots_.size()];
+}
+
+void AsyncLogger::PublishSlot() {
+  // The events are published in batches to reduce the cache line traffic
+  // between the logging thread and the background thread.
+  if (++next_head_ % kPublishBatchSize == 0) {
+    head_.store(next_head_, std::memory_order_release);
+  }
+}
+
+void AsyncLogger::RecordExchangeState(const OhlcTick& ohlc_tick,
+                                      const Account& account, Event& event) {
+  event.timestamp_sec = ohlc_tick.timestamp_sec();
+  event.open = ohlc_tick.open();
+  event.high = ohlc_tick.high();
+  event.low = ohlc_tick.low();
+  event.close = ohlc_tick.close();
+  event.volume = ohlc_tick.volume();
+  event.base_balance = account.base_balance;
+  event.quote_balance = account.quote_balance;
+  event.total_fee = account.total_fee;
+}
+
+void AsyncLogger::Run() {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  int spin = 0;
+  while (true) {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+      if (stopping_.load(std::memory_order_acquire) &&
+          head_.load(std::memory_order_acquire) == tail) {
+        return;
+      }
+      if (++spin < kSpinIterations) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      events_available_.wait_for(lock, kMaxWaitTime);
+      continue;
+    }
+    spin = 0;
+    // Dispatches all published events, freeing their slots in small batches.
+    while (tail < head) {
+      Dispatch(slots_[tail % slots_.size()]);
+      if (++tail % kReleaseBatchSize == 0) {
+        tail_.store(tail, std::memory_order_release);
+      }
+    }
+    tail_.store(tail, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_available_.notify_one();
+  }
+}
+
+void AsyncLogger::Dispatch(const Event& event) {
+  if (event.type == Event::Type::kTraderState) {
+    logger_->LogTraderState(event.trader_state);
+    return;
+  }
+  if (event.type == Event::Type::kStructuredTraderState) {
+    logger_->LogTraderState(event.trader_state_values.data());
+    return;
+  }
+  ohlc_tick_.set_timestamp_sec(event.timestamp_sec);
+  ohlc_tick_.set_open(event.open);
+  ohlc_tick_.set_high(event.high);
+  ohlc_tick_.set_low(event.low);
+  ohlc_tick_.set_close(event.close);
+  ohlc_tick_.set_volume(event.volume);
+  account_.base_balance = event.base_balance;
+  account_.quote_balance = event.quote_balance;
+  account_.total_fee = event.total_fee;
+  if (event.type == Event::Type::kExchangeState) {
+    logger_->LogExchangeState(ohlc_tick_, account_);
+    return;
+  }
+  order_.Clear();
+  order_.set_type(event.order_type);
+  order_.set_side(event.order_side);
+  if (event.order_amount_case == Order::kBaseAmount) {
+    order_.set_base_amount(event.order_amount);
+  } else if (event.order_amount_case == Order::kQuoteAmount) {
+    order_.set_quote_amount(event.order_amount);
+  }
+  order_.set_price(event.order_price);
+  logger_->LogExchangeState(ohlc_tick_, account_, order_);
+}
+
+}  // namespace trader
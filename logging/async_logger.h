@@ -0,0 +1,150 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef LOGGING_ASYNC_LOGGER_H
+#define LOGGING_ASYNC_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logging/logger.h"
+
+namespace trader {
+
+// Logger decorating another logger (e.g. CsvLogger), which is called from a
+// dedicated background thread. Every logged event is recorded (as plain
+// values, without any formatting) into a bounded single-producer
+// single-consumer ring buffer, from which the background thread hands the
+// events over to the decorated logger (which formats and writes them).
+// When the ring buffer is full, the logging thread waits for the background
+// thread (back-pressure), so that the memory stays bounded.
+// Must be used from a single (logging) thread. Should decorate the loggers
+// whose LogsTraderState does not depend on the logged events (since it is
+// called directly from the logging thread), e.g. CsvLogger.
+class AsyncLogger : public Logger {
+ public:
+  // Constructor. Does not take ownership of the decorated logger, which must
+  // outlive this logger. The capacity is the number of events in the ring
+  // buffer.
+  AsyncLogger(Logger* logger, size_t capacity);
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+  // Hands all remaining events over to the decorated logger.
+  virtual ~AsyncLogger();
+
+  // Begins the evaluation period (of the decorated logger, after handing over
+  // all previously logged events).
+  void BeginPeriod(int64_t start_timestamp_sec,
+                   int64_t end_timestamp_sec) override;
+
+  // Logs the current ohlc_tick and account.
+  void LogExchangeState(const OhlcTick& ohlc_tick,
+                        const Account& account) override;
+  // Logs the current ohlc_tick, account, and order, after executing
+  // the given order.
+  void LogExchangeState(const OhlcTick& ohlc_tick, const Account& account,
+                        const Order& order) override;
+
+  // Returns true iff the decorated logger logs the trader states.
+  bool LogsTraderState() const override { return logger_->LogsTraderState(); }
+
+  // Logs the trader state.
+  void LogTraderState(absl::string_view trader_state) override;
+
+  // Sets the schema of the structured trader states (of the decorated logger,
+  // after handing over all previously logged events).
+  void SetTraderStateSchema(const TraderStateSchema& schema) override;
+  // Logs the structured trader state.
+  void LogTraderState(const float* trader_state) override;
+
+  // Blocks until all logged events are handed over to the decorated logger.
+  // Events are otherwise handed over in batches (i.e. with some delay).
+  void Flush();
+
+ private:
+  // Logged event (recorded by the logging thread).
+  struct Event {
+    enum class Type : uint8_t {
+      kExchangeState,
+      kOrder,
+      kTraderState,
+      kStructuredTraderState
+    };
+    Type type = Type::kExchangeState;
+    // OHLC tick.
+    int64_t timestamp_sec = 0;
+    float open = 0;
+    float high = 0;
+    float low = 0;
+    float close = 0;
+    float volume = 0;
+    // Account.
+    float base_balance = 0;
+    float quote_balance = 0;
+    float total_fee = 0;
+    // Order (if the type is kOrder).
+    Order::Type order_type = Order::MARKET;
+    Order::Side order_side = Order::BUY;
+    Order::OneofAmountCase order_amount_case = Order::ONEOF_AMOUNT_NOT_SET;
+    float order_amount = 0;
+    float order_price = 0;
+    // Trader state (if the type is kTraderState). The string capacity of
+    // every slot is reused, so that the steady state does not allocate.
+    std::string trader_state;
+    // Structured trader state (if the type is kStructuredTraderState).
+    std::vector<float> trader_state_values;
+  };
+
+  // Returns the next free slot of the ring buffer (waits if the ring buffer
+  // is full).
+  Event& AcquireSlot();
+  // Publishes the slot returned by AcquireSlot.
+  void PublishSlot();
+  // Records the ohlc_tick and account into the event.
+  static void RecordExchangeState(const OhlcTick& ohlc_tick,
+                                  const Account& account, Event& event);
+  // Main loop of the background thread.
+  void Run();
+  // Hands the event over to the decorated logger.
+  void Dispatch(const Event& event);
+
+  Logger* logger_;
+  std::vector<Event> slots_;
+  // Number of columns of the structured trader state.
+  size_t num_trader_state_columns_ = 0;
+
+  // Number of events recorded by the logging thread (used only by the logging
+  // thread, the events are published in batches).
+  uint64_t next_head_ = 0;
+  // The last observed value of tail_ (used only by the logging thread).
+  uint64_t cached_tail_ = 0;
+
+  // Number of events published by the logging thread.
+  alignas(64) std::atomic<uint64_t> head_{0};
+  // Number of events dispatched by the background thread.
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  // True iff the background thread should exit (after dispatching all events).
+  std::atomic<bool> stopping_{false};
+
+  // Guards the (slow path) waiting of both threads.
+  std::mutex mutex_;
+  // Signaled when new events are published (or when stopping).
+  std::condition_variable events_available_;
+  // Signaled when events are dispatched.
+  std::condition_variable slots_available_;
+
+  // Reused by the background thread for the decorated logger calls.
+  OhlcTick ohlc_tick_;
+  Account account_;
+  Order order_;
+
+  std::thread thread_;
+};
+
+}  // namespace trader
+
+#endif  // LOGGING_ASYNC_LOGGER_H
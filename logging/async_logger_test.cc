@@ -0,0 +1,105 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/async_logger.h"
+
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+#include "logging/csv_logger.h"
+
+namespace trader {
+namespace {
+// Logs a sequence of exchange states, orders, and trader states (structured
+// if the structured flag is true).
+void LogEvents(int num_events, bool structured, Logger& logger) {
+  if (structured) {
+    logger.SetTraderStateSchema({{"index", {}}, {"parity", {"EVEN", "ODD"}}});
+  }
+  OhlcTick ohlc_tick;
+  Account account;
+  Order order;
+  for (int i = 0; i < num_events; ++i) {
+    ohlc_tick.set_timestamp_sec(1483228800 + 60 * i);
+    ohlc_tick.set_open(100.0f + i);
+    ohlc_tick.set_high(150.0f + i);
+    ohlc_tick.set_low(80.0f + i);
+    ohlc_tick.set_close(120.0f + i);
+    ohlc_tick.set_volume(1000.0f + i);
+    account.base_balance = 2.0f + i;
+    account.quote_balance = 1000.0f - i;
+    account.total_fee = 0.5f * i;
+    logger.LogExchangeState(ohlc_tick, account);
+    if (i % 3 == 0) {
+      order.Clear();
+      order.set_type(i % 2 == 0 ? Order::LIMIT : Order::MARKET);
+      order.set_side(i % 2 == 0 ? Order::SELL : Order::BUY);
+      if (i % 2 == 0) {
+        order.set_base_amount(0.1f * i);
+        order.set_price(500.0f + i);
+      } else {
+        order.set_quote_amount(10.0f * i);
+      }
+      logger.LogExchangeState(ohlc_tick, account, order);
+    }
+    if (structured) {
+      const float trader_state[2] = {static_cast<float>(i),
+                                     static_cast<float>(i % 2)};
+      logger.LogTraderState(trader_state);
+    } else {
+      logger.LogTraderState(absl::StrFormat("state_%d", i));
+    }
+  }
+}
+}  // namespace
+
+TEST(AsyncLoggerTest, SameOutputAsDecoratedLogger) {
+  std::stringstream expected_exchange_os;
+  std::stringstream expected_trader_os;
+  CsvLogger expected_logger(&expected_exchange_os, &expected_trader_os);
+  LogEvents(/*num_events=*/1000, /*structured=*/false, expected_logger);
+
+  // Small capacities exercise the back-pressure.
+  for (const size_t capacity : {1, 7, 1024}) {
+    std::stringstream exchange_os;
+    std::stringstream trader_os;
+    CsvLogger csv_logger(&exchange_os, &trader_os);
+    {
+      AsyncLogger logger(&csv_logger, capacity);
+      LogEvents(/*num_events=*/1000, /*structured=*/false, logger);
+    }
+    EXPECT_EQ(exchange_os.str(), expected_exchange_os.str());
+    EXPECT_EQ(trader_os.str(), expected_trader_os.str());
+  }
+}
+
+TEST(AsyncLoggerTest, SameStructuredOutputAsDecoratedLogger) {
+  std::stringstream expected_exchange_os;
+  std::stringstream expected_trader_os;
+  CsvLogger expected_logger(&expected_exchange_os, &expected_trader_os);
+  LogEvents(/*num_events=*/1000, /*structured=*/true, expected_logger);
+
+  std::stringstream exchange_os;
+  std::stringstream trader_os;
+  CsvLogger csv_logger(&exchange_os, &trader_os);
+  {
+    AsyncLogger logger(&csv_logger, /*capacity=*/7);
+    EXPECT_TRUE(logger.LogsTraderState());
+    LogEvents(/*num_events=*/1000, /*structured=*/true, logger);
+  }
+  EXPECT_EQ(exchange_os.str(), expected_exchange_os.str());
+  EXPECT_EQ(trader_os.str(), expected_trader_os.str());
+}
+
+TEST(AsyncLoggerTest, Flush) {
+  std::stringstream trader_os;
+  CsvLogger csv_logger(/*exchange_os=*/nullptr, &trader_os);
+  AsyncLogger logger(&csv_logger, /*capacity=*/16);
+  logger.LogTraderState("state_1");
+  logger.LogTraderState("state_2");
+  logger.Flush();
+  EXPECT_EQ(trader_os.str(), "state_1\nstate_2\n");
+  logger.LogTraderState("state_3");
+  logger.Flush();
+  EXPECT_EQ(trader_os.str(), "state_1\nstate_2\nstate_3\n");
+}
+
+}  // namespace trader
@@ -0,0 +1,214 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/binary_log.h"
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+
+#include "absl/strings/str_format.h"
+#include "util/mapped_file.h"
+
+namespace trader {
+namespace {
+constexpr char kMagic[8] = {'T', 'R', 'D', 'R', 'L', 'O', 'G', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+// Returns the number of bytes rounded up to the multiple of 8.
+uint64_t AlignedSize(uint64_t num_bytes) { return (num_bytes + 7) & ~7ULL; }
+
+// Sequential reader of the packed columns of a single block.
+class BlockReader {
+ public:
+  BlockReader(const char* data, uint64_t data_size)
+      : data_(data), end_(data + data_size) {}
+
+  // Appends the next column of num_rows values. Returns false if the column
+  // does not fit into the block.
+  template <typename T>
+  bool ReadColumn(uint64_t num_rows, std::vector<T>& column) {
+    const uint64_t num_bytes = num_rows * sizeof(T);
+    if (num_rows > Remaining() || AlignedSize(num_bytes) > Remaining()) {
+      return false;
+    }
+    const size_t offset = column.size();
+    column.resize(offset + num_rows);
+    if (num_bytes > 0) {
+      std::memcpy(column.data() + offset, data_, num_bytes);
+    }
+    data_ += AlignedSize(num_bytes);
+    return true;
+  }
+
+  // Appends the next num_rows (null-terminated) strings. Returns false if the
+  // strings do not fit into the block.
+  bool ReadStrings(uint64_t num_rows, std::vector<std::string>& strings) {
+    const char* begin = data_;
+    const char* it = data_;
+    for (uint64_t row = 0; row < num_rows; ++row) {
+      const void* terminator = std::memchr(it, '\0', end_ - it);
+      if (terminator == nullptr) {
+        return false;
+      }
+      strings.emplace_back(it, static_cast<const char*>(terminator) - it);
+      it = static_cast<const char*>(terminator) + 1;
+    }
+    const uint64_t num_bytes = AlignedSize(it - begin);
+    if (num_bytes > Remaining()) {
+      return false;
+    }
+    data_ += num_bytes;
+    return true;
+  }
+
+ private:
+  uint64_t Remaining() const { return end_ - data_; }
+
+  const char* data_;
+  const char* end_;
+};
+
+// Appends the rows of the kExchangeState block to the exchange_states.
+bool ReadExchangeStateBlock(uint64_t num_rows, BlockReader& reader,
+                            ExchangeStateLog& exchange_states) {
+  bool ok = reader.ReadColumn(num_rows, exchange_states.timestamp_sec);
+  for (std::vector<float>* column :
+       {&exchange_states.open, &exchange_states.high, &exchange_states.low,
+        &exchange_states.close, &exchange_states.volume,
+        &exchange_states.base_balance, &exchange_states.quote_balance,
+        &exchange_states.total_fee}) {
+    ok = ok && reader.ReadColumn(num_rows, *column);
+  }
+  ok = ok && reader.ReadColumn(num_rows, exchange_states.order_type);
+  ok = ok && reader.ReadColumn(num_rows, exchange_states.order_side);
+  for (std::vector<float>* column :
+       {&exchange_states.order_base_amount,
+        &exchange_states.order_quote_amount, &exchange_states.order_price}) {
+    ok = ok && reader.ReadColumn(num_rows, *column);
+  }
+  return ok;
+}
+
+// Reads the trader state schema (of num_columns columns) from the
+// kTraderStateSchema block.
+bool ReadTraderStateSchemaBlock(uint64_t num_columns, BlockReader& reader,
+                                TraderStateSchema& schema) {
+  std::vector<uint32_t> num_enum_values;
+  std::vector<std::string> names;
+  if (!reader.ReadColumn(num_columns, num_enum_values) ||
+      !reader.ReadStrings(num_columns, names)) {
+    return false;
+  }
+  uint64_t total_num_enum_values = 0;
+  for (const uint32_t num : num_enum_values) {
+    total_num_enum_values += num;
+  }
+  std::vector<std::string> enum_values;
+  if (!reader.ReadStrings(total_num_enum_values, enum_values)) {
+    return false;
+  }
+  schema.resize(num_columns);
+  auto enum_value_it = enum_values.begin();
+  for (size_t i = 0; i < num_columns; ++i) {
+    schema[i].name = std::move(names[i]);
+    schema[i].enum_values.assign(
+        std::make_move_iterator(enum_value_it),
+        std::make_move_iterator(enum_value_it + num_enum_values[i]));
+    enum_value_it += num_enum_values[i];
+  }
+  return true;
+}
+}  // namespace
+
+BinaryLogFileHeader GetBinaryLogFileHeader() {
+  BinaryLogFileHeader file_header;
+  std::memcpy(file_header.magic, kMagic, sizeof(kMagic));
+  file_header.version = kVersion;
+  file_header.byte_order_mark = kByteOrderMark;
+  return file_header;
+}
+
+absl::StatusOr<BinaryLog> ReadBinaryLog(const std::string& file_name) {
+  absl::StatusOr<std::unique_ptr<MappedFile>> mapped_file_status =
+      MappedFile::Open(file_name);
+  if (!mapped_file_status.ok()) {
+    return mapped_file_status.status();
+  }
+  std::unique_ptr<MappedFile> mapped_file =
+      std::move(mapped_file_status).value();
+  const char* data = mapped_file->data();
+  const uint64_t size = mapped_file->size();
+  if (size < sizeof(BinaryLogFileHeader)) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Truncated binary log file: %s", file_name));
+  }
+  const BinaryLogFileHeader& file_header =
+      *reinterpret_cast<const BinaryLogFileHeader*>(data);
+  if (std::memcmp(file_header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Not a binary log file: %s", file_name));
+  }
+  if (file_header.version != kVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Unsupported binary log file version %d: %s",
+                        file_header.version, file_name));
+  }
+  if (file_header.byte_order_mark != kByteOrderMark) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Incompatible byte order of the file: %s", file_name));
+  }
+  BinaryLog log;
+  TraderStateLog& trader_states = log.trader_states;
+  uint64_t offset = sizeof(BinaryLogFileHeader);
+  int block_index = 0;
+  while (offset < size) {
+    if (size - offset < sizeof(BinaryLogBlockHeader)) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Truncated header of the block %d: %s", block_index, file_name));
+    }
+    BinaryLogBlockHeader block_header;
+    std::memcpy(&block_header, data + offset, sizeof(block_header));
+    offset += sizeof(BinaryLogBlockHeader);
+    if (block_header.data_size % 8 != 0 ||
+        block_header.data_size > size - offset) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Truncated data of the block %d: %s", block_index, file_name));
+    }
+    BlockReader reader(data + offset, block_header.data_size);
+    const uint64_t num_rows = block_header.num_rows;
+    bool ok = false;
+    switch (static_cast<BinaryLogBlockType>(block_header.block_type)) {
+      case BinaryLogBlockType::kExchangeState:
+        ok = ReadExchangeStateBlock(num_rows, reader, log.exchange_states);
+        break;
+      case BinaryLogBlockType::kTraderStateSchema:
+        ok = trader_states.schema.empty() &&
+             ReadTraderStateSchemaBlock(num_rows, reader,
+                                        trader_states.schema);
+        trader_states.columns.resize(trader_states.schema.size());
+        break;
+      case BinaryLogBlockType::kTraderState:
+        ok = block_header.num_columns == trader_states.columns.size() &&
+             reader.ReadColumn(num_rows, trader_states.timestamp_sec);
+        for (std::vector<float>& column : trader_states.columns) {
+          ok = ok && reader.ReadColumn(num_rows, column);
+        }
+        break;
+      case BinaryLogBlockType::kTraderInternalState:
+        ok = reader.ReadColumn(num_rows,
+                               trader_states.internal_state_timestamp_sec) &&
+             reader.ReadStrings(num_rows, trader_states.internal_state);
+        break;
+    }
+    if (!ok) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Invalid data of the block %d: %s", block_index, file_name));
+    }
+    offset += block_header.data_size;
+    ++block_index;
+  }
+  return log;
+}
+
+}  // namespace trader
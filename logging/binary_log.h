@@ -0,0 +1,122 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef LOGGING_BINARY_LOG_H
+#define LOGGING_BINARY_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "base/trader.h"
+
+namespace trader {
+
+// Binary (columnar, versioned) log of exchange movements and trader internal
+// state(s). A compact alternative to the CSV logs (see CsvLogger).
+//
+// The file starts with BinaryLogFileHeader, followed by a sequence of blocks.
+// Every block starts with BinaryLogBlockHeader, followed by data_size bytes
+// storing num_rows rows of a single block type as packed columns:
+//   kExchangeState:
+//     timestamp_sec (int64), open, high, low, close, volume, base_balance,
+//     quote_balance, total_fee (float), order_type, order_side (int8, -1 if
+//     no order was executed), order_base_amount, order_quote_amount,
+//     order_price (float, NaN if not set)
+//   kTraderStateSchema:
+//     num_enum_values (uint32) of every trader state column (num_rows
+//     columns), followed by the column names and then the names of all enum
+//     values (null-terminated strings); precedes the first kTraderState block
+//   kTraderState:
+//     timestamp_sec (int64), followed by num_columns trader state columns
+//     (float, the index of the enum value for the enum columns)
+//   kTraderInternalState:
+//     timestamp_sec (int64), internal_state (num_rows null-terminated strings)
+// Every column is padded to a multiple of 8 bytes, so that every column starts
+// at an 8-byte aligned offset (relative to the beginning of the file).
+// All values are stored in the native byte order, which is verified by the
+// byte_order_mark when reading the file.
+// The blocks are written incrementally (as the rows are logged), so that the
+// memory of the writer stays bounded.
+
+// Type of the rows stored in the block.
+enum class BinaryLogBlockType : uint32_t {
+  kExchangeState = 1,
+  kTraderStateSchema = 2,
+  kTraderState = 3,
+  kTraderInternalState = 4,
+};
+
+struct BinaryLogFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order_mark;
+};
+static_assert(sizeof(BinaryLogFileHeader) == 16,
+              "Unexpected BinaryLogFileHeader size");
+
+struct BinaryLogBlockHeader {
+  // BinaryLogBlockType of the rows stored in the block.
+  uint32_t block_type;
+  // Number of trader state columns (for the kTraderState blocks), otherwise
+  // zero.
+  uint32_t num_columns;
+  // Number of rows stored in the block.
+  uint64_t num_rows;
+  // Size (in bytes) of the block data (a multiple of 8).
+  uint64_t data_size;
+};
+static_assert(sizeof(BinaryLogBlockHeader) == 24,
+              "Unexpected BinaryLogBlockHeader size");
+
+// Returns the binary log file header (magic, version, and byte order mark).
+BinaryLogFileHeader GetBinaryLogFileHeader();
+
+// Logged exchange states (one row per LogExchangeState call).
+struct ExchangeStateLog {
+  size_t size() const { return timestamp_sec.size(); }
+
+  // OHLC tick.
+  std::vector<int64_t> timestamp_sec;
+  std::vector<float> open;
+  std::vector<float> high;
+  std::vector<float> low;
+  std::vector<float> close;
+  std::vector<float> volume;
+  // Account.
+  std::vector<float> base_balance;
+  std::vector<float> quote_balance;
+  std::vector<float> total_fee;
+  // Executed order: Order::Type and Order::Side (-1 if there is no order).
+  std::vector<int8_t> order_type;
+  std::vector<int8_t> order_side;
+  // Executed order amounts and price (NaN if not set).
+  std::vector<float> order_base_amount;
+  std::vector<float> order_quote_amount;
+  std::vector<float> order_price;
+};
+
+// Logged trader states (one row per LogTraderState call). The timestamp_sec
+// of every row is the timestamp of the last logged exchange state.
+struct TraderStateLog {
+  // Schema of the structured trader states.
+  TraderStateSchema schema;
+  // Structured trader states (see Trader::GetState).
+  std::vector<int64_t> timestamp_sec;
+  std::vector<std::vector<float>> columns;
+  // Trader states logged as strings (see Trader::GetInternalState).
+  std::vector<int64_t> internal_state_timestamp_sec;
+  std::vector<std::string> internal_state;
+};
+
+struct BinaryLog {
+  ExchangeStateLog exchange_states;
+  TraderStateLog trader_states;
+};
+
+// Reads the binary log file (written by the BinaryLogger).
+absl::StatusOr<BinaryLog> ReadBinaryLog(const std::string& file_name);
+
+}  // namespace trader
+
+#endif  // LOGGING_BINARY_LOG_H
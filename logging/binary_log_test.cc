@@ -0,0 +1,135 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/binary_log.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+// Appends the raw bytes of the value to the content.
+template <typename T>
+void AppendRaw(const T& value, std::string& content) {
+  content.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Appends the block header (followed by data_size zero bytes) to the content.
+void AppendBlock(BinaryLogBlockType block_type, uint32_t num_columns,
+                 uint64_t num_rows, uint64_t data_size, std::string& content) {
+  BinaryLogBlockHeader block_header;
+  block_header.block_type = static_cast<uint32_t>(block_type);
+  block_header.num_columns = num_columns;
+  block_header.num_rows = num_rows;
+  block_header.data_size = data_size;
+  AppendRaw(block_header, content);
+  content.append(data_size, '\0');
+}
+
+void WriteFile(const std::string& file_name, const std::string& content) {
+  std::ofstream outfile(file_name,
+                        std::ios::out | std::ios::trunc | std::ios::binary);
+  outfile.write(content.data(), content.size());
+}
+}  // namespace
+
+TEST(BinaryLogTest, ReadEmptyLog) {
+  const std::string file_name = ::testing::TempDir() + "binary_log_empty";
+  std::string content;
+  AppendRaw(GetBinaryLogFileHeader(), content);
+  WriteFile(file_name, content);
+  absl::StatusOr<BinaryLog> log_status = ReadBinaryLog(file_name);
+  ASSERT_TRUE(log_status.ok()) << log_status.status();
+  EXPECT_EQ(log_status.value().exchange_states.size(), 0);
+  EXPECT_TRUE(log_status.value().trader_states.schema.empty());
+  EXPECT_TRUE(log_status.value().trader_states.timestamp_sec.empty());
+  EXPECT_TRUE(log_status.value().trader_states.internal_state.empty());
+}
+
+TEST(BinaryLogTest, ReadBlocks) {
+  const std::string file_name = ::testing::TempDir() + "binary_log_blocks";
+  std::string content;
+  AppendRaw(GetBinaryLogFileHeader(), content);
+  // 2 exchange states: 8 + 8 * 8 + 2 * 8 + 3 * 8 bytes.
+  AppendBlock(BinaryLogBlockType::kExchangeState, /*num_columns=*/0,
+              /*num_rows=*/2, /*data_size=*/2 * 8 + 8 * 8 + 2 * 8 + 3 * 8,
+              content);
+  // Numeric column "a" and enum column "bc" with the values "X" and "Y":
+  // the numbers of enum values, the column names, and the enum values (each
+  // padded to 8 bytes).
+  BinaryLogBlockHeader block_header;
+  block_header.block_type =
+      static_cast<uint32_t>(BinaryLogBlockType::kTraderStateSchema);
+  block_header.num_columns = 0;
+  block_header.num_rows = 2;
+  block_header.data_size = 24;
+  AppendRaw(block_header, content);
+  AppendRaw(uint32_t{0}, content);
+  AppendRaw(uint32_t{2}, content);
+  content.append("a\0bc\0\0\0\0", 8);
+  content.append("X\0Y\0\0\0\0\0", 8);
+  // 1 trader state with 2 columns.
+  AppendBlock(BinaryLogBlockType::kTraderState, /*num_columns=*/2,
+              /*num_rows=*/1, /*data_size=*/8 + 8 + 8, content);
+  WriteFile(file_name, content);
+
+  absl::StatusOr<BinaryLog> log_status = ReadBinaryLog(file_name);
+  ASSERT_TRUE(log_status.ok()) << log_status.status();
+  const BinaryLog& log = log_status.value();
+  EXPECT_EQ(log.exchange_states.size(), 2);
+  EXPECT_EQ(log.exchange_states.order_price.size(), 2);
+  ASSERT_EQ(log.trader_states.schema.size(), 2);
+  EXPECT_EQ(log.trader_states.schema[0].name, "a");
+  EXPECT_TRUE(log.trader_states.schema[0].enum_values.empty());
+  EXPECT_EQ(log.trader_states.schema[1].name, "bc");
+  EXPECT_EQ(log.trader_states.schema[1].enum_values,
+            std::vector<std::string>({"X", "Y"}));
+  EXPECT_EQ(log.trader_states.timestamp_sec.size(), 1);
+  ASSERT_EQ(log.trader_states.columns.size(), 2);
+  EXPECT_EQ(log.trader_states.columns[1].size(), 1);
+}
+
+TEST(BinaryLogTest, ReadInvalidFile) {
+  const std::string file_name = ::testing::TempDir() + "binary_log_invalid";
+  WriteFile(file_name, "This is not a binary log file.");
+  EXPECT_FALSE(ReadBinaryLog(file_name).ok());
+  EXPECT_FALSE(ReadBinaryLog(::testing::TempDir() + "binary_log_missing").ok());
+}
+
+TEST(BinaryLogTest, ReadInvalidBlocks) {
+  const std::string file_name = ::testing::TempDir() + "binary_log_invalid";
+  std::string header;
+  AppendRaw(GetBinaryLogFileHeader(), header);
+
+  // Truncated block header.
+  WriteFile(file_name, header + std::string(8, '\0'));
+  EXPECT_FALSE(ReadBinaryLog(file_name).ok());
+
+  // Truncated block data.
+  std::string content = header;
+  AppendBlock(BinaryLogBlockType::kExchangeState, /*num_columns=*/0,
+              /*num_rows=*/1, /*data_size=*/8 * 8, content);
+  WriteFile(file_name, content.substr(0, content.size() - 8));
+  EXPECT_FALSE(ReadBinaryLog(file_name).ok());
+
+  // Block data too small for the number of rows.
+  WriteFile(file_name, content);
+  EXPECT_FALSE(ReadBinaryLog(file_name).ok());
+
+  // Unknown block type.
+  content = header;
+  AppendRaw(BinaryLogBlockHeader{/*block_type=*/42, /*num_columns=*/0,
+                                 /*num_rows=*/0, /*data_size=*/0},
+            content);
+  WriteFile(file_name, content);
+  EXPECT_FALSE(ReadBinaryLog(file_name).ok());
+
+  // Trader states without the schema.
+  content = header;
+  AppendBlock(BinaryLogBlockType::kTraderState, /*num_columns=*/1,
+              /*num_rows=*/1, /*data_size=*/16, content);
+  WriteFile(file_name, content);
+  EXPECT_FALSE(ReadBinaryLog(file_name).ok());
+}
+
+}  // namespace trader
@@ -0,0 +1,212 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/binary_logger.h"
+
+#include <limits>
+
+namespace trader {
+namespace {
+// Number of buffered rows (of a single type) after which they are written.
+constexpr size_t kBlockNumRows = 4096;
+
+// Value of the order columns (of the exchange state) when not set.
+constexpr int8_t kNoOrder = -1;
+constexpr float kNoValue = std::numeric_limits<float>::quiet_NaN();
+
+// Returns the number of bytes rounded up to the multiple of 8.
+uint64_t AlignedSize(uint64_t num_bytes) { return (num_bytes + 7) & ~7ULL; }
+
+// Appends the packed (8-byte aligned) column to the data.
+template <typename T>
+void AppendColumn(const std::vector<T>& column, std::string& data) {
+  const size_t num_bytes = column.size() * sizeof(T);
+  data.append(reinterpret_cast<const char*>(column.data()), num_bytes);
+  data.append(AlignedSize(num_bytes) - num_bytes, '\0');
+}
+
+// Appends the (null-terminated, 8-byte aligned) strings to the data.
+void AppendStrings(const std::vector<std::string>& strings,
+                   std::string& data) {
+  size_t num_bytes = 0;
+  for (const std::string& str : strings) {
+    data.append(str.c_str(), str.size() + 1);
+    num_bytes += str.size() + 1;
+  }
+  data.append(AlignedSize(num_bytes) - num_bytes, '\0');
+}
+}  // namespace
+
+BinaryLogger::BinaryLogger(std::ostream* os) : os_(os) {
+  const BinaryLogFileHeader file_header = GetBinaryLogFileHeader();
+  os_->write(reinterpret_cast<const char*>(&file_header), sizeof(file_header));
+}
+
+BinaryLogger::~BinaryLogger() { Flush(); }
+
+void BinaryLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                    const Account& account) {
+  RecordExchangeState(ohlc_tick, account);
+  exchange_states_.order_type.push_back(kNoOrder);
+  exchange_states_.order_side.push_back(kNoOrder);
+  exchange_states_.order_base_amount.push_back(kNoValue);
+  exchange_states_.order_quote_amount.push_back(kNoValue);
+  exchange_states_.order_price.push_back(kNoValue);
+  if (exchange_states_.size() >= kBlockNumRows) {
+    WriteExchangeStateBlock();
+  }
+}
+
+void BinaryLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                    const Account& account,
+                                    const Order& order) {
+  RecordExchangeState(ohlc_tick, account);
+  exchange_states_.order_type.push_back(static_cast<int8_t>(order.type()));
+  exchange_states_.order_side.push_back(static_cast<int8_t>(order.side()));
+  exchange_states_.order_base_amount.push_back(
+      order.oneof_amount_case() == Order::kBaseAmount ? order.base_amount()
+                                                      : kNoValue);
+  exchange_states_.order_quote_amount.push_back(
+      order.oneof_amount_case() == Order::kQuoteAmount ? order.quote_amount()
+                                                       : kNoValue);
+  exchange_states_.order_price.push_back(order.price() > 0 ? order.price()
+                                                           : kNoValue);
+  if (exchange_states_.size() >= kBlockNumRows) {
+    WriteExchangeStateBlock();
+  }
+}
+
+void BinaryLogger::LogTraderState(absl::string_view trader_state) {
+  trader_states_.internal_state_timestamp_sec.push_back(last_timestamp_sec_);
+  trader_states_.internal_state.emplace_back(trader_state);
+  if (trader_states_.internal_state.size() >= kBlockNumRows) {
+    WriteTraderInternalStateBlock();
+  }
+}
+
+void BinaryLogger::SetTraderStateSchema(const TraderStateSchema& schema) {
+  if (trader_state_schema_written_) {
+    return;
+  }
+  trader_state_schema_written_ = true;
+  trader_states_.schema = schema;
+  trader_states_.columns.resize(schema.size());
+  std::vector<uint32_t> num_enum_values;
+  std::vector<std::string> names;
+  std::vector<std::string> enum_values;
+  for (const TraderStateColumn& column : schema) {
+    num_enum_values.push_back(column.enum_values.size());
+    names.push_back(column.name);
+    enum_values.insert(enum_values.end(), column.enum_values.begin(),
+                       column.enum_values.end());
+  }
+  block_.clear();
+  AppendColumn(num_enum_values, block_);
+  AppendStrings(names, block_);
+  AppendStrings(enum_values, block_);
+  WriteBlock(BinaryLogBlockType::kTraderStateSchema, /*num_columns=*/0,
+             /*num_rows=*/schema.size());
+}
+
+void BinaryLogger::LogTraderState(const float* trader_state) {
+  trader_states_.timestamp_sec.push_back(last_timestamp_sec_);
+  for (size_t i = 0; i < trader_states_.columns.size(); ++i) {
+    trader_states_.columns[i].push_back(trader_state[i]);
+  }
+  if (trader_states_.timestamp_sec.size() >= kBlockNumRows) {
+    WriteTraderStateBlock();
+  }
+}
+
+void BinaryLogger::Flush() {
+  WriteExchangeStateBlock();
+  WriteTraderStateBlock();
+  WriteTraderInternalStateBlock();
+  os_->flush();
+}
+
+void BinaryLogger::RecordExchangeState(const OhlcTick& ohlc_tick,
+                                       const Account& account) {
+  last_timestamp_sec_ = ohlc_tick.timestamp_sec();
+  exchange_states_.timestamp_sec.push_back(ohlc_tick.timestamp_sec());
+  exchange_states_.open.push_back(ohlc_tick.open());
+  exchange_states_.high.push_back(ohlc_tick.high());
+  exchange_states_.low.push_back(ohlc_tick.low());
+  exchange_states_.close.push_back(ohlc_tick.close());
+  exchange_states_.volume.push_back(ohlc_tick.volume());
+  exchange_states_.base_balance.push_back(account.base_balance);
+  exchange_states_.quote_balance.push_back(account.quote_balance);
+  exchange_states_.total_fee.push_back(account.total_fee);
+}
+
+void BinaryLogger::WriteExchangeStateBlock() {
+  const size_t num_rows = exchange_states_.size();
+  if (num_rows == 0) {
+    return;
+  }
+  block_.clear();
+  AppendColumn(exchange_states_.timestamp_sec, block_);
+  for (std::vector<float>* column :
+       {&exchange_states_.open, &exchange_states_.high, &exchange_states_.low,
+        &exchange_states_.close, &exchange_states_.volume,
+        &exchange_states_.base_balance, &exchange_states_.quote_balance,
+        &exchange_states_.total_fee}) {
+    AppendColumn(*column, block_);
+    column->clear();
+  }
+  AppendColumn(exchange_states_.order_type, block_);
+  AppendColumn(exchange_states_.order_side, block_);
+  for (std::vector<float>* column :
+       {&exchange_states_.order_base_amount,
+        &exchange_states_.order_quote_amount, &exchange_states_.order_price}) {
+    AppendColumn(*column, block_);
+    column->clear();
+  }
+  exchange_states_.timestamp_sec.clear();
+  exchange_states_.order_type.clear();
+  exchange_states_.order_side.clear();
+  WriteBlock(BinaryLogBlockType::kExchangeState, /*num_columns=*/0, num_rows);
+}
+
+void BinaryLogger::WriteTraderStateBlock() {
+  const size_t num_rows = trader_states_.timestamp_sec.size();
+  if (num_rows == 0) {
+    return;
+  }
+  block_.clear();
+  AppendColumn(trader_states_.timestamp_sec, block_);
+  trader_states_.timestamp_sec.clear();
+  for (std::vector<float>& column : trader_states_.columns) {
+    AppendColumn(column, block_);
+    column.clear();
+  }
+  WriteBlock(BinaryLogBlockType::kTraderState,
+             /*num_columns=*/trader_states_.columns.size(), num_rows);
+}
+
+void BinaryLogger::WriteTraderInternalStateBlock() {
+  const size_t num_rows = trader_states_.internal_state.size();
+  if (num_rows == 0) {
+    return;
+  }
+  block_.clear();
+  AppendColumn(trader_states_.internal_state_timestamp_sec, block_);
+  AppendStrings(trader_states_.internal_state, block_);
+  trader_states_.internal_state_timestamp_sec.clear();
+  trader_states_.internal_state.clear();
+  WriteBlock(BinaryLogBlockType::kTraderInternalState, /*num_columns=*/0,
+             num_rows);
+}
+
+void BinaryLogger::WriteBlock(BinaryLogBlockType block_type,
+                              uint32_t num_columns, uint64_t num_rows) {
+  BinaryLogBlockHeader block_header;
+  block_header.block_type = static_cast<uint32_t>(block_type);
+  block_header.num_columns = num_columns;
+  block_header.num_rows = num_rows;
+  block_header.data_size = block_.size();
+  os_->write(reinterpret_cast<const char*>(&block_header),
+             sizeof(block_header));
+  os_->write(block_.data(), block_.size());
+}
+
+}  // namespace trader
@@ -0,0 +1,77 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef LOGGING_BINARY_LOGGER_H
+#define LOGGING_BINARY_LOGGER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "logging/binary_log.h"
+#include "logging/logger.h"
+
+namespace trader {
+
+// Binary logger of exchange movements and trader internal state(s).
+// Writes both into a single binary columnar log (see binary_log.h), which can
+// be read by ReadBinaryLog. The logged rows are buffered and written in blocks
+// (of bounded size). The structured trader state (see Trader::GetState) is
+// logged as float columns (with the schema of the first logged trader),
+// otherwise the trader state is logged as a string.
+class BinaryLogger : public Logger {
+ public:
+  // Constructor. Does not take ownership of the provided output stream (opened
+  // in the binary mode). Writes the file header into the output stream.
+  explicit BinaryLogger(std::ostream* os);
+  BinaryLogger(const BinaryLogger&) = delete;
+  BinaryLogger& operator=(const BinaryLogger&) = delete;
+  // Writes all remaining rows into the output stream.
+  virtual ~BinaryLogger();
+
+  // Logs the current ohlc_tick and account.
+  void LogExchangeState(const OhlcTick& ohlc_tick,
+                        const Account& account) override;
+  // Logs the current ohlc_tick, account, and order, after executing
+  // the given order.
+  void LogExchangeState(const OhlcTick& ohlc_tick, const Account& account,
+                        const Order& order) override;
+
+  // Logs the trader state.
+  void LogTraderState(absl::string_view trader_state) override;
+
+  // Sets the schema of the structured trader states (only the first schema is
+  // written into the log).
+  void SetTraderStateSchema(const TraderStateSchema& schema) override;
+  // Logs the structured trader state.
+  void LogTraderState(const float* trader_state) override;
+
+  // Writes all buffered rows (as blocks) into the output stream.
+  void Flush();
+
+ private:
+  // Records the ohlc_tick and account into the exchange_states_.
+  void RecordExchangeState(const OhlcTick& ohlc_tick, const Account& account);
+  // Writes the buffered rows of the given type as a block (if there are any).
+  void WriteExchangeStateBlock();
+  void WriteTraderStateBlock();
+  void WriteTraderInternalStateBlock();
+  // Writes the block header and the block_ data into the output stream.
+  void WriteBlock(BinaryLogBlockType block_type, uint32_t num_columns,
+                  uint64_t num_rows);
+
+  std::ostream* os_;
+  // Buffered rows (not yet written into the output stream).
+  ExchangeStateLog exchange_states_;
+  TraderStateLog trader_states_;
+  // True iff the trader state schema has been written.
+  bool trader_state_schema_written_ = false;
+  // Timestamp of the last logged exchange state.
+  int64_t last_timestamp_sec_ = 0;
+  // Reused buffer for the block data.
+  std::string block_;
+};
+
+}  // namespace trader
+
+#endif  // LOGGING_BINARY_LOGGER_H
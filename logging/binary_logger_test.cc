@@ -0,0 +1,168 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/binary_logger.h"
+
+#include <cmath>
+#include <fstream>
+
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+// Logs a sequence of exchange states, orders, and trader states (structured
+// if the structured flag is true).
+void LogEvents(int num_events, bool structured, Logger& logger) {
+  if (structured) {
+    logger.SetTraderStateSchema({{"close", {}}, {"parity", {"EVEN", "ODD"}}});
+  }
+  OhlcTick ohlc_tick;
+  Account account;
+  Order order;
+  for (int i = 0; i < num_events; ++i) {
+    ohlc_tick.set_timestamp_sec(1483228800 + 60 * i);
+    ohlc_tick.set_open(100.0f + i);
+    ohlc_tick.set_high(150.0f + i);
+    ohlc_tick.set_low(80.0f + i);
+    ohlc_tick.set_close(120.0f + i);
+    ohlc_tick.set_volume(1000.0f + i);
+    account.base_balance = 2.0f + i;
+    account.quote_balance = 1000.0f - i;
+    account.total_fee = 0.5f * i;
+    logger.LogExchangeState(ohlc_tick, account);
+    if (i % 3 == 0) {
+      order.Clear();
+      order.set_type(i % 2 == 0 ? Order::LIMIT : Order::MARKET);
+      order.set_side(i % 2 == 0 ? Order::SELL : Order::BUY);
+      if (i % 2 == 0) {
+        order.set_base_amount(0.1f * i);
+        order.set_price(500.0f + i);
+      } else {
+        order.set_quote_amount(10.0f * i);
+      }
+      logger.LogExchangeState(ohlc_tick, account, order);
+    }
+    if (structured) {
+      const float trader_state[2] = {ohlc_tick.close(),
+                                     static_cast<float>(i % 2)};
+      logger.LogTraderState(trader_state);
+    } else {
+      logger.LogTraderState(absl::StrFormat("%d,%.3f", i, ohlc_tick.close()));
+    }
+  }
+}
+
+absl::StatusOr<BinaryLog> WriteAndReadLog(const std::string& file_name,
+                                          int num_events, bool structured) {
+  {
+    std::ofstream os(file_name,
+                     std::ios::out | std::ios::trunc | std::ios::binary);
+    BinaryLogger logger(&os);
+    LogEvents(num_events, structured, logger);
+  }
+  return ReadBinaryLog(file_name);
+}
+}  // namespace
+
+TEST(BinaryLoggerTest, LogExchangeAndStructuredTraderStates) {
+  // More events than fit into a single block.
+  constexpr int kNumEvents = 10000;
+  absl::StatusOr<BinaryLog> log_status =
+      WriteAndReadLog(::testing::TempDir() + "binary_logger_structured",
+                      kNumEvents, /*structured=*/true);
+  ASSERT_TRUE(log_status.ok()) << log_status.status();
+  const BinaryLog& log = log_status.value();
+
+  const ExchangeStateLog& exchange_states = log.exchange_states;
+  ASSERT_EQ(exchange_states.size(), kNumEvents + (kNumEvents + 2) / 3);
+  size_t row = 0;
+  for (int i = 0; i < kNumEvents; ++i) {
+    for (bool has_order : {false, true}) {
+      if (has_order && i % 3 != 0) {
+        continue;
+      }
+      EXPECT_EQ(exchange_states.timestamp_sec[row], 1483228800 + 60 * i);
+      EXPECT_FLOAT_EQ(exchange_states.open[row], 100.0f + i);
+      EXPECT_FLOAT_EQ(exchange_states.high[row], 150.0f + i);
+      EXPECT_FLOAT_EQ(exchange_states.low[row], 80.0f + i);
+      EXPECT_FLOAT_EQ(exchange_states.close[row], 120.0f + i);
+      EXPECT_FLOAT_EQ(exchange_states.volume[row], 1000.0f + i);
+      EXPECT_FLOAT_EQ(exchange_states.base_balance[row], 2.0f + i);
+      EXPECT_FLOAT_EQ(exchange_states.quote_balance[row], 1000.0f - i);
+      EXPECT_FLOAT_EQ(exchange_states.total_fee[row], 0.5f * i);
+      if (!has_order) {
+        EXPECT_EQ(exchange_states.order_type[row], -1);
+        EXPECT_EQ(exchange_states.order_side[row], -1);
+        EXPECT_TRUE(std::isnan(exchange_states.order_base_amount[row]));
+        EXPECT_TRUE(std::isnan(exchange_states.order_quote_amount[row]));
+        EXPECT_TRUE(std::isnan(exchange_states.order_price[row]));
+      } else if (i % 2 == 0) {
+        EXPECT_EQ(exchange_states.order_type[row], Order::LIMIT);
+        EXPECT_EQ(exchange_states.order_side[row], Order::SELL);
+        EXPECT_FLOAT_EQ(exchange_states.order_base_amount[row], 0.1f * i);
+        EXPECT_TRUE(std::isnan(exchange_states.order_quote_amount[row]));
+        EXPECT_FLOAT_EQ(exchange_states.order_price[row], 500.0f + i);
+      } else {
+        EXPECT_EQ(exchange_states.order_type[row], Order::MARKET);
+        EXPECT_EQ(exchange_states.order_side[row], Order::BUY);
+        EXPECT_TRUE(std::isnan(exchange_states.order_base_amount[row]));
+        EXPECT_FLOAT_EQ(exchange_states.order_quote_amount[row], 10.0f * i);
+        EXPECT_TRUE(std::isnan(exchange_states.order_price[row]));
+      }
+      ++row;
+    }
+  }
+
+  const TraderStateLog& trader_states = log.trader_states;
+  ASSERT_EQ(trader_states.schema.size(), 2);
+  EXPECT_EQ(trader_states.schema[0].name, "close");
+  EXPECT_TRUE(trader_states.schema[0].enum_values.empty());
+  EXPECT_EQ(trader_states.schema[1].name, "parity");
+  EXPECT_EQ(trader_states.schema[1].enum_values,
+            std::vector<std::string>({"EVEN", "ODD"}));
+  ASSERT_EQ(trader_states.timestamp_sec.size(), kNumEvents);
+  ASSERT_EQ(trader_states.columns.size(), 2);
+  ASSERT_EQ(trader_states.columns[0].size(), kNumEvents);
+  ASSERT_EQ(trader_states.columns[1].size(), kNumEvents);
+  for (int i = 0; i < kNumEvents; ++i) {
+    EXPECT_EQ(trader_states.timestamp_sec[i], 1483228800 + 60 * i);
+    EXPECT_FLOAT_EQ(trader_states.columns[0][i], 120.0f + i);
+    EXPECT_EQ(trader_states.columns[1][i], i % 2);
+  }
+  EXPECT_TRUE(trader_states.internal_state.empty());
+}
+
+TEST(BinaryLoggerTest, LogInternalTraderStates) {
+  absl::StatusOr<BinaryLog> log_status =
+      WriteAndReadLog(::testing::TempDir() + "binary_logger_internal",
+                      /*num_events=*/3, /*structured=*/false);
+  ASSERT_TRUE(log_status.ok()) << log_status.status();
+  const TraderStateLog& trader_states = log_status.value().trader_states;
+  EXPECT_TRUE(trader_states.schema.empty());
+  EXPECT_TRUE(trader_states.timestamp_sec.empty());
+  EXPECT_EQ(trader_states.internal_state_timestamp_sec,
+            std::vector<int64_t>({1483228800, 1483228860, 1483228920}));
+  EXPECT_EQ(trader_states.internal_state,
+            std::vector<std::string>({"0,120.000", "1,121.000", "2,122.000"}));
+}
+
+TEST(BinaryLoggerTest, Flush) {
+  const std::string file_name = ::testing::TempDir() + "binary_logger_flush";
+  std::ofstream os(file_name,
+                   std::ios::out | std::ios::trunc | std::ios::binary);
+  BinaryLogger logger(&os);
+  logger.LogTraderState("state_1");
+  logger.Flush();
+  absl::StatusOr<BinaryLog> log_status = ReadBinaryLog(file_name);
+  ASSERT_TRUE(log_status.ok()) << log_status.status();
+  EXPECT_EQ(log_status.value().trader_states.internal_state,
+            std::vector<std::string>({"state_1"}));
+  logger.LogTraderState("state_2");
+  logger.Flush();
+  log_status = ReadBinaryLog(file_name);
+  ASSERT_TRUE(log_status.ok()) << log_status.status();
+  EXPECT_EQ(log_status.value().trader_states.internal_state,
+            std::vector<std::string>({"state_1", "state_2"}));
+}
+
+}  // namespace trader
@@ -3,11 +3,18 @@
 #ifndef LOGGING_CSV_LOGGER_H
 #define LOGGING_CSV_LOGGER_H
 
+#include <cstdint>
+#include <ostream>
+#include <string>
+
 #include "logging/logger.h"
 
 namespace trader {
 
 // CSV logger of exchange movements and trader internal state(s).
+// The structured trader state is logged as the timestamp_sec of the last
+// logged ohlc_tick, followed by the numeric values (formatted as "%.3f") and
+// the names of the enum values.
 class CsvLogger : public Logger {
  public:
   // Constructor. Does not take ownership of the provided output streams.
@@ -25,12 +32,25 @@ class CsvLogger : public Logger {
   void LogExchangeState(const OhlcTick& ohlc_tick, const Account& account,
                         const Order& order) override;
 
+  // Returns true iff the trader_os is not nullptr.
+  bool LogsTraderState() const override { return trader_os_ != nullptr; }
+
   // Logs the trader state.
   void LogTraderState(absl::string_view trader_state) override;
 
+  // Sets the schema of the structured trader states.
+  void SetTraderStateSchema(const TraderStateSchema& schema) override;
+  // Logs the structured trader state.
+  void LogTraderState(const float* trader_state) override;
+
  private:
   std::ostream* exchange_os_;
   std::ostream* trader_os_;
+  // Timestamp of the last logged ohlc_tick.
+  int64_t last_timestamp_sec_ = 0;
+  TraderStateSchema trader_state_schema_;
+  // Reused buffer for the formatted CSV line.
+  std::string line_;
 };
 
 }  // namespace trader
@@ -2,6 +2,9 @@
 
 #include "logging/csv_logger.h"
 
+#include <random>
+
+#include "absl/strings/str_format.h"
 #include "gtest/gtest.h"
 
 namespace trader {
@@ -90,6 +93,43 @@ TEST(CsvLoggerTest, LogExchangeStateWithOrder) {
             "800.000,2.000,1000.000,50.000,,,,,\n");
 }
 
+TEST(CsvLoggerTest, SameFormattingAsPrintf) {
+  // Includes ties (e.g. 1.0625), negative zeros, and huge values.
+  std::vector<float> values = {0.0f,    -0.0f,    0.0005f,   -0.0005f,
+                               0.0015f, 1.0625f,  -1.0625f,  2.0005f,
+                               1.0e-7f, -1.0e-7f, 999.9995f, 123.4565f,
+                               1.0e14f, -1.0e14f, 3.0e15f,   1.0e30f};
+  std::mt19937 generator(/*seed=*/0);
+  std::uniform_real_distribution<float> distribution(-1.0e6f, 1.0e6f);
+  for (int i = 0; i < 10000; ++i) {
+    values.push_back(distribution(generator));
+    values.push_back(distribution(generator) / 1.0e6f);
+  }
+  Account account;
+  std::string expected_output;
+  std::stringstream exchange_os;
+  CsvLogger logger(&exchange_os, /*trader_os=*/nullptr);
+  for (const float value : values) {
+    OhlcTick ohlc_tick;
+    ohlc_tick.set_open(value);
+    ohlc_tick.set_high(value);
+    ohlc_tick.set_low(value);
+    ohlc_tick.set_close(value);
+    ohlc_tick.set_volume(value);
+    account.base_balance = value;
+    account.quote_balance = value;
+    account.total_fee = value;
+    logger.LogExchangeState(ohlc_tick, account);
+    const std::string formatted_value = absl::StrFormat("%.3f", value);
+    expected_output += "0";
+    for (int j = 0; j < 8; ++j) {
+      expected_output += "," + formatted_value;
+    }
+    expected_output += ",,,,,\n";
+  }
+  EXPECT_EQ(exchange_os.str(), expected_output);
+}
+
 TEST(CsvLoggerTest, LogTraderState) {
   std::stringstream trader_os;
   CsvLogger logger(/*exchange_os=*/nullptr, &trader_os);
@@ -100,4 +140,42 @@ TEST(CsvLoggerTest, LogTraderState) {
   EXPECT_EQ(trader_os.str(), "state_1\nstate_2\nstate_3\n");
 }
 
+TEST(CsvLoggerTest, LogStructuredTraderState) {
+  OhlcHistory ohlc_history;
+  PrepareExampleOhlcHistory(ohlc_history);
+
+  Account account;
+  PrepareExampleAccount(account);
+
+  std::stringstream trader_os;
+  CsvLogger logger(/*exchange_os=*/nullptr, &trader_os);
+  EXPECT_TRUE(logger.LogsTraderState());
+  logger.SetTraderStateSchema({{"price", {}}, {"mode", {"LONG", "CASH"}}});
+  float trader_state[2] = {120.5f, 1};
+  logger.LogExchangeState(ohlc_history[0], account);
+  logger.LogTraderState(trader_state);
+  trader_state[1] = 0;
+  logger.LogExchangeState(ohlc_history[1], account);
+  logger.LogTraderState(trader_state);
+  // Invalid enum value.
+  trader_state[1] = 5;
+  logger.LogTraderState(trader_state);
+
+  EXPECT_EQ(trader_os.str(),
+            "1483228800,120.500,CASH\n"
+            "1483315200,120.500,LONG\n"
+            "1483315200,120.500,5.000\n");
+}
+
+TEST(CsvLoggerTest, DiscardTraderState) {
+  std::stringstream exchange_os;
+  CsvLogger logger(&exchange_os, /*trader_os=*/nullptr);
+  EXPECT_FALSE(logger.LogsTraderState());
+  logger.SetTraderStateSchema({{"price", {}}});
+  const float trader_state[1] = {120.5f};
+  logger.LogTraderState(trader_state);
+  logger.LogTraderState("state_1");
+  EXPECT_EQ(exchange_os.str(), "");
+}
+
 }  // namespace trader
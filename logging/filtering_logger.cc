@@ -0,0 +1,84 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/filtering_logger.h"
+
+namespace trader {
+
+void FilteringLogger::BeginPeriod(int64_t start_timestamp_sec,
+                                  int64_t end_timestamp_sec) {
+  next_tick_index_ = 0;
+  tick_selected_ = false;
+  tick_logged_ = false;
+  logger_->BeginPeriod(start_timestamp_sec, end_timestamp_sec);
+}
+
+void FilteringLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                       const Account& account) {
+  tick_selected_ = IsSelected(ohlc_tick.timestamp_sec(), next_tick_index_++);
+  tick_logged_ = false;
+  if (!tick_selected_) {
+    return;
+  }
+  if (logging_config_.executed_orders_only()) {
+    // The exchange state is logged only once an order is executed.
+    pending_ohlc_tick_ = ohlc_tick;
+    pending_account_ = account;
+    return;
+  }
+  logger_->LogExchangeState(ohlc_tick, account);
+  tick_logged_ = true;
+}
+
+void FilteringLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                       const Account& account,
+                                       const Order& order) {
+  if (!tick_selected_) {
+    return;
+  }
+  if (!tick_logged_) {
+    logger_->LogExchangeState(pending_ohlc_tick_, pending_account_);
+    tick_logged_ = true;
+  }
+  logger_->LogExchangeState(ohlc_tick, account, order);
+}
+
+bool FilteringLogger::LogsTraderState() const {
+  return tick_logged_ && logger_->LogsTraderState();
+}
+
+void FilteringLogger::LogTraderState(absl::string_view trader_state) {
+  if (tick_logged_) {
+    logger_->LogTraderState(trader_state);
+  }
+}
+
+void FilteringLogger::SetTraderStateSchema(const TraderStateSchema& schema) {
+  logger_->SetTraderStateSchema(schema);
+}
+
+void FilteringLogger::LogTraderState(const float* trader_state) {
+  if (tick_logged_) {
+    logger_->LogTraderState(trader_state);
+  }
+}
+
+bool FilteringLogger::IsSelected(int64_t timestamp_sec,
+                                 int64_t tick_index) const {
+  if (logging_config_.every_nth_tick() > 1 &&
+      tick_index % logging_config_.every_nth_tick() != 0) {
+    return false;
+  }
+  if (logging_config_.time_window_size() == 0) {
+    return true;
+  }
+  for (const LoggingConfig::TimeWindow& time_window :
+       logging_config_.time_window()) {
+    if (timestamp_sec >= time_window.start_timestamp_sec() &&
+        timestamp_sec < time_window.end_timestamp_sec()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace trader
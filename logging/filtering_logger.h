@@ -0,0 +1,78 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef LOGGING_FILTERING_LOGGER_H
+#define LOGGING_FILTERING_LOGGER_H
+
+#include <cstdint>
+
+#include "logging/logger.h"
+#include "logging/logging.pb.h"
+
+namespace trader {
+
+// Logger decorating another logger, which receives only the OHLC ticks
+// (i.e. their exchange states, executed orders, and trader states) selected
+// by the LoggingConfig. The trader states of the dropped OHLC ticks are not
+// even computed (see LogsTraderState).
+// Assumes that every OHLC tick starts with the LogExchangeState call without
+// the order (followed by the executed orders and the trader state), as logged
+// by ExecuteTrader.
+class FilteringLogger : public Logger {
+ public:
+  // Constructor. Does not take ownership of the decorated logger, which must
+  // outlive this logger.
+  FilteringLogger(const LoggingConfig& logging_config, Logger* logger)
+      : logging_config_(logging_config), logger_(logger) {}
+  FilteringLogger(const FilteringLogger&) = delete;
+  FilteringLogger& operator=(const FilteringLogger&) = delete;
+  virtual ~FilteringLogger() {}
+
+  // Begins the evaluation period (restarts the OHLC tick counting).
+  void BeginPeriod(int64_t start_timestamp_sec,
+                   int64_t end_timestamp_sec) override;
+
+  // Logs the current ohlc_tick and account (if the OHLC tick is selected).
+  void LogExchangeState(const OhlcTick& ohlc_tick,
+                        const Account& account) override;
+  // Logs the current ohlc_tick, account, and order, after executing
+  // the given order (if the OHLC tick is selected).
+  void LogExchangeState(const OhlcTick& ohlc_tick, const Account& account,
+                        const Order& order) override;
+
+  // Returns true iff the current OHLC tick is logged (and the decorated
+  // logger logs the trader state).
+  bool LogsTraderState() const override;
+
+  // Logs the trader state (if the current OHLC tick is logged).
+  void LogTraderState(absl::string_view trader_state) override;
+
+  // Sets the schema of the structured trader states.
+  void SetTraderStateSchema(const TraderStateSchema& schema) override;
+  // Logs the structured trader state (if the current OHLC tick is logged).
+  void LogTraderState(const float* trader_state) override;
+
+ private:
+  // Returns true iff the OHLC tick with the given timestamp and index (within
+  // the evaluation period) satisfies the every_nth_tick and time_window
+  // conditions.
+  bool IsSelected(int64_t timestamp_sec, int64_t tick_index) const;
+
+  LoggingConfig logging_config_;
+  Logger* logger_;
+
+  // Index of the next OHLC tick within the evaluation period.
+  int64_t next_tick_index_ = 0;
+  // True iff the current OHLC tick is selected (but possibly not logged yet,
+  // if waiting for an executed order).
+  bool tick_selected_ = false;
+  // True iff the exchange state of the current OHLC tick has been logged.
+  bool tick_logged_ = false;
+  // Exchange state of the current OHLC tick (when waiting for an executed
+  // order).
+  OhlcTick pending_ohlc_tick_;
+  Account pending_account_;
+};
+
+}  // namespace trader
+
+#endif  // LOGGING_FILTERING_LOGGER_H
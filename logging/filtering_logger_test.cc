@@ -0,0 +1,135 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/filtering_logger.h"
+
+#include <algorithm>
+
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+#include "logging/csv_logger.h"
+
+namespace trader {
+namespace {
+constexpr int64_t kStartTimestampSec = 1483228800;  // 2017-01-01
+
+// Logs num_ticks OHLC ticks (one per minute) the same way as ExecuteTrader.
+// An order is executed on every 3rd OHLC tick.
+void LogTicks(int num_ticks, Logger& logger) {
+  logger.BeginPeriod(kStartTimestampSec, kStartTimestampSec + 60 * num_ticks);
+  OhlcTick ohlc_tick;
+  Account account;
+  Order order;
+  order.set_type(Order::MARKET);
+  order.set_side(Order::BUY);
+  order.set_quote_amount(10.0f);
+  for (int i = 0; i < num_ticks; ++i) {
+    ohlc_tick.set_timestamp_sec(kStartTimestampSec + 60 * i);
+    ohlc_tick.set_close(100.0f + i);
+    logger.LogExchangeState(ohlc_tick, account);
+    if (i % 3 == 0) {
+      account.base_balance += 0.1f;
+      logger.LogExchangeState(ohlc_tick, account, order);
+    }
+    if (logger.LogsTraderState()) {
+      logger.LogTraderState(absl::StrFormat("state_%d", i));
+    }
+  }
+}
+
+// Returns the trader log lines of the given OHLC ticks.
+std::string GetTraderLog(const std::vector<int>& tick_indices) {
+  std::string trader_log;
+  for (int i : tick_indices) {
+    absl::StrAppendFormat(&trader_log, "state_%d\n", i);
+  }
+  return trader_log;
+}
+
+// Returns the number of lines of the given string.
+int CountLines(const std::string& str) {
+  return std::count(str.begin(), str.end(), '\n');
+}
+}  // namespace
+
+TEST(FilteringLoggerTest, LogEverything) {
+  std::stringstream expected_exchange_os;
+  std::stringstream expected_trader_os;
+  CsvLogger expected_logger(&expected_exchange_os, &expected_trader_os);
+  LogTicks(/*num_ticks=*/10, expected_logger);
+
+  std::stringstream exchange_os;
+  std::stringstream trader_os;
+  CsvLogger csv_logger(&exchange_os, &trader_os);
+  FilteringLogger logger(LoggingConfig(), &csv_logger);
+  LogTicks(/*num_ticks=*/10, logger);
+
+  EXPECT_EQ(exchange_os.str(), expected_exchange_os.str());
+  EXPECT_EQ(trader_os.str(), expected_trader_os.str());
+}
+
+TEST(FilteringLoggerTest, LogExecutedOrdersOnly) {
+  std::stringstream exchange_os;
+  std::stringstream trader_os;
+  CsvLogger csv_logger(&exchange_os, &trader_os);
+  LoggingConfig logging_config;
+  logging_config.set_executed_orders_only(true);
+  FilteringLogger logger(logging_config, &csv_logger);
+  LogTicks(/*num_ticks=*/10, logger);
+
+  // Exchange state before and after the order for every logged OHLC tick.
+  EXPECT_EQ(CountLines(exchange_os.str()), 2 * 4);
+  EXPECT_EQ(trader_os.str(), GetTraderLog({0, 3, 6, 9}));
+}
+
+TEST(FilteringLoggerTest, LogEveryNthTick) {
+  std::stringstream exchange_os;
+  std::stringstream trader_os;
+  CsvLogger csv_logger(&exchange_os, &trader_os);
+  LoggingConfig logging_config;
+  logging_config.set_every_nth_tick(4);
+  FilteringLogger logger(logging_config, &csv_logger);
+  LogTicks(/*num_ticks=*/10, logger);
+  // The tick counting restarts with every evaluation period.
+  LogTicks(/*num_ticks=*/5, logger);
+
+  // OHLC tick 0 (with an order), and OHLC ticks 4 and 8 (without orders).
+  EXPECT_EQ(CountLines(exchange_os.str()), (2 + 1 + 1) + (2 + 1));
+  EXPECT_EQ(trader_os.str(), GetTraderLog({0, 4, 8, 0, 4}));
+}
+
+TEST(FilteringLoggerTest, LogTimeWindows) {
+  std::stringstream exchange_os;
+  std::stringstream trader_os;
+  CsvLogger csv_logger(&exchange_os, &trader_os);
+  LoggingConfig logging_config;
+  LoggingConfig::TimeWindow* time_window = logging_config.add_time_window();
+  time_window->set_start_timestamp_sec(kStartTimestampSec + 60 * 2);
+  time_window->set_end_timestamp_sec(kStartTimestampSec + 60 * 4);
+  time_window = logging_config.add_time_window();
+  time_window->set_start_timestamp_sec(kStartTimestampSec + 60 * 8);
+  time_window->set_end_timestamp_sec(kStartTimestampSec + 60 * 100);
+  FilteringLogger logger(logging_config, &csv_logger);
+  LogTicks(/*num_ticks=*/10, logger);
+
+  EXPECT_EQ(CountLines(exchange_os.str()), 1 + 2 + 1 + 2);
+  EXPECT_EQ(trader_os.str(), GetTraderLog({2, 3, 8, 9}));
+}
+
+TEST(FilteringLoggerTest, CombineConditions) {
+  std::stringstream exchange_os;
+  std::stringstream trader_os;
+  CsvLogger csv_logger(&exchange_os, &trader_os);
+  LoggingConfig logging_config;
+  logging_config.set_executed_orders_only(true);
+  logging_config.set_every_nth_tick(2);
+  LoggingConfig::TimeWindow* time_window = logging_config.add_time_window();
+  time_window->set_start_timestamp_sec(kStartTimestampSec + 60 * 1);
+  time_window->set_end_timestamp_sec(kStartTimestampSec + 60 * 100);
+  FilteringLogger logger(logging_config, &csv_logger);
+  LogTicks(/*num_ticks=*/20, logger);
+
+  EXPECT_EQ(CountLines(exchange_os.str()), 2 * 3);
+  EXPECT_EQ(trader_os.str(), GetTraderLog({6, 12, 18}));
+}
+
+}  // namespace trader
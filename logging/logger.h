@@ -3,9 +3,12 @@
 #ifndef LOGGING_LOGGER_H
 #define LOGGING_LOGGER_H
 
+#include <cstdint>
+
 #include "absl/strings/string_view.h"
 #include "base/account.h"
 #include "base/base.h"
+#include "base/trader.h"
 
 namespace trader {
 
@@ -15,6 +18,11 @@ class Logger {
   Logger() {}
   virtual ~Logger() {}
 
+  // Called at the beginning of every evaluation period [start_timestamp_sec,
+  // end_timestamp_sec), before logging any of its states.
+  virtual void BeginPeriod(int64_t start_timestamp_sec,
+                           int64_t end_timestamp_sec) {}
+
   // Logs the current ohlc_tick and account.
   virtual void LogExchangeState(const OhlcTick& ohlc_tick,
                                 const Account& account) = 0;
@@ -23,8 +31,22 @@ class Logger {
   virtual void LogExchangeState(const OhlcTick& ohlc_tick,
                                 const Account& account, const Order& order) = 0;
 
-  // Logs the trader state.
+  // Returns true iff the logger logs the trader state of the current OHLC tick
+  // (i.e. of the last logged ohlc_tick). Otherwise, the trader state is
+  // neither computed nor passed to the logger.
+  virtual bool LogsTraderState() const { return true; }
+
+  // Logs the trader state (see Trader::GetInternalState).
   virtual void LogTraderState(absl::string_view trader_state) = 0;
+
+  // Sets the schema of the structured trader states (see Trader::GetState)
+  // logged by LogTraderState below. Called before executing every trader
+  // exporting the structured state. All such traders logged by the same
+  // logger are expected to share the same schema.
+  virtual void SetTraderStateSchema(const TraderStateSchema& schema) = 0;
+  // Logs the structured trader state (one value per column of the schema).
+  // The state is associated with the last logged ohlc_tick.
+  virtual void LogTraderState(const float* trader_state) = 0;
 };
 
 }  // namespace trader
@@ -0,0 +1,53 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/period_logger.h"
+
+namespace trader {
+
+void PeriodLogger::BeginPeriod(int64_t start_timestamp_sec,
+                               int64_t end_timestamp_sec) {
+  logger_ = logger_factory_(next_period_index_++, start_timestamp_sec,
+                            end_timestamp_sec);
+  if (logger_ != nullptr) {
+    logger_->BeginPeriod(start_timestamp_sec, end_timestamp_sec);
+  }
+}
+
+void PeriodLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                    const Account& account) {
+  if (logger_ != nullptr) {
+    logger_->LogExchangeState(ohlc_tick, account);
+  }
+}
+
+void PeriodLogger::LogExchangeState(const OhlcTick& ohlc_tick,
+                                    const Account& account,
+                                    const Order& order) {
+  if (logger_ != nullptr) {
+    logger_->LogExchangeState(ohlc_tick, account, order);
+  }
+}
+
+bool PeriodLogger::LogsTraderState() const {
+  return logger_ != nullptr && logger_->LogsTraderState();
+}
+
+void PeriodLogger::LogTraderState(absl::string_view trader_state) {
+  if (logger_ != nullptr) {
+    logger_->LogTraderState(trader_state);
+  }
+}
+
+void PeriodLogger::SetTraderStateSchema(const TraderStateSchema& schema) {
+  if (logger_ != nullptr) {
+    logger_->SetTraderStateSchema(schema);
+  }
+}
+
+void PeriodLogger::LogTraderState(const float* trader_state) {
+  if (logger_ != nullptr) {
+    logger_->LogTraderState(trader_state);
+  }
+}
+
+}  // namespace trader
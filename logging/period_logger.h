@@ -0,0 +1,64 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef LOGGING_PERIOD_LOGGER_H
+#define LOGGING_PERIOD_LOGGER_H
+
+#include <cstdint>
+#include <functional>
+
+#include "logging/logger.h"
+
+namespace trader {
+
+// Returns the logger for the evaluation period with the given (zero-based)
+// index and [start_timestamp_sec, end_timestamp_sec). Returns nullptr if the
+// period should not be logged. The returned logger is owned by the factory
+// and has to remain valid until the next call.
+using PeriodLoggerFactory = std::function<Logger*(
+    int period_index, int64_t start_timestamp_sec, int64_t end_timestamp_sec)>;
+
+// Logger forwarding the states of every evaluation period to a separate
+// logger (e.g. writing to a separate file), obtained from the factory at the
+// beginning of the period. Nothing is logged before the first period.
+class PeriodLogger : public Logger {
+ public:
+  explicit PeriodLogger(PeriodLoggerFactory logger_factory)
+      : logger_factory_(std::move(logger_factory)) {}
+  PeriodLogger(const PeriodLogger&) = delete;
+  PeriodLogger& operator=(const PeriodLogger&) = delete;
+  virtual ~PeriodLogger() {}
+
+  // Switches to the logger of the new evaluation period.
+  void BeginPeriod(int64_t start_timestamp_sec,
+                   int64_t end_timestamp_sec) override;
+
+  // Logs the current ohlc_tick and account.
+  void LogExchangeState(const OhlcTick& ohlc_tick,
+                        const Account& account) override;
+  // Logs the current ohlc_tick, account, and order, after executing
+  // the given order.
+  void LogExchangeState(const OhlcTick& ohlc_tick, const Account& account,
+                        const Order& order) override;
+
+  // Returns true iff the logger of the current period logs the trader state.
+  bool LogsTraderState() const override;
+
+  // Logs the trader state.
+  void LogTraderState(absl::string_view trader_state) override;
+
+  // Sets the schema of the structured trader states.
+  void SetTraderStateSchema(const TraderStateSchema& schema) override;
+  // Logs the structured trader state.
+  void LogTraderState(const float* trader_state) override;
+
+ private:
+  PeriodLoggerFactory logger_factory_;
+  // Index of the next evaluation period.
+  int next_period_index_ = 0;
+  // Logger of the current evaluation period (or nullptr if not logged).
+  Logger* logger_ = nullptr;
+};
+
+}  // namespace trader
+
+#endif  // LOGGING_PERIOD_LOGGER_H
@@ -0,0 +1,66 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "logging/period_logger.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+#include "gtest/gtest.h"
+#include "logging/csv_logger.h"
+
+namespace trader {
+namespace {
+// Logs a single OHLC tick (with an order) of the current evaluation period.
+void LogTick(int64_t timestamp_sec, Logger& logger) {
+  OhlcTick ohlc_tick;
+  ohlc_tick.set_timestamp_sec(timestamp_sec);
+  Account account;
+  logger.LogExchangeState(ohlc_tick, account);
+  Order order;
+  order.set_type(Order::MARKET);
+  order.set_side(Order::SELL);
+  order.set_base_amount(1.0f);
+  logger.LogExchangeState(ohlc_tick, account, order);
+  if (logger.LogsTraderState()) {
+    logger.LogTraderState(absl::StrFormat("state_%d", timestamp_sec));
+  }
+}
+}  // namespace
+
+TEST(PeriodLoggerTest, LogPeriodsSeparately) {
+  std::vector<std::stringstream> exchange_os(3);
+  std::vector<std::stringstream> trader_os(3);
+  std::unique_ptr<CsvLogger> csv_logger;
+  std::vector<std::pair<int64_t, int64_t>> periods;
+  PeriodLogger logger([&](int period_index, int64_t start_timestamp_sec,
+                          int64_t end_timestamp_sec) -> Logger* {
+    periods.emplace_back(start_timestamp_sec, end_timestamp_sec);
+    // The second period is not logged.
+    if (period_index == 1) {
+      return nullptr;
+    }
+    csv_logger = absl::make_unique<CsvLogger>(&exchange_os[period_index],
+                                              &trader_os[period_index]);
+    return csv_logger.get();
+  });
+  // Nothing is logged before the first period.
+  LogTick(/*timestamp_sec=*/0, logger);
+  for (int period = 0; period < 3; ++period) {
+    logger.BeginPeriod(/*start_timestamp_sec=*/100 * period,
+                       /*end_timestamp_sec=*/100 * (period + 1));
+    LogTick(/*timestamp_sec=*/100 * period + 10, logger);
+    LogTick(/*timestamp_sec=*/100 * period + 20, logger);
+  }
+
+  EXPECT_EQ(periods, (std::vector<std::pair<int64_t, int64_t>>(
+                         {{0, 100}, {100, 200}, {200, 300}})));
+  EXPECT_EQ(trader_os[0].str(), "state_10\nstate_20\n");
+  EXPECT_TRUE(exchange_os[1].str().empty());
+  EXPECT_TRUE(trader_os[1].str().empty());
+  EXPECT_EQ(trader_os[2].str(), "state_210\nstate_220\n");
+  const std::string exchange_log = exchange_os[2].str();
+  EXPECT_EQ(std::count(exchange_log.begin(), exchange_log.end(), '\n'), 4);
+}
+
+}  // namespace trader
@@ -1,5 +1,10 @@
 // Copyright © 2023 Peter Cerno. All rights reserved.
 
+#include <unistd.h>
+
+#include <map>
+#include <thread>
+
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/memory/memory.h"
@@ -7,24 +12,59 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "base/base.h"
+#include "base/binary_history.h"
+#include "base/columnar_history.h"
+#include "base/ohlc_pyramid.h"
 #include "base/side_input.h"
 #include "eval/eval.h"
+#include "eval/evaluation_cache.h"
+#include "eval/results.h"
+#include "eval/search.h"
+#include "eval/sweep.h"
+#include "logging/async_logger.h"
+#include "logging/binary_logger.h"
 #include "logging/csv_logger.h"
+#include "logging/filtering_logger.h"
+#include "logging/logging.pb.h"
+#include "logging/period_logger.h"
 #include "traders/trader_factory.h"
 #include "util/proto.h"
 #include "util/time.h"
 
 ABSL_FLAG(std::string, input_ohlc_history_delimited_proto_file, "",
           "Input file containing the delimited OhlcRecord protos.");
+ABSL_FLAG(std::string, input_ohlc_history_binary_file, "",
+          "Input (memory-mapped) binary history file containing the OHLC "
+          "history. Alternative to input_ohlc_history_delimited_proto_file.");
 ABSL_FLAG(std::string, input_side_history_delimited_proto_file, "",
           "Input file containing the delimited SideInputRecord protos.");
 ABSL_FLAG(std::string, output_exchange_log_file, "",
           "Output CSV file containing the exchange log.");
 ABSL_FLAG(std::string, output_trader_log_file, "",
           "Output file containing the trader-dependent log.");
+ABSL_FLAG(std::string, output_binary_log_file, "",
+          "Output binary columnar file containing the exchange and trader "
+          "logs (see logging/binary_log.h). Alternative to the CSV logs.");
+ABSL_FLAG(int, async_logger_capacity, 1 << 16,
+          "Number of logged events buffered for the background thread, "
+          "which formats and writes the logs. Zero disables async logging.");
+ABSL_FLAG(bool, log_executed_orders_only, false,
+          "Log only the OHLC ticks on which at least one order was executed.");
+ABSL_FLAG(int, log_every_nth_tick, 0,
+          "Log only every n-th OHLC tick of every evaluation period. Zero or "
+          "one means every OHLC tick.");
+ABSL_FLAG(std::string, log_time_windows, "",
+          "Comma-separated time windows START/END (date-times as in "
+          "start_time and end_time). Log only the OHLC ticks within them.");
+ABSL_FLAG(bool, log_per_period, false,
+          "Log every evaluation period into separate files, whose names are "
+          "suffixed by the start date of the period (before the extension). "
+          "Periods outside of log_time_windows are not logged. Required when "
+          "logging with evaluation_period_months > 0.");
 ABSL_FLAG(std::string, trader, "stop",
           "Trader to be executed. [rebalancing, stop].");
 
@@ -42,6 +82,72 @@ ABSL_FLAG(double, market_liquidity, 0.5,
 ABSL_FLAG(double, max_volume_ratio, 0.5,
           "Fraction of tick volume used to fill the limit order.");
 ABSL_FLAG(bool, evaluate_batch, false, "Batch evaluation.");
+ABSL_FLAG(int, num_threads, 0,
+          "Number of threads for batch evaluation "
+          "(0 = number of hardware threads).");
+ABSL_FLAG(int, lockstep_batch_size, 16,
+          "Number of traders executed in lockstep (in a single pass over "
+          "the OHLC history) during batch evaluation.");
+ABSL_FLAG(int, batch_top_k, 20,
+          "Number of the best traders of the batch (or of the search, or of "
+          "the sweep) kept (and printed).");
+ABSL_FLAG(std::string, batch_top_k_metric, "score",
+          "Metric ranking the traders of the batch: score, avg_gain, "
+          "avg_total_executed_orders, or avg_total_fee.");
+ABSL_FLAG(std::string, output_batch_results_file, "",
+          "Output file with the (delimited) EvaluationResults of all traders "
+          "of the batch, written incrementally during the batch evaluation.");
+ABSL_FLAG(int, checkpoint_interval_sec, 60,
+          "Minimum interval between two checkpoints (flushes) of the "
+          "--output_batch_results_file during the batch evaluation.");
+ABSL_FLAG(bool, resume, false,
+          "Resumes the batch evaluation from the --output_batch_results_file "
+          "(e.g. after a crash), skipping the traders already evaluated.");
+ABSL_FLAG(bool, search, false,
+          "Successive halving search for the best batch traders: all "
+          "candidates are evaluated over a subset of the evaluation periods "
+          "(or over a shorter time window), and only the top 1 / search_eta "
+          "candidates advance to the next rung with search_eta times larger "
+          "budget, until the survivors are evaluated over all periods.");
+ABSL_FLAG(int, search_num_candidates, 0,
+          "Number of candidates sampled at random from the parameter ranges "
+          "of the batch traders (0 = the batch traders).");
+ABSL_FLAG(int, search_eta, 3,
+          "Reduction factor between the consecutive rungs of the search.");
+ABSL_FLAG(int, search_num_rungs, 0,
+          "Number of rungs of the search (0 = automatic).");
+ABSL_FLAG(int, search_seed, 0,
+          "Seed for sampling the candidates of the search.");
+ABSL_FLAG(bool, sweep_coordinator, false,
+          "Coordinates the distributed batch evaluation: splits the batch "
+          "traders into shards evaluated by the --sweep_worker processes "
+          "(sharing the --sweep_work_dir), then merges and ranks the results.");
+ABSL_FLAG(bool, sweep_worker, false,
+          "Evaluates the shards of the batch traders handed out by the "
+          "--sweep_coordinator (via the --sweep_work_dir) until the sweep is "
+          "done. Needs to be run with the same flags as the coordinator.");
+ABSL_FLAG(std::string, sweep_work_dir, "",
+          "Work directory shared by the sweep coordinator and the workers. "
+          "Needs to be empty (or not existing) when the coordinator starts.");
+ABSL_FLAG(int, sweep_shard_size, 16, "Number of traders per sweep shard.");
+ABSL_FLAG(int, sweep_claim_timeout_sec, 600,
+          "Sweep shards whose worker has not refreshed its claim (heartbeat) "
+          "for longer than this (e.g. a crashed worker) are handed out "
+          "again.");
+ABSL_FLAG(int, sweep_max_retries, 3,
+          "Maximum number of times a sweep shard is handed out again.");
+ABSL_FLAG(int, sweep_poll_interval_ms, 1000,
+          "Polling interval of the sweep work directory.");
+ABSL_FLAG(std::string, sweep_worker_id, "",
+          "Unique sweep worker id (default: <hostname>.<pid>).");
+ABSL_FLAG(bool, evaluate_pyramid, false,
+          "Whether to evaluate the trader(s) over every level of the OHLC "
+          "pyramid (i.e. every OHLC section with a different sampling rate) "
+          "stored in input_ohlc_history_binary_file.");
+ABSL_FLAG(std::string, evaluation_cache_file, "",
+          "File containing the cached (per-period) trader execution results. "
+          "The cache is reused (and updated) across runs, and can be shared "
+          "by concurrent runs (e.g. sweep workers).");
 
 using namespace trader;
 
@@ -76,6 +182,38 @@ AccountConfig GetAccountConfig() {
   return config;
 }
 
+// Returns the LoggingConfig based on the flags.
+absl::StatusOr<LoggingConfig> GetLoggingConfig() {
+  LoggingConfig config;
+  config.set_executed_orders_only(
+      absl::GetFlag(FLAGS_log_executed_orders_only));
+  config.set_every_nth_tick(absl::GetFlag(FLAGS_log_every_nth_tick));
+  for (absl::string_view time_window_str :
+       absl::StrSplit(absl::GetFlag(FLAGS_log_time_windows), ',',
+                      absl::SkipWhitespace())) {
+    const std::vector<absl::string_view> times =
+        absl::StrSplit(time_window_str, '/');
+    if (times.size() != 2) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid time window: %s", time_window_str));
+    }
+    const absl::StatusOr<absl::Time> start_time_status = ParseTime(times[0]);
+    if (!start_time_status.ok()) {
+      return start_time_status.status();
+    }
+    const absl::StatusOr<absl::Time> end_time_status = ParseTime(times[1]);
+    if (!end_time_status.ok()) {
+      return end_time_status.status();
+    }
+    LoggingConfig::TimeWindow* time_window = config.add_time_window();
+    time_window->set_start_timestamp_sec(
+        absl::ToUnixSeconds(start_time_status.value()));
+    time_window->set_end_timestamp_sec(
+        absl::ToUnixSeconds(end_time_status.value()));
+  }
+  return config;
+}
+
 // Returns a vector of records of type T read from the delimited_proto_file.
 template <typename T>
 absl::StatusOr<std::vector<T>> ReadHistory(
@@ -101,18 +239,105 @@ absl::StatusOr<std::vector<T>> ReadHistory(
   return history_subset;
 }
 
+// Returns the columnar OHLC history (within the given time period) based on
+// the memory-mapped binary_history_file. Does not copy nor parse the records.
+absl::StatusOr<ColumnarOhlcHistory> ReadOhlcHistoryFromBinaryFile(
+    const std::string& binary_history_file, absl::Time start_time,
+    absl::Time end_time) {
+  const absl::Time latency_start_time = absl::Now();
+  const absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(binary_history_file);
+  if (!history_file_status.ok()) {
+    return history_file_status.status();
+  }
+  const absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+      history_file_status.value().GetOhlcHistory(/*sampling_rate_sec=*/0);
+  if (!ohlc_history_status.ok()) {
+    return ohlc_history_status.status();
+  }
+  const ColumnarOhlcHistory& ohlc_history = ohlc_history_status.value();
+  LogInfo(absl::StrFormat(
+      "- Mapped %d records in %.3f seconds", ohlc_history.size(),
+      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+  const std::pair<size_t, size_t> subset = ohlc_history.Subset(
+      absl::ToUnixSeconds(start_time), absl::ToUnixSeconds(end_time));
+  LogInfo(
+      absl::StrFormat("- Selected %d records within the time period: [%s - %s)",
+                      subset.second - subset.first,  // nowrap
+                      FormatTimeUTC(start_time),     // nowrap
+                      FormatTimeUTC(end_time)));
+  return ohlc_history.Slice(subset.first, subset.second);
+}
+
+// Returns the columnar OHLC history (within the given time period) read from
+// either the binary history file or the delimited proto file.
+absl::StatusOr<ColumnarOhlcHistory> ReadOhlcHistory(absl::Time start_time,
+                                                    absl::Time end_time) {
+  if (!absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty()) {
+    LogInfo(absl::StrFormat(
+        "Reading OHLC history from: %s",
+        absl::GetFlag(FLAGS_input_ohlc_history_binary_file)));
+    return ReadOhlcHistoryFromBinaryFile(
+        absl::GetFlag(FLAGS_input_ohlc_history_binary_file), start_time,
+        end_time);
+  }
+  LogInfo(absl::StrFormat(
+      "Reading OHLC history from: %s",
+      absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file)));
+  const absl::StatusOr<OhlcHistory> ohlc_history_status = ReadHistory<OhlcTick>(
+      absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file),  // nowrap
+      start_time, end_time);
+  if (!ohlc_history_status.ok()) {
+    return ohlc_history_status.status();
+  }
+  // Evaluation runs over the (cache-friendly) columnar OHLC history.
+  return ColumnarOhlcHistory(ohlc_history_status.value());
+}
+
+// Returns the columnar OHLC histories (within the given time period) of all
+// levels of the OHLC pyramid stored in the memory-mapped binary_history_file,
+// together with their sampling rates. Does not copy nor parse the records.
+absl::StatusOr<std::vector<std::pair<int, ColumnarOhlcHistory>>>
+ReadOhlcPyramidFromBinaryFile(const std::string& binary_history_file,
+                              absl::Time start_time, absl::Time end_time) {
+  const absl::StatusOr<BinaryHistoryFile> history_file_status =
+      BinaryHistoryFile::Open(binary_history_file);
+  if (!history_file_status.ok()) {
+    return history_file_status.status();
+  }
+  const absl::StatusOr<OhlcPyramid> pyramid_status =
+      OhlcPyramid::FromBinaryHistoryFile(history_file_status.value());
+  if (!pyramid_status.ok()) {
+    return pyramid_status.status();
+  }
+  const OhlcPyramid& pyramid = pyramid_status.value();
+  std::vector<std::pair<int, ColumnarOhlcHistory>> ohlc_histories;
+  for (size_t level = 0; level < pyramid.num_levels(); ++level) {
+    const ColumnarOhlcHistory& ohlc_history = pyramid.ohlc_history(level);
+    const std::pair<size_t, size_t> subset = ohlc_history.Subset(
+        absl::ToUnixSeconds(start_time), absl::ToUnixSeconds(end_time));
+    LogInfo(absl::StrFormat("- Level %d (%d sec): Selected %d records", level,
+                            pyramid.sampling_rate_sec(level),
+                            subset.second - subset.first));
+    ohlc_histories.emplace_back(
+        pyramid.sampling_rate_sec(level),
+        ohlc_history.Slice(subset.first, subset.second));
+  }
+  return ohlc_histories;
+}
+
 // Opens the file log_filename for logging purposes.
 absl::StatusOr<std::unique_ptr<std::ofstream>> OpenLogFile(
-    const std::string& log_filename) {
+    const std::string& log_filename, bool binary) {
   if (log_filename.empty()) {
     return nullptr;
   }
-  if (absl::GetFlag(FLAGS_evaluation_period_months) > 0) {
-    return absl::FailedPreconditionError(
-        "Logging disabled when evaluating multiple periods");
-  }
   auto log_stream = absl::make_unique<std::ofstream>();
-  log_stream->open(log_filename, std::ios::out | std::ios::trunc);
+  std::ios::openmode mode = std::ios::out | std::ios::trunc;
+  if (binary) {
+    mode |= std::ios::binary;
+  }
+  log_stream->open(log_filename, mode);
   if (!log_stream->is_open()) {
     return absl::InvalidArgumentError(
         absl::StrFormat("Cannot open the file: %s", log_filename));
@@ -120,14 +345,155 @@ absl::StatusOr<std::unique_ptr<std::ofstream>> OpenLogFile(
   return log_stream;
 }
 
+// Returns the log_filename with the suffix inserted before its extension
+// (e.g. "exchange.csv" with the suffix "2017-01-01" becomes
+// "exchange.2017-01-01.csv").
+std::string AddLogFileSuffix(const std::string& log_filename,
+                             absl::string_view suffix) {
+  if (log_filename.empty() || suffix.empty()) {
+    return log_filename;
+  }
+  const size_t dir_end = log_filename.find_last_of('/');
+  const size_t dot = log_filename.find_last_of('.');
+  if (dot == std::string::npos ||
+      (dir_end != std::string::npos && dot < dir_end)) {
+    return absl::StrCat(log_filename, ".", suffix);
+  }
+  return absl::StrCat(log_filename.substr(0, dot), ".", suffix,
+                      log_filename.substr(dot));
+}
+
+// Log files (based on the flags) together with the loggers writing them.
+struct LogFiles {
+  // Flushes the logs written so far.
+  void Flush() {
+    if (async_logger != nullptr) {
+      async_logger->Flush();
+    }
+    if (binary_logger != nullptr) {
+      binary_logger->Flush();
+    }
+  }
+
+  std::unique_ptr<std::ofstream> exchange_log_stream;
+  std::unique_ptr<std::ofstream> trader_log_stream;
+  std::unique_ptr<std::ofstream> binary_log_stream;
+  // The loggers are destroyed (and flushed) before their streams.
+  std::unique_ptr<CsvLogger> csv_logger;
+  std::unique_ptr<AsyncLogger> async_logger;
+  std::unique_ptr<BinaryLogger> binary_logger;
+  // Logger writing the log files (or nullptr if there are none).
+  Logger* logger = nullptr;
+};
+
+// Opens the log files (with the suffix inserted before their extensions).
+absl::StatusOr<std::unique_ptr<LogFiles>> OpenLogFiles(
+    absl::string_view suffix) {
+  auto log_files = absl::make_unique<LogFiles>();
+  absl::StatusOr<std::unique_ptr<std::ofstream>> log_stream_status =
+      OpenLogFile(AddLogFileSuffix(
+                      absl::GetFlag(FLAGS_output_exchange_log_file), suffix),
+                  /*binary=*/false);
+  if (!log_stream_status.ok()) {
+    return log_stream_status.status();
+  }
+  log_files->exchange_log_stream = std::move(log_stream_status).value();
+  log_stream_status = OpenLogFile(
+      AddLogFileSuffix(absl::GetFlag(FLAGS_output_trader_log_file), suffix),
+      /*binary=*/false);
+  if (!log_stream_status.ok()) {
+    return log_stream_status.status();
+  }
+  log_files->trader_log_stream = std::move(log_stream_status).value();
+  log_stream_status = OpenLogFile(
+      AddLogFileSuffix(absl::GetFlag(FLAGS_output_binary_log_file), suffix),
+      /*binary=*/true);
+  if (!log_stream_status.ok()) {
+    return log_stream_status.status();
+  }
+  log_files->binary_log_stream = std::move(log_stream_status).value();
+  if (log_files->exchange_log_stream != nullptr ||
+      log_files->trader_log_stream != nullptr) {
+    log_files->csv_logger =
+        absl::make_unique<CsvLogger>(log_files->exchange_log_stream.get(),
+                                     log_files->trader_log_stream.get());
+    log_files->logger = log_files->csv_logger.get();
+    // Formats and writes the logs in a background thread (unless there is
+    // only a single hardware thread).
+    if (absl::GetFlag(FLAGS_async_logger_capacity) > 0 &&
+        std::thread::hardware_concurrency() > 1) {
+      log_files->async_logger = absl::make_unique<AsyncLogger>(
+          log_files->logger, absl::GetFlag(FLAGS_async_logger_capacity));
+      log_files->logger = log_files->async_logger.get();
+    }
+  }
+  // The binary logger does not format the logs (and logs the structured
+  // trader state), so it is used directly.
+  if (log_files->binary_log_stream != nullptr) {
+    log_files->binary_logger =
+        absl::make_unique<BinaryLogger>(log_files->binary_log_stream.get());
+    log_files->logger = log_files->binary_logger.get();
+  }
+  return log_files;
+}
+
+// Returns true iff the period [start_timestamp_sec, end_timestamp_sec)
+// overlaps with at least one time window of the logging_config (or if there
+// are no time windows).
+bool OverlapsLoggingTimeWindows(const LoggingConfig& logging_config,
+                                int64_t start_timestamp_sec,
+                                int64_t end_timestamp_sec) {
+  if (logging_config.time_window_size() == 0) {
+    return true;
+  }
+  for (const LoggingConfig::TimeWindow& time_window :
+       logging_config.time_window()) {
+    if (time_window.start_timestamp_sec() < end_timestamp_sec &&
+        start_timestamp_sec < time_window.end_timestamp_sec()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void PrintBatchEvalResults(const std::vector<EvaluationResult>& eval_results,
                            size_t top_n) {
   const size_t eval_count = std::min(top_n, eval_results.size());
   for (size_t eval_index = 0; eval_index < eval_count; ++eval_index) {
     const EvaluationResult& eval_result = eval_results.at(eval_index);
-    LogInfo(
-        absl::StrFormat("%s: %.5f", eval_result.name(), eval_result.score()));
+    // Average (annual) trader volatility over all evaluation periods.
+    float trader_volatility = 0;
+    for (const EvaluationResult::Period& period : eval_result.period()) {
+      trader_volatility += period.result().trader_volatility();
+    }
+    if (eval_result.period_size() > 0) {
+      trader_volatility /= eval_result.period_size();
+    }
+    LogInfo(absl::StrFormat("%s: %.5f (volatility: %.3f)", eval_result.name(),
+                            eval_result.score(), trader_volatility));
+  }
+}
+
+// Returns the TopEvaluationResults keeping the batch_top_k best traders of the
+// batch according to the batch_top_k_metric.
+std::unique_ptr<TopEvaluationResults> NewTopEvaluationResults() {
+  absl::StatusOr<EvaluationResultMetric> metric_status =
+      GetEvaluationResultMetric(absl::GetFlag(FLAGS_batch_top_k_metric));
+  CheckOk(metric_status.status());
+  return std::make_unique<TopEvaluationResults>(
+      static_cast<size_t>(std::max(0, absl::GetFlag(FLAGS_batch_top_k))),
+      std::move(metric_status).value());
+}
+
+// Prints the best evaluation results (see NewTopEvaluationResults) out of the
+// given results of the batch (ordered by the trader index).
+void PrintTopBatchEvalResults(std::vector<EvaluationResult> eval_results) {
+  std::unique_ptr<TopEvaluationResults> top_results =
+      NewTopEvaluationResults();
+  for (size_t i = 0; i < eval_results.size(); ++i) {
+    top_results->Add(i, std::move(eval_results[i]));
   }
+  PrintBatchEvalResults(top_results->GetSortedResults(), top_results->size());
 }
 
 void PrintTraderEvalResult(const EvaluationResult& eval_result) {
@@ -145,6 +511,239 @@ void PrintTraderEvalResult(const EvaluationResult& eval_result) {
         period.result().base_volatility()));
   }
 }
+
+// Returns the SweepConfig based on the flags.
+SweepConfig GetSweepConfig() {
+  SweepConfig sweep_config;
+  sweep_config.set_work_dir(absl::GetFlag(FLAGS_sweep_work_dir));
+  sweep_config.set_shard_size(absl::GetFlag(FLAGS_sweep_shard_size));
+  sweep_config.set_claim_timeout_sec(
+      absl::GetFlag(FLAGS_sweep_claim_timeout_sec));
+  sweep_config.set_max_retries(absl::GetFlag(FLAGS_sweep_max_retries));
+  sweep_config.set_poll_interval_ms(
+      absl::GetFlag(FLAGS_sweep_poll_interval_ms));
+  return sweep_config;
+}
+
+// Returns the sweep worker id based on the flags (or the hostname and pid).
+std::string GetSweepWorkerId() {
+  if (!absl::GetFlag(FLAGS_sweep_worker_id).empty()) {
+    return absl::GetFlag(FLAGS_sweep_worker_id);
+  }
+  char hostname[256] = {};
+  gethostname(hostname, sizeof(hostname) - 1);
+  return absl::StrFormat("%s.%d", hostname, getpid());
+}
+
+// Evaluates the trader (or the batch of traders) over the ohlc_history.
+void EvaluateOverOhlcHistory(const AccountConfig& account_config,
+                             EvaluationConfig eval_config,
+                             const ColumnarOhlcHistory& ohlc_history,
+                             const SideInput* side_input,
+                             EvaluationCache* eval_cache) {
+  const absl::Time latency_start_time = absl::Now();
+  // The volatility is cheap enough to be computed even for the batch.
+  eval_config.set_fast_eval(false);
+  if (absl::GetFlag(FLAGS_search)) {
+    LogInfo("\nSearch:");
+    std::vector<std::unique_ptr<TraderEmitter>> trader_emitters =
+        absl::GetFlag(FLAGS_search_num_candidates) > 0
+            ? GetRandomBatchOfTraders(
+                  absl::GetFlag(FLAGS_trader),
+                  absl::GetFlag(FLAGS_search_num_candidates),
+                  absl::GetFlag(FLAGS_search_seed))
+            : GetBatchOfTraders(absl::GetFlag(FLAGS_trader));
+    SearchConfig search_config;
+    search_config.set_eta(absl::GetFlag(FLAGS_search_eta));
+    search_config.set_num_rungs(absl::GetFlag(FLAGS_search_num_rungs));
+    for (const SearchRung& rung :
+         GetSearchRungs(eval_config, search_config, trader_emitters.size())) {
+      LogInfo(absl::StrFormat(
+          "- %d candidates over [%s - %s) with period stride %d",
+          rung.num_candidates,
+          FormatTimeUTC(
+              absl::FromUnixSeconds(rung.eval_config.start_timestamp_sec())),
+          FormatTimeUTC(
+              absl::FromUnixSeconds(rung.eval_config.end_timestamp_sec())),
+          std::max(1, rung.eval_config.period_stride())));
+    }
+    PrintTopBatchEvalResults(SearchBatchOfTraders(
+        account_config, eval_config, search_config, ohlc_history, side_input,
+        trader_emitters, eval_cache));
+  } else if (absl::GetFlag(FLAGS_sweep_coordinator)) {
+    LogInfo(absl::StrFormat("\nSweep coordinator (work directory: %s):",
+                            absl::GetFlag(FLAGS_sweep_work_dir)));
+    absl::StatusOr<std::vector<EvaluationResult>> eval_results_status =
+        CoordinateSweep(GetSweepConfig(),
+                        GetBatchOfTradersSize(absl::GetFlag(FLAGS_trader)));
+    CheckOk(eval_results_status.status());
+    PrintTopBatchEvalResults(std::move(eval_results_status).value());
+  } else if (absl::GetFlag(FLAGS_sweep_worker)) {
+    const std::string worker_id = GetSweepWorkerId();
+    LogInfo(absl::StrFormat("\nSweep worker %s (work directory: %s):",
+                            worker_id, absl::GetFlag(FLAGS_sweep_work_dir)));
+    const absl::StatusOr<int> num_shards_status = RunSweepWorker(
+        GetSweepConfig(), worker_id, [&](size_t begin, size_t end) {
+          const std::vector<std::unique_ptr<TraderEmitter>> trader_emitters =
+              GetBatchOfTraders(absl::GetFlag(FLAGS_trader), begin, end);
+          LogInfo(absl::StrFormat("- Evaluating traders [%d, %d)", begin, end));
+          return EvaluateBatchOfTraders(account_config, eval_config,
+                                        ohlc_history, side_input,
+                                        trader_emitters, eval_cache);
+        });
+    CheckOk(num_shards_status.status());
+    LogInfo(absl::StrFormat("Evaluated %d shards", num_shards_status.value()));
+  } else if (absl::GetFlag(FLAGS_evaluate_batch)) {
+    LogInfo("\nBatch evaluation:");
+    std::vector<std::unique_ptr<TraderEmitter>> trader_emitters =
+        GetBatchOfTraders(absl::GetFlag(FLAGS_trader));
+    const size_t batch_size = trader_emitters.size();
+    std::unique_ptr<TopEvaluationResults> top_results =
+        NewTopEvaluationResults();
+    std::unique_ptr<EvaluationResultsWriter> results_writer;
+    // Whether the trader (with the given index) was already evaluated.
+    std::vector<bool> evaluated(batch_size, false);
+    if (!absl::GetFlag(FLAGS_output_batch_results_file).empty()) {
+      const std::string& results_file =
+          absl::GetFlag(FLAGS_output_batch_results_file);
+      absl::StatusOr<std::unique_ptr<EvaluationResultsWriter>>
+          results_writer_status;
+      if (absl::GetFlag(FLAGS_resume)) {
+        std::map<std::string, size_t> trader_indices;
+        for (size_t i = 0; i < batch_size; ++i) {
+          trader_indices[trader_emitters[i]->GetName()] = i;
+        }
+        size_t num_recovered = 0;
+        results_writer_status = EvaluationResultsWriter::Resume(
+            results_file, account_config, eval_config,
+            [&](const EvaluationResult& eval_result) {
+              const auto it = trader_indices.find(eval_result.name());
+              if (it == trader_indices.end() || evaluated[it->second]) {
+                return;
+              }
+              evaluated[it->second] = true;
+              top_results->Add(it->second, eval_result);
+              ++num_recovered;
+            });
+        CheckOk(results_writer_status.status());
+        LogInfo(absl::StrFormat("- Resumed %d results from: %s",
+                                num_recovered, results_file));
+      } else {
+        results_writer_status = EvaluationResultsWriter::Open(results_file);
+        CheckOk(results_writer_status.status());
+      }
+      results_writer = std::move(results_writer_status).value();
+    }
+    // Traders yet to be evaluated (together with their indices in the batch).
+    std::vector<std::unique_ptr<TraderEmitter>> pending_emitters;
+    std::vector<size_t> pending_indices;
+    for (size_t i = 0; i < batch_size; ++i) {
+      if (!evaluated[i]) {
+        pending_emitters.push_back(std::move(trader_emitters[i]));
+        pending_indices.push_back(i);
+      }
+    }
+    absl::Time checkpoint_time = absl::Now();
+    EvaluateBatchOfTraders(
+        account_config, eval_config, ohlc_history, side_input,
+        pending_emitters, eval_cache,
+        [&](size_t trader_index, EvaluationResult eval_result) {
+          if (results_writer != nullptr) {
+            CheckOk(results_writer->Write(eval_result));
+            if (absl::Now() - checkpoint_time >=
+                absl::Seconds(absl::GetFlag(FLAGS_checkpoint_interval_sec))) {
+              CheckOk(results_writer->Flush());
+              checkpoint_time = absl::Now();
+            }
+          }
+          top_results->Add(pending_indices[trader_index],
+                          std::move(eval_result));
+        });
+    if (results_writer != nullptr) {
+      CheckOk(results_writer->Close());
+      LogInfo(absl::StrFormat("Saved %d results to: %s", batch_size,
+                              absl::GetFlag(FLAGS_output_batch_results_file)));
+    }
+    PrintBatchEvalResults(top_results->GetSortedResults(), top_results->size());
+  } else {
+    std::unique_ptr<TraderEmitter> trader_emitter =
+        GetTrader(absl::GetFlag(FLAGS_trader));
+    LogInfo(absl::StrFormat("\n%s evaluation:", trader_emitter->GetName()));
+    if (!absl::GetFlag(FLAGS_output_binary_log_file).empty() &&
+        (!absl::GetFlag(FLAGS_output_exchange_log_file).empty() ||
+         !absl::GetFlag(FLAGS_output_trader_log_file).empty())) {
+      LogError("Binary log file cannot be combined with the CSV log files");
+      std::exit(EXIT_FAILURE);
+    }
+    absl::StatusOr<LoggingConfig> logging_config_status = GetLoggingConfig();
+    CheckOk(logging_config_status.status());
+    const LoggingConfig& logging_config = logging_config_status.value();
+    // The evaluation cache is bypassed when logging.
+    Logger* logger = nullptr;
+    std::unique_ptr<LogFiles> log_files;
+    std::unique_ptr<PeriodLogger> period_logger;
+    if (absl::GetFlag(FLAGS_log_per_period)) {
+      // The log files of the previous period are closed (and flushed) before
+      // opening the log files of the next period.
+      period_logger = absl::make_unique<PeriodLogger>(
+          [&](int period_index, int64_t start_timestamp_sec,
+              int64_t end_timestamp_sec) -> Logger* {
+            log_files.reset();
+            if (!OverlapsLoggingTimeWindows(logging_config, start_timestamp_sec,
+                                            end_timestamp_sec)) {
+              return nullptr;
+            }
+            absl::StatusOr<std::unique_ptr<LogFiles>> log_files_status =
+                OpenLogFiles(absl::FormatTime(
+                    "%Y-%m-%d", absl::FromUnixSeconds(start_timestamp_sec),
+                    absl::UTCTimeZone()));
+            CheckOk(log_files_status.status());
+            log_files = std::move(log_files_status).value();
+            return log_files->logger;
+          });
+      if (!absl::GetFlag(FLAGS_output_exchange_log_file).empty() ||
+          !absl::GetFlag(FLAGS_output_trader_log_file).empty() ||
+          !absl::GetFlag(FLAGS_output_binary_log_file).empty()) {
+        logger = period_logger.get();
+      }
+    } else {
+      // Multiple (possibly overlapping) evaluation periods would be logged
+      // into the same files without any delimiter.
+      if (absl::GetFlag(FLAGS_evaluation_period_months) > 0 &&
+          (!absl::GetFlag(FLAGS_output_exchange_log_file).empty() ||
+           !absl::GetFlag(FLAGS_output_trader_log_file).empty() ||
+           !absl::GetFlag(FLAGS_output_binary_log_file).empty())) {
+        LogError("Logging multiple evaluation periods requires log_per_period");
+        std::exit(EXIT_FAILURE);
+      }
+      absl::StatusOr<std::unique_ptr<LogFiles>> log_files_status =
+          OpenLogFiles(/*suffix=*/"");
+      CheckOk(log_files_status.status());
+      log_files = std::move(log_files_status).value();
+      logger = log_files->logger;
+    }
+    // Filters the logged OHLC ticks (unless all of them are logged).
+    std::unique_ptr<FilteringLogger> filtering_logger;
+    if (logger != nullptr &&
+        (logging_config.executed_orders_only() ||
+         logging_config.every_nth_tick() > 1 ||
+         logging_config.time_window_size() > 0)) {
+      filtering_logger =
+          absl::make_unique<FilteringLogger>(logging_config, logger);
+      logger = filtering_logger.get();
+    }
+    EvaluationResult eval_result =
+        EvaluateTrader(account_config, eval_config, ohlc_history, side_input,
+                       *trader_emitter, logger, eval_cache);
+    if (log_files != nullptr) {
+      log_files->Flush();
+    }
+    PrintTraderEvalResult(eval_result);
+  }
+  LogInfo(
+      absl::StrFormat("\nEvaluated in %.3f seconds",
+                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
+}
 }  // namespace
 
 int main(int argc, char* argv[]) {
@@ -174,18 +773,64 @@ int main(int argc, char* argv[]) {
   eval_config.set_end_timestamp_sec(absl::ToUnixSeconds(end_time));
   eval_config.set_evaluation_period_months(
       absl::GetFlag(FLAGS_evaluation_period_months));
+  if (absl::GetFlag(FLAGS_num_threads) > 0) {
+    eval_config.set_num_threads(absl::GetFlag(FLAGS_num_threads));
+  }
+  if (absl::GetFlag(FLAGS_lockstep_batch_size) > 0) {
+    eval_config.set_lockstep_batch_size(
+        absl::GetFlag(FLAGS_lockstep_batch_size));
+  }
 
   LogInfo("\nTrader EvaluationConfig:");
   LogInfo(eval_config.DebugString());
 
-  LogInfo(absl::StrFormat(
-      "Reading OHLC history from: %s",
-      absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file)));
-  absl::StatusOr<OhlcHistory> ohlc_history_status = ReadHistory<OhlcTick>(
-      absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file),  // nowrap
-      start_time, end_time);
-  CheckOk(ohlc_history_status.status());
-  const OhlcHistory& ohlc_history = ohlc_history_status.value();
+  if (!absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty() &&
+      !absl::GetFlag(FLAGS_input_ohlc_history_delimited_proto_file).empty()) {
+    LogError("Cannot have two input OHLC history files");
+    std::exit(EXIT_FAILURE);
+  }
+  if (absl::GetFlag(FLAGS_resume) &&
+      absl::GetFlag(FLAGS_output_batch_results_file).empty()) {
+    LogError("Resume requires output_batch_results_file");
+    std::exit(EXIT_FAILURE);
+  }
+  if ((absl::GetFlag(FLAGS_sweep_coordinator) ||
+       absl::GetFlag(FLAGS_sweep_worker)) &&
+      (absl::GetFlag(FLAGS_sweep_work_dir).empty() ||
+       absl::GetFlag(FLAGS_evaluate_pyramid))) {
+    LogError("Sweep requires sweep_work_dir (and no OHLC pyramid)");
+    std::exit(EXIT_FAILURE);
+  }
+  // OHLC histories (together with their sampling rates, or zero if unknown)
+  // to evaluate the trader(s) over.
+  std::vector<std::pair<int, ColumnarOhlcHistory>> ohlc_histories;
+  if (absl::GetFlag(FLAGS_evaluate_pyramid)) {
+    if (absl::GetFlag(FLAGS_input_ohlc_history_binary_file).empty()) {
+      LogError("OHLC pyramid requires input_ohlc_history_binary_file");
+      std::exit(EXIT_FAILURE);
+    }
+    if (!absl::GetFlag(FLAGS_output_exchange_log_file).empty() ||
+        !absl::GetFlag(FLAGS_output_trader_log_file).empty() ||
+        !absl::GetFlag(FLAGS_output_binary_log_file).empty()) {
+      LogError("Logging disabled when evaluating the OHLC pyramid");
+      std::exit(EXIT_FAILURE);
+    }
+    LogInfo(absl::StrFormat(
+        "Reading OHLC pyramid from: %s",
+        absl::GetFlag(FLAGS_input_ohlc_history_binary_file)));
+    absl::StatusOr<std::vector<std::pair<int, ColumnarOhlcHistory>>>
+        ohlc_histories_status = ReadOhlcPyramidFromBinaryFile(
+            absl::GetFlag(FLAGS_input_ohlc_history_binary_file), start_time,
+            end_time);
+    CheckOk(ohlc_histories_status.status());
+    ohlc_histories = std::move(ohlc_histories_status).value();
+  } else {
+    absl::StatusOr<ColumnarOhlcHistory> ohlc_history_status =
+        ReadOhlcHistory(start_time, end_time);
+    CheckOk(ohlc_history_status.status());
+    ohlc_histories.emplace_back(/*sampling_rate_sec=*/0,
+                                std::move(ohlc_history_status).value());
+  }
 
   std::unique_ptr<SideInput> side_input;
   if (!absl::GetFlag(FLAGS_input_side_history_delimited_proto_file).empty()) {
@@ -200,41 +845,32 @@ int main(int argc, char* argv[]) {
     side_input = absl::make_unique<SideInput>(side_history_status.value());
   }
 
-  const absl::Time latency_start_time = absl::Now();
-  if (absl::GetFlag(FLAGS_evaluate_batch)) {
-    eval_config.set_fast_eval(true);
-    LogInfo("\nBatch evaluation:");
-    std::vector<std::unique_ptr<TraderEmitter>> trader_emitters =
-        GetBatchOfTraders(absl::GetFlag(FLAGS_trader));
-    std::vector<EvaluationResult> eval_results =
-        EvaluateBatchOfTraders(account_config, eval_config, ohlc_history,
-                               side_input.get(), trader_emitters);
-    std::sort(eval_results.begin(), eval_results.end(),
-              [](const EvaluationResult& lhs, const EvaluationResult& rhs) {
-                return lhs.score() > rhs.score();
-              });
-    PrintBatchEvalResults(eval_results, 20);
-  } else {
-    eval_config.set_fast_eval(false);
-    std::unique_ptr<TraderEmitter> trader_emitter =
-        GetTrader(absl::GetFlag(FLAGS_trader));
-    LogInfo(absl::StrFormat("\n%s evaluation:", trader_emitter->GetName()));
-    absl::StatusOr<std::unique_ptr<std::ofstream>> exchange_log_stream_status =
-        OpenLogFile(absl::GetFlag(FLAGS_output_exchange_log_file));
-    CheckOk(exchange_log_stream_status.status());
-    absl::StatusOr<std::unique_ptr<std::ofstream>> trader_log_stream_status =
-        OpenLogFile(absl::GetFlag(FLAGS_output_trader_log_file));
-    CheckOk(trader_log_stream_status.status());
-    CsvLogger logger(exchange_log_stream_status.value().get(),
-                     trader_log_stream_status.value().get());
-    EvaluationResult eval_result =
-        EvaluateTrader(account_config, eval_config, ohlc_history,
-                       side_input.get(), *trader_emitter, &logger);
-    PrintTraderEvalResult(eval_result);
+  std::unique_ptr<EvaluationCache> eval_cache;
+  if (!absl::GetFlag(FLAGS_evaluation_cache_file).empty()) {
+    LogInfo(absl::StrFormat("Reading evaluation cache from: %s",
+                            absl::GetFlag(FLAGS_evaluation_cache_file)));
+    absl::StatusOr<std::unique_ptr<EvaluationCache>> eval_cache_status =
+        EvaluationCache::ReadFromFile(
+            absl::GetFlag(FLAGS_evaluation_cache_file));
+    CheckOk(eval_cache_status.status());
+    eval_cache = std::move(eval_cache_status).value();
+    LogInfo(absl::StrFormat("- Loaded %d cache entries", eval_cache->size()));
+  }
+
+  for (const auto& [sampling_rate_sec, ohlc_history] : ohlc_histories) {
+    if (sampling_rate_sec > 0) {
+      LogInfo(absl::StrFormat("\nSampling rate: %d sec", sampling_rate_sec));
+    }
+    EvaluateOverOhlcHistory(account_config, eval_config, ohlc_history,
+                            side_input.get(), eval_cache.get());
+  }
+
+  if (eval_cache != nullptr) {
+    CheckOk(
+        eval_cache->WriteToFile(absl::GetFlag(FLAGS_evaluation_cache_file)));
+    LogInfo(absl::StrFormat("Saved %d cache entries to: %s", eval_cache->size(),
+                            absl::GetFlag(FLAGS_evaluation_cache_file)));
   }
-  LogInfo(
-      absl::StrFormat("\nEvaluated in %.3f seconds",
-                      absl::ToDoubleSeconds(absl::Now() - latency_start_time)));
 
   // Optional: Delete all global objects allocated by libprotobuf.
   google::protobuf::ShutdownProtobufLibrary();
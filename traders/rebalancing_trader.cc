@@ -2,15 +2,16 @@
 
 #include "traders/rebalancing_trader.h"
 
+#include <algorithm>
+
 #include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
 
 namespace trader {
 
-void RebalancingTrader::Update(const OhlcTick& ohlc_tick,
-                               const std::vector<float>& side_input_signals,
-                               float base_balance, float quote_balance,
-                               std::vector<Order>& orders) {
+void RebalancingTrader::UpdateAndEmit(
+    const OhlcTick& ohlc_tick, const std::vector<float>& side_input_signals,
+    float base_balance, float quote_balance, OrderBuffer& orders) {
   const int64_t timestamp_sec = ohlc_tick.timestamp_sec();
   const float price = ohlc_tick.close();
   assert(timestamp_sec > last_timestamp_sec_);
@@ -25,43 +26,29 @@ void RebalancingTrader::Update(const OhlcTick& ohlc_tick,
   if (beta > alpha_up) {
     const float market_sell_base_amount =
         ((1 - alpha) * portfolio_value - quote_balance) / price;
-    orders.emplace_back();
-    Order& order = orders.back();
-    order.set_type(Order_Type_MARKET);
-    order.set_side(Order_Side_SELL);
-    order.set_base_amount(market_sell_base_amount);
+    orders.push_back(OrderSpec::Base(Order::MARKET, Order::SELL,
+                                     market_sell_base_amount));
   } else if (beta < alpha_down) {
     const float market_buy_base_amount =
         (quote_balance - (1 - alpha) * portfolio_value) / price;
-    orders.emplace_back();
-    Order& order = orders.back();
-    order.set_type(Order_Type_MARKET);
-    order.set_side(Order_Side_BUY);
-    order.set_base_amount(market_buy_base_amount);
+    orders.push_back(OrderSpec::Base(Order::MARKET, Order::BUY,
+                                     market_buy_base_amount));
   } else if (base_balance > 1.0e-6f && quote_balance > 1.0e-6f) {
     if (alpha * (1 + epsilon) < 1) {
       const float sell_price =
           (alpha * (1 + epsilon) * quote_balance) / (1 - alpha * (1 + epsilon));
       if (sell_price > price && sell_price < 100.0f * price) {
         const float sell_base_amount = base_balance * epsilon / (1 + epsilon);
-        orders.emplace_back();
-        Order& sell_order = orders.back();
-        sell_order.set_type(Order_Type_LIMIT);
-        sell_order.set_side(Order_Side_SELL);
-        sell_order.set_base_amount(sell_base_amount);
-        sell_order.set_price(sell_price);
+        orders.push_back(OrderSpec::Base(Order::LIMIT, Order::SELL,
+                                         sell_base_amount, sell_price));
       }
     }
     const float buy_price =
         (alpha * (1 - epsilon) * quote_balance) / (1 - alpha * (1 - epsilon));
     if (buy_price < price && buy_price > price / 100.0f) {
       const float buy_base_amount = base_balance * epsilon / (1 - epsilon);
-      orders.emplace_back();
-      Order& buy_order = orders.back();
-      buy_order.set_type(Order_Type_LIMIT);
-      buy_order.set_side(Order_Side_BUY);
-      buy_order.set_base_amount(buy_base_amount);
-      buy_order.set_price(buy_price);
+      orders.push_back(OrderSpec::Base(Order::LIMIT, Order::BUY,
+                                       buy_base_amount, buy_price));
     }
   }
   last_base_balance_ = base_balance;
@@ -75,6 +62,16 @@ std::string RebalancingTrader::GetInternalState() const {
                          last_base_balance_, last_quote_balance_, last_close_);
 }
 
+TraderStateSchema RebalancingTrader::GetStateSchema() const {
+  return {{"base_balance", {}}, {"quote_balance", {}}, {"close", {}}};
+}
+
+void RebalancingTrader::GetState(float* state) const {
+  state[0] = last_base_balance_;
+  state[1] = last_quote_balance_;
+  state[2] = last_close_;
+}
+
 std::string RebalancingTraderEmitter::GetName() const {
   return absl::StrFormat("rebalancing-trader[%.3f|%.3f]",
                          trader_config_.alpha(), trader_config_.epsilon());
@@ -87,16 +84,30 @@ std::unique_ptr<Trader> RebalancingTraderEmitter::NewTrader() const {
 std::vector<std::unique_ptr<TraderEmitter>>
 RebalancingTraderEmitter::GetBatchOfTraders(
     const std::vector<float>& alphas, const std::vector<float>& epsilons) {
+  return GetBatchOfTraders(alphas, epsilons, /*begin=*/0,
+                           /*end=*/GetBatchSize(alphas, epsilons));
+}
+
+std::vector<std::unique_ptr<TraderEmitter>>
+RebalancingTraderEmitter::GetBatchOfTraders(
+    const std::vector<float>& alphas, const std::vector<float>& epsilons,
+    size_t begin, size_t end) {
+  end = std::min(end, GetBatchSize(alphas, epsilons));
   std::vector<std::unique_ptr<TraderEmitter>> batch;
-  batch.reserve(alphas.size() * epsilons.size());
-  for (const float alpha : alphas)
-    for (const float epsilon : epsilons) {
-      RebalancingTraderConfig trader_config;
-      trader_config.set_alpha(alpha);
-      trader_config.set_epsilon(epsilon);
-      batch.emplace_back(new RebalancingTraderEmitter(trader_config));
-    }
+  batch.reserve(end > begin ? end - begin : 0);
+  // The last parameter changes the fastest.
+  for (size_t index = begin; index < end; ++index) {
+    RebalancingTraderConfig trader_config;
+    trader_config.set_alpha(alphas[index / epsilons.size()]);
+    trader_config.set_epsilon(epsilons[index % epsilons.size()]);
+    batch.emplace_back(new RebalancingTraderEmitter(trader_config));
+  }
   return batch;
 }
 
+size_t RebalancingTraderEmitter::GetBatchSize(
+    const std::vector<float>& alphas, const std::vector<float>& epsilons) {
+  return alphas.size() * epsilons.size();
+}
+
 }  // namespace trader
@@ -10,16 +10,19 @@ namespace trader {
 
 // RebalancingTrader keeps the base (crypto) currency value to quote value
 // ratio constant.
-class RebalancingTrader : public Trader {
+class RebalancingTrader : public OrderBufferTrader {
  public:
   explicit RebalancingTrader(const RebalancingTraderConfig& trader_config)
       : trader_config_(trader_config) {}
   virtual ~RebalancingTrader() {}
 
-  void Update(const OhlcTick& ohlc_tick,
-              const std::vector<float>& side_input_signals, float base_balance,
-              float quote_balance, std::vector<Order>& orders) override;
+  void UpdateAndEmit(const OhlcTick& ohlc_tick,
+                     const std::vector<float>& side_input_signals,
+                     float base_balance, float quote_balance,
+                     OrderBuffer& orders) override;
   std::string GetInternalState() const override;
+  TraderStateSchema GetStateSchema() const override;
+  void GetState(float* state) const override;
 
  private:
   RebalancingTraderConfig trader_config_;
@@ -43,8 +46,17 @@ class RebalancingTraderEmitter : public TraderEmitter {
   std::string GetName() const override;
   std::unique_ptr<Trader> NewTrader() const override;
 
+  // Returns the batch of emitters spanning all combinations of parameters.
   static std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
       const std::vector<float>& alphas, const std::vector<float>& epsilons);
+  // Returns the emitters [begin, end) of the batch above (without creating
+  // the other emitters).
+  static std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
+      const std::vector<float>& alphas, const std::vector<float>& epsilons,
+      size_t begin, size_t end);
+  // Returns the size of the batch above.
+  static size_t GetBatchSize(const std::vector<float>& alphas,
+                             const std::vector<float>& epsilons);
 
  private:
   RebalancingTraderConfig trader_config_;
@@ -2,15 +2,17 @@
 
 #include "traders/stop_trader.h"
 
+#include <algorithm>
+
 #include "absl/memory/memory.h"
 #include "absl/strings/str_format.h"
 
 namespace trader {
 
-void StopTrader::Update(const OhlcTick& ohlc_tick,
-                        const std::vector<float>& side_input_signals,
-                        float base_balance, float quote_balance,
-                        std::vector<Order>& orders) {
+void StopTrader::UpdateAndEmit(const OhlcTick& ohlc_tick,
+                               const std::vector<float>& side_input_signals,
+                               float base_balance, float quote_balance,
+                               OrderBuffer& orders) {
   const int64_t timestamp_sec = ohlc_tick.timestamp_sec();
   const float price = ohlc_tick.close();
   assert(timestamp_sec > last_timestamp_sec_);
@@ -73,19 +75,15 @@ void StopTrader::UpdateStopOrderPrice(Mode mode, int64_t timestamp_sec,
   }
 }
 
-void StopTrader::EmitStopOrder(float price, std::vector<Order>& orders) const {
-  orders.emplace_back();
-  Order& order = orders.back();
-  order.set_type(Order_Type_STOP);
+void StopTrader::EmitStopOrder(float price, OrderBuffer& orders) const {
   if (mode_ == Mode::LONG) {
-    order.set_side(Order_Side_SELL);
-    order.set_base_amount(last_base_balance_);
+    orders.push_back(OrderSpec::Base(Order::STOP, Order::SELL,
+                                     last_base_balance_, stop_order_price_));
   } else {
     assert(mode_ == Mode::CASH);
-    order.set_side(Order_Side_BUY);
-    order.set_quote_amount(last_quote_balance_);
+    orders.push_back(OrderSpec::Quote(Order::STOP, Order::BUY,
+                                      last_quote_balance_, stop_order_price_));
   }
-  order.set_price(stop_order_price_);
 }
 
 std::string StopTrader::GetInternalState() const {
@@ -95,6 +93,22 @@ std::string StopTrader::GetInternalState() const {
                          stop_order_price_);
 }
 
+TraderStateSchema StopTrader::GetStateSchema() const {
+  return {{"base_balance", {}},
+          {"quote_balance", {}},
+          {"close", {}},
+          {"mode", {"NONE", "LONG", "CASH"}},
+          {"stop_order_price", {}}};
+}
+
+void StopTrader::GetState(float* state) const {
+  state[0] = last_base_balance_;
+  state[1] = last_quote_balance_;
+  state[2] = last_close_;
+  state[3] = static_cast<float>(mode_);
+  state[4] = stop_order_price_;
+}
+
 std::string StopTraderEmitter::GetName() const {
   return absl::StrFormat("stop-trader[%.3f|%.3f|%.3f|%.3f]",
                          trader_config_.stop_order_margin(),
@@ -113,26 +127,54 @@ StopTraderEmitter::GetBatchOfTraders(
     const std::vector<float>& stop_order_move_margins,
     const std::vector<float>& stop_order_increases_per_day,
     const std::vector<float>& stop_order_decreases_per_day) {
+  return GetBatchOfTraders(
+      stop_order_margins, stop_order_move_margins,
+      stop_order_increases_per_day, stop_order_decreases_per_day,
+      /*begin=*/0,
+      /*end=*/GetBatchSize(stop_order_margins, stop_order_move_margins,
+                           stop_order_increases_per_day,
+                           stop_order_decreases_per_day));
+}
+
+std::vector<std::unique_ptr<TraderEmitter>>
+StopTraderEmitter::GetBatchOfTraders(
+    const std::vector<float>& stop_order_margins,
+    const std::vector<float>& stop_order_move_margins,
+    const std::vector<float>& stop_order_increases_per_day,
+    const std::vector<float>& stop_order_decreases_per_day, size_t begin,
+    size_t end) {
+  end = std::min(end, GetBatchSize(stop_order_margins, stop_order_move_margins,
+                                   stop_order_increases_per_day,
+                                   stop_order_decreases_per_day));
   std::vector<std::unique_ptr<TraderEmitter>> batch;
-  batch.reserve(stop_order_margins.size() * stop_order_move_margins.size() *
-                stop_order_increases_per_day.size() *
-                stop_order_decreases_per_day.size());
-  for (const float stop_order_margin : stop_order_margins)
-    for (const float stop_order_move_margin : stop_order_move_margins)
-      for (const float stop_order_increase_per_day :
-           stop_order_increases_per_day)
-        for (const float stop_order_decrease_per_day :
-             stop_order_decreases_per_day) {
-          StopTraderConfig trader_config;
-          trader_config.set_stop_order_margin(stop_order_margin);
-          trader_config.set_stop_order_move_margin(stop_order_move_margin);
-          trader_config.set_stop_order_increase_per_day(
-              stop_order_increase_per_day);
-          trader_config.set_stop_order_decrease_per_day(
-              stop_order_decrease_per_day);
-          batch.emplace_back(new StopTraderEmitter(trader_config));
-        }
+  batch.reserve(end > begin ? end - begin : 0);
+  // The last parameter changes the fastest.
+  for (size_t index = begin; index < end; ++index) {
+    size_t i = index;
+    StopTraderConfig trader_config;
+    trader_config.set_stop_order_decrease_per_day(
+        stop_order_decreases_per_day[i % stop_order_decreases_per_day.size()]);
+    i /= stop_order_decreases_per_day.size();
+    trader_config.set_stop_order_increase_per_day(
+        stop_order_increases_per_day[i % stop_order_increases_per_day.size()]);
+    i /= stop_order_increases_per_day.size();
+    trader_config.set_stop_order_move_margin(
+        stop_order_move_margins[i % stop_order_move_margins.size()]);
+    i /= stop_order_move_margins.size();
+    trader_config.set_stop_order_margin(stop_order_margins[i]);
+    batch.emplace_back(new StopTraderEmitter(trader_config));
+  }
   return batch;
 }
 
+size_t StopTraderEmitter::GetBatchSize(
+    const std::vector<float>& stop_order_margins,
+    const std::vector<float>& stop_order_move_margins,
+    const std::vector<float>& stop_order_increases_per_day,
+    const std::vector<float>& stop_order_decreases_per_day) {
+  return stop_order_margins.size() * stop_order_move_margins.size() *
+         stop_order_increases_per_day.size() *
+         stop_order_decreases_per_day.size();
+}
+
 }  // namespace trader
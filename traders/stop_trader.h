@@ -9,16 +9,19 @@
 namespace trader {
 
 // Stop trader. Emits exactly one stop order per OHLC tick.
-class StopTrader : public Trader {
+class StopTrader : public OrderBufferTrader {
  public:
   explicit StopTrader(const StopTraderConfig& trader_config)
       : trader_config_(trader_config) {}
   virtual ~StopTrader() {}
 
-  void Update(const OhlcTick& ohlc_tick,
-              const std::vector<float>& side_input_signals, float base_balance,
-              float quote_balance, std::vector<Order>& orders) override;
+  void UpdateAndEmit(const OhlcTick& ohlc_tick,
+                     const std::vector<float>& side_input_signals,
+                     float base_balance, float quote_balance,
+                     OrderBuffer& orders) override;
   std::string GetInternalState() const override;
+  TraderStateSchema GetStateSchema() const override;
+  void GetState(float* state) const override;
 
  private:
   // Enumeration of possible trader modes.
@@ -48,7 +51,7 @@ class StopTrader : public Trader {
   // Updates the trader stop order price.
   void UpdateStopOrderPrice(Mode mode, int64_t timestamp_sec, float price);
   // Emits the stop order based on the (updated) internal trader state.
-  void EmitStopOrder(float price, std::vector<Order>& orders) const;
+  void EmitStopOrder(float price, OrderBuffer& orders) const;
 };
 
 // Emitter that emits StopTraders.
@@ -61,11 +64,26 @@ class StopTraderEmitter : public TraderEmitter {
   std::string GetName() const override;
   std::unique_ptr<Trader> NewTrader() const override;
 
+  // Returns the batch of emitters spanning all combinations of parameters.
   static std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
       const std::vector<float>& stop_order_margins,
       const std::vector<float>& stop_order_move_margins,
       const std::vector<float>& stop_order_increases_per_day,
       const std::vector<float>& stop_order_decreases_per_day);
+  // Returns the emitters [begin, end) of the batch above (without creating
+  // the other emitters).
+  static std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
+      const std::vector<float>& stop_order_margins,
+      const std::vector<float>& stop_order_move_margins,
+      const std::vector<float>& stop_order_increases_per_day,
+      const std::vector<float>& stop_order_decreases_per_day, size_t begin,
+      size_t end);
+  // Returns the size of the batch above.
+  static size_t GetBatchSize(
+      const std::vector<float>& stop_order_margins,
+      const std::vector<float>& stop_order_move_margins,
+      const std::vector<float>& stop_order_increases_per_day,
+      const std::vector<float>& stop_order_decreases_per_day);
 
  private:
   StopTraderConfig trader_config_;
@@ -2,6 +2,9 @@
 
 #include "traders/trader_factory.h"
 
+#include <cmath>
+#include <random>
+
 #include "traders/rebalancing_trader.h"
 #include "traders/stop_trader.h"
 #include "traders/trader_config.pb.h"
@@ -19,11 +22,25 @@ std::unique_ptr<TraderEmitter> GetDefaultRebalancingTraderEmitter() {
   return std::unique_ptr<TraderEmitter>(new RebalancingTraderEmitter(config));
 }
 
-// Returns the default batch of rebalancing traders.
-std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfRebalancingTraders() {
+// Parameters of the default batch of rebalancing traders.
+struct RebalancingTraderBatchParams {
+  std::vector<float> alphas = {0.1f, 0.3f, 0.5f, 0.7f, 0.9f};
+  std::vector<float> epsilons = {0.01f, 0.05f, 0.1f, 0.2f};
+};
+
+// Returns the rebalancing traders [begin, end) of the default batch.
+std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfRebalancingTraders(
+    size_t begin, size_t end) {
+  const RebalancingTraderBatchParams params;
   return RebalancingTraderEmitter::GetBatchOfTraders(
-      /*alphas=*/{0.1f, 0.3f, 0.5f, 0.7f, 0.9f},
-      /*epsilons=*/{0.01f, 0.05f, 0.1f, 0.2f});
+      params.alphas, params.epsilons, begin, end);
+}
+
+// Returns the size of the default batch of rebalancing traders.
+size_t GetBatchOfRebalancingTradersSize() {
+  const RebalancingTraderBatchParams params;
+  return RebalancingTraderEmitter::GetBatchSize(params.alphas,
+                                                params.epsilons);
 }
 
 // Returns the default stop trader emitter.
@@ -36,13 +53,71 @@ std::unique_ptr<TraderEmitter> GetDefaultStopTraderEmitter() {
   return std::unique_ptr<TraderEmitter>(new StopTraderEmitter(config));
 }
 
-// Returns the default batch of stop traders.
-std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfStopTraders() {
+// Parameters of the default batch of stop traders.
+struct StopTraderBatchParams {
+  std::vector<float> stop_order_margins = {0.05, 0.1, 0.15, 0.2};
+  std::vector<float> stop_order_move_margins = {0.05, 0.1, 0.15, 0.2};
+  std::vector<float> stop_order_increases_per_day = {0.01, 0.05, 0.1};
+  std::vector<float> stop_order_decreases_per_day = {0.01, 0.05, 0.1};
+};
+
+// Returns the stop traders [begin, end) of the default batch.
+std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfStopTraders(
+    size_t begin, size_t end) {
+  const StopTraderBatchParams params;
   return StopTraderEmitter::GetBatchOfTraders(
-      /*stop_order_margins=*/{0.05, 0.1, 0.15, 0.2},
-      /*stop_order_move_margins=*/{0.05, 0.1, 0.15, 0.2},
-      /*stop_order_increases_per_day=*/{0.01, 0.05, 0.1},
-      /*stop_order_decreases_per_day=*/{0.01, 0.05, 0.1});
+      params.stop_order_margins, params.stop_order_move_margins,
+      params.stop_order_increases_per_day, params.stop_order_decreases_per_day,
+      begin, end);
+}
+
+// Returns the size of the default batch of stop traders.
+size_t GetBatchOfStopTradersSize() {
+  const StopTraderBatchParams params;
+  return StopTraderEmitter::GetBatchSize(
+      params.stop_order_margins, params.stop_order_move_margins,
+      params.stop_order_increases_per_day,
+      params.stop_order_decreases_per_day);
+}
+
+// Returns a random parameter sampled uniformly from [min_value, max_value]
+// and rounded to 3 decimal places (as in the trader names), so that traders
+// with the same name have the same configuration.
+float GetRandomParameter(float min_value, float max_value, std::mt19937& rng) {
+  std::uniform_real_distribution<float> distribution(min_value, max_value);
+  return std::round(distribution(rng) * 1000.0f) / 1000.0f;
+}
+
+// Returns the batch of rebalancing traders with random parameters.
+std::vector<std::unique_ptr<TraderEmitter>> GetRandomBatchOfRebalancingTraders(
+    int batch_size, std::mt19937& rng) {
+  std::vector<std::unique_ptr<TraderEmitter>> batch;
+  batch.reserve(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    RebalancingTraderConfig config;
+    config.set_alpha(GetRandomParameter(0.1f, 0.9f, rng));
+    config.set_epsilon(GetRandomParameter(0.01f, 0.2f, rng));
+    batch.emplace_back(new RebalancingTraderEmitter(config));
+  }
+  return batch;
+}
+
+// Returns the batch of stop traders with random parameters.
+std::vector<std::unique_ptr<TraderEmitter>> GetRandomBatchOfStopTraders(
+    int batch_size, std::mt19937& rng) {
+  std::vector<std::unique_ptr<TraderEmitter>> batch;
+  batch.reserve(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    StopTraderConfig config;
+    config.set_stop_order_margin(GetRandomParameter(0.05f, 0.2f, rng));
+    config.set_stop_order_move_margin(GetRandomParameter(0.05f, 0.2f, rng));
+    config.set_stop_order_increase_per_day(
+        GetRandomParameter(0.01f, 0.1f, rng));
+    config.set_stop_order_decrease_per_day(
+        GetRandomParameter(0.01f, 0.1f, rng));
+    batch.emplace_back(new StopTraderEmitter(config));
+  }
+  return batch;
 }
 }  // namespace
 
@@ -57,11 +132,37 @@ std::unique_ptr<TraderEmitter> GetTrader(absl::string_view trader_name) {
 
 std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
     absl::string_view trader_name) {
+  return GetBatchOfTraders(trader_name, /*begin=*/0,
+                           /*end=*/GetBatchOfTradersSize(trader_name));
+}
+
+std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
+    absl::string_view trader_name, size_t begin, size_t end) {
+  if (trader_name == kRebalancingTraderName) {
+    return GetBatchOfRebalancingTraders(begin, end);
+  } else {
+    assert(trader_name == kStopTraderName);
+    return GetBatchOfStopTraders(begin, end);
+  }
+}
+
+size_t GetBatchOfTradersSize(absl::string_view trader_name) {
+  if (trader_name == kRebalancingTraderName) {
+    return GetBatchOfRebalancingTradersSize();
+  } else {
+    assert(trader_name == kStopTraderName);
+    return GetBatchOfStopTradersSize();
+  }
+}
+
+std::vector<std::unique_ptr<TraderEmitter>> GetRandomBatchOfTraders(
+    absl::string_view trader_name, int batch_size, int seed) {
+  std::mt19937 rng(seed);
   if (trader_name == kRebalancingTraderName) {
-    return GetBatchOfRebalancingTraders();
+    return GetRandomBatchOfRebalancingTraders(batch_size, rng);
   } else {
     assert(trader_name == kStopTraderName);
-    return GetBatchOfStopTraders();
+    return GetRandomBatchOfStopTraders(batch_size, rng);
   }
 }
 
@@ -15,6 +15,22 @@ std::unique_ptr<TraderEmitter> GetTrader(absl::string_view trader_name);
 std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
     absl::string_view trader_name);
 
+// Returns the TraderEmitters [begin, end) of the batch for the given
+// trader_name (e.g. a shard of the batch) without creating the other
+// TraderEmitters of the batch.
+std::vector<std::unique_ptr<TraderEmitter>> GetBatchOfTraders(
+    absl::string_view trader_name, size_t begin, size_t end);
+
+// Returns the size of the batch for the given trader_name (without creating
+// the TraderEmitters).
+size_t GetBatchOfTradersSize(absl::string_view trader_name);
+
+// Returns batch of batch_size TraderEmitters for the given trader_name with
+// parameters sampled uniformly at random (using the given seed) from the
+// parameter ranges spanned by the batch returned by GetBatchOfTraders.
+std::vector<std::unique_ptr<TraderEmitter>> GetRandomBatchOfTraders(
+    absl::string_view trader_name, int batch_size, int seed);
+
 }  // namespace trader
 
 #endif  // TRADERS_TRADER_FACTORY_H
@@ -0,0 +1,129 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "util/executor.h"
+
+#include <algorithm>
+
+namespace trader {
+namespace {
+// Executor and the index of the worker running on the current thread.
+thread_local const WorkStealingExecutor* current_executor = nullptr;
+thread_local size_t current_worker_index = 0;
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(new Worker());
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread = std::thread([this, i]() { RunWorker(i); });
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_available_.notify_all();
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void WorkStealingExecutor::Schedule(std::function<void()> task) {
+  const size_t worker_index =
+      current_executor == this
+          ? current_worker_index
+          : next_worker_index_.fetch_add(1, std::memory_order_relaxed) %
+                workers_.size();
+  // The counters are incremented before the task is queued, so that they are
+  // never lower than the actual numbers of queued (and pending) tasks.
+  num_pending_tasks_.fetch_add(1);
+  num_queued_tasks_.fetch_add(1);
+  {
+    Worker& worker = *workers_[worker_index];
+    std::lock_guard<std::mutex> worker_lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  }
+  // A worker going to sleep increments num_sleeping_workers_ before checking
+  // num_queued_tasks_ (under the mutex_), so either it sees the new task, or
+  // it is seen here (and then woken up after it starts waiting).
+  if (num_sleeping_workers_.load() > 0) {
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    work_available_.notify_one();
+  }
+}
+
+void WorkStealingExecutor::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(lock, [this]() { return num_pending_tasks_.load() == 0; });
+}
+
+void WorkStealingExecutor::ParallelFor(
+    size_t num_tasks, const std::function<void(size_t)>& task) {
+  for (size_t i = 0; i < num_tasks; ++i) {
+    Schedule([&task, i]() { task(i); });
+  }
+  Wait();
+}
+
+bool WorkStealingExecutor::TakeTask(size_t worker_index,
+                                    std::function<void()>& task) {
+  bool found = false;
+  {
+    Worker& worker = *workers_[worker_index];
+    std::lock_guard<std::mutex> worker_lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      found = true;
+    }
+  }
+  for (size_t offset = 1; !found && offset < workers_.size(); ++offset) {
+    Worker& victim = *workers_[(worker_index + offset) % workers_.size()];
+    std::lock_guard<std::mutex> victim_lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      found = true;
+    }
+  }
+  if (found) {
+    num_queued_tasks_.fetch_sub(1);
+  }
+  return found;
+}
+
+void WorkStealingExecutor::RunWorker(size_t worker_index) {
+  current_executor = this;
+  current_worker_index = worker_index;
+  while (true) {
+    std::function<void()> task;
+    if (TakeTask(worker_index, task)) {
+      task();
+      if (num_pending_tasks_.fetch_sub(1) == 1) {
+        // Waiters check num_pending_tasks_ under the mutex_.
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        work_done_.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    num_sleeping_workers_.fetch_add(1);
+    work_available_.wait(lock, [this]() {
+      return stopping_ || num_queued_tasks_.load() > 0;
+    });
+    num_sleeping_workers_.fetch_sub(1);
+    if (stopping_ && num_queued_tasks_.load() == 0) {
+      return;
+    }
+  }
+}
+
+}  // namespace trader
@@ -0,0 +1,90 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef UTIL_EXECUTOR_H
+#define UTIL_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace trader {
+
+// Bounded work-stealing thread pool.
+// Every worker thread has its own task deque. Tasks scheduled from outside of
+// the pool are distributed among the workers in a round-robin fashion, tasks
+// scheduled from within a worker are added to its own deque. A worker takes
+// tasks from the back of its own deque and, when it runs out of work, steals
+// tasks from the front of the other workers' deques.
+// Every deque is guarded by its own mutex, so that the workers schedule, take,
+// and steal tasks concurrently. The (global) executor mutex is used only by
+// the idle workers going to sleep (and by the threads waking them up or
+// waiting for all tasks to finish).
+// The worker threads are started in the constructor and live until the
+// executor is destroyed (after all scheduled tasks are finished).
+class WorkStealingExecutor {
+ public:
+  // Starts num_threads worker threads. If num_threads is not positive, the
+  // number of hardware threads is used.
+  explicit WorkStealingExecutor(int num_threads);
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+  // Waits for all scheduled tasks and joins the worker threads.
+  ~WorkStealingExecutor();
+
+  // Returns the number of worker threads.
+  int num_threads() const { return static_cast<int>(workers_.size()); }
+
+  // Schedules the task for (asynchronous) execution. Thread-safe.
+  void Schedule(std::function<void()> task);
+
+  // Blocks until all scheduled tasks (including the tasks scheduled by other
+  // tasks) are finished. Must not be called from within a task.
+  void Wait();
+
+  // Executes task(i) for every i in [0, num_tasks) and waits until all of them
+  // are finished. Must not be called from within a task.
+  void ParallelFor(size_t num_tasks, const std::function<void(size_t)>& task);
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    std::thread thread;
+  };
+
+  // Main loop of the worker_index-th worker thread.
+  void RunWorker(size_t worker_index);
+  // Takes a task from the worker's own deque or steals one from the others.
+  bool TakeTask(size_t worker_index, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Index of the next worker (for the round-robin scheduling).
+  std::atomic<size_t> next_worker_index_{0};
+  // Number of tasks in the deques (possibly including tasks being queued).
+  std::atomic<int64_t> num_queued_tasks_{0};
+  // Number of scheduled tasks that are not finished yet.
+  std::atomic<int64_t> num_pending_tasks_{0};
+  // Number of workers sleeping (or going to sleep) on work_available_.
+  std::atomic<int> num_sleeping_workers_{0};
+
+  // Used for sleeping and waking up (see the condition variables below).
+  std::mutex mutex_;
+  // Signaled when a new task is scheduled (and some workers are sleeping) or
+  // when the executor is stopping.
+  std::condition_variable work_available_;
+  // Signaled when all scheduled tasks are finished.
+  std::condition_variable work_done_;
+  // True iff the executor is being destroyed. Guarded by the mutex_.
+  bool stopping_ = false;
+};
+
+}  // namespace trader
+
+#endif  // UTIL_EXECUTOR_H
@@ -0,0 +1,88 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "util/executor.h"
+
+#include <chrono>
+#include <set>
+
+#include "gtest/gtest.h"
+
+namespace trader {
+
+TEST(WorkStealingExecutorTest, NumThreads) {
+  EXPECT_EQ(WorkStealingExecutor(3).num_threads(), 3);
+  EXPECT_GE(WorkStealingExecutor(0).num_threads(), 1);
+}
+
+TEST(WorkStealingExecutorTest, ScheduleAndWait) {
+  for (const int num_threads : {1, 2, 4}) {
+    WorkStealingExecutor executor(num_threads);
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 1000; ++i) {
+      executor.Schedule([&counter]() { ++counter; });
+    }
+    executor.Wait();
+    EXPECT_EQ(counter.load(), 1000);
+    // The executor can be reused after Wait.
+    for (int i = 0; i < 100; ++i) {
+      executor.Schedule([&counter]() { ++counter; });
+    }
+    executor.Wait();
+    EXPECT_EQ(counter.load(), 1100);
+  }
+}
+
+TEST(WorkStealingExecutorTest, NestedSchedule) {
+  WorkStealingExecutor executor(4);
+  std::atomic<int> counter(0);
+  for (int i = 0; i < 10; ++i) {
+    executor.Schedule([&executor, &counter]() {
+      for (int j = 0; j < 100; ++j) {
+        executor.Schedule([&counter]() { ++counter; });
+      }
+    });
+  }
+  executor.Wait();
+  EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(WorkStealingExecutorTest, ParallelFor) {
+  WorkStealingExecutor executor(3);
+  std::vector<int> values(1000, 0);
+  executor.ParallelFor(values.size(), [&values](size_t i) { values[i] = i; });
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(WorkStealingExecutorTest, UnevenTasksAreStolen) {
+  // All tasks are scheduled to the same worker (via the nested schedule).
+  // The remaining workers need to steal them.
+  WorkStealingExecutor executor(4);
+  std::mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  executor.Schedule([&]() {
+    for (int i = 0; i < 200; ++i) {
+      executor.Schedule([&]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        std::lock_guard<std::mutex> lock(mutex);
+        thread_ids.insert(std::this_thread::get_id());
+      });
+    }
+  });
+  executor.Wait();
+  EXPECT_GT(thread_ids.size(), 1);
+}
+
+TEST(WorkStealingExecutorTest, DestructorFinishesTasks) {
+  std::atomic<int> counter(0);
+  {
+    WorkStealingExecutor executor(2);
+    for (int i = 0; i < 100; ++i) {
+      executor.Schedule([&counter]() { ++counter; });
+    }
+  }
+  EXPECT_EQ(counter.load(), 100);
+}
+
+}  // namespace trader
@@ -0,0 +1,23 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "util/fingerprint.h"
+
+namespace trader {
+namespace {
+// FNV-1a 64-bit prime.
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+}  // namespace
+
+void Fingerprinter::AddBytes(const void* data, size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    fingerprint_ = (fingerprint_ ^ bytes[i]) * kFnvPrime;
+  }
+}
+
+void Fingerprinter::AddString(std::string_view value) {
+  Add(static_cast<uint64_t>(value.size()));
+  AddBytes(value.data(), value.size());
+}
+
+}  // namespace trader
@@ -0,0 +1,42 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef UTIL_FINGERPRINT_H
+#define UTIL_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace trader {
+
+// Computes a 64-bit fingerprint (FNV-1a hash) of a sequence of values.
+// Unlike std::hash, the fingerprint is stable across runs and platforms
+// (with the same endianness), so it can be persisted on disk.
+class Fingerprinter {
+ public:
+  Fingerprinter() {}
+
+  // Adds the given bytes to the fingerprint.
+  void AddBytes(const void* data, size_t size);
+  // Adds the (length-prefixed) string to the fingerprint.
+  void AddString(std::string_view value);
+  // Adds the object representation of the (trivially-copyable) value.
+  template <typename T>
+  void Add(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Fingerprinted values must be trivially copyable");
+    AddBytes(&value, sizeof(T));
+  }
+
+  // Returns the fingerprint of all the values added so far.
+  uint64_t fingerprint() const { return fingerprint_; }
+
+ private:
+  // FNV-1a 64-bit offset basis.
+  uint64_t fingerprint_ = 14695981039346656037ULL;
+};
+
+}  // namespace trader
+
+#endif  // UTIL_FINGERPRINT_H
@@ -0,0 +1,44 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "util/fingerprint.h"
+
+#include "gtest/gtest.h"
+
+namespace trader {
+
+TEST(FingerprinterTest, KnownValues) {
+  // Reference values of the FNV-1a 64-bit hash.
+  Fingerprinter empty;
+  EXPECT_EQ(empty.fingerprint(), 0xcbf29ce484222325ULL);
+  Fingerprinter fingerprinter;
+  fingerprinter.AddBytes("a", 1);
+  EXPECT_EQ(fingerprinter.fingerprint(), 0xaf63dc4c8601ec8cULL);
+  fingerprinter.AddBytes("bc", 2);
+  Fingerprinter abc;
+  abc.AddBytes("abc", 3);
+  EXPECT_EQ(fingerprinter.fingerprint(), abc.fingerprint());
+}
+
+TEST(FingerprinterTest, StringsAreLengthPrefixed) {
+  Fingerprinter ab_c;
+  ab_c.AddString("ab");
+  ab_c.AddString("c");
+  Fingerprinter a_bc;
+  a_bc.AddString("a");
+  a_bc.AddString("bc");
+  EXPECT_NE(ab_c.fingerprint(), a_bc.fingerprint());
+}
+
+TEST(FingerprinterTest, Values) {
+  Fingerprinter first;
+  first.Add<int64_t>(1483228800);
+  first.Add(100.5f);
+  Fingerprinter second;
+  second.Add<int64_t>(1483228800);
+  second.Add(100.5f);
+  EXPECT_EQ(first.fingerprint(), second.fingerprint());
+  second.Add(1.0f);
+  EXPECT_NE(first.fingerprint(), second.fingerprint());
+}
+
+}  // namespace trader
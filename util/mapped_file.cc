@@ -0,0 +1,82 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "util/mapped_file.h"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "absl/strings/str_format.h"
+
+namespace trader {
+
+#ifdef _WIN32
+absl::StatusOr<std::unique_ptr<MappedFile>> MappedFile::Open(
+    const std::string& file_name) {
+  std::ifstream infile(file_name, std::ios::in | std::ios::binary);
+  if (!infile.is_open()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot open the file: %s", file_name));
+  }
+  infile.seekg(0, std::ios::end);
+  const size_t size = static_cast<size_t>(infile.tellg());
+  infile.seekg(0, std::ios::beg);
+  // Buffer of 8-byte words so that the data is suitably aligned.
+  uint64_t* buffer = new uint64_t[(size + 7) / 8 + 1];
+  char* data = reinterpret_cast<char*>(buffer);
+  if (!infile.read(data, size)) {
+    delete[] buffer;
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot read the file: %s", file_name));
+  }
+  return std::unique_ptr<MappedFile>(new MappedFile(data, size));
+}
+
+MappedFile::~MappedFile() {
+  delete[] reinterpret_cast<const uint64_t*>(data_);
+}
+#else
+absl::StatusOr<std::unique_ptr<MappedFile>> MappedFile::Open(
+    const std::string& file_name) {
+  const int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot open the file: %s", file_name));
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Cannot stat the file: %s", file_name));
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  if (size == 0) {
+    close(fd);
+    return std::unique_ptr<MappedFile>(new MappedFile(nullptr, 0));
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the file descriptor is closed.
+  close(fd);
+  if (data == MAP_FAILED) {
+    return absl::InternalError(
+        absl::StrFormat("Cannot mmap the file: %s", file_name));
+  }
+  return std::unique_ptr<MappedFile>(
+      new MappedFile(static_cast<const char*>(data), size));
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+#endif
+
+}  // namespace trader
@@ -0,0 +1,43 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#ifndef UTIL_MAPPED_FILE_H
+#define UTIL_MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/status/statusor.h"
+
+namespace trader {
+
+// Read-only memory-mapped file. The file content is mapped into the address
+// space of the process (as a shared mapping), i.e. pages are loaded lazily by
+// the OS on first access and multiple processes reading the same file share
+// the same page-cache copy. The mapped data is (at least) page-aligned.
+// On platforms without mmap the whole file is read into an aligned buffer.
+class MappedFile {
+ public:
+  // Maps the given file into memory.
+  static absl::StatusOr<std::unique_ptr<MappedFile>> Open(
+      const std::string& file_name);
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  // Returns the pointer to the beginning of the mapped file content.
+  const char* data() const { return data_; }
+  // Returns the size of the mapped file (in bytes).
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(const char* data, size_t size) : data_(data), size_(size) {}
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace trader
+
+#endif  // UTIL_MAPPED_FILE_H
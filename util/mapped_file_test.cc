@@ -0,0 +1,44 @@
+// Copyright © 2023 Peter Cerno. All rights reserved.
+
+#include "util/mapped_file.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+namespace trader {
+namespace {
+std::string WriteTempFile(const std::string& name,
+                          const std::string& content) {
+  const std::string file_name = ::testing::TempDir() + name;
+  std::ofstream outfile(file_name, std::ios::out | std::ios::binary);
+  outfile.write(content.data(), content.size());
+  return file_name;
+}
+}  // namespace
+
+TEST(MappedFileTest, OpenAndRead) {
+  const std::string content("Hello\0World\n12345", 17);
+  const std::string file_name = WriteTempFile("mapped_file_test", content);
+  absl::StatusOr<std::unique_ptr<MappedFile>> mapped_file_status =
+      MappedFile::Open(file_name);
+  ASSERT_TRUE(mapped_file_status.ok());
+  const MappedFile& mapped_file = *mapped_file_status.value();
+  ASSERT_EQ(mapped_file.size(), content.size());
+  EXPECT_EQ(std::string(mapped_file.data(), mapped_file.size()), content);
+}
+
+TEST(MappedFileTest, OpenEmptyFile) {
+  const std::string file_name = WriteTempFile("mapped_file_test_empty", "");
+  absl::StatusOr<std::unique_ptr<MappedFile>> mapped_file_status =
+      MappedFile::Open(file_name);
+  ASSERT_TRUE(mapped_file_status.ok());
+  EXPECT_EQ(mapped_file_status.value()->size(), 0);
+}
+
+TEST(MappedFileTest, OpenMissingFile) {
+  EXPECT_FALSE(
+      MappedFile::Open(::testing::TempDir() + "mapped_file_test_missing").ok());
+}
+
+}  // namespace trader
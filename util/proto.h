@@ -13,9 +13,11 @@
 #include <google/protobuf/util/delimited_message_util.h>
 
 #include <cassert>
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -64,6 +66,52 @@ absl::Status ReadDelimitedMessagesFromIStream(
   return absl::OkStatus();
 }
 
+// Input stream decompressing the (compressed) input stream, as written by
+// WriteDelimitedMessagesToOStream or DelimitedMessageWriter. Without zlib,
+// the input stream is read as is.
+class DecompressingInputStream
+    : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  // Does not take ownership of the input_stream, which must outlive this
+  // stream.
+  explicit DecompressingInputStream(
+      google::protobuf::io::ZeroCopyInputStream* input_stream)
+#ifdef HAVE_ZLIB
+      : gzip_stream_(input_stream), stream_(&gzip_stream_) {}
+#else
+      : stream_(input_stream) {}
+#endif
+  DecompressingInputStream(const DecompressingInputStream&) = delete;
+  DecompressingInputStream& operator=(const DecompressingInputStream&) = delete;
+
+  bool Next(const void** data, int* size) override {
+    return stream_->Next(data, size);
+  }
+  void BackUp(int count) override { stream_->BackUp(count); }
+  bool Skip(int count) override { return stream_->Skip(count); }
+  int64_t ByteCount() const override { return stream_->ByteCount(); }
+
+  // Returns true iff the decompression failed (e.g. on corrupted data).
+  // A truncated input stream is not a failure, since it simply ends
+  // the decompressed stream.
+  bool failed() const {
+#ifdef HAVE_ZLIB
+    const int error_code = gzip_stream_.ZlibErrorCode();
+    return error_code != Z_OK && error_code != Z_STREAM_END &&
+           error_code != Z_BUF_ERROR;
+#else
+    return false;
+#endif
+  }
+
+ private:
+#ifdef HAVE_ZLIB
+  google::protobuf::io::GzipInputStream gzip_stream_;
+#endif
+  // Decompressed stream.
+  google::protobuf::io::ZeroCopyInputStream* stream_;
+};
+
 // Reads delimited messages from the (compressed) input stream.
 template <typename T>
 absl::Status ReadDelimitedMessagesFromIStream(std::istream& stream,
@@ -143,6 +191,127 @@ absl::Status WriteDelimitedMessagesToFile(InputIterator first,
   return WriteDelimitedMessagesToOStream(first, last, out_fstream, compress);
 }
 
+// Incrementally writes (and compresses) delimited messages to the output file,
+// i.e. the messages do not need to be kept in memory.
+class DelimitedMessageWriter {
+ public:
+  // Opens (truncates) the output file.
+  static absl::StatusOr<std::unique_ptr<DelimitedMessageWriter>> Open(
+      const std::string& file_name, bool compress) {
+    std::unique_ptr<DelimitedMessageWriter> writer(
+        new DelimitedMessageWriter(file_name, compress));
+    if (!writer->out_fstream_) {
+      writer->closed_ = true;
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Cannot open the output file: %s", file_name));
+    }
+    writer->OpenStreams();
+    return writer;
+  }
+  DelimitedMessageWriter(const DelimitedMessageWriter&) = delete;
+  DelimitedMessageWriter& operator=(const DelimitedMessageWriter&) = delete;
+  ~DelimitedMessageWriter() { Close().IgnoreError(); }
+
+  // Returns the number of written messages.
+  size_t num_messages() const { return num_messages_; }
+
+  // Writes the (delimited) message to the output file.
+  absl::Status Write(const google::protobuf::MessageLite& message) {
+    assert(!closed_);
+    if (!google::protobuf::util::SerializeDelimitedToZeroCopyStream(
+            message, output_stream())) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Cannot serialize the message to the file: %s",
+                          file_name_));
+    }
+    ++num_messages_;
+    return absl::OkStatus();
+  }
+
+  // Flushes all messages written so far to the output file, so that they can
+  // be read back even if the writer is never closed (e.g. if the process gets
+  // killed). Every flush completes the current gzip member and starts a new
+  // one (concatenated gzip members are read back as a single stream).
+  absl::Status Flush() {
+    assert(!closed_);
+    const bool streams_closed = CloseStreams();
+    out_fstream_.flush();
+    if (!streams_closed || out_fstream_.fail()) {
+      closed_ = true;
+      return absl::InternalError(
+          absl::StrFormat("Cannot write to the file: %s", file_name_));
+    }
+    OpenStreams();
+    return absl::OkStatus();
+  }
+
+  // Flushes (and closes) the output file. Called by the destructor.
+  absl::Status Close() {
+    if (closed_) {
+      return absl::OkStatus();
+    }
+    closed_ = true;
+    const bool streams_closed = CloseStreams();
+    out_fstream_.close();
+    if (!streams_closed || out_fstream_.fail()) {
+      return absl::InternalError(
+          absl::StrFormat("Cannot write to the file: %s", file_name_));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  DelimitedMessageWriter(const std::string& file_name, bool compress)
+      : file_name_(file_name),
+        compress_(compress),
+        out_fstream_(file_name,
+                     std::ios::out | std::ios::trunc | std::ios::binary) {}
+
+  // Opens the (compressed) output stream on top of the output file.
+  void OpenStreams() {
+    out_stream_.reset(new google::protobuf::io::OstreamOutputStream(
+        &out_fstream_));
+#ifdef HAVE_ZLIB
+    google::protobuf::io::GzipOutputStream::Options options;
+    options.format = google::protobuf::io::GzipOutputStream::GZIP;
+    options.compression_level = compress_ ? Z_DEFAULT_COMPRESSION : 0;
+    gzip_stream_.reset(
+        new google::protobuf::io::GzipOutputStream(out_stream_.get(), options));
+#endif
+  }
+
+  // Closes the (compressed) output stream, writing all buffered data into
+  // the output file. Returns false on failure.
+  bool CloseStreams() {
+#ifdef HAVE_ZLIB
+    const bool gzip_closed = gzip_stream_->Close();
+    gzip_stream_.reset();
+#else
+    const bool gzip_closed = true;
+#endif
+    out_stream_.reset();
+    return gzip_closed;
+  }
+
+  google::protobuf::io::ZeroCopyOutputStream* output_stream() {
+#ifdef HAVE_ZLIB
+    return gzip_stream_.get();
+#else
+    return out_stream_.get();
+#endif
+  }
+
+  std::string file_name_;
+  bool compress_;
+  std::fstream out_fstream_;
+  std::unique_ptr<google::protobuf::io::OstreamOutputStream> out_stream_;
+#ifdef HAVE_ZLIB
+  std::unique_ptr<google::protobuf::io::GzipOutputStream> gzip_stream_;
+#endif
+  size_t num_messages_ = 0;
+  bool closed_ = false;
+};
+
 }  // namespace trader
 
 #endif  // UTIL_PROTO_H
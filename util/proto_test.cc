@@ -65,4 +65,125 @@ TEST(ReadWriteDelimitedTest, ReadWriteMultipleOhlcTicks) {
   }
 }
 
+TEST(DelimitedMessageWriterTest, WriteAndReadFile) {
+  static constexpr int kNumRecords = 1000;
+  const std::string file_name =
+      ::testing::TempDir() + "delimited_message_writer_test.dpb";
+  for (const bool compress : {false, true}) {
+    {
+      absl::StatusOr<std::unique_ptr<DelimitedMessageWriter>> writer_status =
+          DelimitedMessageWriter::Open(file_name, compress);
+      ASSERT_TRUE(writer_status.ok());
+      DelimitedMessageWriter& writer = *writer_status.value();
+      PriceRecord price_record;
+      for (int i = 0; i < kNumRecords; ++i) {
+        price_record.set_timestamp_sec(1483228800 + 60 * i);
+        price_record.set_price(700.0f + i);
+        price_record.set_volume(1.5e4f);
+        ASSERT_TRUE(writer.Write(price_record).ok());
+      }
+      EXPECT_EQ(writer.num_messages(), kNumRecords);
+      ASSERT_TRUE(writer.Close().ok());
+    }
+    std::vector<PriceRecord> messages;
+    ASSERT_TRUE(ReadDelimitedMessagesFromFile(file_name, messages).ok());
+    ASSERT_EQ(messages.size(), kNumRecords);
+    for (int i = 0; i < kNumRecords; ++i) {
+      EXPECT_EQ(messages[i].timestamp_sec(), 1483228800 + 60 * i);
+      EXPECT_FLOAT_EQ(messages[i].price(), 700.0f + i);
+      EXPECT_FLOAT_EQ(messages[i].volume(), 1.5e4f);
+    }
+  }
+}
+
+TEST(DelimitedMessageWriterTest, FlushBeforeClose) {
+  const std::string file_name =
+      ::testing::TempDir() + "delimited_message_writer_flush_test.dpb";
+  for (const bool compress : {false, true}) {
+    absl::StatusOr<std::unique_ptr<DelimitedMessageWriter>> writer_status =
+        DelimitedMessageWriter::Open(file_name, compress);
+    ASSERT_TRUE(writer_status.ok());
+    DelimitedMessageWriter& writer = *writer_status.value();
+    PriceRecord price_record;
+    for (int i = 0; i < 10; ++i) {
+      price_record.set_timestamp_sec(1483228800 + 60 * i);
+      ASSERT_TRUE(writer.Write(price_record).ok());
+      if (i % 3 == 2) {
+        ASSERT_TRUE(writer.Flush().ok());
+        // All flushed messages can be read back before the writer is closed.
+        std::vector<PriceRecord> messages;
+        ASSERT_TRUE(ReadDelimitedMessagesFromFile(file_name, messages).ok());
+        ASSERT_EQ(messages.size(), i + 1);
+        EXPECT_EQ(messages.back().timestamp_sec(), 1483228800 + 60 * i);
+      }
+    }
+    ASSERT_TRUE(writer.Close().ok());
+    std::vector<PriceRecord> messages;
+    ASSERT_TRUE(ReadDelimitedMessagesFromFile(file_name, messages).ok());
+    ASSERT_EQ(messages.size(), 10);
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(messages[i].timestamp_sec(), 1483228800 + 60 * i);
+    }
+  }
+}
+
+TEST(DelimitedMessageWriterTest, CannotOpenFile) {
+  EXPECT_FALSE(DelimitedMessageWriter::Open(
+                   ::testing::TempDir() + "missing/directory/file.dpb",
+                   /*compress=*/true)
+                   .ok());
+}
+
+TEST(ReadDelimitedTest, EmptyMessages) {
+  std::ostringstream oss;
+  std::vector<PriceRecord> input_messages(5);
+  input_messages[0].set_price(700.0f);
+  input_messages[3].set_price(800.0f);
+  ASSERT_TRUE(WriteDelimitedMessagesToOStream(input_messages.begin(),
+                                              input_messages.end(), oss,
+                                              /*compress=*/false)
+                  .ok());
+  std::istringstream iss(oss.str());
+  std::vector<PriceRecord> messages;
+  ASSERT_TRUE(ReadDelimitedMessagesFromIStream(iss, messages).ok());
+  ASSERT_EQ(messages.size(), 5);
+  EXPECT_FLOAT_EQ(messages[0].price(), 700.0f);
+  EXPECT_FALSE(messages[1].has_price());
+  EXPECT_FALSE(messages[2].has_price());
+  EXPECT_FLOAT_EQ(messages[3].price(), 800.0f);
+  EXPECT_FALSE(messages[4].has_price());
+}
+
+TEST(DecompressingInputStreamTest, ReadMessages) {
+  for (const bool compress : {false, true}) {
+    std::ostringstream oss;
+    std::vector<PriceRecord> input_messages(100);
+    for (int i = 0; i < 100; ++i) {
+      input_messages[i].set_timestamp_sec(1483228800 + 60 * i);
+      input_messages[i].set_price(700.0f + i);
+    }
+    ASSERT_TRUE(WriteDelimitedMessagesToOStream(
+                    input_messages.begin(), input_messages.end(), oss,
+                    compress)
+                    .ok());
+    const std::string content = oss.str();
+    google::protobuf::io::ArrayInputStream array_stream(
+        content.data(), static_cast<int>(content.size()));
+    DecompressingInputStream input_stream(&array_stream);
+    for (int i = 0; i < 100; ++i) {
+      PriceRecord message;
+      ASSERT_TRUE(google::protobuf::util::ParseDelimitedFromZeroCopyStream(
+          &message, &input_stream, /*clean_eof=*/nullptr));
+      EXPECT_EQ(message.timestamp_sec(), 1483228800 + 60 * i);
+      EXPECT_FLOAT_EQ(message.price(), 700.0f + i);
+    }
+    PriceRecord message;
+    bool clean_eof = false;
+    EXPECT_FALSE(google::protobuf::util::ParseDelimitedFromZeroCopyStream(
+        &message, &input_stream, &clean_eof));
+    EXPECT_TRUE(clean_eof);
+    EXPECT_FALSE(input_stream.failed());
+  }
+}
+
 }  // namespace trader